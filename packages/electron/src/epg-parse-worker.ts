@@ -10,50 +10,15 @@
  */
 import { parentPort, workerData } from 'worker_threads';
 import { createReadStream, statSync } from 'fs';
+import { buildMatchedXmltvIds, type EpgChannel, type ProviderChannel } from '@sbtltv/local-adapter/epg-match';
 
-interface EpgChannel { id: string; displayNames: string[]; }
 interface EpgProgram { channel_id: string; title: string; description: string; start: string; stop: string; }
-interface ProviderChannel { epg_channel_id: string; name: string; stream_id: string; }
 
 function workerLog(msg: string) {
   parentPort?.postMessage({ type: 'log', message: msg });
 }
 
-// ---- Matching helpers (duplicated from epg-matcher.ts) ----
-// Worker thread runs in Node.js main process and can't import from the
-// renderer-side UI package. Keep these in sync with epg-matcher.ts manually.
-
-function normalize(name: string): string {
-  let s = name;
-  s = s.replace(/^(USA?|UK|CA|AU|NZ|FR|DE|ES|IT|PT|NL|BE|AT|CH|IE|IN)\s*[:\-|]?\s*/i, '');
-  s = s.replace(/([\s*]*(L?HD|UHD|FHD|SD|4K|East|West|\+1|\*))+\s*$/i, '');
-  s = s.toLowerCase();
-  s = s.replace(/&/g, 'and').replace(/\+/g, 'plus');
-  return s.replace(/[^a-z0-9]/g, '');
-}
-
-function normalizeLooser(name: string): string {
-  let s = normalize(name);
-  s = s.replace(/^the/, '');
-  s = s.replace(/(channel|network|television)$/, '');
-  // Only strip trailing "tv" if preceded by 3+ chars (avoid mangling acronyms like MTV, CTV, ATV)
-  s = s.replace(/(?<=.{3})tv$/, '');
-  return s;
-}
-
-function extractCodes(epgId: string): string[] {
-  const matches = epgId.match(/\(([^)]+)\)/g);
-  if (!matches) return [];
-  return matches.map(m => m.slice(1, -1).toLowerCase());
-}
-
-function slugify(id: string): string {
-  return id.replace(/\.\w{2,3}$/, '').replace(/\([^)]*\)/g, '').toLowerCase().replace(/[^a-z0-9]/g, '');
-}
-
-function stripTld(id: string): string {
-  return id.replace(/\.\w{2,3}$/, '').toLowerCase();
-}
+// ---- Parsing helpers ----
 
 function decodeEntities(s: string): string {
   if (s.indexOf('&') === -1) return s;
@@ -71,165 +36,6 @@ function parseDate(d: string): string | null {
   return `${yr}-${mo}-${dy}T${hr}:${mn}:${sc}${tz ? tz.slice(0, 3) + ':' + tz.slice(3) : 'Z'}`;
 }
 
-// ---- Matching logic ----
-
-function buildMatchedXmltvIds(xmltvChannels: EpgChannel[], providerChannels: ProviderChannel[]): Set<string> {
-  const matched = new Set<string>();
-
-  const exactMap = new Map<string, string>();
-  const codeMap = new Map<string, string>();
-  const displayNameMap = new Map<string, string>();
-  const slugMap = new Map<string, string>();
-  const looseNameMap = new Map<string, string>();
-  const looseSlugMap = new Map<string, string>();
-
-  for (const xch of xmltvChannels) {
-    exactMap.set(xch.id, xch.id);
-    for (const code of extractCodes(xch.id)) {
-      codeMap.set(code, xch.id);
-      // US/CA local stations use DT (digital television) suffix in XMLTV (e.g. "wabcdt"),
-      // but providers use bare call signs ("wabc"). Map base call to catch these.
-      const dtMatch = code.match(/^(.+?)dt(\d?)$/);
-      if (dtMatch) {
-        const baseCall = dtMatch[1];
-        const dtNum = dtMatch[2];
-        if (!dtNum || !codeMap.has(baseCall)) {
-          codeMap.set(baseCall, xch.id);
-        }
-      }
-    }
-    for (const dn of xch.displayNames) {
-      const norm = normalize(dn);
-      if (norm) displayNameMap.set(norm, xch.id);
-      const loose = normalizeLooser(dn);
-      if (loose) looseNameMap.set(loose, xch.id);
-    }
-    const slug = slugify(xch.id);
-    if (slug) {
-      slugMap.set(slug, xch.id);
-      const looseSlug = slug.replace(/(channel|network|television|tv)$/, '');
-      if (looseSlug) looseSlugMap.set(looseSlug, xch.id);
-    }
-  }
-
-  const providerMatched = new Set<string>();
-  const callsignSkip = new Set(['USA', 'UHD', 'WEST', 'EAST', 'COZI', 'CBSN', 'CSPAN', 'CNBC', 'CMT', 'CNN', 'CBS', 'CMA', 'CITY', 'CRIME', 'WORLD', 'CGTN', 'WWE', 'NBC', 'ABC', 'FOX', 'PBS', 'CW']);
-
-  for (const ch of providerChannels) {
-    if (providerMatched.has(ch.stream_id)) continue;
-    const norm = normalize(ch.name);
-    const loose = normalizeLooser(ch.name);
-
-    if (ch.epg_channel_id) {
-      const ex = exactMap.get(ch.epg_channel_id);
-      if (ex) { matched.add(ex); providerMatched.add(ch.stream_id); continue; }
-      const base = stripTld(ch.epg_channel_id);
-      if (base) { const cm = codeMap.get(base); if (cm) { matched.add(cm); providerMatched.add(ch.stream_id); continue; } }
-    }
-    if (norm) { const dm = displayNameMap.get(norm); if (dm) { matched.add(dm); providerMatched.add(ch.stream_id); continue; } }
-    if (norm) { const cm2 = codeMap.get(norm); if (cm2) { matched.add(cm2); providerMatched.add(ch.stream_id); continue; } }
-    if (ch.epg_channel_id) {
-      const slug = slugify(ch.epg_channel_id);
-      if (slug) { const sm = slugMap.get(slug); if (sm) { matched.add(sm); providerMatched.add(ch.stream_id); continue; } }
-    }
-    if (ch.epg_channel_id) {
-      const base = stripTld(ch.epg_channel_id);
-      if (base) { const dm2 = displayNameMap.get(base); if (dm2) { matched.add(dm2); providerMatched.add(ch.stream_id); continue; } }
-    }
-    if (loose) { const lm = looseNameMap.get(loose); if (lm) { matched.add(lm); providerMatched.add(ch.stream_id); continue; } }
-    if (loose) { const lc = codeMap.get(loose); if (lc) { matched.add(lc); providerMatched.add(ch.stream_id); continue; } }
-    if (ch.epg_channel_id) {
-      const baseLo = normalizeLooser(stripTld(ch.epg_channel_id));
-      if (baseLo) {
-        const bl = looseNameMap.get(baseLo); if (bl) { matched.add(bl); providerMatched.add(ch.stream_id); continue; }
-        const bls = looseSlugMap.get(baseLo); if (bls) { matched.add(bls); providerMatched.add(ch.stream_id); continue; }
-      }
-    }
-    if (loose) { const ls = looseSlugMap.get(loose); if (ls) { matched.add(ls); providerMatched.add(ch.stream_id); continue; } }
-
-    // Strategy 11: Extract call signs from channel name
-    {
-      const parenMatches = ch.name.match(/\(([A-Z][A-Z0-9\-]{2,8})\)/g) || [];
-      const parenSigns = parenMatches.map(s => s.slice(1, -1).replace(/-/g, ''));
-      const textSigns = ch.name.match(/\b([KWCX][A-Z]{2,4}(?:-?DT\d?)?)\b/g) || [];
-      const allSigns = [...parenSigns, ...textSigns.map(s => s.replace(/-/g, ''))];
-
-      for (const sign of allSigns) {
-        if (callsignSkip.has(sign) || sign.length < 3) continue;
-        const code = sign.toLowerCase();
-        const cm = codeMap.get(code)
-          || codeMap.get(code + 'dt')
-          || (code.match(/dt\d?$/) ? codeMap.get(code.replace(/dt\d?$/, '')) : null);
-        if (cm) { matched.add(cm); providerMatched.add(ch.stream_id); break; }
-      }
-      if (providerMatched.has(ch.stream_id)) continue;
-    }
-  }
-
-  // Strategy 12: Lightweight fuzzy fallback — word overlap + substring matching
-  {
-    const wordIndex = new Map<string, Set<string>>();
-    for (const xch of xmltvChannels) {
-      for (const dn of xch.displayNames) {
-        const words = normalize(dn).match(/[a-z]{3,}/g) || [];
-        for (const w of words) {
-          if (!wordIndex.has(w)) wordIndex.set(w, new Set());
-          wordIndex.get(w)!.add(xch.id);
-        }
-      }
-    }
-
-    const epgNormById = new Map<string, string>();
-    for (const xch of xmltvChannels) {
-      if (xch.displayNames.length > 0) {
-        epgNormById.set(xch.id, normalize(xch.displayNames[0]));
-      }
-    }
-
-    let fuzzyMatched = 0;
-    for (const ch of providerChannels) {
-      if (providerMatched.has(ch.stream_id)) continue;
-      const norm = normalize(ch.name);
-      if (!norm || norm.length < 4) continue;
-      const words = norm.match(/[a-z]{3,}/g) || [];
-      if (words.length === 0) continue;
-
-      const candidates = new Map<string, number>();
-      for (const w of words) {
-        const ids = wordIndex.get(w);
-        if (ids) {
-          for (const id of ids) candidates.set(id, (candidates.get(id) || 0) + 1);
-        }
-      }
-
-      let bestId: string | null = null;
-      let bestScore = 0;
-      for (const [id, wordOverlap] of candidates) {
-        if (wordOverlap < Math.max(1, words.length * 0.4)) continue;
-        const epgNorm = epgNormById.get(id);
-        if (!epgNorm) continue;
-        const shorter = norm.length < epgNorm.length ? norm : epgNorm;
-        const longer = norm.length >= epgNorm.length ? norm : epgNorm;
-        if (longer.includes(shorter) || shorter.includes(longer)) {
-          const score = shorter.length / longer.length;
-          if (score > bestScore && score >= 0.6) { bestScore = score; bestId = id; }
-        }
-      }
-
-      if (bestId) {
-        matched.add(bestId);
-        providerMatched.add(ch.stream_id);
-        fuzzyMatched++;
-      }
-    }
-    if (fuzzyMatched > 0) {
-      workerLog(`[epg-worker] Fuzzy fallback matched ${fuzzyMatched} additional channels`);
-    }
-  }
-
-  return matched;
-}
-
 // ---- Stream parser ----
 
 /**
@@ -411,7 +217,7 @@ try {
     workerLog(`[epg-worker] Found ${xmltvChannels.length} EPG channels`);
 
     // Run matching
-    filterIds = buildMatchedXmltvIds(xmltvChannels, providerChannels);
+    filterIds = buildMatchedXmltvIds(xmltvChannels, providerChannels, workerLog);
     workerLog(`[epg-worker] Matched ${filterIds.size}/${providerChannels.length} provider channels — will filter programmes`);
   }
 
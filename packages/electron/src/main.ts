@@ -6,14 +6,19 @@ import * as fs from 'fs';
 import { fileURLToPath } from 'url';
 import type { Source } from '@sbtltv/core';
 import * as storage from './storage.js';
+import { buildMatchedXmltvIds } from '@sbtltv/local-adapter/epg-match';
 import electronUpdater from 'electron-updater';
 const { autoUpdater } = electronUpdater;
 type UpdateInfo = electronUpdater.UpdateInfo;
 // Dynamic import - mpv-texture-bridge depends on Electron's sharedTexture API
 // which may not be available on all platforms
 type MpvTextureBridgeType = import('./mpv-texture-bridge.js').MpvTextureBridge;
+type PlaybackProfile = import('@sbtltv/mpv-texture').PlaybackProfile;
+
+// Live channels probe less and buffer moderately; standby players use it too
+const LIVE_PROFILE: PlaybackProfile = 'stable-live';
 let MpvTextureBridgeClass: (new () => MpvTextureBridgeType) | null = null;
-if (process.platform === 'darwin') {
+if (process.platform === 'darwin' || process.platform === 'linux' || process.platform === 'win32') {
   try {
     const mod = await import('./mpv-texture-bridge.js');
     MpvTextureBridgeClass = mod.MpvTextureBridge;
@@ -22,9 +27,9 @@ if (process.platform === 'darwin') {
   }
 }
 
-// On macOS, default to native mpv-texture addon (IOSurface shared texture).
+// Default to native mpv-texture addon (IOSurface / dma-buf / DXGI shared texture).
 // Falls back to external mpv process if the bridge fails to load or initialize.
-const USE_NATIVE_MPV = process.platform === 'darwin';
+const USE_NATIVE_MPV = process.platform === 'darwin' || process.platform === 'linux' || process.platform === 'win32';
 
 // ESM equivalent of __dirname
 const __filename = fileURLToPath(import.meta.url);
@@ -42,6 +47,11 @@ const pendingRequests = new Map<number, { resolve: (data: unknown) => void; reje
 
 // Native mpv-texture state
 let useNativeMpv = false;
+// Settles once startup has picked native or external mpv (renderer asks via mpv-get-mode)
+let resolveMpvMode: () => void = () => {};
+const mpvModeDecided = new Promise<void>((resolve) => {
+  resolveMpvMode = resolve;
+});
 let mpvBridge: MpvTextureBridgeType | null = null;
 
 // Track mpv state
@@ -127,6 +137,8 @@ function rotateLogIfNeeded(): boolean {
 
 function initDebugLogging(enabled: boolean): void {
   debugLoggingEnabled = enabled;
+  // Frame latency tracing rides along with debug logging
+  mpvBridge?.setTrace(enabled);
 
   if (enabled && !debugLogStream) {
     const logPath = getDebugLogPath();
@@ -226,6 +238,17 @@ async function createWindow(): Promise<void> {
     }
   });
 
+  // Nothing of the video is visible while minimized or hidden: stop
+  // rendering it (audio keeps playing) until the window comes back
+  const suspendVideo = (suspended: boolean) => {
+    mpvBridge?.setRenderMode(suspended ? 'suspended' : 'active');
+    debugLog(`Video rendering ${suspended ? 'suspended' : 'resumed'}`, 'mpv');
+  };
+  mainWindow.on('minimize', () => suspendVideo(true));
+  mainWindow.on('hide', () => suspendVideo(true));
+  mainWindow.on('restore', () => suspendVideo(false));
+  mainWindow.on('show', () => suspendVideo(false));
+
   mainWindow.on('closed', () => {
     mainWindow = null;
     killMpv();
@@ -543,6 +566,9 @@ async function initNativeMpv(): Promise<boolean> {
     bridge = new MpvTextureBridgeClass();
     const success = await bridge.initialize(mainWindow, {
       hwdec: 'auto',
+      displaySync: true,
+      profile: LIVE_PROFILE,
+      trace: debugLoggingEnabled,
     });
 
     if (!success) {
@@ -766,24 +792,30 @@ ipcMain.handle('window-set-size', (_event, width: number, height: number) => {
 });
 
 // IPC Handlers - mpv control
-ipcMain.handle('mpv-load', async (_event, url: string, startPosition?: number) => {
+ipcMain.handle('mpv-load', async (_event, url: string, startPosition?: number, isLive?: boolean) => {
   const resumeAt = startPosition && startPosition > 0 ? Math.floor(startPosition) : 0;
-  debugLog(`mpv-load called with URL: ${url}${resumeAt ? ` (resume @ ${resumeAt}s)` : ''}`, 'mpv');
+  const profile: PlaybackProfile = isLive === false ? 'vod' : LIVE_PROFILE;
+  debugLog(`mpv-load called with URL: ${url} [${profile}]${resumeAt ? ` (resume @ ${resumeAt}s)` : ''}`, 'mpv');
 
   // Set pending resume — will seek when duration property arrives (file loaded).
   // Generation counter ensures stale seeks from previous loads are discarded.
   loadGeneration++;
   pendingResume = resumeAt > 0 ? { position: resumeAt, generation: loadGeneration } : null;
 
-  // Route to native bridge if available — plain loadfile, no options string
+  // Route to native bridge if available — no options string beyond the profile
   // (start= option is unreliable across mpv versions; seek-on-duration is used instead)
   if (useNativeMpv && mpvBridge) {
     try {
-      await mpvBridge.load(url, '');
+      await mpvBridge.load(url, '', profile);
       debugLog('mpv-load SUCCESS (native)', 'mpv');
       return { success: true };
     } catch (error) {
       const errMsg = error instanceof Error ? error.message : 'Unknown error';
+      if (errMsg === 'Load aborted') {
+        // Replaced by a newer load (channel zap) — not a failure, skip fallbacks
+        debugLog('mpv-load superseded (native)', 'mpv');
+        return { success: false };
+      }
       debugLog(`mpv-load FAILED (native): ${errMsg}`, 'mpv');
       return { error: 'Failed to load stream. Enable debug logging in Settings for details.' };
     }
@@ -847,7 +879,7 @@ ipcMain.handle('mpv-pause', async () => {
 ipcMain.handle('mpv-toggle-pause', async () => {
   if (useNativeMpv && mpvBridge) {
     try {
-      const status = mpvBridge.getStatus();
+      const status = mpvBridge.readStatus();
       if (status?.playing) {
         mpvBridge.pause();
       } else {
@@ -925,6 +957,25 @@ ipcMain.handle('mpv-seek', async (_event, seconds: number) => {
   }
 });
 
+ipcMain.handle('mpv-prepare', async (_event, urls: string[]) => {
+  // Standby players only exist in native mode; external mpv has a single instance
+  if (useNativeMpv && mpvBridge && Array.isArray(urls)) {
+    mpvBridge.prepare(urls.filter((url) => typeof url === 'string'));
+  }
+  return { success: true };
+});
+
+ipcMain.handle('mpv-capture-thumbnail', async (_event, width: number, height: number) => {
+  // Native only: external mpv renders into its own window
+  if (!useNativeMpv || !mpvBridge) return { error: 'Thumbnails need native mpv' };
+  try {
+    const { width: w, height: h, data } = await mpvBridge.captureThumbnail(width, height);
+    return { success: true, width: w, height: h, data: new Uint8Array(data.buffer, data.byteOffset, data.byteLength) };
+  } catch (error) {
+    return { error: error instanceof Error ? error.message : 'Unknown error' };
+  }
+});
+
 ipcMain.handle('mpv-stop', async () => {
   debugLog('mpv-stop called', 'mpv');
   pendingResume = null;
@@ -957,11 +1008,21 @@ ipcMain.handle('mpv-get-status', async () => {
   return mpvState;
 });
 
+// Presentation feedback from VideoCanvas (paces native rendering to the display)
+ipcMain.on('video-presented', (_event, presentedAtMs: number) => {
+  if (typeof presentedAtMs === 'number') {
+    mpvBridge?.reportPresentation(presentedAtMs);
+  }
+});
+
 // Get mpv mode (native vs external) for renderer adaptation
-ipcMain.handle('mpv-get-mode', async () => ({
-  mode: useNativeMpv ? 'native' : 'external',
-  sharedTextureAvailable: useNativeMpv,
-}));
+ipcMain.handle('mpv-get-mode', async () => {
+  await mpvModeDecided;
+  return {
+    mode: useNativeMpv ? 'native' : 'external',
+    sharedTextureAvailable: useNativeMpv,
+  };
+});
 
 // IPC Handlers - Storage
 ipcMain.handle('storage-get-sources', async () => {
@@ -1028,6 +1089,28 @@ ipcMain.handle('debug-get-log-path', async () => {
   return { success: true, data: getDebugLogPath() };
 });
 
+// Recent native mpv log (native mode only; external mpv logs to its own output)
+ipcMain.handle('debug-get-mpv-log', async () => {
+  return { success: true, data: mpvBridge?.dumpLog() ?? '' };
+});
+
+// Native frame latency trace, written next to the debug log as Chrome
+// trace-event JSON; returns the file path (null if nothing was recorded)
+ipcMain.handle('debug-dump-mpv-trace', async () => {
+  try {
+    const trace = mpvBridge?.dumpTrace();
+    if (!trace) return { success: true, data: null };
+    const stamp = new Date().toISOString().replace(/[:.]/g, '-');
+    const tracePath = path.join(path.dirname(getDebugLogPath()), `sbtltv-frame-trace-${stamp}.json`);
+    await fs.promises.mkdir(path.dirname(tracePath), { recursive: true });
+    await fs.promises.writeFile(tracePath, trace);
+    debugLog(`Frame trace written to ${tracePath}`, 'mpv');
+    return { success: true, data: tracePath };
+  } catch (error) {
+    return { error: error instanceof Error ? error.message : 'Unknown error' };
+  }
+});
+
 ipcMain.handle('debug-log-renderer', async (_event, message: string) => {
   debugLog(message, 'renderer');
   return { success: true };
@@ -1266,13 +1349,13 @@ function parseEpgInWorkerThread(filePath: string, providerChannels?: ProviderCha
 const MAX_DOWNLOAD_BYTES = 500 * 1024 * 1024;   // 500MB compressed
 const MAX_DECOMPRESS_BYTES = 4 * 1024 * 1024 * 1024; // 4GB decompressed
 
-// Stream download to temp file (avoids ArrayBuffer size limits for large EPG files)
-async function downloadToTempFile(url: string): Promise<string> {
+// Stream download to temp file (avoids ArrayBuffer size limits for large EPG / M3U files)
+async function downloadToTempFile(url: string, label = 'epg'): Promise<string> {
   const { createWriteStream } = await import('fs');
   const { randomUUID } = await import('crypto');
   const { tmpdir } = await import('os');
 
-  const tmpPath = path.join(tmpdir(), `epg-${randomUUID()}.tmp`);
+  const tmpPath = path.join(tmpdir(), `${label}-${randomUUID()}.tmp`);
   const response = await electronNet.fetch(url);
   if (!response.ok) {
     throw new Error(`HTTP ${response.status}: ${response.statusText}`);
@@ -1294,7 +1377,7 @@ async function downloadToTempFile(url: string): Promise<string> {
       if (totalBytes > MAX_DOWNLOAD_BYTES) {
         fileStream.destroy();
         try { (await import('fs')).unlinkSync(tmpPath); } catch {}
-        throw new Error(`EPG download exceeds ${MAX_DOWNLOAD_BYTES / 1024 / 1024}MB limit`);
+        throw new Error(`${label.toUpperCase()} download exceeds ${MAX_DOWNLOAD_BYTES / 1024 / 1024}MB limit`);
       }
       fileStream.write(Buffer.from(value));
     }
@@ -1309,7 +1392,7 @@ async function downloadToTempFile(url: string): Promise<string> {
     throw err;
   }
 
-  console.log(`[epg] Downloaded ${Math.round(totalBytes / 1024 / 1024)}MB to temp file`);
+  console.log(`[${label}] Downloaded ${Math.round(totalBytes / 1024 / 1024)}MB to temp file`);
   return tmpPath;
 }
 
@@ -1371,7 +1454,44 @@ async function decompressToFile(filePath: string, isGz: boolean): Promise<{ xmlP
   return { xmlPath, sizeMB: Math.round(decompressedSize / 1024 / 1024) };
 }
 
-// Fetch, decompress, and parse EPG — parsing runs in a worker thread
+// Native playlist / guide parser (playlist_parser.node), loaded on first use
+type PlaylistParserModule = typeof import('@sbtltv/mpv-texture/dist/playlist.js');
+let playlistParser: PlaylistParserModule | null | undefined;
+
+async function loadPlaylistParser(): Promise<PlaylistParserModule | null> {
+  if (playlistParser === undefined) {
+    try {
+      const mod = await import('@sbtltv/mpv-texture/dist/playlist.js');
+      playlistParser = mod.isPlaylistParserAvailable() ? mod : null;
+    } catch (error) {
+      console.warn('[playlist] Failed to load native playlist parser:', error);
+      playlistParser = null;
+    }
+  }
+  return playlistParser;
+}
+
+// Parse an uncompressed XMLTV file with the native parser: channels first,
+// then only the programmes of matched channels, multi-threaded. Programmes
+// come back as columns (see EpgColumns) rather than one object each.
+async function parseEpgNative(parser: PlaylistParserModule, filePath: string, providerChannels?: ProviderChannelInfo[]) {
+  const t0 = Date.now();
+  const channels = await parser.scanXmltvChannels(filePath);
+  let filterIds: string[] | null = null;
+  if (providerChannels && providerChannels.length > 0) {
+    filterIds = [...buildMatchedXmltvIds(channels, providerChannels)];
+    console.log(`[epg] Matched ${filterIds.length}/${providerChannels.length} provider channels — will filter programmes`);
+  }
+  const guide = await parser.parseXmltvProgrammes(filePath, filterIds);
+  if (guide.skipped > 0) {
+    console.log(`[epg] Skipped ${guide.skipped} programmes for non-matching channels`);
+  }
+  console.log(`[epg] Native parse: ${channels.length} channels, ${guide.count} programs (${guide.strings.length} strings) in ${Date.now() - t0}ms`);
+  return { channels, guide };
+}
+
+// Fetch, decompress, and parse EPG — natively when the playlist parser addon
+// is available, otherwise in a worker thread
 ipcMain.handle('fetch-and-parse-epg', async (_event, url: string, providerChannels?: ProviderChannelInfo[]) => {
   const settings = storage.getSettings();
   if (!isAllowedBinaryUrl(url, settings.allowLanSources ?? false)) {
@@ -1387,6 +1507,12 @@ ipcMain.handle('fetch-and-parse-epg', async (_event, url: string, providerChanne
     const { xmlPath, sizeMB } = await decompressToFile(tmpPath, isGz);
     if (xmlPath !== tmpPath) tempFiles.push(xmlPath);
 
+    const parser = await loadPlaylistParser();
+    if (parser) {
+      console.log(`[epg] Parsing ${sizeMB}MB natively...`);
+      return { success: true, data: await parseEpgNative(parser, xmlPath, providerChannels) };
+    }
+
     // Worker stream-parses from the file — no memory limits
     console.log(`[epg] Parsing ${sizeMB}MB in worker thread...`);
     const t0 = Date.now();
@@ -1405,6 +1531,39 @@ ipcMain.handle('fetch-and-parse-epg', async (_event, url: string, providerChanne
   }
 });
 
+// =========================================================================
+// M3U: download to a temp file and parse it natively (memory-mapped, on the
+// libuv thread pool). Only columns and a string table cross IPC; the
+// renderer falls back to its JS parser only when the result is flagged
+// `unavailable` (addon not built) — fetch and parse errors are final.
+// =========================================================================
+ipcMain.handle('fetch-and-parse-m3u', async (_event, url: string) => {
+  const settings = storage.getSettings();
+  if (!isAllowedBinaryUrl(url, settings.allowLanSources ?? false)) {
+    return { success: false, error: 'Blocked: Local network access is disabled. Enable "Allow LAN sources" in Settings > System > Security if you trust this source.' };
+  }
+  const parser = await loadPlaylistParser();
+  if (!parser) {
+    return { success: false, unavailable: true, error: 'Native playlist parser not available' };
+  }
+  let tmpPath: string | null = null;
+  try {
+    console.log(`[m3u] Fetching ${url}...`);
+    tmpPath = await downloadToTempFile(url, 'm3u');
+    const t0 = Date.now();
+    const columns = await parser.parseM3UFile(tmpPath);
+    console.log(`[m3u] Parsed ${columns.count} entries (${columns.strings.length} strings) in ${Date.now() - t0}ms`);
+    return { success: true, data: columns };
+  } catch (error) {
+    console.error('[m3u] Parse failed:', error);
+    return { success: false, error: error instanceof Error ? error.message : 'Fetch/parse failed' };
+  } finally {
+    if (tmpPath) {
+      try { fs.unlinkSync(tmpPath); } catch {}
+    }
+  }
+});
+
 // App lifecycle
 app.whenReady().then(async () => {
   // Initialize debug logging from saved settings
@@ -1413,7 +1572,7 @@ app.whenReady().then(async () => {
 
   await createWindow();
 
-  // Try native mpv-texture if on macOS and bridge loaded
+  // Try native mpv-texture if the bridge loaded
   if (USE_NATIVE_MPV && MpvTextureBridgeClass) {
     console.log('[mpv] Attempting native mpv-texture initialization...');
     const nativeSuccess = await initNativeMpv();
@@ -1429,7 +1588,7 @@ app.whenReady().then(async () => {
       await initMpv();
     }
   } else {
-    // Non-macOS or addon not loaded: use external mpv
+    // Native disabled or addon not loaded: use external mpv
     const mpvAvailable = await checkMpvAvailable();
     if (!mpvAvailable) {
       app.quit();
@@ -1437,6 +1596,7 @@ app.whenReady().then(async () => {
     }
     await initMpv();
   }
+  resolveMpvMode();
 
   // Auto-updater (packaged builds with native update support:
   //   Windows NSIS, macOS DMG/ZIP, Linux AppImage)
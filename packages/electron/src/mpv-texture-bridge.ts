@@ -6,7 +6,37 @@
  */
 
 import { BrowserWindow, sharedTexture, SharedTextureHandle } from 'electron';
-import type { MpvTexture, MpvStatus, TextureInfo, MpvConfig } from '@sbtltv/mpv-texture';
+import type { MpvTexture, MpvStatus, StatusSample, TextureInfo, MpvConfig, PlaybackProfile, RenderMode, Thumbnail, TraceEvent } from '@sbtltv/mpv-texture';
+
+/** Most standby players kept warm at once (each holds a decoder and GPU textures) */
+const MAX_STANDBY = 2;
+
+/** A frame waiting to be sent, tagged with the player it must be released to */
+interface PendingFrame {
+  player: MpvTexture;
+  info: TextureInfo;
+}
+
+/** A hidden player pre-opening a likely next channel */
+interface StandbyPlayer {
+  player: MpvTexture;
+  loaded: Promise<void>;
+}
+
+/**
+ * Color space Chromium should sample a frame with. Planar exports are limited
+ * range YUV: nv12 is BT.709, p010 BT.2020 with the frame's transfer function.
+ */
+function colorSpaceOf(info: TextureInfo) {
+  if (info.format === 'p010') {
+    const transfer = info.transfer === 'sdr' ? 'bt709' : info.transfer;
+    return { primaries: 'bt2020', transfer, matrix: 'bt2020-ncl', range: 'limited' } as const;
+  }
+  if (info.format === 'nv12') {
+    return { primaries: 'bt709', transfer: 'bt709', matrix: 'bt709', range: 'limited' } as const;
+  }
+  return undefined;
+}
 
 /**
  * MpvTextureBridge - Integrates mpv-texture with Electron's sharedTexture API
@@ -17,13 +47,24 @@ export class MpvTextureBridge {
   private frameIndex = 0;
   private initialized = false;
   private sending = false;
-  private pendingFrame: TextureInfo | null = null;
+  private pendingFrame: PendingFrame | null = null;
+  private playerClass: (new () => MpvTexture) | null = null;
+  private toChromeTrace: ((events: TraceEvent[]) => object) | null = null;
+  private config?: MpvConfig;
+  private standby = new Map<string, StandbyPlayer>();
+  // URLs of the last prepare(), and those whose standby player is still being created
+  private wanted: string[] = [];
+  private warming = new Set<string>();
+  private currentUrl: string | null = null;
+  private outputSize = { width: 0, height: 0 };
+  private renderMode: RenderMode = 'active';
+  private statusSample = {} as StatusSample;
   private statusCallback?: (status: MpvStatus) => void;
   private errorCallback?: (error: string) => void;
   private consecutiveErrors = 0;
 
   // Diagnostics
-  private stats = { received: 0, dropped: 0, sent: 0, errors: 0, importMs: 0, sendMs: 0, sendCount: 0 };
+  private stats = { received: 0, dropped: 0, nativeDropped: 0, sent: 0, errors: 0, importMs: 0, sendMs: 0, sendCount: 0 };
   private statsInterval: ReturnType<typeof setInterval> | null = null;
 
   /**
@@ -41,31 +82,21 @@ export class MpvTextureBridge {
     try {
       // Dynamic import of the native addon
       // This allows the app to run without the addon (falling back to external mpv)
+      // Each bridge owns its own native player so several can run side by side
       const mpvModule = await import('@sbtltv/mpv-texture');
-      this.mpv = mpvModule.mpvTexture;
+      this.playerClass = mpvModule.MpvTexture;
+      this.toChromeTrace = mpvModule.toChromeTrace;
+      this.mpv = new mpvModule.MpvTexture();
+      this.config = config;
     } catch (error) {
       console.warn('[MpvTextureBridge] Failed to load mpv-texture addon:', error);
       return false;
     }
 
     try {
-      // Create mpv context
-      this.mpv.create(config);
-
-      // Set up frame callback for sharedTexture integration
-      this.mpv.onFrame((textureInfo) => {
-        this.handleFrame(textureInfo);
-      });
-
-      // Set up status callback
-      this.mpv.onStatus((status) => {
-        this.statusCallback?.(status);
-      });
-
-      // Set up error callback
-      this.mpv.onError((error) => {
-        this.errorCallback?.(error);
-      });
+      // Create mpv context (initialized on its own render thread)
+      await this.mpv.create(config);
+      this.attach(this.mpv);
 
       this.initialized = true;
       console.log('[MpvTextureBridge] Initialized successfully');
@@ -75,8 +106,12 @@ export class MpvTextureBridge {
         if (this.stats.received > 0) {
           const avgImport = this.stats.sendCount > 0 ? (this.stats.importMs / this.stats.sendCount).toFixed(1) : '?';
           const avgSend = this.stats.sendCount > 0 ? (this.stats.sendMs / this.stats.sendCount).toFixed(1) : '?';
-          console.log(`[MpvTextureBridge] sent:${this.stats.sent}/2s drop:${this.stats.dropped} mpv:${this.stats.received} err:${this.stats.errors} | import:${avgImport}ms send:${avgSend}ms`);
-          this.stats = { received: 0, dropped: 0, sent: 0, errors: 0, importMs: 0, sendMs: 0, sendCount: 0 };
+          const native = this.mpv?.getStats(true);
+          const nativeLine = native
+            ? ` | gpu-p95:${(native.gpuUs.p95 / 1000).toFixed(1)}ms deliver-p95:${(native.deliveryUs.p95 / 1000).toFixed(1)}ms lock-fail:${native.lockFailures}`
+            : '';
+          console.log(`[MpvTextureBridge] sent:${this.stats.sent}/2s drop:${this.stats.dropped} native-drop:${this.stats.nativeDropped} mpv:${this.stats.received} err:${this.stats.errors} | import:${avgImport}ms send:${avgSend}ms${nativeLine}`);
+          this.stats = { received: 0, dropped: 0, nativeDropped: 0, sent: 0, errors: 0, importMs: 0, sendMs: 0, sendCount: 0 };
         }
       }, 2000);
 
@@ -87,6 +122,40 @@ export class MpvTextureBridge {
     }
   }
 
+  /**
+   * Route a player's frames, status and errors to this bridge
+   *
+   * Callbacks check that the player is still the active one, so a player
+   * swapped out by promote() cannot leak stale frames or status.
+   */
+  private attach(player: MpvTexture): void {
+    // Set up frame callback for sharedTexture integration
+    player.onFrame((textureInfo) => {
+      this.handleFrame(player, textureInfo);
+    });
+
+    // Set up status callback
+    player.onStatus((status) => {
+      if (player === this.mpv) this.statusCallback?.(status);
+    });
+
+    // Set up error callback
+    player.onError((error) => {
+      if (player === this.mpv) this.errorCallback?.(error);
+    });
+
+    // mpv's error lines arrive batched through the log ring; surface them
+    // like player errors (standby players stay quiet until on air)
+    player.onLog((entries) => {
+      if (player !== this.mpv) return;
+      for (const entry of entries) {
+        if (entry.level === 'error' || entry.level === 'fatal') {
+          this.errorCallback?.(`${entry.prefix}: ${entry.text}`);
+        }
+      }
+    });
+  }
+
   /**
    * Handle a new frame from mpv
    *
@@ -94,16 +163,21 @@ export class MpvTextureBridge {
    * in progress, the frame is stored and will be picked up when the current
    * send completes — always sending the most recent frame available.
    */
-  private handleFrame(textureInfo: TextureInfo): void {
-    if (!this.window || !this.mpv) return;
+  private handleFrame(player: MpvTexture, textureInfo: TextureInfo): void {
+    if (!this.window || player !== this.mpv) {
+      player.releaseFrame(textureInfo);
+      return;
+    }
 
     this.stats.received++;
+    this.stats.nativeDropped += textureInfo.dropped;
 
-    if (this.sending) {
-      // Store latest, overwriting any previously pending frame
+    if (this.pendingFrame) {
+      // Store latest, overwriting (and handing back) any previously pending frame
       this.stats.dropped++;
+      this.pendingFrame.player.releaseFrame(this.pendingFrame.info);
     }
-    this.pendingFrame = textureInfo;
+    this.pendingFrame = { player, info: textureInfo };
 
     if (!this.sending) {
       this.sendLoop();
@@ -119,7 +193,7 @@ export class MpvTextureBridge {
     this.sending = true;
 
     while (this.pendingFrame) {
-      const textureInfo = this.pendingFrame;
+      const { player, info: textureInfo } = this.pendingFrame;
       this.pendingFrame = null;
 
       let imported: ReturnType<typeof sharedTexture.importSharedTexture> | null = null;
@@ -131,6 +205,20 @@ export class MpvTextureBridge {
           const ioSurfaceBuffer = Buffer.alloc(8);
           ioSurfaceBuffer.writeBigUInt64LE(textureInfo.handle);
           sharedTextureHandle = { ioSurface: ioSurfaceBuffer };
+        } else if (process.platform === 'linux') {
+          // handle is the exported dma-buf fd (single plane, layout from the addon)
+          const stride = textureInfo.stride ?? textureInfo.width * 4;
+          sharedTextureHandle = {
+            nativePixmap: {
+              planes: [{
+                stride,
+                offset: textureInfo.offset ?? 0,
+                size: stride * textureInfo.height,
+                fd: Number(textureInfo.handle),
+              }],
+              modifier: (textureInfo.modifier ?? 0n).toString(),
+            },
+          };
         } else {
           const handleBuffer = Buffer.alloc(8);
           handleBuffer.writeBigUInt64LE(textureInfo.handle);
@@ -144,8 +232,11 @@ export class MpvTextureBridge {
             handle: sharedTextureHandle,
             codedSize: { width: textureInfo.width, height: textureInfo.height },
             visibleRect: { x: 0, y: 0, width: textureInfo.width, height: textureInfo.height },
-            pixelFormat: textureInfo.format === 'nv12' ? 'rgba' : textureInfo.format,
+            pixelFormat: textureInfo.format === 'p010' ? 'p010le' : textureInfo.format,
+            colorSpace: colorSpaceOf(textureInfo),
           },
+          // Fires once both our handle and the renderer's are gone
+          allReferencesReleased: () => player.releaseFrame(textureInfo),
         });
 
         const t1 = performance.now();
@@ -173,6 +264,10 @@ export class MpvTextureBridge {
         if (this.consecutiveErrors === 5) {
           this.errorCallback?.(`Shared texture pipeline failing: ${this.consecutiveErrors} consecutive frame errors`);
         }
+        if (!imported) {
+          // Import never happened, so allReferencesReleased will not fire
+          player.releaseFrame(textureInfo);
+        }
       } finally {
         imported?.release();
       }
@@ -183,17 +278,117 @@ export class MpvTextureBridge {
 
   /**
    * Load a media URL
+   *
+   * @param profile - Playback profile for this file (default: the one from
+   *   initialize(), which standby players also use)
    */
-  async load(url: string, options?: string): Promise<void> {
+  async load(url: string, options?: string, profile?: PlaybackProfile): Promise<void> {
     if (!this.mpv || !this.initialized) {
       throw new Error('Bridge not initialized');
     }
-    // Clear stale frame in renderer and discard any queued frame
+    this.dropPendingFrame();
+
+    // Standby players were opened with the configured profile and no options
+    const reusable = !options && (!profile || profile === (this.config?.profile ?? 'default'));
+    const warm = reusable ? this.standby.get(url) : undefined;
+    if (warm) {
+      // Already opened and decoded in standby — swap it on air
+      this.standby.delete(url);
+      this.promote(warm.player);
+      this.currentUrl = url;
+      return warm.loaded;
+    }
+
+    // Clear stale frame in renderer
     if (this.window && !this.window.isDestroyed()) {
       this.window.webContents.send('video-clear');
     }
-    this.pendingFrame = null;
-    return this.mpv.load(url, options);
+    this.currentUrl = url;
+    return this.mpv.load(url, options, profile);
+  }
+
+  /**
+   * Pre-open likely next channels (e.g. the neighbours of the playing one)
+   * in hidden standby players, so that load() of one of them is instant.
+   * Standby players for URLs no longer listed are destroyed.
+   */
+  prepare(urls: string[]): void {
+    if (!this.initialized || !this.playerClass) return;
+
+    const wanted = urls.filter((url) => url !== this.currentUrl).slice(0, MAX_STANDBY);
+    for (const [url, warm] of this.standby) {
+      if (!wanted.includes(url)) {
+        warm.player.destroy();
+        this.standby.delete(url);
+      }
+    }
+
+    this.wanted = wanted;
+    for (const url of wanted) {
+      if (this.standby.has(url) || this.warming.has(url)) continue;
+      void this.warmUp(url);
+    }
+  }
+
+  /**
+   * Create a standby player for `url` and start opening it
+   */
+  private async warmUp(url: string): Promise<void> {
+    if (!this.playerClass) return;
+    const player = new this.playerClass();
+    this.warming.add(url);
+    try {
+      await player.create({ ...this.config, standby: true });
+    } catch (error) {
+      console.warn('[MpvTextureBridge] Failed to create standby player:', error);
+      return;
+    } finally {
+      this.warming.delete(url);
+    }
+
+    // Creation is asynchronous: the list may have moved on, or the URL gone on air
+    if (!this.initialized || !this.wanted.includes(url) || url === this.currentUrl || this.standby.has(url)) {
+      player.destroy();
+      return;
+    }
+
+    this.attach(player);
+    player.setOutputSize(this.outputSize.width, this.outputSize.height);
+
+    const loaded = player.load(url);
+    this.standby.set(url, { player, loaded });
+    loaded.catch(() => {
+      // Dead stream: don't keep it warm (and don't report — it isn't on air)
+      if (this.standby.get(url)?.player === player) {
+        this.standby.delete(url);
+        player.destroy();
+      }
+    });
+  }
+
+  /**
+   * Make a standby player the active one, carrying over volume and mute
+   */
+  private promote(next: MpvTexture): void {
+    const previous = this.mpv;
+    const status = previous?.getStatus();
+
+    this.mpv = next;
+    if (this.renderMode !== 'active') next.setRenderMode(this.renderMode);
+    next.promote();
+    if (status) {
+      next.setVolume(status.volume);
+      if (status.muted) next.toggleMute();
+    }
+
+    previous?.destroy();
+  }
+
+  private dropPendingFrame(): void {
+    if (this.pendingFrame) {
+      this.pendingFrame.player.releaseFrame(this.pendingFrame.info);
+      this.pendingFrame = null;
+    }
   }
 
   /**
@@ -238,6 +433,77 @@ export class MpvTextureBridge {
     this.mpv?.toggleMute();
   }
 
+  /**
+   * Render at the on-screen size (physical pixels) instead of the source
+   * size; 0, 0 follows the video. Applies to standby players too, so a
+   * promoted channel already matches the view.
+   */
+  setOutputSize(width: number, height: number): void {
+    this.outputSize = { width, height };
+    this.mpv?.setOutputSize(width, height);
+    for (const warm of this.standby.values()) {
+      warm.player.setOutputSize(width, height);
+    }
+  }
+
+  /**
+   * The on-air player's recent mpv log as text, for bug reports
+   */
+  dumpLog(): string {
+    const entries = this.mpv?.dumpLog() ?? [];
+    return entries
+      .map((entry) => `${new Date(entry.time).toISOString()} [${entry.prefix}] ${entry.level}: ${entry.text}`)
+      .join('\n');
+  }
+
+  /**
+   * Scale the on-air player's rendering down while the video is not visible
+   * (see MpvTexture.setRenderMode); audio keeps playing. Follows zaps.
+   */
+  setRenderMode(mode: RenderMode): void {
+    this.renderMode = mode;
+    this.mpv?.setRenderMode(mode);
+  }
+
+  /**
+   * Record per-frame latency events natively (see MpvTexture.setTrace).
+   * Standby players follow, so a promoted channel keeps tracing.
+   */
+  setTrace(enabled: boolean): void {
+    this.config = { ...this.config, trace: enabled };
+    this.mpv?.setTrace(enabled);
+    for (const warm of this.standby.values()) {
+      warm.player.setTrace(enabled);
+    }
+  }
+
+  /**
+   * The on-air player's latency trace as Chrome trace-event JSON
+   * (chrome://tracing, ui.perfetto.dev), or null if nothing was recorded
+   */
+  dumpTrace(): string | null {
+    const events = this.mpv?.dumpTrace() ?? [];
+    if (events.length === 0 || !this.toChromeTrace) return null;
+    return JSON.stringify(this.toChromeTrace(events));
+  }
+
+  /**
+   * Capture a thumbnail of the on-air picture (RGBA, read back natively
+   * without touching the shared texture in the renderer)
+   */
+  captureThumbnail(width: number, height: number): Promise<Thumbnail> {
+    if (!this.mpv) return Promise.reject(new Error('mpv not initialized'));
+    return this.mpv.captureThumbnail(width, height);
+  }
+
+  /**
+   * Presentation feedback from the renderer (epoch ms) for display-synced
+   * pacing; only the on-air player is being shown
+   */
+  reportPresentation(presentedAtMs: number): void {
+    this.mpv?.reportPresentation(presentedAtMs);
+  }
+
   /**
    * Get current status
    */
@@ -245,6 +511,13 @@ export class MpvTextureBridge {
     return this.mpv?.getStatus();
   }
 
+  /**
+   * Numeric status and counters from the shared snapshot (no native call)
+   */
+  readStatus(): StatusSample | undefined {
+    return this.mpv?.readStatus(this.statusSample);
+  }
+
   /**
    * Set status change callback
    */
@@ -274,6 +547,11 @@ export class MpvTextureBridge {
       clearInterval(this.statsInterval);
       this.statsInterval = null;
     }
+    this.dropPendingFrame();
+    for (const warm of this.standby.values()) {
+      warm.player.destroy();
+    }
+    this.standby.clear();
     if (this.mpv) {
       this.mpv.destroy();
       this.mpv = null;
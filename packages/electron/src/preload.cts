@@ -18,13 +18,21 @@ export interface MpvResult {
   error?: string;
 }
 
+export interface MpvThumbnailResult extends MpvResult {
+  width?: number;
+  height?: number;
+  /** RGBA8 pixels, top row first */
+  data?: Uint8Array;
+}
+
 export interface MpvModeInfo {
   mode: 'native' | 'external';
   sharedTextureAvailable: boolean;
 }
 
 export interface MpvApi {
-  load: (url: string, startPosition?: number) => Promise<MpvResult>;
+  // isLive picks the playback profile (native mode; live when omitted)
+  load: (url: string, startPosition?: number, isLive?: boolean) => Promise<MpvResult>;
   play: () => Promise<MpvResult>;
   pause: () => Promise<MpvResult>;
   togglePause: () => Promise<MpvResult>;
@@ -32,6 +40,10 @@ export interface MpvApi {
   setVolume: (volume: number) => Promise<MpvResult>;
   toggleMute: () => Promise<MpvResult>;
   seek: (seconds: number) => Promise<MpvResult>;
+  /** Pre-open likely next channels for instant zapping (native mode only) */
+  prepare: (urls: string[]) => Promise<MpvResult>;
+  /** Snapshot the playing picture, scaled to width x height (0 keeps aspect; native mode only) */
+  captureThumbnail: (width: number, height?: number) => Promise<MpvThumbnailResult>;
   getStatus: () => Promise<MpvStatus>;
   getMode: () => Promise<MpvModeInfo>;
   onReady: (callback: (ready: boolean) => void) => void;
@@ -84,16 +96,56 @@ export interface FetchProxyResponse {
   text: string;
 }
 
+// Columnar M3U parse result (shape must match M3UColumns in mpv-texture/src/playlist.ts)
+export interface M3UColumns {
+  count: number;
+  epgUrl: string | null;
+  strings: string[];
+  name: Uint32Array;
+  url: Uint32Array;
+  tvgId: Uint32Array;
+  tvgName: Uint32Array;
+  tvgLogo: Uint32Array;
+  group: Uint32Array;
+  channelNumber: Int32Array;
+  duration: Int32Array;
+}
+
+// Columnar XMLTV programmes (shape must match EpgColumns in mpv-texture/src/playlist.ts)
+export interface EpgColumns {
+  count: number;
+  skipped: number;
+  strings: string[];
+  channels: string[];
+  offsets: Uint32Array;
+  title: Uint32Array;
+  description: Uint32Array;
+  start: Float64Array;
+  stop: Float64Array;
+}
+
+// EPG parse result: `programs` from the worker thread (ISO date strings),
+// `guide` from the native parser
+export interface EpgParseData {
+  channels: { id: string; displayNames: string[] }[];
+  programs?: { channel_id: string; title: string; description: string; start: string; stop: string }[];
+  guide?: EpgColumns;
+}
+
 export interface FetchProxyApi {
   fetch: (url: string, options?: { method?: string; headers?: Record<string, string>; body?: string }) => Promise<StorageResult<FetchProxyResponse>>;
   fetchBinary: (url: string) => Promise<StorageResult<string>>; // Returns base64-encoded data
-  fetchAndParseEpg: (url: string, providerChannels?: { epg_channel_id: string; name: string; stream_id: string }[]) => Promise<StorageResult<{ channels: { id: string; displayNames: string[] }[]; programs: { channel_id: string; title: string; description: string; start: string; stop: string }[] }>>;
+  fetchAndParseEpg: (url: string, providerChannels?: { epg_channel_id: string; name: string; stream_id: string }[]) => Promise<StorageResult<EpgParseData>>;
+  fetchAndParseM3U: (url: string) => Promise<StorageResult<M3UColumns> & { unavailable?: boolean }>;
 }
 
 export interface DebugApi {
   getLogPath: () => Promise<StorageResult<string>>;
   logFromRenderer: (message: string) => Promise<StorageResult>;
   openLogFolder: () => Promise<StorageResult>;
+  /** Recent native mpv log messages as text (empty in external mode) */
+  getMpvLog: () => Promise<StorageResult<string>>;
+  dumpMpvTrace: () => Promise<StorageResult<string | null>>;
 }
 
 export interface PlatformApi {
@@ -119,7 +171,7 @@ contextBridge.exposeInMainWorld('electronWindow', {
 // Expose mpv API to the renderer process
 contextBridge.exposeInMainWorld('mpv', {
   // Control functions
-  load: (url: string, startPosition?: number) => ipcRenderer.invoke('mpv-load', url, startPosition),
+  load: (url: string, startPosition?: number, isLive?: boolean) => ipcRenderer.invoke('mpv-load', url, startPosition, isLive),
   play: () => ipcRenderer.invoke('mpv-play'),
   pause: () => ipcRenderer.invoke('mpv-pause'),
   togglePause: () => ipcRenderer.invoke('mpv-toggle-pause'),
@@ -127,6 +179,8 @@ contextBridge.exposeInMainWorld('mpv', {
   setVolume: (volume: number) => ipcRenderer.invoke('mpv-volume', volume),
   toggleMute: () => ipcRenderer.invoke('mpv-toggle-mute'),
   seek: (seconds: number) => ipcRenderer.invoke('mpv-seek', seconds),
+  prepare: (urls: string[]) => ipcRenderer.invoke('mpv-prepare', urls),
+  captureThumbnail: (width: number, height = 0) => ipcRenderer.invoke('mpv-capture-thumbnail', width, height),
   getStatus: () => ipcRenderer.invoke('mpv-get-status'),
   getMode: () => ipcRenderer.invoke('mpv-get-mode'),
 
@@ -169,6 +223,8 @@ contextBridge.exposeInMainWorld('fetchProxy', {
     ipcRenderer.invoke('fetch-binary', url),
   fetchAndParseEpg: (url: string, providerChannels?: { epg_channel_id: string; name: string; stream_id: string }[]) =>
     ipcRenderer.invoke('fetch-and-parse-epg', url, providerChannels),
+  fetchAndParseM3U: (url: string) =>
+    ipcRenderer.invoke('fetch-and-parse-m3u', url),
 } satisfies FetchProxyApi);
 
 // Expose platform info for conditional UI (e.g., resize grip on Windows only)
@@ -191,6 +247,8 @@ contextBridge.exposeInMainWorld('debug', {
   getLogPath: () => ipcRenderer.invoke('debug-get-log-path'),
   logFromRenderer: (message: string) => ipcRenderer.invoke('debug-log-renderer', message),
   openLogFolder: () => ipcRenderer.invoke('debug-open-log-folder'),
+  getMpvLog: () => ipcRenderer.invoke('debug-get-mpv-log'),
+  dumpMpvTrace: () => ipcRenderer.invoke('debug-dump-mpv-trace'),
 } satisfies DebugApi);
 
 // Expose auto-updater API (types defined in electron.d.ts)
@@ -224,14 +282,16 @@ export interface SharedTextureApi {
   removeFrameListener: () => void;
   onClear: (callback: () => void) => void;
   removeClearListener: () => void;
+  reportPresentation: (presentedAtMs: number) => void;
   isAvailable: boolean;
 }
 
-// Check if sharedTexture API is available AND we're on a platform that uses native mpv.
-// Windows uses external mpv via --wid (renders behind the window), so the VideoCanvas
-// must not activate there — it would cover the external mpv output with a black canvas.
+// Check if sharedTexture API is available AND we're on a platform that can use native mpv.
+// Whether native mpv actually started is only known later (mpv.getMode()); the VideoCanvas
+// stays hidden in external mode so it never covers an external mpv window (Windows --wid
+// renders behind the window).
 let sharedTextureAvailable = false;
-if (process.platform === 'darwin') {
+if (process.platform === 'darwin' || process.platform === 'linux' || process.platform === 'win32') {
   try {
     const { sharedTexture } = require('electron');
     sharedTextureAvailable = !!sharedTexture?.setSharedTextureReceiver;
@@ -291,5 +351,9 @@ contextBridge.exposeInMainWorld('sharedTexture', {
   removeClearListener: () => {
     clearCallback = null;
   },
+  // Fire-and-forget: sent every displayed frame
+  reportPresentation: (presentedAtMs: number) => {
+    ipcRenderer.send('video-presented', presentedAtMs);
+  },
   isAvailable: sharedTextureAvailable,
 } satisfies SharedTextureApi);
@@ -1,11 +1,15 @@
 // M3U Parser
-export { parseM3U, fetchAndParseM3U } from './m3u-parser';
+export { parseM3U, parseM3UColumns, fetchAndParseM3U } from './m3u-parser';
 export type { M3UParseResult } from './m3u-parser';
 
 // XMLTV Parser (shared by Xtream and M3U)
 export { parseXmltv, parseXmltvFull } from './xmltv-parser';
 export type { XmltvProgram, XmltvChannel, XmltvParseResult } from './xmltv-parser';
 
+// EPG channel matching (also built for the main process, see epg-match.ts)
+export { matchEpgChannels, buildMatchedXmltvIds } from './epg-match';
+export type { EpgChannel, ProviderChannel, EpgMatchConfidence, EpgMatchStrategy } from './epg-match';
+
 // Xtream Client
 export { XtreamClient } from './xtream-client';
 export type {
@@ -11,6 +11,7 @@
  */
 
 import type { Channel, Category } from '@sbtltv/core';
+import type { M3UColumns } from './types/electron';
 
 export interface M3UParseResult {
   channels: Channel[];
@@ -33,8 +34,7 @@ interface ExtInfMetadata {
  */
 export function parseM3U(content: string, sourceId: string): M3UParseResult {
   const lines = content.split('\n').map(line => line.trim());
-  const channels: Channel[] = [];
-  const categoriesMap = new Map<string, Category>();
+  const builder = new M3UResultBuilder(sourceId);
 
   let epgUrl: string | null = null;
   let currentMetadata: ExtInfMetadata | null = null;
@@ -64,50 +64,106 @@ export function parseM3U(content: string, sourceId: string): M3UParseResult {
 
     // This should be a URL - create channel if we have metadata
     if (currentMetadata && (line.startsWith('http://') || line.startsWith('https://') || line.startsWith('rtmp://'))) {
-      const displayName = currentMetadata.displayName || currentMetadata.tvgName || 'Unknown';
-
-      // Create category if needed
-      const categoryId = createCategoryId(sourceId, currentMetadata.groupTitle);
-      if (currentMetadata.groupTitle && !categoriesMap.has(categoryId)) {
-        categoriesMap.set(categoryId, {
-          category_id: categoryId,
-          category_name: currentMetadata.groupTitle,
-          source_id: sourceId,
-        });
-      }
+      builder.add(currentMetadata, line);
+      currentMetadata = null;
+    }
+  }
 
-      // Create channel with stable hash-based ID (survives resyncs)
-      const streamId = `${sourceId}_${stableHash(displayName + '|' + line)}`;
-
-      // If this stream already exists (same channel in multiple groups),
-      // merge category_ids instead of creating a duplicate
-      const existing = channels.find(ch => ch.stream_id === streamId);
-      if (existing) {
-        if (categoryId && !existing.category_ids.includes(categoryId)) {
-          existing.category_ids.push(categoryId);
-        }
-      } else {
-        channels.push({
-          stream_id: streamId,
-          name: displayName,
-          stream_icon: currentMetadata.tvgLogo || '',
-          epg_channel_id: currentMetadata.tvgId || '',
-          category_ids: categoryId ? [categoryId] : [],
-          direct_url: line,
-          source_id: sourceId,
-          ...(currentMetadata.tvgChno !== null && { channel_num: currentMetadata.tvgChno }),
-        });
-      }
+  return builder.result(epgUrl);
+}
 
-      currentMetadata = null;
+/** channelNumber value in M3UColumns for entries without a usable tvg-chno */
+const CHANNEL_NUMBER_NONE = -2147483648;
+
+/**
+ * Build the parse result from the native parser's columns
+ *
+ * The columns carry the same fields parseM3U() extracts, so both paths
+ * produce identical channels and categories.
+ */
+export function parseM3UColumns(columns: M3UColumns, sourceId: string): M3UParseResult {
+  const builder = new M3UResultBuilder(sourceId);
+  const strings = columns.strings;
+
+  for (let i = 0; i < columns.count; i++) {
+    const channelNumber = columns.channelNumber[i];
+    builder.add({
+      duration: columns.duration[i],
+      tvgId: strings[columns.tvgId[i]],
+      tvgName: strings[columns.tvgName[i]],
+      tvgLogo: strings[columns.tvgLogo[i]],
+      tvgChno: channelNumber === CHANNEL_NUMBER_NONE ? null : channelNumber,
+      groupTitle: strings[columns.group[i]],
+      displayName: strings[columns.name[i]],
+    }, strings[columns.url[i]]);
+  }
+
+  return builder.result(columns.epgUrl);
+}
+
+/**
+ * Accumulates channels and categories from parsed entries
+ */
+class M3UResultBuilder {
+  private channels: Channel[] = [];
+  private channelsById = new Map<string, Channel>();
+  private categoriesMap = new Map<string, Category>();
+  // Groups repeat across thousands of entries; slugify each once
+  private categoryIds = new Map<string, string>();
+
+  constructor(private sourceId: string) {}
+
+  add(metadata: ExtInfMetadata, url: string): void {
+    const displayName = metadata.displayName || metadata.tvgName || 'Unknown';
+
+    // Create category if needed
+    let categoryId = this.categoryIds.get(metadata.groupTitle);
+    if (categoryId === undefined) {
+      categoryId = createCategoryId(this.sourceId, metadata.groupTitle);
+      this.categoryIds.set(metadata.groupTitle, categoryId);
+    }
+    if (metadata.groupTitle && !this.categoriesMap.has(categoryId)) {
+      this.categoriesMap.set(categoryId, {
+        category_id: categoryId,
+        category_name: metadata.groupTitle,
+        source_id: this.sourceId,
+      });
+    }
+
+    // Create channel with stable hash-based ID (survives resyncs)
+    const streamId = `${this.sourceId}_${stableHash(displayName + '|' + url)}`;
+
+    // If this stream already exists (same channel in multiple groups),
+    // merge category_ids instead of creating a duplicate
+    const existing = this.channelsById.get(streamId);
+    if (existing) {
+      if (categoryId && !existing.category_ids.includes(categoryId)) {
+        existing.category_ids.push(categoryId);
+      }
+      return;
     }
+
+    const channel: Channel = {
+      stream_id: streamId,
+      name: displayName,
+      stream_icon: metadata.tvgLogo || '',
+      epg_channel_id: metadata.tvgId || '',
+      category_ids: categoryId ? [categoryId] : [],
+      direct_url: url,
+      source_id: this.sourceId,
+      ...(metadata.tvgChno !== null && { channel_num: metadata.tvgChno }),
+    };
+    this.channels.push(channel);
+    this.channelsById.set(streamId, channel);
   }
 
-  return {
-    channels,
-    categories: Array.from(categoriesMap.values()),
-    epgUrl,
-  };
+  result(epgUrl: string | null): M3UParseResult {
+    return {
+      channels: this.channels,
+      categories: Array.from(this.categoriesMap.values()),
+      epgUrl,
+    };
+  }
 }
 
 /**
@@ -231,6 +287,19 @@ function createCategoryId(sourceId: string, groupTitle: string): string {
  * Fetch and parse an M3U playlist from URL
  */
 export async function fetchAndParseM3U(url: string, sourceId: string): Promise<M3UParseResult> {
+  // Native parser in the main process: streams to disk and memory-maps the
+  // file instead of holding the whole playlist as one JS string
+  if (typeof window !== 'undefined' && window.fetchProxy?.fetchAndParseM3U) {
+    const result = await window.fetchProxy.fetchAndParseM3U(url);
+    if (result.success && result.data) {
+      return parseM3UColumns(result.data, sourceId);
+    }
+    if (!result.unavailable) {
+      throw new Error(result.error || 'Failed to fetch M3U');
+    }
+    console.warn(`[m3u] Native parse unavailable (${result.error}), using JS parser`);
+  }
+
   // Use Electron's fetch proxy if available (bypasses CORS + SSRF protection)
   if (typeof window !== 'undefined' && window.fetchProxy) {
     const result = await window.fetchProxy.fetch(url);
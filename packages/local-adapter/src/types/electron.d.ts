@@ -13,8 +13,24 @@ export interface StorageResult<T = void> {
   data?: T;
 }
 
+// Columnar M3U parse result (shape must match M3UColumns in mpv-texture/src/playlist.ts)
+export interface M3UColumns {
+  count: number;
+  epgUrl: string | null;
+  strings: string[];
+  name: Uint32Array;
+  url: Uint32Array;
+  tvgId: Uint32Array;
+  tvgName: Uint32Array;
+  tvgLogo: Uint32Array;
+  group: Uint32Array;
+  channelNumber: Int32Array;
+  duration: Int32Array;
+}
+
 export interface FetchProxyApi {
   fetch: (url: string, options?: { method?: string; headers?: Record<string, string>; body?: string }) => Promise<StorageResult<FetchProxyResponse>>;
+  fetchAndParseM3U?: (url: string) => Promise<StorageResult<M3UColumns> & { unavailable?: boolean }>;
 }
 
 declare global {
@@ -1,4 +1,22 @@
 {
+  "variables": {
+    "conditions": [
+      # Linux builds the real addon only when the system dev packages exist
+      ["OS=='linux'", {
+        "linux_native%": "<!(pkg-config --exists mpv egl gl && echo 1 || echo 0)"
+      }, {
+        "linux_native%": 0
+      }],
+      # Windows needs the import library from scripts/setup-mpv-win.ps1
+      ["OS=='win'", {
+        "win_native%": "<!(node -p \"require('fs').existsSync('deps/mpv/win64/mpv.lib') ? 1 : 0\")"
+      }, {
+        "win_native%": 0
+      }]
+    ],
+    # pipeline_bench executable (npm run build:bench); not part of releases
+    "build_benchmark%": 0
+  },
   "targets": [
     {
       "target_name": "mpv_texture",
@@ -15,6 +33,10 @@
           "sources": [
             "src/native/addon.cpp",
             "src/native/mpv_context.cpp",
+            "src/native/gl_context.cpp",
+            "src/native/thumbnail_capture.cpp",
+            "src/native/compositor.cpp",
+            "src/native/vsync_source.cpp",
             "src/native/macos/iosurface_texture.mm"
           ],
           "include_dirs": [
@@ -25,7 +47,8 @@
             "-lmpv",
             "-framework OpenGL",
             "-framework IOSurface",
-            "-framework CoreFoundation"
+            "-framework CoreFoundation",
+            "-framework CoreVideo"
           ],
           "xcode_settings": {
             "GCC_ENABLE_CPP_EXCEPTIONS": "YES",
@@ -43,16 +66,193 @@
           ]
         }],
 
-        # ── Non-macOS: build a no-op stub (see src/native/stub.cpp for details) ──
-        # Windows uses external mpv via --wid flag, Linux uses separate window.
-        # The stub lets node-gyp and @electron/rebuild succeed without requiring
+        # ── Linux: EGL + dma-buf texture sharing against the system libmpv ──
+        ["OS=='linux' and linux_native==1", {
+          "sources": [
+            "src/native/addon.cpp",
+            "src/native/mpv_context.cpp",
+            "src/native/gl_context.cpp",
+            "src/native/thumbnail_capture.cpp",
+            "src/native/compositor.cpp",
+            "src/native/vsync_source.cpp",
+            "src/native/linux/dmabuf_texture.cpp"
+          ],
+          "cflags_cc": [
+            "-std=c++17",
+            "<!@(pkg-config --cflags mpv egl gl)"
+          ],
+          "libraries": [
+            "<!@(pkg-config --libs mpv egl gl)"
+          ]
+        }],
+
+        # ── Windows: DXGI shared textures, GL through ANGLE (D3D11) or WGL_NV_DX_interop ──
+        ["OS=='win' and win_native==1", {
+          "sources": [
+            "src/native/addon.cpp",
+            "src/native/mpv_context.cpp",
+            "src/native/gl_context.cpp",
+            "src/native/thumbnail_capture.cpp",
+            "src/native/compositor.cpp",
+            "src/native/vsync_source.cpp",
+            "src/native/win32/d3d_device.cpp",
+            "src/native/win32/dxgi_texture.cpp"
+          ],
+          "include_dirs": [
+            "deps/mpv/include"
+          ],
+          "defines": ["NOMINMAX"],
+          "libraries": [
+            "<(module_root_dir)/deps/mpv/win64/mpv.lib",
+            "d3d11.lib",
+            "dxgi.lib",
+            "opengl32.lib"
+          ],
+          "msvs_settings": {
+            "VCCLCompilerTool": {
+              "ExceptionHandling": 1,
+              "AdditionalOptions": ["/std:c++17"]
+            }
+          },
+          "copies": [
+            {
+              "destination": "<(module_root_dir)/build/Release",
+              "files": ["<(module_root_dir)/deps/mpv/win64/libmpv-2.dll"]
+            }
+          ]
+        }],
+
+        # ── Everything else: build a no-op stub (see src/native/stub.cpp for details) ──
+        # Windows and Linux without the mpv dev files use external mpv. The
+        # stub lets node-gyp and @electron/rebuild succeed without requiring
         # mpv dev libraries on platforms that don't use the native addon.
-        ["OS!='mac'", {
+        ["(OS!='mac' and OS!='linux' and OS!='win') or (OS=='linux' and linux_native==0) or (OS=='win' and win_native==0)", {
           "sources": [
             "src/native/stub.cpp"
           ]
         }]
       ]
+    },
+    {
+      # Playlist parsing: no mpv or GPU dependencies, built on every platform
+      "target_name": "playlist_parser",
+      "cflags!": ["-fno-exceptions"],
+      "cflags_cc!": ["-fno-exceptions"],
+      "cflags_cc": ["-std=c++17"],
+      "include_dirs": [
+        "<!@(node -p \"require('node-addon-api').include\")"
+      ],
+      "defines": ["NAPI_DISABLE_CPP_EXCEPTIONS"],
+      "sources": [
+        "src/native/playlist/playlist_addon.cpp",
+        "src/native/playlist/m3u_parser.cpp",
+        "src/native/playlist/mapped_file.cpp",
+        "src/native/playlist/xmltv_parser.cpp"
+      ],
+      "conditions": [
+        ["OS=='linux'", {
+          "cflags_cc": ["-pthread"],
+          "ldflags": ["-pthread"]
+        }],
+        ["OS=='mac'", {
+          "xcode_settings": {
+            "GCC_ENABLE_CPP_EXCEPTIONS": "YES",
+            "CLANG_CXX_LANGUAGE_STANDARD": "c++17",
+            "MACOSX_DEPLOYMENT_TARGET": "10.15"
+          }
+        }],
+        ["OS=='win'", {
+          "defines": ["NOMINMAX"],
+          "msvs_settings": {
+            "VCCLCompilerTool": {
+              "ExceptionHandling": 1,
+              "AdditionalOptions": ["/std:c++17"]
+            }
+          }
+        }]
+      ]
     }
+  ],
+  "conditions": [
+    # ── Headless render pipeline benchmark (src/native/bench/pipeline_bench.cpp) ──
+    # Same MpvContext and texture-share sources as the addon, no N-API. Only
+    # where the real addon builds.
+    ["build_benchmark==1 and (OS=='mac' or (OS=='linux' and linux_native==1) or (OS=='win' and win_native==1))", {
+      "targets": [
+        {
+          "target_name": "pipeline_bench",
+          "type": "executable",
+          # node-gyp's delay-load hook (and node.lib) is for addons only
+          "win_delay_load_hook": "false",
+          "cflags!": ["-fno-exceptions"],
+          "cflags_cc!": ["-fno-exceptions"],
+          "sources": [
+            "src/native/bench/pipeline_bench.cpp",
+            "src/native/mpv_context.cpp",
+            "src/native/gl_context.cpp",
+            "src/native/thumbnail_capture.cpp",
+            "src/native/compositor.cpp",
+            "src/native/vsync_source.cpp"
+          ],
+          "conditions": [
+            ["OS=='mac'", {
+              "sources": ["src/native/macos/iosurface_texture.mm"],
+              "include_dirs": ["deps/mpv/include"],
+              "libraries": [
+                "-L<(module_root_dir)/deps/mpv/macos",
+                "-lmpv",
+                "-framework OpenGL",
+                "-framework IOSurface",
+                "-framework CoreFoundation",
+                "-framework CoreVideo"
+              ],
+              "xcode_settings": {
+                "GCC_ENABLE_CPP_EXCEPTIONS": "YES",
+                "CLANG_CXX_LANGUAGE_STANDARD": "c++17",
+                "MACOSX_DEPLOYMENT_TARGET": "10.15",
+                "OTHER_LDFLAGS": [
+                  "-Wl,-rpath,@executable_path"
+                ]
+              }
+            }],
+            ["OS=='linux'", {
+              "sources": ["src/native/linux/dmabuf_texture.cpp"],
+              "cflags_cc": [
+                "-std=c++17",
+                "-pthread",
+                "<!@(pkg-config --cflags mpv egl gl)"
+              ],
+              "ldflags": ["-pthread"],
+              "libraries": [
+                "<!@(pkg-config --libs mpv egl gl)"
+              ]
+            }],
+            ["OS=='win'", {
+              "sources": [
+                "src/native/win32/d3d_device.cpp",
+                "src/native/win32/dxgi_texture.cpp"
+              ],
+              "include_dirs": ["deps/mpv/include"],
+              "defines": ["NOMINMAX"],
+              "libraries": [
+                "<(module_root_dir)/deps/mpv/win64/mpv.lib",
+                "d3d11.lib",
+                "dxgi.lib",
+                "opengl32.lib"
+              ],
+              "msvs_settings": {
+                "VCCLCompilerTool": {
+                  "ExceptionHandling": 1,
+                  "AdditionalOptions": ["/std:c++17"]
+                },
+                "VCLinkerTool": {
+                  "SubSystem": 1
+                }
+              }
+            }]
+          ]
+        }
+      ]
+    }]
   ]
 }
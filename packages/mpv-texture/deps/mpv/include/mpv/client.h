@@ -144,11 +144,22 @@ typedef struct mpv_event_log_message {
     mpv_log_level log_level;
 } mpv_event_log_message;
 
+typedef struct mpv_event_start_file {
+    int64_t playlist_entry_id;
+} mpv_event_start_file;
+
 typedef struct mpv_event_end_file {
     int reason;
     int error;
+    int64_t playlist_entry_id;
+    int64_t playlist_insert_id;
+    int playlist_insert_num_entries;
 } mpv_event_end_file;
 
+typedef struct mpv_event_command {
+    mpv_node result;
+} mpv_event_command;
+
 typedef struct mpv_event {
     mpv_event_id event_id;
     int error;
@@ -166,6 +177,7 @@ void mpv_terminate_destroy(mpv_handle *ctx);
 void mpv_destroy(mpv_handle *ctx);
 
 const char *mpv_error_string(int error);
+int64_t mpv_get_time_us(mpv_handle *ctx);
 const char *mpv_event_name(mpv_event_id event);
 
 int mpv_set_option(mpv_handle *ctx, const char *name, mpv_format format, void *data);
@@ -175,6 +187,7 @@ int mpv_command(mpv_handle *ctx, const char **args);
 int mpv_command_node(mpv_handle *ctx, mpv_node *args, mpv_node *result);
 int mpv_command_string(mpv_handle *ctx, const char *args);
 int mpv_command_async(mpv_handle *ctx, uint64_t reply_userdata, const char **args);
+int mpv_command_node_async(mpv_handle *ctx, uint64_t reply_userdata, mpv_node *args);
 
 int mpv_set_property(mpv_handle *ctx, const char *name, mpv_format format, void *data);
 int mpv_set_property_string(mpv_handle *ctx, const char *name, const char *data);
@@ -16,4 +16,24 @@
  * - MPV_RENDER_API_TYPE_OPENGL
  */
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* For MPV_RENDER_PARAM_DRM_DISPLAY_V2. Only render_fd is needed for VAAPI
+ * interop when rendering offscreen (fd = -1, no KMS output). */
+struct _drmModeAtomicReq;
+
+typedef struct mpv_opengl_drm_params_v2 {
+    int fd;
+    int crtc_id;
+    int connector_id;
+    struct _drmModeAtomicReq **atomic_request_ptr;
+    int render_fd;
+} mpv_opengl_drm_params_v2;
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* MPV_RENDER_GL_H_ */
@@ -119,6 +119,11 @@ done
 # Ensure writable permissions so Squirrel.Mac can overwrite during auto-update
 cp "$BUILD_DIR/mpv_texture.node" "$BUNDLE_DIR/"
 chmod 755 "$BUNDLE_DIR/mpv_texture.node"
+# Playlist parser has no dylib deps; it only needs to sit next to the addon
+if [ -f "$BUILD_DIR/playlist_parser.node" ]; then
+  cp "$BUILD_DIR/playlist_parser.node" "$BUNDLE_DIR/"
+  chmod 755 "$BUNDLE_DIR/playlist_parser.node"
+fi
 cp "$BUILD_DIR"/*.dylib "$BUNDLE_DIR/" 2>/dev/null || true
 chmod 755 "$BUNDLE_DIR"/*.dylib 2>/dev/null || true
 # Also copy any non-.dylib shared libs (e.g. libsharpyuv might not have .dylib ext)
@@ -57,13 +57,19 @@ console.log(`[mpv-texture] Loaded native addon from: ${loadedPath}`);
 /**
  * Texture format for shared textures
  */
-export type TextureFormat = 'rgba' | 'nv12' | 'bgra';
+export type TextureFormat = 'rgba' | 'nv12' | 'bgra' | 'p010';
+
+/**
+ * Transfer function of the exported pixels. Planar formats are limited range
+ * BT.709 (nv12) or BT.2020 (p010); HDR is only carried by p010.
+ */
+export type TextureTransfer = 'sdr' | 'pq' | 'hlg';
 
 /**
  * Information about an exported texture frame
  */
 export interface TextureInfo {
-  /** Platform-specific handle (HANDLE on Windows, IOSurfaceRef pointer on macOS) */
+  /** Platform-specific handle (HANDLE on Windows, IOSurfaceRef pointer on macOS, dma-buf fd on Linux) */
   handle: bigint;
   /** Texture width in pixels */
   width: number;
@@ -71,8 +77,96 @@ export interface TextureInfo {
   height: number;
   /** Pixel format */
   format: TextureFormat;
+  /** Transfer function ('sdr' unless a p010 frame carries HDR) */
+  transfer: TextureTransfer;
+  /** Linux: dma-buf row stride in bytes */
+  stride?: number;
+  /** Linux: dma-buf plane offset in bytes */
+  offset?: number;
+  /** Linux: DRM format modifier */
+  modifier?: bigint;
+  /**
+   * Export generation, passed back by releaseFrame(): a handle is exported
+   * again and again, and this names this export only
+   */
+  generation: number;
+  /** Per-player frame number, from 1 (gaps are frames dropped or superseded) */
+  seq: number;
+  /**
+   * Playback position in seconds when the frame was rendered (the latest
+   * time-pos, so approximate); null before the first position is known
+   */
+  pts: number | null;
+  /**
+   * Frame timeline in microseconds on the native monotonic clock, the same
+   * clock as dumpTrace(): render call start and return (GPU work submitted),
+   * and when the GPU finished and the frame was handed to JS
+   */
+  renderStartUs: number;
+  renderDoneUs: number;
+  exportUs: number;
+  /**
+   * Frames coalesced away natively since the previous delivered frame
+   * (the addon only ever delivers the newest frame)
+   */
+  dropped: number;
 }
 
+/**
+ * A frame read from the shared frame record (see MpvTexture.onFrameSignal):
+ * TextureInfo's fields, with the handle as a number (exact: every
+ * platform's handles are below 2^53). The same object is refilled for every
+ * frame, so copy what must outlive the callback.
+ */
+export interface FrameSample {
+  handle: number;
+  width: number;
+  height: number;
+  format: TextureFormat;
+  transfer: TextureTransfer;
+  /** Linux dma-buf layout; stride 0 elsewhere */
+  stride: number;
+  offset: number;
+  /** Linux: DRM format modifier (0n elsewhere; reading it allocates a BigInt) */
+  modifier: bigint;
+  generation: number;
+  seq: number;
+  pts: number | null;
+  renderStartUs: number;
+  renderDoneUs: number;
+  exportUs: number;
+  dropped: number;
+}
+
+/**
+ * Float64 slot layout of the frame record (mirrors FrameRecord::Slot in
+ * frame_record.h). format / transfer hold TextureFormat / TextureTransfer
+ * enum values; the modifier slot holds raw uint64 bits.
+ */
+const FRAME_SLOTS = {
+  seq: 0,
+  handle: 1,
+  width: 2,
+  height: 3,
+  format: 4,
+  transfer: 5,
+  pts: 6,
+  renderStartUs: 7,
+  renderDoneUs: 8,
+  exportUs: 9,
+  dropped: 10,
+  stride: 11,
+  offset: 12,
+  modifier: 13,
+  generation: 14,
+} as const;
+
+const FRAME_SLOT_COUNT = 15;
+
+/** Native enum order of TextureFormat / TextureTransfer */
+const FRAME_FORMATS: readonly TextureFormat[] = ['rgba', 'nv12', 'bgra', 'p010'];
+const FRAME_TRANSFERS: readonly TextureTransfer[] = ['sdr', 'pq', 'hlg'];
+
 /**
  * Playback status information
  */
@@ -91,8 +185,223 @@ export interface MpvStatus {
   width: number;
   /** Video height in pixels */
   height: number;
+  /** Source pixel format, e.g. 'yuv420p', 'nv12', 'p010' (empty until known) */
+  pixelFormat: string;
+  /** Color matrix, e.g. 'bt.709', 'bt.2020-ncl' */
+  colorMatrix: string;
+  /** Color range: 'limited' or 'full' */
+  colorLevels: string;
+  /** Color primaries, e.g. 'bt.709', 'bt.2020' */
+  primaries: string;
+  /** Transfer function, e.g. 'bt.1886', 'pq', 'hlg' */
+  gamma: string;
+  /** Current subtitle line as plain text ('' between lines or for image subtitles) */
+  subtitleText: string;
+  /** The same line as ASS event text, override tags kept */
+  subtitleAss: string;
+  /** The subtitle track is image-based (PGS, DVB, VobSub) and has no text */
+  subtitleBitmap: boolean;
+}
+
+/**
+ * mpv log level, most severe first
+ */
+export type LogLevel = 'fatal' | 'error' | 'warn' | 'info' | 'v' | 'debug' | 'trace';
+
+/**
+ * One mpv log message from the native log ring
+ */
+export interface LogEntry {
+  /** When the message was logged, epoch milliseconds */
+  time: number;
+  level: LogLevel;
+  /** mpv module, e.g. 'ffmpeg/demuxer', 'cplayer' */
+  prefix: string;
+  text: string;
+}
+
+/**
+ * Stage of a latency trace event (see MpvTexture.dumpTrace())
+ *
+ * render: mpv's render call; gpu: submitted until the GPU finished;
+ * deliver: handed over until onFrame took it; hold: taken until
+ * releaseFrame(); drop: coalesced away before delivery (instant);
+ * present: a reportPresentation() time (instant, seq 0)
+ */
+export type TraceStage = 'render' | 'gpu' | 'deliver' | 'hold' | 'drop' | 'present';
+
+/**
+ * One event from the native latency trace ring
+ */
+export interface TraceEvent {
+  stage: TraceStage;
+  /** TextureInfo.seq of the frame (0 for present) */
+  seq: number;
+  /** Native monotonic clock, microseconds; equal for instants */
+  startUs: number;
+  endUs: number;
+  /** Playback position of the frame, null if unknown */
+  pts: number | null;
+}
+
+/**
+ * Thumbnail from captureThumbnail()
+ */
+export interface Thumbnail {
+  width: number;
+  height: number;
+  /** RGBA8 pixels, tightly packed, top row first (fits ImageData as is) */
+  data: Buffer;
+}
+
+/**
+ * Latency distribution in microseconds. Percentiles have power-of-two
+ * bucket resolution.
+ */
+export interface LatencyStats {
+  count: number;
+  mean: number;
+  max: number;
+  p50: number;
+  p95: number;
+  p99: number;
+}
+
+/**
+ * Native render pipeline counters (cumulative since create or last reset)
+ */
+export interface RenderStats {
+  /** Frames rendered and exported by mpv */
+  framesRendered: number;
+  /** Frames delivered to the onFrame callback */
+  framesDelivered: number;
+  /** Frames coalesced away in the mailbox before JS took them */
+  framesDropped: number;
+  /** Frames replaced before the GPU finished them */
+  framesSuperseded: number;
+  /** Frames retired without rendering (render mode other than 'active') */
+  framesSkipped: number;
+  /** Renders deferred because every texture slot was still held by the consumer */
+  lockFailures: number;
+  /** mpv_render_context_render failures */
+  renderFailures: number;
+  /** Texture reallocations (resolution changes) */
+  resizes: number;
+  /** Most recent load() -> first frame published, in microseconds */
+  lastFirstFrameUs: number;
+  /** displaySync: frames rendered just in time for a target vsync */
+  framesPaced: number;
+  /** displaySync: paced frames that completed after their vsync */
+  framesLate: number;
+  /** displaySync: measured display refresh period in microseconds (0 = not locked) */
+  displayPeriodUs: number;
+  /** fastRender: the cheaper, lower-quality render settings are in effect right now */
+  fastRenderActive: boolean;
+  /** mpv render request -> render start */
+  updateToRenderUs: LatencyStats;
+  /** mpv_render_context_render call (CPU submission) */
+  renderUs: LatencyStats;
+  /** Export fence -> GPU completion */
+  gpuUs: LatencyStats;
+  /** Frame ready -> taken by JS */
+  deliveryUs: LatencyStats;
+  /** load() -> file opened */
+  loadUs: LatencyStats;
+  /** load() -> first frame published (time to first frame) */
+  firstFrameUs: LatencyStats;
+}
+
+/**
+ * Buffered window of a stream (see MpvTexture.timeshiftRange), in seconds
+ * on the playback position's scale
+ */
+export interface TimeshiftRange {
+  /** Oldest buffered time */
+  start: number;
+  /** Newest buffered time: the live edge */
+  end: number;
+  /** Current playback position */
+  position: number;
+  /** end - position */
+  behindLive: number;
+}
+
+/**
+ * Numeric status and pipeline counters from the shared snapshot buffer
+ * (see MpvTexture.readStatus)
+ */
+export interface StatusSample {
+  playing: boolean;
+  volume: number;
+  muted: boolean;
+  position: number;
+  duration: number;
+  width: number;
+  height: number;
+  framesRendered: number;
+  framesDelivered: number;
+  framesDropped: number;
+  framesSuperseded: number;
+  lockFailures: number;
+  renderFailures: number;
+  resizes: number;
+  lastFirstFrameUs: number;
+  framesPaced: number;
+  framesLate: number;
+  displayPeriodUs: number;
 }
 
+/**
+ * Float64 slot layout of the snapshot buffer (mirrors StatusSnapshot::Slot
+ * in status_snapshot.h). Slot 0 holds the two uint32 sequence numbers:
+ * int32 index 0 guards the status block, index 1 the stats block.
+ */
+const STATUS_SLOTS = {
+  playing: 1,
+  volume: 2,
+  muted: 3,
+  position: 4,
+  duration: 5,
+  width: 6,
+  height: 7,
+  framesRendered: 8,
+  framesDelivered: 9,
+  framesDropped: 10,
+  framesSuperseded: 11,
+  lockFailures: 12,
+  renderFailures: 13,
+  resizes: 14,
+  lastFirstFrameUs: 15,
+  framesPaced: 16,
+  framesLate: 17,
+  displayPeriodUs: 18,
+} as const;
+
+const STATUS_SLOT_COUNT = 19;
+
+/** A writer holds its block for a few stores; give up after this many */
+const SNAPSHOT_READ_ATTEMPTS = 8;
+
+/**
+ * Demuxer cache, probe and network timeout presets
+ *
+ * - `default`: mpv's defaults, tuned for local files
+ * - `low-latency-live`: short probe (500 KB / 0.5 s) and 2 s of buffer;
+ *   fastest channel start, least slack against network stalls
+ * - `stable-live`: 1 MB / 1 s probe, 10 s of buffer, pauses to refill
+ * - `vod`: full probe, 60 s readahead and a seek-back cache
+ */
+export type PlaybackProfile = 'default' | 'low-latency-live' | 'stable-live' | 'vod';
+
+/**
+ * How much of the render pipeline runs (see MpvTexture.setRenderMode())
+ *
+ * - `active`: every frame is rendered and delivered
+ * - `throttled`: about one frame a second (previews, thumbnails)
+ * - `suspended`: nothing is rendered or delivered; audio keeps playing
+ */
+export type RenderMode = 'active' | 'throttled' | 'suspended';
+
 /**
  * Configuration options for creating the context
  */
@@ -103,27 +412,187 @@ export interface MpvConfig {
   height?: number;
   /** Hardware decoding mode: 'auto', 'd3d11va', 'videotoolbox', etc. (default: 'auto') */
   hwdec?: string;
+  /**
+   * GPU memory (MB) kept for texture sets of previously used resolutions, so
+   * adaptive-bitrate switches back to a known size skip reallocation.
+   * 0 disables pooling (default: 64)
+   */
+  texturePoolMB?: number;
+  /** Minimum interval between position updates in ms; 0 = every change (default: 250) */
+  statusIntervalMs?: number;
+  /** Create the player in standby (see setStandby) (default: false) */
+  standby?: boolean;
+  /**
+   * Export 4:2:0 sources as planar YUV instead of RGB: 8-bit as nv12, 10-bit
+   * as p010 (keeping HDR). Halves per-frame bandwidth; other sources stay
+   * RGB (default: false)
+   */
+  yuvExport?: boolean;
+  /**
+   * mpv log messages kept in the native log ring, in mpv's msg-level syntax,
+   * e.g. 'all=warn,ffmpeg=error'. Changeable at runtime with setLogLevels()
+   * (default: 'all=info')
+   */
+  logLevels?: string;
+  /**
+   * Pace rendering to the display. mpv resamples to the measured refresh
+   * rate and renders each frame just before the vsync it is shown on,
+   * instead of as soon as it is decoded. The refresh is tracked natively on
+   * macOS and Windows; on Linux it relies on reportPresentation()
+   * (default: false)
+   */
+  displaySync?: boolean;
+  /** Playback profile for loads that don't pass their own (default: 'default') */
+  profile?: PlaybackProfile;
+  /** Record latency trace events from the start; see setTrace() (default: false) */
+  trace?: boolean;
+  /** Start with subtitles delivered as text; see setSubtitleOverlay() (default: false) */
+  subtitleOverlay?: boolean;
+  /** Start with fast render on; see setFastRender() (default: false) */
+  fastRender?: boolean;
+  /**
+   * Timeshift buffer in MiB (default: 0 = off). The demuxer cache goes to
+   * disk and keeps this much behind the playback position, and as much
+   * ahead so a paused live stream keeps recording; see timeshiftRange()
+   */
+  timeshiftMB?: number;
+  /** Directory for the timeshift cache files (default: mpv's cache directory) */
+  timeshiftDir?: string;
+  /**
+   * Defer mpv_initialize, the GL context and the texture slots to the first
+   * load(), so an unused player costs only an idle thread. Startup failures
+   * then reject that load() instead of create() (default: false)
+   */
+  lazyStart?: boolean;
+  /**
+   * Render into a tile of this compositor instead of an own exported
+   * texture (see MpvCompositor). onFrame() then never fires and yuvExport
+   * is ignored. The compositor must outlive the player.
+   */
+  compositor?: MpvCompositor;
+}
+
+/**
+ * Compositor configuration
+ */
+export interface CompositorConfig {
+  /** Atlas width (default: 1920) */
+  width?: number;
+  /** Atlas height (default: 1080) */
+  height?: number;
+  /** Upper bound on composites per second, 0 = unlimited (default: 60) */
+  maxFps?: number;
+}
+
+/**
+ * A region of the atlas and the player drawn into it (pixels, top-left origin)
+ */
+export interface CompositorTile {
+  player: MpvTexture;
+  x: number;
+  y: number;
+  width: number;
+  height: number;
+}
+
+/**
+ * What a tile showed in an atlas frame. `player` is the player's native
+ * handle; seq 0 means the player had no frame yet (the region is black).
+ */
+export interface TileFrame {
+  player: number;
+  x: number;
+  y: number;
+  width: number;
+  height: number;
+  seq: number;
+  pts: number | null;
+}
+
+/**
+ * Atlas frame delivered by MpvCompositor.onFrame
+ */
+export interface CompositorFrame extends TextureInfo {
+  tiles: TileFrame[];
+}
+
+/**
+ * Compositor counters
+ */
+export interface CompositorStats {
+  /** Atlas frames exported */
+  framesComposited: number;
+  /** Composites skipped because every atlas slot was still held */
+  lockFailures: number;
+}
+
+/**
+ * Opaque native player handle returned by create()
+ */
+type PlayerHandle = number;
+
+/**
+ * Opaque native compositor handle returned by createCompositor()
+ */
+type CompositorHandle = number;
+
+/**
+ * Tile as passed to the native addon
+ */
+interface NativeTile {
+  player: PlayerHandle;
+  x: number;
+  y: number;
+  width: number;
+  height: number;
 }
 
 /**
  * Native addon interface
+ *
+ * Every call except create() takes the handle of the player it targets.
  */
 interface NativeAddon {
-  create(config?: MpvConfig): void;
-  destroy(): void;
-  load(url: string, options?: string): Promise<void>;
-  play(): void;
-  pause(): void;
-  stop(): void;
-  seek(position: number): void;
-  setVolume(volume: number): void;
-  toggleMute(): void;
-  getStatus(): MpvStatus | undefined;
-  onFrame(callback: (info: TextureInfo) => void): void;
-  onStatus(callback: (status: MpvStatus) => void): void;
-  onError(callback: (error: string) => void): void;
-  releaseFrame(): void;
-  isInitialized(): boolean;
+  create(config?: Omit<MpvConfig, 'compositor'> & { compositor?: CompositorHandle }): Promise<PlayerHandle>;
+  destroy(handle: PlayerHandle): void;
+  load(handle: PlayerHandle, url: string, options?: string, profile?: PlaybackProfile): Promise<void>;
+  play(handle: PlayerHandle): void;
+  pause(handle: PlayerHandle): void;
+  stop(handle: PlayerHandle): void;
+  seek(handle: PlayerHandle, position: number): void;
+  timeshiftRange(handle: PlayerHandle): TimeshiftRange | null;
+  seekLive(handle: PlayerHandle, secondsBehindLive: number): boolean;
+  setVolume(handle: PlayerHandle, volume: number): void;
+  toggleMute(handle: PlayerHandle): void;
+  setStandby(handle: PlayerHandle, standby: boolean): void;
+  setRenderMode(handle: PlayerHandle, mode: RenderMode, dropVideo?: boolean): void;
+  setSubtitleOverlay(handle: PlayerHandle, enabled: boolean): void;
+  setFastRender(handle: PlayerHandle, enabled: boolean): void;
+  promote(handle: PlayerHandle): void;
+  setOutputSize(handle: PlayerHandle, width: number, height: number): void;
+  reportPresentation(handle: PlayerHandle, ageUs: number): void;
+  captureThumbnail(handle: PlayerHandle, width: number, height: number): Promise<Thumbnail>;
+  getStatus(handle: PlayerHandle): MpvStatus | undefined;
+  getStats(handle: PlayerHandle, reset?: boolean): RenderStats | undefined;
+  getStatusBuffer(handle: PlayerHandle): ArrayBuffer | undefined;
+  onFrame(handle: PlayerHandle, callback: (info: TextureInfo) => void): void;
+  onFrameSignal(handle: PlayerHandle, callback: (seq: number) => void): void;
+  getFrameBuffer(handle: PlayerHandle): ArrayBuffer | undefined;
+  onStatus(handle: PlayerHandle, callback: (changed: Partial<MpvStatus>) => void): void;
+  onError(handle: PlayerHandle, callback: (error: string) => void): void;
+  onLog(handle: PlayerHandle, callback: (entries: LogEntry[], lost: number) => void): void;
+  setLogLevels(handle: PlayerHandle, spec: string): void;
+  dumpLog(handle: PlayerHandle): LogEntry[] | undefined;
+  setTrace(handle: PlayerHandle, enabled: boolean): void;
+  dumpTrace(handle: PlayerHandle): TraceEvent[] | undefined;
+  releaseFrame(handle: PlayerHandle, textureHandle: bigint | number, generation?: number): void;
+  isInitialized(handle: PlayerHandle): boolean;
+  createCompositor(config?: CompositorConfig): CompositorHandle;
+  destroyCompositor(handle: CompositorHandle): void;
+  compositorSetLayout(handle: CompositorHandle, tiles: NativeTile[]): void;
+  compositorOnFrame(handle: CompositorHandle, callback: (frame: CompositorFrame) => void): void;
+  compositorReleaseFrame(handle: CompositorHandle, textureHandle: bigint, generation?: number): void;
+  compositorGetStats(handle: CompositorHandle): CompositorStats | undefined;
 }
 
 /**
@@ -131,29 +600,48 @@ interface NativeAddon {
  */
 export type FrameCallback = (info: TextureInfo) => void;
 
+/**
+ * Allocation-free frame callback type (see MpvTexture.onFrameSignal)
+ */
+export type FrameSignalCallback = (frame: FrameSample) => void;
+
 /**
  * Status callback type
+ *
+ * `status` is the full current status (the same object on every call, updated
+ * in place); `changed` holds only the fields that changed since the last call.
  */
-export type StatusCallback = (status: MpvStatus) => void;
+export type StatusCallback = (status: MpvStatus, changed: Partial<MpvStatus>) => void;
 
 /**
  * Error callback type
  */
 export type ErrorCallback = (error: string) => void;
 
+/**
+ * Log callback type: entries logged since the previous call, and how many
+ * were overwritten in the ring before they could be delivered
+ */
+export type LogCallback = (entries: LogEntry[], lost: number) => void;
+
 /**
  * MpvTexture class - high-level wrapper for the native addon
  *
+ * Each instance owns an independent native player (its own GL context,
+ * callbacks and texture slots). All instances share one GPU device / GL
+ * share group, so several can play at once for multiview or
+ * picture-in-picture.
+ *
  * @example
  * ```typescript
  * const mpv = new MpvTexture();
- * mpv.create({ width: 1920, height: 1080, hwdec: 'auto' });
+ * await mpv.create({ width: 1920, height: 1080, hwdec: 'auto' });
  *
  * mpv.onFrame((textureInfo) => {
  *   // Import texture via Electron's sharedTexture API
  *   const imported = sharedTexture.importSharedTexture({
  *     textureInfo,
- *     allReferenceReleased: () => mpv.releaseFrame()
+ *     allReferencesReleased: () => mpv.releaseFrame(textureInfo)
  *   });
  *   sharedTexture.sendToRenderer(window.webContents, imported, frameIdx++);
  * });
@@ -167,73 +655,111 @@ export type ErrorCallback = (error: string) => void;
  * ```
  */
 export class MpvTexture {
-  private _initialized = false;
+  private _handle: PlayerHandle | null = null;
+  private _creating = false;
+  private _destroyRequested = false;
+  private _snapshotSeq: Int32Array | null = null;
+  private _snapshotSlots: Float64Array | null = null;
 
   /**
    * Create and initialize the mpv context
    *
+   * Never blocks the calling thread: mpv_initialize, the GL context and the
+   * texture slots are set up on the player's own render thread, which owns
+   * GL from then on. With `lazyStart` even that waits for the first load().
+   *
    * @param config - Configuration options
-   * @throws Error if context creation fails
+   * @returns Promise that resolves once the player is usable and rejects
+   *   with the reason if creation fails
    */
-  create(config?: MpvConfig): void {
-    if (this._initialized) {
+  async create(config?: MpvConfig): Promise<void> {
+    if (this._handle !== null || this._creating) {
       throw new Error('Context already created');
     }
 
-    addon.create(config);
-    this._initialized = true;
+    let created: Promise<PlayerHandle>;
+    if (config?.compositor) {
+      const { compositor, ...rest } = config;
+      created = addon.create({ ...rest, compositor: compositor.nativeHandle });
+    } else {
+      created = addon.create(config);
+    }
+
+    this._creating = true;
+    this._destroyRequested = false;
+    const handle = await created.finally(() => {
+      this._creating = false;
+    });
+
+    if (this._destroyRequested) {
+      addon.destroy(handle);
+      throw new Error('Player destroyed during create()');
+    }
+    this._handle = handle;
   }
 
   /**
-   * Destroy the mpv context and release all resources
+   * Destroy the mpv context and release all resources. During create(),
+   * the player is destroyed as soon as it exists.
    */
   destroy(): void {
-    if (!this._initialized) return;
+    if (this._creating) {
+      this._destroyRequested = true;
+      return;
+    }
+    if (this._handle === null) return;
 
-    addon.destroy();
-    this._initialized = false;
+    addon.destroy(this._handle);
+    this._handle = null;
+    this._snapshotSeq = null;
+    this._snapshotSlots = null;
   }
 
   /**
    * Check if the context is initialized
    */
   get isInitialized(): boolean {
-    return this._initialized && addon.isInitialized();
+    return this._handle !== null && addon.isInitialized(this._handle);
   }
 
   /**
    * Load a media URL
    *
+   * Never blocks the calling thread: the loadfile command is queued with
+   * mpv_command_async. A newer load() replaces an unfinished one, whose
+   * promise then rejects with 'Load aborted'.
+   *
    * @param url - URL to load (file://, http://, https://, or stream URL)
-   * @returns Promise that resolves when loading starts
+   * @param options - Per-file mpv options ("key=value,..."), applied over the profile
+   * @param profile - Playback profile for this file only (default: the one from create())
+   * @returns Promise that resolves once mpv has opened the file
+   *   (MPV_EVENT_FILE_LOADED) and rejects if it fails to open
    */
-  load(url: string, options?: string): Promise<void> {
-    this.ensureInitialized();
-    return options ? addon.load(url, options) : addon.load(url);
+  load(url: string, options?: string, profile?: PlaybackProfile): Promise<void> {
+    const handle = this.ensureInitialized();
+    if (profile) return addon.load(handle, url, options ?? '', profile);
+    return options ? addon.load(handle, url, options) : addon.load(handle, url);
   }
 
   /**
    * Start or resume playback
    */
   play(): void {
-    this.ensureInitialized();
-    addon.play();
+    addon.play(this.ensureInitialized());
   }
 
   /**
    * Pause playback
    */
   pause(): void {
-    this.ensureInitialized();
-    addon.pause();
+    addon.pause(this.ensureInitialized());
   }
 
   /**
    * Stop playback completely
    */
   stop(): void {
-    this.ensureInitialized();
-    addon.stop();
+    addon.stop(this.ensureInitialized());
   }
 
   /**
@@ -242,8 +768,30 @@ export class MpvTexture {
    * @param position - Position in seconds
    */
   seek(position: number): void {
-    this.ensureInitialized();
-    addon.seek(position);
+    addon.seek(this.ensureInitialized(), position);
+  }
+
+  /**
+   * The part of the stream that can be seeked to without the network
+   *
+   * Every player has a few seconds of demuxer cache; with `timeshiftMB` it
+   * holds minutes of a live channel on disk, so rewinding is a local seek.
+   *
+   * @returns The window, or null before anything is buffered
+   */
+  timeshiftRange(): TimeshiftRange | null {
+    return addon.timeshiftRange(this.ensureInitialized());
+  }
+
+  /**
+   * Seek relative to the live edge, inside the buffered window
+   *
+   * @param secondsBehindLive - How far behind the newest buffered data
+   *   (0 = catch up with live); clamped to timeshiftRange()
+   * @returns false if nothing is buffered
+   */
+  seekLive(secondsBehindLive: number): boolean {
+    return addon.seekLive(this.ensureInitialized(), secondsBehindLive);
   }
 
   /**
@@ -252,16 +800,119 @@ export class MpvTexture {
    * @param volume - Volume level (0-100)
    */
   setVolume(volume: number): void {
-    this.ensureInitialized();
-    addon.setVolume(Math.max(0, Math.min(100, volume)));
+    addon.setVolume(this.ensureInitialized(), Math.max(0, Math.min(100, volume)));
   }
 
   /**
    * Toggle mute state
    */
   toggleMute(): void {
-    this.ensureInitialized();
-    addon.toggleMute();
+    addon.toggleMute(this.ensureInitialized());
+  }
+
+  /**
+   * Put the player in (or take it out of) standby
+   *
+   * A standby player is hidden: paused on its first decoded frame, muted, and
+   * its frames are not delivered to onFrame. Loading the likely next channel
+   * into a standby player keeps its demuxer warm for instant zapping.
+   */
+  setStandby(standby: boolean): void {
+    addon.setStandby(this.ensureInitialized(), standby);
+  }
+
+  /**
+   * Scale rendering down while the video is not visible
+   *
+   * For a minimized window or a hidden player: playback, audio and status
+   * continue, but frames are retired natively without being rendered
+   * ('suspended') or at most one a second is rendered and delivered
+   * ('throttled'), saving the GPU work and the texture hand-over.
+   * captureThumbnail() still works in every mode. With `dropVideo`,
+   * 'suspended' also deselects the video track so nothing is decoded;
+   * returning to another mode selects it again, and the picture comes back
+   * with the next keyframe. Switching modes redraws the current frame.
+   */
+  setRenderMode(mode: RenderMode, options?: { dropVideo?: boolean }): void {
+    addon.setRenderMode(this.ensureInitialized(), mode, options?.dropVideo ?? false);
+  }
+
+  /**
+   * Keep subtitles and the OSD out of the video texture
+   *
+   * mpv stops drawing them, so a subtitle line appearing or clearing no
+   * longer re-renders and re-exports the full video frame, and the video
+   * keeps the planar yuvExport path. The current line arrives through
+   * onStatus() as `subtitleText` / `subtitleAss` for the renderer to layer
+   * over the video. Image subtitles (`subtitleBitmap`) have no text and are
+   * still burned in while selected.
+   */
+  setSubtitleOverlay(enabled: boolean): void {
+    addon.setSubtitleOverlay(this.ensureInitialized(), enabled);
+  }
+
+  /**
+   * Trade picture quality for GPU time while frames need no scaling
+   *
+   * While the texture has the decoded size (no setOutputSize(), or one equal
+   * to it) and no glsl-shaders are loaded, scalers drop to bilinear and
+   * dithering, debanding and HDR peak detection are off, so banding and HDR
+   * tone mapping can get worse. The player's own settings return whenever
+   * mpv has to scale; getStats().fastRenderActive tells which are in effect.
+   * No render pass is skipped: libmpv does not hand out the decoder's
+   * surfaces, so mpv still renders and converts every frame.
+   */
+  setFastRender(enabled: boolean): void {
+    addon.setFastRender(this.ensureInitialized(), enabled);
+  }
+
+  /**
+   * Take a standby player on air
+   *
+   * Unpauses and unmutes it and delivers its already-decoded frame right
+   * away. A live stream that idled in standby skips ahead to the newest
+   * buffered data first.
+   */
+  promote(): void {
+    addon.promote(this.ensureInitialized());
+  }
+
+  /**
+   * Render at the presentation size instead of the source size
+   *
+   * Sizes the shared texture to the on-screen target (physical pixels) so
+   * mpv's scaler does the one downscale, instead of exporting full-resolution
+   * frames for Chromium to scale again. The video is letterboxed to keep its
+   * aspect ratio. Pass 0, 0 to follow the decoded video size again (default).
+   */
+  setOutputSize(width: number, height: number): void {
+    addon.setOutputSize(this.ensureInitialized(), Math.round(width), Math.round(height));
+  }
+
+  /**
+   * Capture the current picture as a small RGBA image
+   *
+   * The next render is scaled into a width x height framebuffer on the GPU
+   * and read back asynchronously (pixel-pack buffer behind a fence), so
+   * neither playback nor Chromium's GPU process waits on the copy. A paused
+   * player redraws its current frame for it. Pass 0 for one side to keep the
+   * video's aspect ratio; thumbnails are never larger than the texture.
+   */
+  captureThumbnail(width: number, height = 0): Promise<Thumbnail> {
+    return addon.captureThumbnail(this.ensureInitialized(), Math.round(width), Math.round(height));
+  }
+
+  /**
+   * Report that a frame reached the screen (displaySync)
+   *
+   * Call with the presentation time of a drawn frame, e.g. the timestamp of
+   * the requestAnimationFrame after it was drawn, as epoch milliseconds
+   * (performance.timeOrigin + timestamp). Feeds the display clock that paces
+   * rendering; a no-op unless the player was created with displaySync.
+   */
+  reportPresentation(presentedAtMs: number): void {
+    const ageMs = performance.timeOrigin + performance.now() - presentedAtMs;
+    addon.reportPresentation(this.ensureInitialized(), Math.max(0, ageMs * 1000));
   }
 
   /**
@@ -270,8 +921,77 @@ export class MpvTexture {
    * @returns Current status or undefined if not initialized
    */
   getStatus(): MpvStatus | undefined {
-    if (!this._initialized) return undefined;
-    return addon.getStatus();
+    if (this._handle === null) return undefined;
+    return addon.getStatus(this._handle);
+  }
+
+  /**
+   * Get native render pipeline counters and latency histograms
+   *
+   * @param reset - Clear the counters after reading (for interval sampling)
+   * @returns Stats or undefined if not initialized
+   */
+  getStats(reset = false): RenderStats | undefined {
+    if (this._handle === null) return undefined;
+    return addon.getStats(this._handle, reset);
+  }
+
+  /**
+   * Read status and pipeline counters without calling into native code
+   *
+   * The event and render threads publish into a buffer this object views
+   * directly, each block behind its own sequence number; a read copies a
+   * block and retries if a writer was mid-update. Nothing is allocated when
+   * `out` is passed, so this is cheap enough to call every animation frame.
+   * String fields (pixel format, colorimetry) and latency histograms are
+   * only available from getStatus() / getStats().
+   *
+   * @param out - Object to fill in place (reused across calls)
+   * @returns The sample or undefined if not initialized
+   */
+  readStatus(out?: StatusSample): StatusSample | undefined {
+    if (this._handle === null) return undefined;
+    if (this._snapshotSlots === null) {
+      const buffer = addon.getStatusBuffer(this._handle);
+      if (!buffer) return undefined;
+      this._snapshotSeq = new Int32Array(buffer, 0, 2);
+      this._snapshotSlots = new Float64Array(buffer, 0, STATUS_SLOT_COUNT);
+    }
+    const seq = this._snapshotSeq as Int32Array;
+    const slots = this._snapshotSlots;
+    const sample = out ?? ({} as StatusSample);
+
+    for (let attempt = 0; attempt < SNAPSHOT_READ_ATTEMPTS; attempt++) {
+      const before = Atomics.load(seq, 0);
+      if (before & 1) continue;
+      sample.playing = slots[STATUS_SLOTS.playing] !== 0;
+      sample.volume = slots[STATUS_SLOTS.volume];
+      sample.muted = slots[STATUS_SLOTS.muted] !== 0;
+      sample.position = slots[STATUS_SLOTS.position];
+      sample.duration = slots[STATUS_SLOTS.duration];
+      sample.width = slots[STATUS_SLOTS.width];
+      sample.height = slots[STATUS_SLOTS.height];
+      if (Atomics.load(seq, 0) === before) break;
+    }
+
+    for (let attempt = 0; attempt < SNAPSHOT_READ_ATTEMPTS; attempt++) {
+      const before = Atomics.load(seq, 1);
+      if (before & 1) continue;
+      sample.framesRendered = slots[STATUS_SLOTS.framesRendered];
+      sample.framesDelivered = slots[STATUS_SLOTS.framesDelivered];
+      sample.framesDropped = slots[STATUS_SLOTS.framesDropped];
+      sample.framesSuperseded = slots[STATUS_SLOTS.framesSuperseded];
+      sample.lockFailures = slots[STATUS_SLOTS.lockFailures];
+      sample.renderFailures = slots[STATUS_SLOTS.renderFailures];
+      sample.resizes = slots[STATUS_SLOTS.resizes];
+      sample.lastFirstFrameUs = slots[STATUS_SLOTS.lastFirstFrameUs];
+      sample.framesPaced = slots[STATUS_SLOTS.framesPaced];
+      sample.framesLate = slots[STATUS_SLOTS.framesLate];
+      sample.displayPeriodUs = slots[STATUS_SLOTS.displayPeriodUs];
+      if (Atomics.load(seq, 1) === before) break;
+    }
+
+    return sample;
   }
 
   /**
@@ -284,53 +1004,317 @@ export class MpvTexture {
    * @param callback - Function to call with texture info
    */
   onFrame(callback: FrameCallback): void {
-    this.ensureInitialized();
-    addon.onFrame(callback);
+    addon.onFrame(this.ensureInitialized(), callback);
+  }
+
+  /**
+   * Set an allocation-free callback for new frame events
+   *
+   * The same frames as onFrame() (which it replaces, and vice versa), but
+   * nothing is allocated per frame on either side: the addon writes the
+   * frame into a record this object views through a typed array and only
+   * signals its seq, and `frame` is one FrameSample refilled each time.
+   * At 60 fps across several players that takes the per-frame TextureInfo
+   * objects, BigInts and strings out of the main thread's GC load. Release
+   * with releaseFrame(frame) while still in the callback; to release later,
+   * keep frame.handle and frame.generation and pass both.
+   *
+   * @param callback - Function to call with the (reused) frame sample
+   */
+  onFrameSignal(callback: FrameSignalCallback): void {
+    const handle = this.ensureInitialized();
+    const sample: FrameSample = {
+      handle: 0, width: 0, height: 0, format: 'rgba', transfer: 'sdr',
+      stride: 0, offset: 0, modifier: 0n, generation: 0, seq: 0, pts: null,
+      renderStartUs: 0, renderDoneUs: 0, exportUs: 0, dropped: 0,
+    };
+    let slots: Float64Array | null = null;
+    let modifier: BigUint64Array | null = null;
+
+    addon.onFrameSignal(handle, () => {
+      if (slots === null) {
+        const buffer = addon.getFrameBuffer(handle);
+        if (!buffer) return;
+        slots = new Float64Array(buffer, 0, FRAME_SLOT_COUNT);
+        modifier = new BigUint64Array(buffer, FRAME_SLOTS.modifier * 8, 1);
+      }
+      const pts = slots[FRAME_SLOTS.pts];
+      sample.handle = slots[FRAME_SLOTS.handle];
+      sample.width = slots[FRAME_SLOTS.width];
+      sample.height = slots[FRAME_SLOTS.height];
+      sample.format = FRAME_FORMATS[slots[FRAME_SLOTS.format]] ?? 'rgba';
+      sample.transfer = FRAME_TRANSFERS[slots[FRAME_SLOTS.transfer]] ?? 'sdr';
+      sample.stride = slots[FRAME_SLOTS.stride];
+      sample.offset = slots[FRAME_SLOTS.offset];
+      sample.modifier = sample.stride !== 0 ? (modifier as BigUint64Array)[0] : 0n;
+      sample.generation = slots[FRAME_SLOTS.generation];
+      sample.seq = slots[FRAME_SLOTS.seq];
+      sample.pts = Number.isNaN(pts) ? null : pts;
+      sample.renderStartUs = slots[FRAME_SLOTS.renderStartUs];
+      sample.renderDoneUs = slots[FRAME_SLOTS.renderDoneUs];
+      sample.exportUs = slots[FRAME_SLOTS.exportUs];
+      sample.dropped = slots[FRAME_SLOTS.dropped];
+      callback(sample);
+    });
   }
 
   /**
    * Set callback for status change events
    *
-   * Called whenever playback status changes (position, playing state, etc.)
+   * Changes are coalesced natively: playing state, volume, duration and video
+   * format arrive immediately, position at most every `statusIntervalMs`.
+   * Only changed fields cross into JS; they are merged into one status object.
    *
-   * @param callback - Function to call with status
+   * @param callback - Function to call with status and the changed fields
    */
   onStatus(callback: StatusCallback): void {
-    this.ensureInitialized();
-    addon.onStatus(callback);
+    const handle = this.ensureInitialized();
+    const status = addon.getStatus(handle) as MpvStatus;
+    addon.onStatus(handle, (changed) => {
+      Object.assign(status, changed);
+      callback(status, changed);
+    });
   }
 
   /**
    * Set callback for error events
    *
+   * Player failures and playback errors (a file that fails to play).
+   * mpv's own log lines, errors included, arrive through onLog().
+   *
    * @param callback - Function to call with error message
    */
   onError(callback: ErrorCallback): void {
-    this.ensureInitialized();
-    addon.onError(callback);
+    addon.onError(this.ensureInitialized(), callback);
+  }
+
+  /**
+   * Set callback for mpv log messages
+   *
+   * Messages go into a bounded native ring buffer; the callback receives
+   * them in batches, at most one call outstanding, rather than one call per
+   * line. Which messages are kept is set by logLevels / setLogLevels().
+   */
+  onLog(callback: LogCallback): void {
+    addon.onLog(this.ensureInitialized(), callback);
+  }
+
+  /**
+   * Change which mpv log messages are kept, in msg-level syntax
+   * ('all=warn,ffmpeg=error,cplayer=v'). Modules below their level are
+   * filtered natively and never reach JS. Throws on an invalid spec.
+   */
+  setLogLevels(spec: string): void {
+    addon.setLogLevels(this.ensureInitialized(), spec);
+  }
+
+  /**
+   * The retained log history (the most recent 512 messages), oldest first,
+   * e.g. to attach to a bug report. Does not affect onLog() delivery.
+   */
+  dumpLog(): LogEntry[] {
+    return addon.dumpLog(this.ensureInitialized()) ?? [];
+  }
+
+  /**
+   * Turn the per-frame latency trace on or off
+   *
+   * While on, every frame's render call, GPU completion, hand-over to JS and
+   * hold until releaseFrame() is recorded in a bounded native ring (the
+   * last ~8000 events), along with drops and reportPresentation() times.
+   * Recording is a few atomic stores per stage, so it can stay on while
+   * debugging; dumpTrace() reads the ring.
+   */
+  setTrace(enabled: boolean): void {
+    addon.setTrace(this.ensureInitialized(), enabled);
+  }
+
+  /**
+   * The retained trace events, oldest first. Pass them to toChromeTrace()
+   * for a file chrome://tracing or Perfetto can open.
+   */
+  dumpTrace(): TraceEvent[] {
+    return addon.dumpTrace(this.ensureInitialized()) ?? [];
   }
 
   /**
-   * Release the current frame
+   * Release a delivered frame so its texture slot can be rendered into again
+   *
+   * Must be called exactly once per frame passed to onFrame, after Electron
+   * has finished using the texture (in the allReferencesReleased callback of
+   * importSharedTexture). Slots that are never released are reclaimed after
+   * about a second, so forgetting to release shows up as stutter.
    *
-   * Must be called after Electron has finished using the texture
-   * (in the allReferenceReleased callback of importSharedTexture).
+   * A bare handle should come with the frame's generation: without it, a
+   * late release can free a later export of the same handle.
    */
-  releaseFrame(): void {
-    if (this._initialized) {
-      addon.releaseFrame();
+  releaseFrame(frame: TextureInfo | FrameSample | bigint | number, generation?: number): void {
+    if (this._handle !== null) {
+      if (typeof frame === 'object') {
+        addon.releaseFrame(this._handle, frame.handle, frame.generation);
+      } else {
+        addon.releaseFrame(this._handle, frame, generation);
+      }
     }
   }
 
-  private ensureInitialized(): void {
-    if (!this._initialized) {
+  /** @internal Native handle, for MpvCompositor */
+  get nativeHandle(): PlayerHandle {
+    return this.ensureInitialized();
+  }
+
+  private ensureInitialized(): PlayerHandle {
+    if (this._handle === null) {
       throw new Error('Context not initialized. Call create() first.');
     }
+    return this._handle;
+  }
+}
+
+/**
+ * MpvCompositor - several players in one exported texture (multiview)
+ *
+ * Players created with `{ compositor }` render straight into their tile
+ * size inside the GPU share group; the compositor blits the newest frame of
+ * each into one atlas and exports that. The renderer imports and draws one
+ * texture per display frame for the whole grid, however many streams play.
+ *
+ * @example
+ * ```typescript
+ * const grid = new MpvCompositor();
+ * grid.create({ width: 1920, height: 1080 });
+ * const players = urls.map(() => new MpvTexture());
+ * await Promise.all(players.map((p) => p.create({ compositor: grid })));
+ * grid.setLayout(players.map((player, i) => ({
+ *   player, x: (i % 2) * 960, y: Math.floor(i / 2) * 540, width: 960, height: 540,
+ * })));
+ * grid.onFrame((frame) => {
+ *   // Import like an MpvTexture frame, then grid.releaseFrame(frame)
+ * });
+ * ```
+ */
+export class MpvCompositor {
+  private _handle: CompositorHandle | null = null;
+
+  /**
+   * Create the compositor and its atlas
+   *
+   * @throws Error if the GL context or atlas cannot be created
+   */
+  create(config?: CompositorConfig): void {
+    if (this._handle !== null) {
+      throw new Error('Compositor already created');
+    }
+    this._handle = addon.createCompositor(config);
+  }
+
+  /**
+   * Destroy the compositor. Attached players keep playing, but their
+   * frames are shown nowhere until they are destroyed too.
+   */
+  destroy(): void {
+    if (this._handle === null) return;
+    addon.destroyCompositor(this._handle);
+    this._handle = null;
+  }
+
+  /**
+   * Replace the layout. Each player is resized to its region so tiles are
+   * drawn 1:1; regions are clipped to the atlas, and players not created
+   * with this compositor are ignored. Players left out keep playing unseen.
+   */
+  setLayout(tiles: CompositorTile[]): void {
+    addon.compositorSetLayout(
+      this.ensureInitialized(),
+      tiles.map(({ player, x, y, width, height }) => ({ player: player.nativeHandle, x, y, width, height }))
+    );
+  }
+
+  /**
+   * Set the atlas frame callback. The same contract as MpvTexture.onFrame:
+   * at most one frame outstanding, each released exactly once.
+   */
+  onFrame(callback: (frame: CompositorFrame) => void): void {
+    addon.compositorOnFrame(this.ensureInitialized(), callback);
+  }
+
+  /**
+   * Release a delivered atlas frame (see MpvTexture.releaseFrame)
+   */
+  releaseFrame(frame: CompositorFrame | bigint): void {
+    if (this._handle !== null) {
+      if (typeof frame === 'bigint') {
+        addon.compositorReleaseFrame(this._handle, frame);
+      } else {
+        addon.compositorReleaseFrame(this._handle, frame.handle, frame.generation);
+      }
+    }
+  }
+
+  /**
+   * Compositor counters
+   */
+  getStats(): CompositorStats {
+    return addon.compositorGetStats(this.ensureInitialized()) ?? { framesComposited: 0, lockFailures: 0 };
+  }
+
+  /** @internal Native handle, for MpvConfig.compositor */
+  get nativeHandle(): CompositorHandle {
+    return this.ensureInitialized();
+  }
+
+  private ensureInitialized(): CompositorHandle {
+    if (this._handle === null) {
+      throw new Error('Compositor not initialized. Call create() first.');
+    }
+    return this._handle;
+  }
+}
+
+const TRACE_STAGES: TraceStage[] = ['render', 'gpu', 'deliver', 'hold', 'drop', 'present'];
+
+/**
+ * Convert trace events to Chrome trace-event JSON (chrome://tracing,
+ * ui.perfetto.dev). Each stage gets its own track under process `pid`, so
+ * several players can be merged into one file. Timestamps stay on the
+ * native monotonic clock (steady_clock, the clock Chromium's own traces
+ * use), so they usually line up with a trace recorded by Chromium.
+ */
+export function toChromeTrace(events: TraceEvent[], pid = 1, name = 'mpv-texture'): {
+  traceEvents: Record<string, unknown>[];
+  displayTimeUnit: 'ms';
+} {
+  const traceEvents: Record<string, unknown>[] = [
+    { ph: 'M', name: 'process_name', pid, tid: 0, args: { name } },
+  ];
+  TRACE_STAGES.forEach((stage, i) => {
+    traceEvents.push({ ph: 'M', name: 'thread_name', pid, tid: i + 1, args: { name: stage } });
+    traceEvents.push({ ph: 'M', name: 'thread_sort_index', pid, tid: i + 1, args: { sort_index: i } });
+  });
+
+  for (const event of events) {
+    const tid = TRACE_STAGES.indexOf(event.stage) + 1;
+    const args = { seq: event.seq, pts: event.pts };
+    if (event.stage === 'drop' || event.stage === 'present') {
+      traceEvents.push({ ph: 'i', s: 't', name: event.stage, cat: 'frame', pid, tid, ts: event.startUs, args });
+    } else {
+      traceEvents.push({
+        ph: 'X',
+        name: `${event.stage} #${event.seq}`,
+        cat: 'frame',
+        pid,
+        tid,
+        ts: event.startUs,
+        dur: event.endUs - event.startUs,
+        args,
+      });
+    }
   }
+  return { traceEvents, displayTimeUnit: 'ms' };
 }
 
 // Export a singleton instance for convenience
 export const mpvTexture = new MpvTexture();
 
-// Also export the class for those who want multiple instances (not recommended)
+// Also export the class for multiple concurrent players (multiview / PiP)
 export default MpvTexture;
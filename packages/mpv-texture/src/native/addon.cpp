@@ -3,6 +3,13 @@
  */
 
 #include <napi.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <unordered_map>
+#include "compositor.h"
+#include "frame_record.h"
 #include "mpv_context.h"
 
 // Request high-performance GPU on Windows (NVIDIA Optimus / AMD PowerXpress)
@@ -16,13 +23,117 @@ extern "C" {
 
 using namespace mpv_texture;
 
-// Global context (single instance per process)
-static MpvContext* g_context = nullptr;
+// One compositor per handle (see Compositor), shared with the players
+// attached to it so it outlives them
+struct CompositorEntry {
+    Compositor compositor;
+    Napi::ThreadSafeFunction frameCallback;
+};
+
+struct Player;
+
+// Frame delivery through the shared frame record (see OnFrameSignal). A
+// typed thread-safe function queues a call without allocating; `context`
+// is the player, weakly held since the call may run after Destroy.
+static void CallFrameSignal(Napi::Env env, Napi::Function jsCallback, std::weak_ptr<Player>* context, void* data);
+using FrameSignal = Napi::TypedThreadSafeFunction<std::weak_ptr<Player>, void, CallFrameSignal>;
+
+// One player per handle. Each owns its MpvContext (and with it a GL context
+// and texture slots) plus the thread-safe functions for its JS callbacks.
+// GPU device / GL share group are shared across players inside MpvContext.
+struct Player {
+    // Declared first: the context detaches from it while being destroyed
+    std::shared_ptr<CompositorEntry> compositor;
+    MpvContext context;
+    Napi::ThreadSafeFunction frameCallback;
+    Napi::ThreadSafeFunction statusCallback;
+    Napi::ThreadSafeFunction errorCallback;
+    Napi::ThreadSafeFunction logCallback;
+    // V8-allocated backing for the context's StatusSnapshot (Electron does
+    // not allow external buffers); held until Destroy has joined the writers
+    Napi::Reference<Napi::ArrayBuffer> statusBuffer;
+    // onFrameSignal: the frame record and its V8 backing (JS thread only)
+    FrameSignal frameSignal;
+    FrameRecord frameRecord;
+    Napi::Reference<Napi::ArrayBuffer> frameBuffer;
+};
+
+// Only touched from the JS thread. Native threads capture Player* directly,
+// which stays valid until Destroy has joined them; calls queued to the JS
+// thread hold a weak_ptr since they may run after Destroy.
+static std::unordered_map<uint32_t, std::shared_ptr<Player>> g_players;
+static uint32_t g_nextHandle = 1;
+static std::unordered_map<uint32_t, std::shared_ptr<CompositorEntry>> g_compositors;
+static uint32_t g_nextCompositorHandle = 1;
+
+// Look up the player for the handle passed as the first argument.
+// Throws (and returns nullptr) if the handle is not a number; returns nullptr
+// without throwing for unknown/destroyed handles.
+static std::shared_ptr<Player> FindPlayer(const Napi::CallbackInfo& info) {
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(info.Env(), "Player handle required").ThrowAsJavaScriptException();
+        return nullptr;
+    }
+    auto it = g_players.find(info[0].As<Napi::Number>().Uint32Value());
+    return it != g_players.end() ? it->second : nullptr;
+}
 
-// Thread-safe function references for callbacks
-static Napi::ThreadSafeFunction g_frameCallback;
-static Napi::ThreadSafeFunction g_statusCallback;
-static Napi::ThreadSafeFunction g_errorCallback;
+// Same as FindPlayer, for compositor handles
+static std::shared_ptr<CompositorEntry> FindCompositor(const Napi::CallbackInfo& info) {
+    if (info.Length() < 1 || !info[0].IsNumber()) {
+        Napi::TypeError::New(info.Env(), "Compositor handle required").ThrowAsJavaScriptException();
+        return nullptr;
+    }
+    auto it = g_compositors.find(info[0].As<Napi::Number>().Uint32Value());
+    return it != g_compositors.end() ? it->second : nullptr;
+}
+
+static void ReleaseCallbacks(Player* player) {
+    if (player->frameCallback) {
+        player->frameCallback.Release();
+    }
+    if (player->frameSignal) {
+        player->frameSignal.Release();
+    }
+    if (player->statusCallback) {
+        player->statusCallback.Release();
+    }
+    if (player->errorCallback) {
+        player->errorCallback.Release();
+    }
+    if (player->logCallback) {
+        player->logCallback.Release();
+    }
+}
+
+// Convert log ring entries to JS objects. Times become epoch milliseconds.
+static Napi::Array LogEntriesToJS(Napi::Env env, const std::vector<LogEntry>& entries) {
+    auto epochUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    double offsetUs = static_cast<double>(epochUs) - static_cast<double>(nowUs());
+
+    auto array = Napi::Array::New(env, entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        const LogEntry& entry = entries[i];
+        const char* level = "trace";
+        switch (entry.level) {
+            case MPV_LOG_LEVEL_FATAL: level = "fatal"; break;
+            case MPV_LOG_LEVEL_ERROR: level = "error"; break;
+            case MPV_LOG_LEVEL_WARN: level = "warn"; break;
+            case MPV_LOG_LEVEL_INFO: level = "info"; break;
+            case MPV_LOG_LEVEL_V: level = "v"; break;
+            case MPV_LOG_LEVEL_DEBUG: level = "debug"; break;
+            default: break;
+        }
+        auto obj = Napi::Object::New(env);
+        obj.Set("time", Napi::Number::New(env, (static_cast<double>(entry.timeUs) + offsetUs) / 1000.0));
+        obj.Set("level", Napi::String::New(env, level));
+        obj.Set("prefix", Napi::String::New(env, entry.prefix));
+        obj.Set("text", Napi::String::New(env, entry.text));
+        array.Set(static_cast<uint32_t>(i), obj);
+    }
+    return array;
+}
 
 // Convert TextureInfo to JS object
 Napi::Object TextureInfoToJS(Napi::Env env, const TextureInfo& info) {
@@ -35,36 +146,117 @@ Napi::Object TextureInfoToJS(Napi::Env env, const TextureInfo& info) {
     switch (info.format) {
         case TextureFormat::NV12: formatStr = "nv12"; break;
         case TextureFormat::BGRA8: formatStr = "bgra"; break;
+        case TextureFormat::P010: formatStr = "p010"; break;
         default: formatStr = "rgba"; break;
     }
     obj.Set("format", Napi::String::New(env, formatStr));
 
+    const char* transferStr = "sdr";
+    switch (info.transfer) {
+        case TextureTransfer::PQ: transferStr = "pq"; break;
+        case TextureTransfer::HLG: transferStr = "hlg"; break;
+        default: transferStr = "sdr"; break;
+    }
+    obj.Set("transfer", Napi::String::New(env, transferStr));
+
+    // Linux dma-buf layout (handle is the fd)
+    if (info.stride) {
+        obj.Set("stride", Napi::Number::New(env, info.stride));
+        obj.Set("offset", Napi::Number::New(env, info.offset));
+        obj.Set("modifier", Napi::BigInt::New(env, info.modifier));
+    }
+
+    obj.Set("generation", Napi::Number::New(env, static_cast<double>(info.generation)));
+
+    // Frame timeline (microseconds, player's monotonic clock)
+    obj.Set("seq", Napi::Number::New(env, static_cast<double>(info.seq)));
+    obj.Set("pts", std::isnan(info.pts) ? env.Null() : Napi::Number::New(env, info.pts));
+    obj.Set("renderStartUs", Napi::Number::New(env, static_cast<double>(info.renderStartUs)));
+    obj.Set("renderDoneUs", Napi::Number::New(env, static_cast<double>(info.renderDoneUs)));
+    obj.Set("exportUs", Napi::Number::New(env, static_cast<double>(info.exportUs)));
+
     return obj;
 }
 
-// Convert MpvStatus to JS object
-Napi::Object StatusToJS(Napi::Env env, const MpvStatus& status) {
+// Convert MpvStatus to JS object, limited to the StatusField bits in `fields`
+Napi::Object StatusToJS(Napi::Env env, const MpvStatus& status, uint32_t fields = STATUS_ALL) {
     auto obj = Napi::Object::New(env);
-    obj.Set("playing", Napi::Boolean::New(env, status.playing));
-    obj.Set("volume", Napi::Number::New(env, status.volume));
-    obj.Set("muted", Napi::Boolean::New(env, status.muted));
-    obj.Set("position", Napi::Number::New(env, status.position));
-    obj.Set("duration", Napi::Number::New(env, status.duration));
-    obj.Set("width", Napi::Number::New(env, status.width));
-    obj.Set("height", Napi::Number::New(env, status.height));
+    if (fields & STATUS_PLAYING) {
+        obj.Set("playing", Napi::Boolean::New(env, status.playing));
+    }
+    if (fields & STATUS_VOLUME) {
+        obj.Set("volume", Napi::Number::New(env, status.volume));
+    }
+    if (fields & STATUS_MUTED) {
+        obj.Set("muted", Napi::Boolean::New(env, status.muted));
+    }
+    if (fields & STATUS_POSITION) {
+        obj.Set("position", Napi::Number::New(env, status.position));
+    }
+    if (fields & STATUS_DURATION) {
+        obj.Set("duration", Napi::Number::New(env, status.duration));
+    }
+    if (fields & STATUS_VIDEO) {
+        obj.Set("width", Napi::Number::New(env, status.width));
+        obj.Set("height", Napi::Number::New(env, status.height));
+        obj.Set("pixelFormat", Napi::String::New(env, status.pixelFormat));
+        obj.Set("colorMatrix", Napi::String::New(env, status.colorMatrix));
+        obj.Set("colorLevels", Napi::String::New(env, status.colorLevels));
+        obj.Set("primaries", Napi::String::New(env, status.primaries));
+        obj.Set("gamma", Napi::String::New(env, status.gamma));
+    }
+    if (fields & STATUS_SUBTITLE) {
+        obj.Set("subtitleText", Napi::String::New(env, status.subtitleText));
+        obj.Set("subtitleAss", Napi::String::New(env, status.subtitleAss));
+        obj.Set("subtitleBitmap", Napi::Boolean::New(env, status.subtitleBitmap));
+    }
     return obj;
 }
 
-// Create the mpv context
-Napi::Value Create(const Napi::CallbackInfo& info) {
-    Napi::Env env = info.Env();
+// Runs MpvContext::create on the thread pool (it blocks until the render
+// thread has mpv and GL up) and resolves with the new player's handle. The
+// player is only registered once created, so JS never sees a half-made one.
+class CreateWorker : public Napi::AsyncWorker {
+public:
+    CreateWorker(Napi::Env env, std::shared_ptr<Player> player, const MpvConfig& config)
+        : Napi::AsyncWorker(env, "mpvCreate"),
+          m_deferred(Napi::Promise::Deferred::New(env)),
+          m_player(std::move(player)),
+          m_config(config) {}
+
+    Napi::Promise Promise() const { return m_deferred.Promise(); }
+
+protected:
+    void Execute() override {
+        if (!m_player->context.create(m_config)) {
+            std::string error = m_player->context.startError();
+            SetError(error.empty() ? "Failed to create mpv context" : error);
+        }
+    }
 
-    if (g_context) {
-        Napi::TypeError::New(env, "Context already created").ThrowAsJavaScriptException();
-        return env.Undefined();
+    void OnOK() override {
+        uint32_t handle = g_nextHandle++;
+        g_players.emplace(handle, std::move(m_player));
+        m_deferred.Resolve(Napi::Number::New(Env(), handle));
+    }
+
+    void OnError(const Napi::Error& error) override {
+        m_player->statusBuffer.Reset();
+        m_deferred.Reject(error.Value());
     }
 
+private:
+    Napi::Promise::Deferred m_deferred;
+    std::shared_ptr<Player> m_player;
+    MpvConfig m_config;
+};
+
+// Create a player; resolves with its handle
+Napi::Value Create(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
     MpvConfig config;
+    std::shared_ptr<CompositorEntry> compositor;
 
     if (info.Length() > 0 && info[0].IsObject()) {
         auto configObj = info[0].As<Napi::Object>();
@@ -78,41 +270,95 @@ Napi::Value Create(const Napi::CallbackInfo& info) {
         if (configObj.Has("hwdec")) {
             config.hwdec = configObj.Get("hwdec").As<Napi::String>().Utf8Value();
         }
+        if (configObj.Has("standby")) {
+            config.standby = configObj.Get("standby").As<Napi::Boolean>().Value();
+        }
+        if (configObj.Has("yuvExport")) {
+            config.yuvExport = configObj.Get("yuvExport").As<Napi::Boolean>().Value();
+        }
+        if (configObj.Has("logLevels")) {
+            config.logLevels = configObj.Get("logLevels").As<Napi::String>().Utf8Value();
+        }
+        if (configObj.Has("displaySync")) {
+            config.displaySync = configObj.Get("displaySync").As<Napi::Boolean>().Value();
+        }
+        if (configObj.Has("trace")) {
+            config.trace = configObj.Get("trace").As<Napi::Boolean>().Value();
+        }
+        if (configObj.Has("subtitleOverlay")) {
+            config.subtitleOverlay = configObj.Get("subtitleOverlay").As<Napi::Boolean>().Value();
+        }
+        if (configObj.Has("fastRender")) {
+            config.fastRender = configObj.Get("fastRender").As<Napi::Boolean>().Value();
+        }
+        if (configObj.Has("lazyStart")) {
+            config.lazyStart = configObj.Get("lazyStart").As<Napi::Boolean>().Value();
+        }
+        if (configObj.Has("profile")) {
+            std::string name = configObj.Get("profile").As<Napi::String>().Utf8Value();
+            if (!parsePlaybackProfile(name, config.profile)) {
+                Napi::TypeError::New(env, "Unknown playback profile: " + name).ThrowAsJavaScriptException();
+                return env.Undefined();
+            }
+        }
+        if (configObj.Has("statusIntervalMs")) {
+            config.statusIntervalMs = configObj.Get("statusIntervalMs").As<Napi::Number>().Uint32Value();
+        }
+        if (configObj.Has("timeshiftMB")) {
+            double mb = configObj.Get("timeshiftMB").As<Napi::Number>().DoubleValue();
+            config.timeshiftMB = mb > 0 ? static_cast<uint32_t>(mb) : 0;
+        }
+        if (configObj.Has("timeshiftDir")) {
+            config.timeshiftDir = configObj.Get("timeshiftDir").As<Napi::String>().Utf8Value();
+        }
+        if (configObj.Has("texturePoolMB")) {
+            double mb = configObj.Get("texturePoolMB").As<Napi::Number>().DoubleValue();
+            config.texturePoolBudget = mb > 0 ? static_cast<uint64_t>(mb * 1024 * 1024) : 0;
+        }
+        if (configObj.Has("compositor")) {
+            auto it = g_compositors.find(configObj.Get("compositor").As<Napi::Number>().Uint32Value());
+            if (it == g_compositors.end()) {
+                Napi::TypeError::New(env, "Unknown compositor handle").ThrowAsJavaScriptException();
+                return env.Undefined();
+            }
+            compositor = it->second;
+        }
     }
 
-    g_context = new MpvContext();
-
-    if (!g_context->create(config)) {
-        delete g_context;
-        g_context = nullptr;
-        Napi::Error::New(env, "Failed to create mpv context").ThrowAsJavaScriptException();
-        return env.Undefined();
+    auto player = std::make_shared<Player>();
+    if (compositor) {
+        player->compositor = compositor;
+        player->context.attachCompositor(&compositor->compositor);
     }
 
-    return env.Undefined();
+    // Allocated here: V8 memory, JS thread only
+    auto statusBuffer = Napi::ArrayBuffer::New(env, StatusSnapshot::SIZE_BYTES);
+    player->statusBuffer = Napi::Persistent(statusBuffer);
+    player->context.attachStatusSnapshot(statusBuffer.Data());
+
+    auto* worker = new CreateWorker(env, std::move(player), config);
+    Napi::Promise promise = worker->Promise();
+    worker->Queue();
+    return promise;
 }
 
-// Destroy the context
+// Destroy a player
 Napi::Value Destroy(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
-    if (g_context) {
-        g_context->destroy();
-        delete g_context;
-        g_context = nullptr;
-    }
+    auto player = FindPlayer(info);
+    if (!player) return env.Undefined();
+
+    // Joins the player's threads, so nothing can touch the callbacks afterwards
+    player->context.destroy();
 
     // Release thread-safe functions
-    if (g_frameCallback) {
-        g_frameCallback.Release();
-    }
-    if (g_statusCallback) {
-        g_statusCallback.Release();
-    }
-    if (g_errorCallback) {
-        g_errorCallback.Release();
-    }
+    ReleaseCallbacks(player.get());
+    // JS may keep the buffer; nothing writes to it any more
+    player->statusBuffer.Reset();
+    player->frameBuffer.Reset();
 
+    g_players.erase(info[0].As<Napi::Number>().Uint32Value());
     return env.Undefined();
 }
 
@@ -120,50 +366,83 @@ Napi::Value Destroy(const Napi::CallbackInfo& info) {
 Napi::Value Load(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
-    if (!g_context) {
-        Napi::Error::New(env, "Context not initialized").ThrowAsJavaScriptException();
+    auto player = FindPlayer(info);
+    if (!player) {
+        if (!env.IsExceptionPending()) {
+            Napi::Error::New(env, "Context not initialized").ThrowAsJavaScriptException();
+        }
         return env.Undefined();
     }
 
-    if (info.Length() < 1 || !info[0].IsString()) {
+    if (info.Length() < 2 || !info[1].IsString()) {
         Napi::TypeError::New(env, "URL string required").ThrowAsJavaScriptException();
         return env.Undefined();
     }
 
-    std::string url = info[0].As<Napi::String>().Utf8Value();
-    std::string options = info.Length() > 1 && info[1].IsString()
-        ? info[1].As<Napi::String>().Utf8Value() : "";
+    std::string url = info[1].As<Napi::String>().Utf8Value();
+    std::string options = info.Length() > 2 && info[2].IsString()
+        ? info[2].As<Napi::String>().Utf8Value() : "";
+    PlaybackProfile profile = PlaybackProfile::INHERIT;
+    if (info.Length() > 3 && info[3].IsString()) {
+        std::string name = info[3].As<Napi::String>().Utf8Value();
+        if (!parsePlaybackProfile(name, profile)) {
+            Napi::TypeError::New(env, "Unknown playback profile: " + name).ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+    }
+
+    // Settled from the event thread once mpv reports FILE_LOADED / END_FILE.
+    // The TSFN wraps a no-op function; it only exists to hop back to JS.
+    auto deferred = std::make_shared<Napi::Promise::Deferred>(Napi::Promise::Deferred::New(env));
+    auto settle = Napi::ThreadSafeFunction::New(
+        env,
+        Napi::Function::New(env, [](const Napi::CallbackInfo&) {}),
+        "LoadCallback",
+        0,
+        1
+    );
 
-    // Return a promise
-    auto deferred = Napi::Promise::Deferred::New(env);
+    bool queued = player->context.load(url, options, profile, [deferred, settle](bool ok, const std::string& error) mutable {
+        auto callback = [deferred, ok, error](Napi::Env env, Napi::Function) {
+            if (ok) {
+                deferred->Resolve(env.Undefined());
+            } else {
+                deferred->Reject(Napi::Error::New(env, error).Value());
+            }
+        };
+        settle.NonBlockingCall(callback);
+        settle.Release();
+    });
 
-    if (g_context->load(url, options)) {
-        deferred.Resolve(env.Undefined());
-    } else {
-        deferred.Reject(Napi::Error::New(env, "Failed to load URL").Value());
+    if (!queued) {
+        settle.Release();
+        deferred->Reject(Napi::Error::New(env, "Failed to load URL").Value());
     }
 
-    return deferred.Promise();
+    return deferred->Promise();
 }
 
 // Play
 Napi::Value Play(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    if (g_context) g_context->play();
+    auto player = FindPlayer(info);
+    if (player) player->context.play();
     return env.Undefined();
 }
 
 // Pause
 Napi::Value Pause(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    if (g_context) g_context->pause();
+    auto player = FindPlayer(info);
+    if (player) player->context.pause();
     return env.Undefined();
 }
 
 // Stop
 Napi::Value Stop(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    if (g_context) g_context->stop();
+    auto player = FindPlayer(info);
+    if (player) player->context.stop();
     return env.Undefined();
 }
 
@@ -171,32 +450,67 @@ Napi::Value Stop(const Napi::CallbackInfo& info) {
 Napi::Value Seek(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
-    if (!g_context) return env.Undefined();
+    auto player = FindPlayer(info);
+    if (!player) return env.Undefined();
 
-    if (info.Length() < 1 || !info[0].IsNumber()) {
+    if (info.Length() < 2 || !info[1].IsNumber()) {
         Napi::TypeError::New(env, "Position number required").ThrowAsJavaScriptException();
         return env.Undefined();
     }
 
-    double position = info[0].As<Napi::Number>().DoubleValue();
-    g_context->seek(position);
+    double position = info[1].As<Napi::Number>().DoubleValue();
+    player->context.seek(position);
 
     return env.Undefined();
 }
 
+// Buffered window of a (live) stream: { start, end, position, behindLive } or null
+Napi::Value GetTimeshiftRange(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto player = FindPlayer(info);
+    if (!player) return env.Undefined();
+
+    TimeshiftRange range;
+    if (!player->context.timeshiftRange(range)) {
+        return env.Null();
+    }
+    auto obj = Napi::Object::New(env);
+    obj.Set("start", Napi::Number::New(env, range.start));
+    obj.Set("end", Napi::Number::New(env, range.end));
+    obj.Set("position", Napi::Number::New(env, range.position));
+    obj.Set("behindLive", Napi::Number::New(env, std::max(0.0, range.end - range.position)));
+    return obj;
+}
+
+// Seek relative to the live edge: seekLive(handle, secondsBehindLive)
+Napi::Value SeekLive(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto player = FindPlayer(info);
+    if (!player) return env.Undefined();
+
+    if (info.Length() < 2 || !info[1].IsNumber()) {
+        Napi::TypeError::New(env, "Seconds behind live (number) required").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    bool ok = player->context.seekLive(info[1].As<Napi::Number>().DoubleValue());
+    return Napi::Boolean::New(env, ok);
+}
+
 // Set volume
 Napi::Value SetVolume(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
-    if (!g_context) return env.Undefined();
+    auto player = FindPlayer(info);
+    if (!player) return env.Undefined();
 
-    if (info.Length() < 1 || !info[0].IsNumber()) {
+    if (info.Length() < 2 || !info[1].IsNumber()) {
         Napi::TypeError::New(env, "Volume number required").ThrowAsJavaScriptException();
         return env.Undefined();
     }
 
-    double volume = info[0].As<Napi::Number>().DoubleValue();
-    g_context->setVolume(volume);
+    double volume = info[1].As<Napi::Number>().DoubleValue();
+    player->context.setVolume(volume);
 
     return env.Undefined();
 }
@@ -204,7 +518,8 @@ Napi::Value SetVolume(const Napi::CallbackInfo& info) {
 // Toggle mute
 Napi::Value ToggleMute(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    if (g_context) g_context->toggleMute();
+    auto player = FindPlayer(info);
+    if (player) player->context.toggleMute();
     return env.Undefined();
 }
 
@@ -212,90 +527,252 @@ Napi::Value ToggleMute(const Napi::CallbackInfo& info) {
 Napi::Value GetStatus(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
-    if (!g_context) {
+    auto player = FindPlayer(info);
+    if (!player) {
         return env.Undefined();
     }
 
-    MpvStatus status = g_context->getStatus();
+    MpvStatus status = player->context.getStatus();
     return StatusToJS(env, status);
 }
 
+// Convert a latency histogram to JS ({count, mean, max, p50, p95, p99} in us)
+Napi::Object HistogramToJS(Napi::Env env, const LatencyHistogram& histogram) {
+    HistogramSnapshot snap = histogram.snapshot();
+    auto obj = Napi::Object::New(env);
+    obj.Set("count", Napi::Number::New(env, static_cast<double>(snap.count)));
+    obj.Set("mean", Napi::Number::New(env, snap.meanUs));
+    obj.Set("max", Napi::Number::New(env, static_cast<double>(snap.maxUs)));
+    obj.Set("p50", Napi::Number::New(env, static_cast<double>(snap.p50Us)));
+    obj.Set("p95", Napi::Number::New(env, static_cast<double>(snap.p95Us)));
+    obj.Set("p99", Napi::Number::New(env, static_cast<double>(snap.p99Us)));
+    return obj;
+}
+
+// Get render pipeline counters; optional second argument resets them after reading
+Napi::Value GetStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    auto player = FindPlayer(info);
+    if (!player) {
+        return env.Undefined();
+    }
+
+    const RenderStats& stats = player->context.stats();
+    auto counter = [&env](const std::atomic<uint64_t>& value) {
+        return Napi::Number::New(env, static_cast<double>(value.load(std::memory_order_relaxed)));
+    };
+
+    auto obj = Napi::Object::New(env);
+    obj.Set("framesRendered", counter(stats.framesRendered));
+    obj.Set("framesDelivered", counter(stats.framesDelivered));
+    obj.Set("framesDropped", Napi::Number::New(env, static_cast<double>(player->context.framesDropped())));
+    obj.Set("framesSuperseded", counter(stats.framesSuperseded));
+    obj.Set("framesSkipped", counter(stats.framesSkipped));
+    obj.Set("lockFailures", counter(stats.lockFailures));
+    obj.Set("renderFailures", counter(stats.renderFailures));
+    obj.Set("resizes", counter(stats.resizes));
+    obj.Set("lastFirstFrameUs", counter(stats.lastFirstFrameUs));
+    obj.Set("framesPaced", counter(stats.framesPaced));
+    obj.Set("framesLate", counter(stats.framesLate));
+    obj.Set("displayPeriodUs", counter(stats.displayPeriodUs));
+    obj.Set("fastRenderActive", Napi::Boolean::New(env, player->context.fastRenderActive()));
+    obj.Set("updateToRenderUs", HistogramToJS(env, stats.updateToRender));
+    obj.Set("renderUs", HistogramToJS(env, stats.renderCall));
+    obj.Set("gpuUs", HistogramToJS(env, stats.gpuComplete));
+    obj.Set("deliveryUs", HistogramToJS(env, stats.delivery));
+    obj.Set("loadUs", HistogramToJS(env, stats.loadToFileLoaded));
+    obj.Set("firstFrameUs", HistogramToJS(env, stats.timeToFirstFrame));
+
+    if (info.Length() > 1 && info[1].IsBoolean() && info[1].As<Napi::Boolean>().Value()) {
+        player->context.resetStats();
+    }
+    return obj;
+}
+
 // Set frame callback
 Napi::Value OnFrame(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
-    if (!g_context) {
-        Napi::Error::New(env, "Context not initialized").ThrowAsJavaScriptException();
+    auto player = FindPlayer(info);
+    if (!player) {
+        if (!env.IsExceptionPending()) {
+            Napi::Error::New(env, "Context not initialized").ThrowAsJavaScriptException();
+        }
         return env.Undefined();
     }
 
-    if (info.Length() < 1 || !info[0].IsFunction()) {
+    if (info.Length() < 2 || !info[1].IsFunction()) {
         Napi::TypeError::New(env, "Callback function required").ThrowAsJavaScriptException();
         return env.Undefined();
     }
 
-    // Release previous callback if any
-    if (g_frameCallback) {
-        g_frameCallback.Release();
+    // Detach first: the render thread calls the context callback under its
+    // lock, so once this returns nothing uses the functions being released
+    player->context.setFrameCallback(nullptr);
+    if (player->frameCallback) {
+        player->frameCallback.Release();
+    }
+    if (player->frameSignal) {
+        player->frameSignal.Release();
+        player->frameSignal = FrameSignal();
     }
 
-    // Create thread-safe function
-    g_frameCallback = Napi::ThreadSafeFunction::New(
+    // Create thread-safe function. The context's mailbox keeps at most one
+    // delivery outstanding, so the queue never needs more than one entry.
+    player->frameCallback = Napi::ThreadSafeFunction::New(
         env,
-        info[0].As<Napi::Function>(),
+        info[1].As<Napi::Function>(),
         "FrameCallback",
-        0,  // Unlimited queue
+        1,  // Max queue size
         1   // Initial thread count
     );
 
-    // Set callback on context
-    g_context->setFrameCallback([](const TextureInfo& textureInfo) {
-        if (g_frameCallback) {
-            auto callback = [textureInfo](Napi::Env env, Napi::Function jsCallback) {
-                jsCallback.Call({TextureInfoToJS(env, textureInfo)});
-            };
-            g_frameCallback.NonBlockingCall(callback);
+    // Set callback on context. The frame itself is read from the mailbox when
+    // the call runs on the JS thread, so it is always the newest one.
+    Player* raw = player.get();
+    std::weak_ptr<Player> weakPlayer = player;
+    player->context.setFrameCallback([raw, weakPlayer]() {
+        if (!raw->frameCallback) {
+            return false;
+        }
+        auto callback = [weakPlayer](Napi::Env env, Napi::Function jsCallback) {
+            auto self = weakPlayer.lock();
+            if (!self) return;
+
+            TextureInfo textureInfo;
+            uint64_t dropped = 0;
+            if (!self->context.takeFrame(textureInfo, dropped)) {
+                return;  // Invalidated (resize) before it could be delivered
+            }
+            auto obj = TextureInfoToJS(env, textureInfo);
+            obj.Set("dropped", Napi::Number::New(env, static_cast<double>(dropped)));
+            jsCallback.Call({obj});
+        };
+        return raw->frameCallback.NonBlockingCall(callback) == napi_ok;
+    });
+
+    return env.Undefined();
+}
+
+static void CallFrameSignal(Napi::Env env, Napi::Function jsCallback, std::weak_ptr<Player>* context, void*) {
+    if (env == nullptr || jsCallback == nullptr) return;  // Being torn down
+    auto self = context->lock();
+    if (!self) return;
+
+    TextureInfo textureInfo;
+    uint64_t dropped = 0;
+    if (!self->context.takeFrame(textureInfo, dropped)) {
+        return;  // Invalidated (resize) before it could be delivered
+    }
+    self->frameRecord.write(textureInfo, dropped);
+    jsCallback.Call({Napi::Number::New(env, static_cast<double>(textureInfo.seq))});
+}
+
+// Set frame callback, allocation-free: each frame is written into the
+// player's frame record (getFrameBuffer) and the callback only receives its
+// seq. Replaces an onFrame callback, and vice versa.
+Napi::Value OnFrameSignal(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    auto player = FindPlayer(info);
+    if (!player) {
+        if (!env.IsExceptionPending()) {
+            Napi::Error::New(env, "Context not initialized").ThrowAsJavaScriptException();
         }
+        return env.Undefined();
+    }
+
+    if (info.Length() < 2 || !info[1].IsFunction()) {
+        Napi::TypeError::New(env, "Callback function required").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    // Detached before releasing, as in OnFrame
+    player->context.setFrameCallback(nullptr);
+    if (player->frameCallback) {
+        player->frameCallback.Release();
+        player->frameCallback = Napi::ThreadSafeFunction();
+    }
+    if (player->frameSignal) {
+        player->frameSignal.Release();
+    }
+
+    if (player->frameBuffer.IsEmpty()) {
+        // Allocated here: V8 memory, JS thread only
+        auto frameBuffer = Napi::ArrayBuffer::New(env, FrameRecord::SIZE_BYTES);
+        player->frameBuffer = Napi::Persistent(frameBuffer);
+        player->frameRecord.attach(frameBuffer.Data());
+    }
+
+    // One queue entry, as for onFrame (the mailbox keeps one delivery
+    // outstanding). The context is freed with the thread-safe function.
+    player->frameSignal = FrameSignal::New(
+        env,
+        info[1].As<Napi::Function>(),
+        "FrameSignal",
+        1,  // Max queue size
+        1,  // Initial thread count
+        new std::weak_ptr<Player>(player),
+        [](Napi::Env, std::weak_ptr<Player>* context) { delete context; });
+
+    Player* raw = player.get();
+    player->context.setFrameCallback([raw]() {
+        return raw->frameSignal && raw->frameSignal.NonBlockingCall() == napi_ok;
     });
 
     return env.Undefined();
 }
 
+// The frame record written for onFrameSignal (undefined before it is set)
+Napi::Value GetFrameBuffer(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto player = FindPlayer(info);
+    if (!player || player->frameBuffer.IsEmpty()) return env.Undefined();
+    return player->frameBuffer.Value();
+}
+
 // Set status callback
 Napi::Value OnStatus(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
-    if (!g_context) {
-        Napi::Error::New(env, "Context not initialized").ThrowAsJavaScriptException();
+    auto player = FindPlayer(info);
+    if (!player) {
+        if (!env.IsExceptionPending()) {
+            Napi::Error::New(env, "Context not initialized").ThrowAsJavaScriptException();
+        }
         return env.Undefined();
     }
 
-    if (info.Length() < 1 || !info[0].IsFunction()) {
+    if (info.Length() < 2 || !info[1].IsFunction()) {
         Napi::TypeError::New(env, "Callback function required").ThrowAsJavaScriptException();
         return env.Undefined();
     }
 
-    // Release previous callback if any
-    if (g_statusCallback) {
-        g_statusCallback.Release();
+    // Detach, then release the previous callback (see OnFrame)
+    player->context.setStatusCallback(nullptr);
+    if (player->statusCallback) {
+        player->statusCallback.Release();
     }
 
     // Create thread-safe function
-    g_statusCallback = Napi::ThreadSafeFunction::New(
+    player->statusCallback = Napi::ThreadSafeFunction::New(
         env,
-        info[0].As<Napi::Function>(),
+        info[1].As<Napi::Function>(),
         "StatusCallback",
         0,
         1
     );
 
     // Set callback on context
-    g_context->setStatusCallback([](const MpvStatus& status) {
-        if (g_statusCallback) {
-            auto callback = [status](Napi::Env env, Napi::Function jsCallback) {
-                jsCallback.Call({StatusToJS(env, status)});
+    Player* raw = player.get();
+    player->context.setStatusCallback([raw](const MpvStatus& status, uint32_t changed) {
+        if (raw->statusCallback) {
+            // JS only receives the changed fields
+            auto callback = [status, changed](Napi::Env env, Napi::Function jsCallback) {
+                jsCallback.Call({StatusToJS(env, status, changed)});
             };
-            g_statusCallback.NonBlockingCall(callback);
+            raw->statusCallback.NonBlockingCall(callback);
         }
     });
 
@@ -306,54 +783,598 @@ Napi::Value OnStatus(const Napi::CallbackInfo& info) {
 Napi::Value OnError(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
 
-    if (!g_context) {
-        Napi::Error::New(env, "Context not initialized").ThrowAsJavaScriptException();
+    auto player = FindPlayer(info);
+    if (!player) {
+        if (!env.IsExceptionPending()) {
+            Napi::Error::New(env, "Context not initialized").ThrowAsJavaScriptException();
+        }
         return env.Undefined();
     }
 
-    if (info.Length() < 1 || !info[0].IsFunction()) {
+    if (info.Length() < 2 || !info[1].IsFunction()) {
         Napi::TypeError::New(env, "Callback function required").ThrowAsJavaScriptException();
         return env.Undefined();
     }
 
-    // Release previous callback if any
-    if (g_errorCallback) {
-        g_errorCallback.Release();
+    // Detach, then release the previous callback (see OnFrame)
+    player->context.setErrorCallback(nullptr);
+    if (player->errorCallback) {
+        player->errorCallback.Release();
     }
 
     // Create thread-safe function
-    g_errorCallback = Napi::ThreadSafeFunction::New(
+    player->errorCallback = Napi::ThreadSafeFunction::New(
         env,
-        info[0].As<Napi::Function>(),
+        info[1].As<Napi::Function>(),
         "ErrorCallback",
         0,
         1
     );
 
     // Set callback on context
-    g_context->setErrorCallback([](const std::string& error) {
-        if (g_errorCallback) {
+    Player* raw = player.get();
+    player->context.setErrorCallback([raw](const std::string& error) {
+        if (raw->errorCallback) {
             auto callback = [error](Napi::Env env, Napi::Function jsCallback) {
                 jsCallback.Call({Napi::String::New(env, error)});
             };
-            g_errorCallback.NonBlockingCall(callback);
+            raw->errorCallback.NonBlockingCall(callback);
+        }
+    });
+
+    return env.Undefined();
+}
+
+// Set log callback: receives batches of entries as (entries, lost)
+Napi::Value OnLog(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    auto player = FindPlayer(info);
+    if (!player) {
+        if (!env.IsExceptionPending()) {
+            Napi::Error::New(env, "Context not initialized").ThrowAsJavaScriptException();
+        }
+        return env.Undefined();
+    }
+
+    if (info.Length() < 2 || !info[1].IsFunction()) {
+        Napi::TypeError::New(env, "Callback function required").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    // Detach, then release the previous callback (see OnFrame)
+    player->context.setLogCallback(nullptr);
+    if (player->logCallback) {
+        player->logCallback.Release();
+    }
+
+    // At most one drain is outstanding (see MpvContext::notifyLog)
+    player->logCallback = Napi::ThreadSafeFunction::New(
+        env,
+        info[1].As<Napi::Function>(),
+        "LogCallback",
+        1,
+        1
+    );
+
+    // Entries are read from the ring when the call runs, so one call carries
+    // everything logged in the meantime
+    Player* raw = player.get();
+    std::weak_ptr<Player> weakPlayer = player;
+    player->context.setLogCallback([raw, weakPlayer]() {
+        if (!raw->logCallback) {
+            return false;
         }
+        auto callback = [weakPlayer](Napi::Env env, Napi::Function jsCallback) {
+            auto self = weakPlayer.lock();
+            if (!self) return;
+
+            std::vector<LogEntry> entries;
+            uint64_t lost = self->context.drainLog(entries);
+            if (entries.empty() && lost == 0) return;
+            jsCallback.Call({LogEntriesToJS(env, entries), Napi::Number::New(env, static_cast<double>(lost))});
+        };
+        return raw->logCallback.NonBlockingCall(callback) == napi_ok;
     });
 
     return env.Undefined();
 }
 
-// Release current frame
+// Set per-module log levels (msg-level syntax)
+Napi::Value SetLogLevels(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto player = FindPlayer(info);
+    if (!player) return env.Undefined();
+
+    if (info.Length() < 2 || !info[1].IsString()) {
+        Napi::TypeError::New(env, "Log level spec (string) required").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    std::string spec = info[1].As<Napi::String>().Utf8Value();
+    if (!player->context.setLogLevels(spec)) {
+        Napi::RangeError::New(env, "Invalid log level spec: " + spec).ThrowAsJavaScriptException();
+    }
+    return env.Undefined();
+}
+
+// Retained log history, oldest first
+Napi::Value DumpLog(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto player = FindPlayer(info);
+    if (!player) return env.Undefined();
+
+    std::vector<LogEntry> entries;
+    player->context.dumpLog(entries);
+    return LogEntriesToJS(env, entries);
+}
+
+// Turn the per-frame latency trace on or off
+Napi::Value SetTrace(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto player = FindPlayer(info);
+    if (!player) return env.Undefined();
+
+    if (info.Length() < 2 || !info[1].IsBoolean()) {
+        Napi::TypeError::New(env, "Trace flag (boolean) required").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    player->context.setTrace(info[1].As<Napi::Boolean>().Value());
+    return env.Undefined();
+}
+
+// Retained trace events, oldest first. Times stay on the native clock
+// (microseconds) so they line up with TextureInfo's timeline fields.
+Napi::Value DumpTrace(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto player = FindPlayer(info);
+    if (!player) return env.Undefined();
+
+    std::vector<TraceRecord> records;
+    player->context.dumpTrace(records);
+
+    auto array = Napi::Array::New(env, records.size());
+    for (size_t i = 0; i < records.size(); i++) {
+        const TraceRecord& record = records[i];
+        const char* stage = "render";
+        switch (record.stage) {
+            case TraceStage::GPU: stage = "gpu"; break;
+            case TraceStage::DELIVER: stage = "deliver"; break;
+            case TraceStage::HOLD: stage = "hold"; break;
+            case TraceStage::DROP: stage = "drop"; break;
+            case TraceStage::PRESENT: stage = "present"; break;
+            default: break;
+        }
+        auto obj = Napi::Object::New(env);
+        obj.Set("stage", Napi::String::New(env, stage));
+        obj.Set("seq", Napi::Number::New(env, static_cast<double>(record.frame)));
+        obj.Set("startUs", Napi::Number::New(env, static_cast<double>(record.startUs)));
+        obj.Set("endUs", Napi::Number::New(env, static_cast<double>(record.endUs)));
+        obj.Set("pts", std::isnan(record.pts) ? env.Null() : Napi::Number::New(env, record.pts));
+        array.Set(static_cast<uint32_t>(i), obj);
+    }
+    return array;
+}
+
+// Optional export generation after the handle (0 = the handle's current export)
+static uint64_t GenerationArg(const Napi::CallbackInfo& info, size_t index) {
+    if (info.Length() > index && info[index].IsNumber()) {
+        return static_cast<uint64_t>(info[index].As<Napi::Number>().DoubleValue());
+    }
+    return 0;
+}
+
+// Release a delivered frame's texture slot: releaseFrame(handle, textureHandle, generation?)
 Napi::Value ReleaseFrame(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    if (g_context) g_context->releaseFrame();
+    auto player = FindPlayer(info);
+    if (!player) return env.Undefined();
+
+    // A number comes from the frame record (exact: see FrameRecord)
+    uint64_t handle;
+    if (info.Length() >= 2 && info[1].IsBigInt()) {
+        bool lossless = false;
+        handle = info[1].As<Napi::BigInt>().Uint64Value(&lossless);
+    } else if (info.Length() >= 2 && info[1].IsNumber()) {
+        handle = static_cast<uint64_t>(info[1].As<Napi::Number>().DoubleValue());
+    } else {
+        Napi::TypeError::New(env, "Texture handle (bigint or number) required").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    player->context.releaseFrame(handle, GenerationArg(info, 2));
+    return env.Undefined();
+}
+
+// Hide / unhide a player (standby players pre-open streams for zapping)
+Napi::Value SetStandby(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto player = FindPlayer(info);
+    if (!player) return env.Undefined();
+
+    if (info.Length() < 2 || !info[1].IsBoolean()) {
+        Napi::TypeError::New(env, "Standby flag (boolean) required").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    player->context.setStandby(info[1].As<Napi::Boolean>().Value());
+    return env.Undefined();
+}
+
+// Deliver subtitles as status text instead of drawing them into the video
+Napi::Value SetSubtitleOverlay(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto player = FindPlayer(info);
+    if (!player) return env.Undefined();
+
+    if (info.Length() < 2 || !info[1].IsBoolean()) {
+        Napi::TypeError::New(env, "Overlay flag (boolean) required").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    player->context.setSubtitleOverlay(info[1].As<Napi::Boolean>().Value());
+    return env.Undefined();
+}
+
+Napi::Value SetFastRender(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto player = FindPlayer(info);
+    if (!player) return env.Undefined();
+
+    if (info.Length() < 2 || !info[1].IsBoolean()) {
+        Napi::TypeError::New(env, "Fast render flag (boolean) required").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    player->context.setFastRender(info[1].As<Napi::Boolean>().Value());
+    return env.Undefined();
+}
+
+// Scale rendering down while off screen: setRenderMode(handle, mode, dropVideo?)
+Napi::Value SetRenderMode(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto player = FindPlayer(info);
+    if (!player) return env.Undefined();
+
+    if (info.Length() < 2 || !info[1].IsString()) {
+        Napi::TypeError::New(env, "Render mode (string) required").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    std::string name = info[1].As<Napi::String>().Utf8Value();
+    RenderMode mode;
+    if (!parseRenderMode(name, mode)) {
+        Napi::TypeError::New(env, "Unknown render mode: " + name).ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+    bool dropVideo = info.Length() > 2 && info[2].IsBoolean() && info[2].As<Napi::Boolean>().Value();
+    player->context.setRenderMode(mode, dropVideo);
+    return env.Undefined();
+}
+
+// Bring a standby player on air
+Napi::Value Promote(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto player = FindPlayer(info);
+    if (player) player->context.promote();
+    return env.Undefined();
+}
+
+// Size the shared texture to the presentation size (0x0 = follow the video)
+Napi::Value SetOutputSize(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto player = FindPlayer(info);
+    if (!player) return env.Undefined();
+
+    if (info.Length() < 3 || !info[1].IsNumber() || !info[2].IsNumber()) {
+        Napi::TypeError::New(env, "Width and height (numbers) required").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    int32_t width = info[1].As<Napi::Number>().Int32Value();
+    int32_t height = info[2].As<Napi::Number>().Int32Value();
+    if (width < 0 || height < 0) {
+        Napi::RangeError::New(env, "Output size must not be negative").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    player->context.setOutputSize(static_cast<uint32_t>(width), static_cast<uint32_t>(height));
+    return env.Undefined();
+}
+
+// Largest thumbnail side accepted (readback memory is width * height * 4)
+static const int32_t MAX_THUMBNAIL_SIZE = 4096;
+
+// Capture the current picture as RGBA, resolved once the GPU readback lands
+Napi::Value CaptureThumbnail(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    auto player = FindPlayer(info);
+    if (!player) {
+        if (!env.IsExceptionPending()) {
+            Napi::Error::New(env, "Context not initialized").ThrowAsJavaScriptException();
+        }
+        return env.Undefined();
+    }
+
+    if (info.Length() < 3 || !info[1].IsNumber() || !info[2].IsNumber()) {
+        Napi::TypeError::New(env, "Width and height (numbers) required").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    int32_t width = info[1].As<Napi::Number>().Int32Value();
+    int32_t height = info[2].As<Napi::Number>().Int32Value();
+    if (width < 0 || height < 0 || width > MAX_THUMBNAIL_SIZE || height > MAX_THUMBNAIL_SIZE ||
+        (width == 0 && height == 0)) {
+        Napi::RangeError::New(env, "Thumbnail size out of range").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    // Settled from the render thread, like load()
+    auto deferred = std::make_shared<Napi::Promise::Deferred>(Napi::Promise::Deferred::New(env));
+    auto settle = Napi::ThreadSafeFunction::New(
+        env,
+        Napi::Function::New(env, [](const Napi::CallbackInfo&) {}),
+        "ThumbnailCallback",
+        0,
+        1
+    );
+
+    bool queued = player->context.captureThumbnail(
+        static_cast<uint32_t>(width), static_cast<uint32_t>(height),
+        [deferred, settle](bool ok, const std::string& error, ThumbnailImage&& image) mutable {
+            auto result = std::make_shared<ThumbnailImage>(std::move(image));
+            auto callback = [deferred, ok, error, result](Napi::Env env, Napi::Function) {
+                if (!ok) {
+                    deferred->Reject(Napi::Error::New(env, error).Value());
+                    return;
+                }
+                auto obj = Napi::Object::New(env);
+                obj.Set("width", Napi::Number::New(env, result->width));
+                obj.Set("height", Napi::Number::New(env, result->height));
+                // Copied: Electron does not allow external (native-owned) buffers
+                obj.Set("data", Napi::Buffer<uint8_t>::Copy(env, result->rgba.data(), result->rgba.size()));
+                deferred->Resolve(obj);
+            };
+            settle.NonBlockingCall(callback);
+            settle.Release();
+        });
+
+    if (!queued) {
+        settle.Release();
+        deferred->Reject(Napi::Error::New(env, "Failed to queue thumbnail capture").Value());
+    }
+
+    return deferred->Promise();
+}
+
+// Presentation feedback: a frame reached the screen ageUs ago
+Napi::Value ReportPresentation(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto player = FindPlayer(info);
+    if (!player) return env.Undefined();
+
+    if (info.Length() < 2 || !info[1].IsNumber()) {
+        Napi::TypeError::New(env, "Presentation age (number) required").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    double ageUs = info[1].As<Napi::Number>().DoubleValue();
+    player->context.reportPresentation(ageUs > 0 ? static_cast<uint64_t>(ageUs) : 0);
     return env.Undefined();
 }
 
+// The player's shared status snapshot (see StatusSnapshot for the layout)
+Napi::Value GetStatusBuffer(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto player = FindPlayer(info);
+    if (!player || player->statusBuffer.IsEmpty()) return env.Undefined();
+    return player->statusBuffer.Value();
+}
+
 // Check if initialized
 Napi::Value IsInitialized(const Napi::CallbackInfo& info) {
     Napi::Env env = info.Env();
-    return Napi::Boolean::New(env, g_context && g_context->isInitialized());
+    auto player = FindPlayer(info);
+    return Napi::Boolean::New(env, player && player->context.isInitialized());
+}
+
+// Create a multiview compositor: { width, height, maxFps }
+Napi::Value CreateCompositor(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    CompositorConfig config;
+    if (info.Length() > 0 && info[0].IsObject()) {
+        auto configObj = info[0].As<Napi::Object>();
+        if (configObj.Has("width")) {
+            config.width = configObj.Get("width").As<Napi::Number>().Uint32Value();
+        }
+        if (configObj.Has("height")) {
+            config.height = configObj.Get("height").As<Napi::Number>().Uint32Value();
+        }
+        if (configObj.Has("maxFps")) {
+            config.maxFps = configObj.Get("maxFps").As<Napi::Number>().Uint32Value();
+        }
+    }
+    if (config.width == 0 || config.height == 0) {
+        Napi::RangeError::New(env, "Compositor size must be non-zero").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    auto entry = std::make_shared<CompositorEntry>();
+    if (!entry->compositor.create(config)) {
+        Napi::Error::New(env, "Failed to create compositor").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    uint32_t handle = g_nextCompositorHandle++;
+    g_compositors.emplace(handle, std::move(entry));
+    return Napi::Number::New(env, handle);
+}
+
+// Destroy a compositor. Players attached to it stop showing anywhere but
+// keep playing until destroyed themselves.
+Napi::Value DestroyCompositor(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto entry = FindCompositor(info);
+    if (!entry) return env.Undefined();
+
+    // Joins the compositor thread, so the callback is unused afterwards
+    entry->compositor.destroy();
+    if (entry->frameCallback) {
+        entry->frameCallback.Release();
+    }
+
+    g_compositors.erase(info[0].As<Napi::Number>().Uint32Value());
+    return env.Undefined();
+}
+
+// Replace the layout: [{ player, x, y, width, height }], player handles
+// that were created with this compositor
+Napi::Value CompositorSetLayout(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto entry = FindCompositor(info);
+    if (!entry) return env.Undefined();
+
+    if (info.Length() < 2 || !info[1].IsArray()) {
+        Napi::TypeError::New(env, "Tile array required").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    auto array = info[1].As<Napi::Array>();
+    std::vector<CompositorTile> tiles;
+    tiles.reserve(array.Length());
+    for (uint32_t i = 0; i < array.Length(); i++) {
+        Napi::Value value = array.Get(i);
+        if (!value.IsObject()) {
+            Napi::TypeError::New(env, "Tile must be an object").ThrowAsJavaScriptException();
+            return env.Undefined();
+        }
+        auto tileObj = value.As<Napi::Object>();
+        for (const char* field : {"player", "x", "y", "width", "height"}) {
+            if (!tileObj.Get(field).IsNumber()) {
+                Napi::TypeError::New(env, std::string("Tile ") + field + " must be a number")
+                    .ThrowAsJavaScriptException();
+                return env.Undefined();
+            }
+        }
+        uint32_t id = tileObj.Get("player").As<Napi::Number>().Uint32Value();
+        auto player = g_players.find(id);
+        if (player == g_players.end() || player->second->compositor != entry) {
+            continue;
+        }
+        CompositorTile tile;
+        tile.id = id;
+        tile.player = &player->second->context;
+        tile.x = tileObj.Get("x").As<Napi::Number>().Uint32Value();
+        tile.y = tileObj.Get("y").As<Napi::Number>().Uint32Value();
+        tile.width = tileObj.Get("width").As<Napi::Number>().Uint32Value();
+        tile.height = tileObj.Get("height").As<Napi::Number>().Uint32Value();
+        tiles.push_back(tile);
+    }
+
+    entry->compositor.setLayout(tiles);
+    return env.Undefined();
+}
+
+// Set the atlas frame callback (same delivery contract as OnFrame)
+Napi::Value CompositorOnFrame(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+
+    auto entry = FindCompositor(info);
+    if (!entry) {
+        if (!env.IsExceptionPending()) {
+            Napi::Error::New(env, "Compositor not initialized").ThrowAsJavaScriptException();
+        }
+        return env.Undefined();
+    }
+
+    if (info.Length() < 2 || !info[1].IsFunction()) {
+        Napi::TypeError::New(env, "Callback function required").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    // Detach, then release the previous callback (see OnFrame)
+    entry->compositor.setFrameCallback(nullptr);
+    if (entry->frameCallback) {
+        entry->frameCallback.Release();
+    }
+    entry->frameCallback = Napi::ThreadSafeFunction::New(
+        env,
+        info[1].As<Napi::Function>(),
+        "CompositorFrameCallback",
+        1,  // Max queue size
+        1   // Initial thread count
+    );
+
+    CompositorEntry* raw = entry.get();
+    std::weak_ptr<CompositorEntry> weakEntry = entry;
+    entry->compositor.setFrameCallback([raw, weakEntry]() {
+        if (!raw->frameCallback) {
+            return false;
+        }
+        auto callback = [weakEntry](Napi::Env env, Napi::Function jsCallback) {
+            auto self = weakEntry.lock();
+            if (!self) return;
+
+            TextureInfo textureInfo;
+            uint64_t dropped = 0;
+            std::vector<TileFrame> tiles;
+            if (!self->compositor.takeFrame(textureInfo, dropped, tiles)) {
+                return;
+            }
+            auto obj = TextureInfoToJS(env, textureInfo);
+            obj.Set("dropped", Napi::Number::New(env, static_cast<double>(dropped)));
+
+            auto tileArray = Napi::Array::New(env, tiles.size());
+            for (size_t i = 0; i < tiles.size(); i++) {
+                const TileFrame& tile = tiles[i];
+                auto tileObj = Napi::Object::New(env);
+                tileObj.Set("player", Napi::Number::New(env, tile.id));
+                tileObj.Set("x", Napi::Number::New(env, tile.x));
+                tileObj.Set("y", Napi::Number::New(env, tile.y));
+                tileObj.Set("width", Napi::Number::New(env, tile.width));
+                tileObj.Set("height", Napi::Number::New(env, tile.height));
+                tileObj.Set("seq", Napi::Number::New(env, static_cast<double>(tile.seq)));
+                tileObj.Set("pts", std::isnan(tile.pts) ? env.Null() : Napi::Number::New(env, tile.pts));
+                tileArray.Set(static_cast<uint32_t>(i), tileObj);
+            }
+            obj.Set("tiles", tileArray);
+            jsCallback.Call({obj});
+        };
+        return raw->frameCallback.NonBlockingCall(callback) == napi_ok;
+    });
+
+    return env.Undefined();
+}
+
+// Return an atlas frame's slot (the consumer imported and drew it)
+Napi::Value CompositorReleaseFrame(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto entry = FindCompositor(info);
+    if (!entry) return env.Undefined();
+
+    if (info.Length() < 2 || !info[1].IsBigInt()) {
+        Napi::TypeError::New(env, "Texture handle (bigint) required").ThrowAsJavaScriptException();
+        return env.Undefined();
+    }
+
+    bool lossless = false;
+    uint64_t handle = info[1].As<Napi::BigInt>().Uint64Value(&lossless);
+    entry->compositor.releaseFrame(handle, GenerationArg(info, 2));
+    return env.Undefined();
+}
+
+// Compositor counters: { framesComposited, lockFailures }
+Napi::Value CompositorGetStats(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    auto entry = FindCompositor(info);
+    if (!entry) return env.Undefined();
+
+    auto obj = Napi::Object::New(env);
+    obj.Set("framesComposited", Napi::Number::New(env, static_cast<double>(entry->compositor.framesComposited())));
+    obj.Set("lockFailures", Napi::Number::New(env, static_cast<double>(entry->compositor.lockFailures())));
+    return obj;
 }
 
 // Module initialization
@@ -365,14 +1386,39 @@ Napi::Object Init(Napi::Env env, Napi::Object exports) {
     exports.Set("pause", Napi::Function::New(env, Pause));
     exports.Set("stop", Napi::Function::New(env, Stop));
     exports.Set("seek", Napi::Function::New(env, Seek));
+    exports.Set("timeshiftRange", Napi::Function::New(env, GetTimeshiftRange));
+    exports.Set("seekLive", Napi::Function::New(env, SeekLive));
     exports.Set("setVolume", Napi::Function::New(env, SetVolume));
     exports.Set("toggleMute", Napi::Function::New(env, ToggleMute));
     exports.Set("getStatus", Napi::Function::New(env, GetStatus));
+    exports.Set("getStats", Napi::Function::New(env, GetStats));
+    exports.Set("getStatusBuffer", Napi::Function::New(env, GetStatusBuffer));
+    exports.Set("onFrameSignal", Napi::Function::New(env, OnFrameSignal));
+    exports.Set("getFrameBuffer", Napi::Function::New(env, GetFrameBuffer));
     exports.Set("onFrame", Napi::Function::New(env, OnFrame));
     exports.Set("onStatus", Napi::Function::New(env, OnStatus));
     exports.Set("onError", Napi::Function::New(env, OnError));
+    exports.Set("onLog", Napi::Function::New(env, OnLog));
+    exports.Set("setLogLevels", Napi::Function::New(env, SetLogLevels));
+    exports.Set("dumpLog", Napi::Function::New(env, DumpLog));
+    exports.Set("setTrace", Napi::Function::New(env, SetTrace));
+    exports.Set("dumpTrace", Napi::Function::New(env, DumpTrace));
     exports.Set("releaseFrame", Napi::Function::New(env, ReleaseFrame));
+    exports.Set("setStandby", Napi::Function::New(env, SetStandby));
+    exports.Set("setRenderMode", Napi::Function::New(env, SetRenderMode));
+    exports.Set("setSubtitleOverlay", Napi::Function::New(env, SetSubtitleOverlay));
+    exports.Set("setFastRender", Napi::Function::New(env, SetFastRender));
+    exports.Set("promote", Napi::Function::New(env, Promote));
+    exports.Set("setOutputSize", Napi::Function::New(env, SetOutputSize));
+    exports.Set("captureThumbnail", Napi::Function::New(env, CaptureThumbnail));
+    exports.Set("reportPresentation", Napi::Function::New(env, ReportPresentation));
     exports.Set("isInitialized", Napi::Function::New(env, IsInitialized));
+    exports.Set("createCompositor", Napi::Function::New(env, CreateCompositor));
+    exports.Set("destroyCompositor", Napi::Function::New(env, DestroyCompositor));
+    exports.Set("compositorSetLayout", Napi::Function::New(env, CompositorSetLayout));
+    exports.Set("compositorOnFrame", Napi::Function::New(env, CompositorOnFrame));
+    exports.Set("compositorReleaseFrame", Napi::Function::New(env, CompositorReleaseFrame));
+    exports.Set("compositorGetStats", Napi::Function::New(env, CompositorGetStats));
 
     return exports;
 }
@@ -0,0 +1,479 @@
+/*
+ * Headless render pipeline benchmark (pipeline_bench)
+ *
+ * Drives MpvContext the way the addon does, minus JS: a consumer thread
+ * takes every exported frame and releases it straight away. The source is a
+ * lavfi test pattern, so runs are reproducible on any machine and need no
+ * network. One JSON report is printed to stdout; mpv's own messages go to
+ * stderr.
+ *
+ *   pipeline_bench [--width 1920] [--height 1080] [--fps 60] [--seconds 10]
+ *                  [--warmup 2] [--untimed] [--hwdec no] [--yuv]
+ *                  [--profile default] [--resizes 10] [--zaps 5]
+ *
+ * --untimed renders as fast as the pipeline allows instead of at --fps, for
+ * throughput rather than pacing. Frame times and resize latencies are exact
+ * percentiles; the pipeline's own histograms (see RenderStats) have
+ * power-of-two resolution. Built only with -Dbuild_benchmark=1.
+ */
+
+#include "../mpv_context.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#include <sys/time.h>
+#endif
+
+using namespace mpv_texture;
+
+namespace {
+
+// Longest wait for a load, a resize or a zap before the run is failed
+const uint64_t STEP_TIMEOUT_US = 10000000;
+// Frames shown after a resize / zap before the next one starts
+const uint32_t SETTLE_FRAMES = 10;
+
+struct Options {
+    uint32_t width = 1920;
+    uint32_t height = 1080;
+    uint32_t fps = 60;
+    double seconds = 10;
+    double warmup = 2;
+    bool untimed = false;
+    std::string hwdec = "no";  // lavfi decodes nothing; keeps runs comparable
+    bool yuv = false;
+    PlaybackProfile profile = PlaybackProfile::DEFAULT;
+    uint32_t resizes = 10;
+    uint32_t zaps = 5;
+};
+
+bool parseOptions(int argc, char** argv, Options& out, std::string& error) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&](const char*& v) {
+            if (i + 1 >= argc) {
+                error = arg + " needs a value";
+                return false;
+            }
+            v = argv[++i];
+            return true;
+        };
+        const char* v = nullptr;
+        if (arg == "--untimed") {
+            out.untimed = true;
+        } else if (arg == "--yuv") {
+            out.yuv = true;
+        } else if (arg == "--width") {
+            if (!value(v)) return false;
+            out.width = static_cast<uint32_t>(std::strtoul(v, nullptr, 10));
+        } else if (arg == "--height") {
+            if (!value(v)) return false;
+            out.height = static_cast<uint32_t>(std::strtoul(v, nullptr, 10));
+        } else if (arg == "--fps") {
+            if (!value(v)) return false;
+            out.fps = static_cast<uint32_t>(std::strtoul(v, nullptr, 10));
+        } else if (arg == "--seconds") {
+            if (!value(v)) return false;
+            out.seconds = std::strtod(v, nullptr);
+        } else if (arg == "--warmup") {
+            if (!value(v)) return false;
+            out.warmup = std::strtod(v, nullptr);
+        } else if (arg == "--hwdec") {
+            if (!value(v)) return false;
+            out.hwdec = v;
+        } else if (arg == "--profile") {
+            if (!value(v)) return false;
+            if (!parsePlaybackProfile(v, out.profile)) {
+                error = std::string("Unknown profile ") + v;
+                return false;
+            }
+        } else if (arg == "--resizes") {
+            if (!value(v)) return false;
+            out.resizes = static_cast<uint32_t>(std::strtoul(v, nullptr, 10));
+        } else if (arg == "--zaps") {
+            if (!value(v)) return false;
+            out.zaps = static_cast<uint32_t>(std::strtoul(v, nullptr, 10));
+        } else {
+            error = "Unknown argument " + arg;
+            return false;
+        }
+    }
+    if (out.width < 16 || out.height < 16 || out.fps == 0 || out.seconds <= 0) {
+        error = "Invalid size, fps or duration";
+        return false;
+    }
+    return true;
+}
+
+// User + kernel time of the whole process (mpv's threads included)
+double processCpuSeconds() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return 0;
+    }
+    auto seconds = [](const FILETIME& t) {
+        ULARGE_INTEGER value;
+        value.LowPart = t.dwLowDateTime;
+        value.HighPart = t.dwHighDateTime;
+        return static_cast<double>(value.QuadPart) / 1e7;  // 100 ns units
+    };
+    return seconds(kernel) + seconds(user);
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    auto seconds = [](const timeval& t) { return t.tv_sec + t.tv_usec / 1e6; };
+    return seconds(usage.ru_utime) + seconds(usage.ru_stime);
+#endif
+}
+
+std::string lavfiUrl(const char* source, const Options& options) {
+    char url[256];
+    std::snprintf(url, sizeof(url), "av://lavfi:%s=size=%ux%u:rate=%u", source,
+                  options.width, options.height, options.fps);
+    return url;
+}
+
+// Takes and releases every frame, standing in for the JS consumer
+class FrameConsumer {
+public:
+    explicit FrameConsumer(MpvContext& context) : m_context(context) {}
+
+    void start() {
+        m_running = true;
+        m_thread = std::thread([this] { run(); });
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_running = false;
+        }
+        m_cv.notify_one();
+        if (m_thread.joinable()) m_thread.join();
+    }
+
+    // Frame callback: only wakes the consumer thread
+    bool notify() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_pending = true;
+        }
+        m_cv.notify_one();
+        return true;
+    }
+
+    // Delivery timestamps of the frames taken while recording
+    void record(bool on) {
+        std::lock_guard<std::mutex> lock(m_recordMutex);
+        if (on) m_times.clear();
+        m_recording = on;
+    }
+
+    std::vector<uint64_t> recorded() {
+        std::lock_guard<std::mutex> lock(m_recordMutex);
+        return m_times;
+    }
+
+    uint64_t frames() const { return m_frames.load(std::memory_order_acquire); }
+    uint32_t width() const { return m_width.load(std::memory_order_acquire); }
+    uint32_t height() const { return m_height.load(std::memory_order_acquire); }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (m_running) {
+            m_cv.wait_for(lock, std::chrono::milliseconds(50), [this] { return m_pending || !m_running; });
+            m_pending = false;
+            lock.unlock();
+
+            TextureInfo info;
+            uint64_t dropped = 0;
+            while (m_context.takeFrame(info, dropped)) {
+                uint64_t now = nowUs();
+                m_width.store(info.width, std::memory_order_release);
+                m_height.store(info.height, std::memory_order_release);
+                {
+                    std::lock_guard<std::mutex> recordLock(m_recordMutex);
+                    if (m_recording) m_times.push_back(now);
+                }
+                m_context.releaseFrame(info.handle, info.generation);
+                m_frames.fetch_add(1, std::memory_order_acq_rel);
+            }
+            lock.lock();
+        }
+    }
+
+    MpvContext& m_context;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_running = false;
+    bool m_pending = false;
+
+    std::mutex m_recordMutex;
+    bool m_recording = false;
+    std::vector<uint64_t> m_times;
+
+    std::atomic<uint64_t> m_frames{0};
+    std::atomic<uint32_t> m_width{0};
+    std::atomic<uint32_t> m_height{0};
+};
+
+template <typename Predicate>
+bool waitUntil(Predicate done, uint64_t timeoutUs = STEP_TIMEOUT_US) {
+    uint64_t deadline = nowUs() + timeoutUs;
+    while (!done()) {
+        if (nowUs() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+void sleepSeconds(double seconds) {
+    std::this_thread::sleep_for(std::chrono::microseconds(static_cast<uint64_t>(seconds * 1e6)));
+}
+
+// Blocking load: true once mpv reports the file loaded
+bool loadAndWait(MpvContext& context, const std::string& url, const std::string& options, std::string& error) {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool settled = false;
+    bool ok = false;
+    bool queued = context.load(url, options, PlaybackProfile::INHERIT, [&](bool success, const std::string& reason) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            settled = true;
+            ok = success;
+            if (!success) error = reason;
+        }
+        cv.notify_one();
+    });
+    if (!queued) {
+        error = "Failed to queue load";
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    if (!cv.wait_for(lock, std::chrono::microseconds(STEP_TIMEOUT_US), [&] { return settled; })) {
+        // The callback still references our locals; wait it out
+        cv.wait(lock, [&] { return settled; });
+        error = "Load timed out";
+        return false;
+    }
+    return ok;
+}
+
+uint64_t percentile(const std::vector<uint64_t>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// Exact percentiles of collected samples, in the same shape as a histogram
+void printSamples(const char* name, std::vector<uint64_t> samples, bool last = false) {
+    std::sort(samples.begin(), samples.end());
+    double mean = 0;
+    for (uint64_t s : samples) mean += static_cast<double>(s);
+    if (!samples.empty()) mean /= samples.size();
+    std::printf("    \"%s\": {\"count\": %zu, \"mean\": %.1f, \"p50\": %llu, \"p95\": %llu, \"p99\": %llu, \"max\": %llu}%s\n",
+                name, samples.size(), mean,
+                static_cast<unsigned long long>(percentile(samples, 0.50)),
+                static_cast<unsigned long long>(percentile(samples, 0.95)),
+                static_cast<unsigned long long>(percentile(samples, 0.99)),
+                static_cast<unsigned long long>(samples.empty() ? 0 : samples.back()),
+                last ? "" : ",");
+}
+
+void printHistogram(const char* name, const LatencyHistogram& histogram, bool last = false) {
+    HistogramSnapshot snap = histogram.snapshot();
+    std::printf("    \"%s\": {\"count\": %llu, \"mean\": %.1f, \"p50\": %llu, \"p95\": %llu, \"p99\": %llu, \"max\": %llu}%s\n",
+                name, static_cast<unsigned long long>(snap.count), snap.meanUs,
+                static_cast<unsigned long long>(snap.p50Us), static_cast<unsigned long long>(snap.p95Us),
+                static_cast<unsigned long long>(snap.p99Us), static_cast<unsigned long long>(snap.maxUs),
+                last ? "" : ",");
+}
+
+// Message as the contents of a JSON string (control characters dropped)
+std::string jsonEscape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20) escaped += c;
+    }
+    return escaped;
+}
+
+int fail(const std::string& error) {
+    std::printf("{\"error\": \"%s\"}\n", jsonEscape(error).c_str());
+    return 1;
+}
+
+const char* backendName() {
+#ifdef _WIN32
+    return "dxgi";
+#elif defined(__APPLE__)
+    return "iosurface";
+#else
+    return "dmabuf";
+#endif
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    std::string error;
+    if (!parseOptions(argc, argv, options, error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return 2;
+    }
+
+    MpvConfig config;
+    config.width = options.width;
+    config.height = options.height;
+    config.hwdec = options.hwdec;
+    config.yuvExport = options.yuv;
+    config.profile = options.profile;
+    config.logLevels = "all=warn";
+
+    MpvContext context;
+    FrameConsumer consumer(context);
+    context.setFrameCallback([&consumer] { return consumer.notify(); });
+    context.setErrorCallback([](const std::string& message) {
+        std::fprintf(stderr, "[pipeline_bench] %s\n", message.c_str());
+    });
+    if (!context.create(config)) {
+        return fail("Failed to create mpv context");
+    }
+    consumer.start();
+
+    const std::string fileOptions = options.untimed ? "untimed=yes" : "";
+    const std::string sources[] = { lavfiUrl("testsrc2", options), lavfiUrl("smptehdbars", options) };
+
+    auto finish = [&](int code) {
+        consumer.stop();
+        context.destroy();
+        return code;
+    };
+
+    // ── Steady state ──
+    if (!loadAndWait(context, sources[0], fileOptions, error)) {
+        finish(1);
+        return fail(error);
+    }
+    if (!waitUntil([&] { return consumer.frames() > 0; })) {
+        finish(1);
+        return fail("No frame after load");
+    }
+    sleepSeconds(options.warmup);
+
+    context.resetStats();
+    consumer.record(true);
+    double cpuStart = processCpuSeconds();
+    uint64_t start = nowUs();
+    sleepSeconds(options.seconds);
+    uint64_t elapsedUs = nowUs() - start;
+    double cpuSeconds = processCpuSeconds() - cpuStart;
+    consumer.record(false);
+
+    std::vector<uint64_t> times = consumer.recorded();
+    std::vector<uint64_t> frameTimes;
+    for (size_t i = 1; i < times.size(); i++) {
+        frameTimes.push_back(times[i] - times[i - 1]);
+    }
+    const RenderStats& stats = context.stats();
+    uint64_t rendered = stats.framesRendered.load(std::memory_order_relaxed);
+    uint64_t delivered = stats.framesDelivered.load(std::memory_order_relaxed);
+    uint64_t superseded = stats.framesSuperseded.load(std::memory_order_relaxed);
+    uint64_t lockFailures = stats.lockFailures.load(std::memory_order_relaxed);
+    uint64_t renderFailures = stats.renderFailures.load(std::memory_order_relaxed);
+    uint64_t dropped = context.framesDropped();
+
+    // Percentiles of the steady-state phase, before resizes / zaps add theirs
+    std::printf("{\n");
+    std::printf("  \"backend\": \"%s\",\n", backendName());
+    std::printf("  \"source\": {\"width\": %u, \"height\": %u, \"fps\": %u, \"untimed\": %s, \"hwdec\": \"%s\", \"yuvExport\": %s},\n",
+                options.width, options.height, options.fps, options.untimed ? "true" : "false",
+                options.hwdec.c_str(), options.yuv ? "true" : "false");
+    std::printf("  \"steady\": {\n");
+    std::printf("    \"seconds\": %.3f,\n", elapsedUs / 1e6);
+    std::printf("    \"fps\": %.2f,\n", times.size() / (elapsedUs / 1e6));
+    std::printf("    \"cpuUsPerFrame\": %.1f,\n", times.empty() ? 0.0 : cpuSeconds * 1e6 / times.size());
+    std::printf("    \"cpuPercent\": %.1f,\n", cpuSeconds * 1e8 / elapsedUs);
+    std::printf("    \"framesRendered\": %llu,\n", static_cast<unsigned long long>(rendered));
+    std::printf("    \"framesDelivered\": %llu,\n", static_cast<unsigned long long>(delivered));
+    std::printf("    \"framesDropped\": %llu,\n", static_cast<unsigned long long>(dropped));
+    std::printf("    \"framesSuperseded\": %llu,\n", static_cast<unsigned long long>(superseded));
+    std::printf("    \"lockFailures\": %llu,\n", static_cast<unsigned long long>(lockFailures));
+    std::printf("    \"renderFailures\": %llu,\n", static_cast<unsigned long long>(renderFailures));
+    printSamples("frameTimeUs", frameTimes);
+    printHistogram("updateToRenderUs", stats.updateToRender);
+    printHistogram("renderCallUs", stats.renderCall);
+    printHistogram("gpuCompleteUs", stats.gpuComplete);
+    printHistogram("deliveryUs", stats.delivery, true);
+    std::printf("  },\n");
+
+    // ── Resize: output size change -> first frame at the new size ──
+    std::vector<uint64_t> resizeTimes;
+    for (uint32_t i = 0; i < options.resizes; i++) {
+        uint32_t width = i % 2 == 0 ? options.width / 2 : options.width;
+        uint32_t height = i % 2 == 0 ? options.height / 2 : options.height;
+        uint64_t requested = nowUs();
+        context.setOutputSize(width, height);
+        if (!waitUntil([&] { return consumer.width() == width && consumer.height() == height; })) {
+            std::printf("  \"resize\": {\"error\": \"Timed out at %ux%u\"},\n", width, height);
+            resizeTimes.clear();
+            break;
+        }
+        resizeTimes.push_back(nowUs() - requested);
+        uint64_t settled = consumer.frames() + SETTLE_FRAMES;
+        waitUntil([&] { return consumer.frames() >= settled; });
+    }
+    if (!resizeTimes.empty() || options.resizes == 0) {
+        std::printf("  \"resize\": {\n");
+        printSamples("latencyUs", resizeTimes, true);
+        std::printf("  },\n");
+    }
+    context.setOutputSize(0, 0);
+
+    // ── Zap: load of another source -> file loaded / first frame ──
+    context.resetStats();
+    uint32_t zapped = 0;
+    for (uint32_t i = 0; i < options.zaps; i++) {
+        uint64_t firstFrames = context.stats().timeToFirstFrame.snapshot().count;
+        if (!loadAndWait(context, sources[(i + 1) % 2], fileOptions, error)) break;
+        if (!waitUntil([&] { return context.stats().timeToFirstFrame.snapshot().count > firstFrames; })) {
+            error = "No frame after zap";
+            break;
+        }
+        zapped++;
+        uint64_t settled = consumer.frames() + SETTLE_FRAMES;
+        waitUntil([&] { return consumer.frames() >= settled; });
+    }
+    std::printf("  \"zap\": {\n");
+    if (zapped < options.zaps) {
+        std::printf("    \"error\": \"%s\",\n", jsonEscape(error).c_str());
+    }
+    printHistogram("loadToFileLoadedUs", context.stats().loadToFileLoaded);
+    printHistogram("timeToFirstFrameUs", context.stats().timeToFirstFrame, true);
+    std::printf("  }\n");
+    std::printf("}\n");
+
+    return finish(zapped < options.zaps ? 1 : 0);
+}
@@ -0,0 +1,741 @@
+/*
+ * Multiview compositor implementation
+ */
+
+#include "compositor.h"
+#include "mpv_context.h"
+#include "render_stats.h"
+#include "slot_tracker.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <gl/GL.h>
+#elif defined(__APPLE__)
+#define GL_SILENCE_DEPRECATION
+#include <OpenGL/gl3.h>
+#else
+#include <GL/gl.h>
+#endif
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+// GL 3 / GLES 3 constants missing from the Windows 1.1 header
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER 0x8D40
+#define GL_READ_FRAMEBUFFER 0x8CA8
+#define GL_DRAW_FRAMEBUFFER 0x8CA9
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_TIMEOUT_EXPIRED 0x911B
+#define GL_WAIT_FAILED 0x911D
+#endif
+#ifndef GL_TIMEOUT_IGNORED
+#define GL_TIMEOUT_IGNORED 0xFFFFFFFFFFFFFFFFull
+#endif
+#ifndef GL_RGBA8
+#define GL_RGBA8 0x8058
+#endif
+
+namespace mpv_texture {
+
+// Longest the compositor blocks on one atlas fence before re-checking for shutdown
+static const uint64_t ATLAS_FENCE_WAIT_NS = 2000000;
+
+// Tile slots per player: one being rendered, one waiting for the compositor,
+// one being blitted from
+static const int TILE_BUFFER_COUNT = 3;
+
+// Resolved through GLContext::getProcAddress so one code path serves desktop
+// GL and ANGLE's GLES 3 alike. Sync objects are plain pointers here.
+struct CompositorGL {
+    void (APIENTRY* genTextures)(GLsizei, GLuint*);
+    void (APIENTRY* deleteTextures)(GLsizei, const GLuint*);
+    void (APIENTRY* bindTexture)(GLenum, GLuint);
+    void (APIENTRY* texParameteri)(GLenum, GLenum, GLint);
+    void (APIENTRY* texImage2D)(GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const void*);
+    void (APIENTRY* genFramebuffers)(GLsizei, GLuint*);
+    void (APIENTRY* deleteFramebuffers)(GLsizei, const GLuint*);
+    void (APIENTRY* bindFramebuffer)(GLenum, GLuint);
+    void (APIENTRY* framebufferTexture2D)(GLenum, GLenum, GLenum, GLuint, GLint);
+    GLenum (APIENTRY* checkFramebufferStatus)(GLenum);
+    void (APIENTRY* blitFramebuffer)(GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLbitfield, GLenum);
+    void (APIENTRY* clearColor)(GLfloat, GLfloat, GLfloat, GLfloat);
+    void (APIENTRY* clear)(GLbitfield);
+    void (APIENTRY* flush)(void);
+    void* (APIENTRY* fenceSync)(GLenum, GLbitfield);
+    GLenum (APIENTRY* clientWaitSync)(void*, GLbitfield, uint64_t);
+    void (APIENTRY* waitSync)(void*, GLbitfield, uint64_t);
+    void (APIENTRY* deleteSync)(void*);
+};
+
+static CompositorGL g_gl;
+
+template <typename T>
+static bool loadFunction(T& function, const char* name) {
+    function = reinterpret_cast<T>(GLContext::getProcAddress(name));
+    return function != nullptr;
+}
+
+// Loaded once, with any context of the share group current
+static bool loadGL() {
+    static const bool loaded = [] {
+        bool ok = loadFunction(g_gl.genTextures, "glGenTextures") &&
+            loadFunction(g_gl.deleteTextures, "glDeleteTextures") &&
+            loadFunction(g_gl.bindTexture, "glBindTexture") &&
+            loadFunction(g_gl.texParameteri, "glTexParameteri") &&
+            loadFunction(g_gl.texImage2D, "glTexImage2D") &&
+            loadFunction(g_gl.genFramebuffers, "glGenFramebuffers") &&
+            loadFunction(g_gl.deleteFramebuffers, "glDeleteFramebuffers") &&
+            loadFunction(g_gl.bindFramebuffer, "glBindFramebuffer") &&
+            loadFunction(g_gl.framebufferTexture2D, "glFramebufferTexture2D") &&
+            loadFunction(g_gl.checkFramebufferStatus, "glCheckFramebufferStatus") &&
+            loadFunction(g_gl.blitFramebuffer, "glBlitFramebuffer") &&
+            loadFunction(g_gl.clearColor, "glClearColor") &&
+            loadFunction(g_gl.clear, "glClear") &&
+            loadFunction(g_gl.flush, "glFlush") &&
+            loadFunction(g_gl.fenceSync, "glFenceSync") &&
+            loadFunction(g_gl.clientWaitSync, "glClientWaitSync") &&
+            loadFunction(g_gl.waitSync, "glWaitSync") &&
+            loadFunction(g_gl.deleteSync, "glDeleteSync");
+        if (!ok) {
+            std::cerr << "[Compositor] GL 3 framebuffer / sync functions unavailable" << std::endl;
+        }
+        return ok;
+    }();
+    return loaded;
+}
+
+// A player's tile target: triple-buffered plain GL textures in the share
+// group. Exports never leave the process; the "consumer" is the compositor,
+// which blits from them and hands each slot back with the fence of its
+// last read. Render-side calls run on the player's render thread, the
+// source/fence calls on the compositor's.
+class TileTextureShare : public ITextureShare {
+public:
+    TileTextureShare() = default;
+    ~TileTextureShare() override { destroy(); }
+
+    bool initialize(void* /*gl_context*/) override {
+        return loadGL();
+    }
+
+    bool createTexture(uint32_t width, uint32_t height, TextureFormat format) override {
+        if (isPlanar(format)) {
+            return false;  // Tiles are always blitted as RGB
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return createSlots(width, height);
+    }
+
+    bool resizeTexture(uint32_t width, uint32_t height, TextureFormat format) override {
+        if (isPlanar(format)) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (width == m_width && height == m_height) {
+            return true;
+        }
+        m_locked = false;
+        m_tracker.clear();
+        destroySlots();
+        return createSlots(width, height);
+    }
+
+    // Tile sizes follow the layout, not the stream: nothing to pool
+    void setPoolBudget(uint64_t /*bytes*/) override {}
+
+    uint32_t getGLTexture() const override {
+        return m_slots[m_writeIndex].texture;
+    }
+
+    uint32_t getGLFBO() const override {
+        return m_slots[m_writeIndex].fbo;
+    }
+
+    uint32_t getGLInternalFormat() const override {
+        return GL_RGBA8;
+    }
+
+    bool lockTexture() override {
+        int index = m_tracker.acquire(m_lastExported);
+        if (index < 0) return false;
+
+        auto& slot = m_slots[index];
+        void* readFence;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            readFence = slot.readFence;
+            slot.readFence = nullptr;
+        }
+        if (readFence) {
+            // Order this render after the compositor's blit on the GPU,
+            // without blocking the render thread
+            g_gl.waitSync(readFence, 0, GL_TIMEOUT_IGNORED);
+            g_gl.deleteSync(readFence);
+        }
+        dropFence(slot.renderFence);
+
+        m_writeIndex = index;
+        m_locked = true;
+        return true;
+    }
+
+    TextureInfo unlockAndExport() override {
+        TextureInfo info = {};
+        if (!m_locked) {
+            return info;
+        }
+        m_locked = false;
+
+        auto& slot = m_slots[m_writeIndex];
+        // Flushed so the compositor's context sees the fence
+        slot.renderFence = g_gl.fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        g_gl.flush();
+
+        info.handle = slot.handle;
+        info.width = m_width;
+        info.height = m_height;
+        info.format = TextureFormat::RGBA8;
+        info.is_valid = true;
+
+        info.generation = m_tracker.markExported(m_writeIndex);
+        m_lastExported = m_writeIndex;
+        return info;
+    }
+
+    void abandonTexture() override {
+        if (!m_locked) return;
+        m_locked = false;
+        m_tracker.abandon(m_writeIndex);
+    }
+
+    bool waitForExport(const TextureInfo& info, uint64_t timeoutNs) override {
+        for (auto& slot : m_slots) {
+            if (slot.handle != info.handle) continue;
+            if (!slot.renderFence) return true;
+
+            GLenum result = g_gl.clientWaitSync(slot.renderFence, 0, timeoutNs);
+            if (result == GL_TIMEOUT_EXPIRED) {
+                return false;
+            }
+            if (result == GL_WAIT_FAILED) {
+                std::cerr << "[Compositor] Tile glClientWaitSync failed" << std::endl;
+            }
+            dropFence(slot.renderFence);
+            return true;
+        }
+        return true;  // Slot no longer exists (resized)
+    }
+
+    void releaseTexture(uint64_t handle, uint64_t generation) override {
+        m_tracker.release(handle, generation);
+    }
+
+    void destroy() override {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_locked = false;
+        m_tracker.clear();
+        destroySlots();
+    }
+
+    // Compositor thread: run `blit(texture, width, height)` for the slot
+    // exported under `handle`, with the slot kept alive meanwhile. False if
+    // the handle is stale (the tile was resized since).
+    template <typename F>
+    bool withSource(uint64_t handle, F blit) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& slot : m_slots) {
+            if (slot.handle == handle && handle != 0) {
+                blit(slot.texture, m_width, m_height);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Compositor thread: the next render into `handle`'s slot must wait for
+    // `fence`. Takes ownership; false (fence not taken) if the handle is stale.
+    bool setReadFence(uint64_t handle, void* fence) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto& slot : m_slots) {
+            if (slot.handle == handle && handle != 0) {
+                if (slot.readFence) g_gl.deleteSync(slot.readFence);
+                slot.readFence = fence;
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    struct Slot {
+        GLuint texture = 0;
+        GLuint fbo = 0;          // Player's context only (FBOs are not shared)
+        uint64_t handle = 0;     // Unique per allocation, so stale handles never match
+        void* renderFence = nullptr;
+        void* readFence = nullptr;
+    };
+
+    // Caller holds m_mutex
+    bool createSlots(uint32_t width, uint32_t height) {
+        uint64_t handles[TILE_BUFFER_COUNT];
+        for (int i = 0; i < TILE_BUFFER_COUNT; i++) {
+            auto& slot = m_slots[i];
+            g_gl.genTextures(1, &slot.texture);
+            g_gl.bindTexture(GL_TEXTURE_2D, slot.texture);
+            g_gl.texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            g_gl.texParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            g_gl.texImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, static_cast<GLsizei>(width), static_cast<GLsizei>(height),
+                            0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            g_gl.bindTexture(GL_TEXTURE_2D, 0);
+
+            g_gl.genFramebuffers(1, &slot.fbo);
+            g_gl.bindFramebuffer(GL_FRAMEBUFFER, slot.fbo);
+            g_gl.framebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, slot.texture, 0);
+            GLenum status = g_gl.checkFramebufferStatus(GL_FRAMEBUFFER);
+            g_gl.bindFramebuffer(GL_FRAMEBUFFER, 0);
+            if (status != GL_FRAMEBUFFER_COMPLETE) {
+                std::cerr << "[Compositor] Tile FBO incomplete: " << std::hex << status << std::dec << std::endl;
+                destroySlots();
+                return false;
+            }
+            slot.handle = m_nextHandle++;
+            handles[i] = slot.handle;
+        }
+
+        m_width = width;
+        m_height = height;
+        m_tracker.reset(handles);
+        m_writeIndex = 0;
+        m_lastExported = TILE_BUFFER_COUNT - 1;
+        return true;
+    }
+
+    // Caller holds m_mutex
+    void destroySlots() {
+        for (auto& slot : m_slots) {
+            dropFence(slot.renderFence);
+            dropFence(slot.readFence);
+            if (slot.fbo) g_gl.deleteFramebuffers(1, &slot.fbo);
+            if (slot.texture) g_gl.deleteTextures(1, &slot.texture);
+            slot = Slot{};
+        }
+        m_width = 0;
+        m_height = 0;
+    }
+
+    static void dropFence(void*& fence) {
+        if (fence) {
+            g_gl.deleteSync(fence);
+            fence = nullptr;
+        }
+    }
+
+    // Guards the slot textures and read fences against the compositor
+    std::mutex m_mutex;
+    Slot m_slots[TILE_BUFFER_COUNT];
+    SlotTracker<TILE_BUFFER_COUNT> m_tracker;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    uint64_t m_nextHandle = 1;
+    bool m_locked = false;
+    int m_writeIndex = 0;
+    int m_lastExported = TILE_BUFFER_COUNT - 1;
+};
+
+Compositor::~Compositor() {
+    destroy();
+}
+
+ITextureShare* Compositor::createTileShare() {
+    return new TileTextureShare();
+}
+
+bool Compositor::create(const CompositorConfig& config) {
+    if (m_initialized) {
+        return true;
+    }
+    m_config = config;
+
+    if (!m_glContext.create()) {
+        std::cerr << "[Compositor] Failed to create GL context" << std::endl;
+        return false;
+    }
+    if (!loadGL()) {
+        m_glContext.destroy();
+        return false;
+    }
+
+    // The atlas is a regular platform export, exactly like a player's texture
+    m_atlas = createTextureShare();
+    if (!m_atlas || !m_atlas->initialize(m_glContext.nativeHandle())) {
+        std::cerr << "[Compositor] Failed to initialize texture sharing" << std::endl;
+        delete m_atlas;
+        m_atlas = nullptr;
+        m_glContext.destroy();
+        return false;
+    }
+    m_atlas->setPoolBudget(0);
+    if (!m_atlas->createTexture(config.width, config.height, TextureFormat::RGBA8)) {
+        std::cerr << "[Compositor] Failed to create " << config.width << "x" << config.height
+                  << " atlas" << std::endl;
+        m_atlas->destroy();
+        delete m_atlas;
+        m_atlas = nullptr;
+        m_glContext.destroy();
+        return false;
+    }
+    g_gl.genFramebuffers(1, &m_readFbo);
+
+    m_running = true;
+    // Release GL context from main thread so the compositor thread can use it
+    m_glContext.releaseCurrent();
+    m_renderThread = std::thread(&Compositor::renderLoop, this);
+
+    m_initialized = true;
+    std::cout << "[Compositor] Created " << config.width << "x" << config.height << " atlas" << std::endl;
+    return true;
+}
+
+void Compositor::destroy() {
+    if (!m_initialized) {
+        return;
+    }
+
+    m_running = false;
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_dirty = true;
+    }
+    m_wakeCV.notify_one();
+    if (m_renderThread.joinable()) {
+        m_renderThread.join();
+    }
+
+    // Free GL objects in our own context (see MpvContext::destroy)
+    m_glContext.makeCurrent();
+    {
+        std::lock_guard<std::mutex> lock(m_layoutMutex);
+        // Players outliving the compositor get their tile frames back
+        for (auto& state : m_tiles) {
+            releaseTile(state);
+        }
+        for (auto& state : m_retired) {
+            releaseTile(state);
+        }
+        for (void* fence : m_staleFences) {
+            g_gl.deleteSync(fence);
+        }
+        m_tiles.clear();
+        m_retired.clear();
+        m_staleFences.clear();
+        m_shares.clear();
+    }
+    g_gl.deleteFramebuffers(1, &m_readFbo);
+    m_readFbo = 0;
+
+    TextureInfo discarded;  // The atlas is destroyed below, slots and all
+    m_mailbox.invalidate(discarded);
+    {
+        std::lock_guard<std::mutex> lock(m_outputMutex);
+        m_atlas->destroy();
+        delete m_atlas;
+        m_atlas = nullptr;
+        m_frameTiles.clear();
+    }
+
+    m_glContext.destroy();
+    m_initialized = false;
+}
+
+void Compositor::setLayout(const std::vector<CompositorTile>& tiles) {
+    std::vector<CompositorTile> resized;
+    {
+        std::lock_guard<std::mutex> lock(m_layoutMutex);
+        std::vector<TileState> next;
+        for (CompositorTile tile : tiles) {
+            auto share = m_shares.find(tile.player);
+            if (share == m_shares.end() || tile.x >= m_config.width || tile.y >= m_config.height) {
+                continue;
+            }
+            tile.width = std::min(tile.width, m_config.width - tile.x);
+            tile.height = std::min(tile.height, m_config.height - tile.y);
+            bool duplicate = std::any_of(next.begin(), next.end(),
+                                         [&](const TileState& state) { return state.tile.player == tile.player; });
+            if (tile.width == 0 || tile.height == 0 || duplicate) {
+                continue;
+            }
+
+            TileState state{tile, share->second};
+            // A player that stays keeps its frame, so it is not black for a frame
+            for (auto& old : m_tiles) {
+                if (old.tile.player == tile.player) {
+                    state.current = old.current;
+                    state.readFence = old.readFence;
+                    old.current = TextureInfo{};
+                    old.readFence = nullptr;
+                }
+            }
+            resized.push_back(tile);
+            next.push_back(state);
+        }
+
+        // Frames of dropped tiles go back from the compositor thread, which
+        // owns the fences ordering them after the last blit
+        for (auto& old : m_tiles) {
+            if (old.current.is_valid) {
+                m_retired.push_back(old);
+            }
+        }
+        m_tiles = std::move(next);
+    }
+
+    for (const auto& tile : resized) {
+        tile.player->setOutputSize(tile.width, tile.height);
+    }
+    tileReady();
+}
+
+void Compositor::setFrameCallback(std::function<bool()> callback) {
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    m_frameCallback = std::move(callback);
+}
+
+bool Compositor::takeFrame(TextureInfo& info, uint64_t& dropped, std::vector<TileFrame>& tiles) {
+    uint64_t postedAtUs = 0;
+    if (!m_mailbox.take(info, dropped, postedAtUs)) {
+        return false;
+    }
+    // Only needed until the frame is taken
+    std::lock_guard<std::mutex> lock(m_outputMutex);
+    auto it = m_frameTiles.find(info.generation);
+    if (it != m_frameTiles.end()) {
+        tiles = std::move(it->second);
+        m_frameTiles.erase(it);
+    }
+    return true;
+}
+
+void Compositor::releaseFrame(uint64_t handle, uint64_t generation) {
+    {
+        std::lock_guard<std::mutex> lock(m_outputMutex);
+        if (!m_atlas) return;
+        m_atlas->releaseTexture(handle, generation);
+    }
+
+    // A composite may be parked waiting for a free atlas slot
+    std::lock_guard<std::mutex> lock(m_wakeMutex);
+    if (m_slotStarved) {
+        m_slotStarved = false;
+        m_dirty = true;
+        m_wakeCV.notify_one();
+    }
+}
+
+void Compositor::attach(MpvContext* player, ITextureShare* share) {
+    std::lock_guard<std::mutex> lock(m_layoutMutex);
+    m_shares[player] = static_cast<TileTextureShare*>(share);
+}
+
+void Compositor::tileReady() {
+    std::lock_guard<std::mutex> lock(m_wakeMutex);
+    m_dirty = true;
+    m_wakeCV.notify_one();
+}
+
+void Compositor::detach(MpvContext* player) {
+    std::lock_guard<std::mutex> lock(m_layoutMutex);
+    m_shares.erase(player);
+    // The player's textures are about to go: forget its frames without
+    // releasing them; only the fences are ours to delete
+    auto forget = [&](std::vector<TileState>& states) {
+        for (auto it = states.begin(); it != states.end();) {
+            if (it->tile.player != player) {
+                ++it;
+                continue;
+            }
+            if (it->readFence) m_staleFences.push_back(it->readFence);
+            it = states.erase(it);
+        }
+    };
+    forget(m_tiles);
+    forget(m_retired);
+}
+
+void Compositor::releaseTile(TileState& state) {
+    if (state.readFence) {
+        if (!state.current.is_valid || !state.share->setReadFence(state.current.handle, state.readFence)) {
+            g_gl.deleteSync(state.readFence);
+        }
+        state.readFence = nullptr;
+    }
+    if (state.current.is_valid) {
+        state.tile.player->releaseFrame(state.current.handle, state.current.generation);
+        state.current = TextureInfo{};
+    }
+}
+
+void Compositor::renderLoop() {
+    if (!m_glContext.makeCurrent()) {
+        std::cerr << "[Compositor] Failed to make GL context current in render thread" << std::endl;
+        return;
+    }
+
+    uint64_t intervalUs = m_config.maxFps ? 1000000 / m_config.maxFps : 0;
+    uint64_t lastCompositeUs = 0;
+    uint64_t frameSeq = 0;
+
+    while (m_running) {
+        {
+            std::unique_lock<std::mutex> lock(m_wakeMutex);
+            m_wakeCV.wait(lock, [this] { return m_dirty || !m_running; });
+            // Tiles arriving within one interval share a composite
+            uint64_t now = nowUs();
+            if (intervalUs && lastCompositeUs && now < lastCompositeUs + intervalUs) {
+                m_wakeCV.wait_for(lock, std::chrono::microseconds(lastCompositeUs + intervalUs - now),
+                                  [this] { return !m_running.load(); });
+            }
+            if (!m_running) break;
+            m_dirty = false;
+        }
+
+        lastCompositeUs = nowUs();
+        if (composite(frameSeq + 1)) {
+            frameSeq++;
+        } else {
+            // releaseFrame() wakes us once an atlas slot comes back
+            std::lock_guard<std::mutex> lock(m_wakeMutex);
+            m_slotStarved = true;
+        }
+    }
+
+    m_glContext.releaseCurrent();
+}
+
+bool Compositor::composite(uint64_t frameSeq) {
+    uint64_t startUs = nowUs();
+    if (!m_atlas->lockTexture()) {
+        m_lockFailures.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    std::vector<TileFrame> frames;
+    {
+        std::lock_guard<std::mutex> lock(m_layoutMutex);
+        for (auto& state : m_retired) {
+            releaseTile(state);
+        }
+        m_retired.clear();
+        for (void* fence : m_staleFences) {
+            g_gl.deleteSync(fence);
+        }
+        m_staleFences.clear();
+
+        // Newest frame of every tile; the one it replaces goes back first
+        for (auto& state : m_tiles) {
+            TextureInfo info;
+            uint64_t dropped = 0;
+            if (state.tile.player->takeFrame(info, dropped)) {
+                releaseTile(state);
+                state.current = info;
+            }
+        }
+
+        g_gl.bindFramebuffer(GL_DRAW_FRAMEBUFFER, m_atlas->getGLFBO());
+        g_gl.clearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        g_gl.clear(GL_COLOR_BUFFER_BIT);
+        g_gl.bindFramebuffer(GL_READ_FRAMEBUFFER, m_readFbo);
+
+        frames.reserve(m_tiles.size());
+        for (auto& state : m_tiles) {
+            const CompositorTile& tile = state.tile;
+            TileFrame frame{tile.id, tile.x, tile.y, tile.width, tile.height, 0,
+                            std::numeric_limits<double>::quiet_NaN()};
+            bool drawn = state.current.is_valid && state.share->withSource(state.current.handle,
+                [&](GLuint texture, uint32_t width, uint32_t height) {
+                    g_gl.framebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+                    // 1:1 once the player follows the layout; until then
+                    // (resize in flight) fit the frame into the region
+                    uint32_t drawWidth = tile.width;
+                    uint32_t drawHeight = tile.height;
+                    if (width != tile.width || height != tile.height) {
+                        if (static_cast<uint64_t>(width) * tile.height > static_cast<uint64_t>(height) * tile.width) {
+                            drawHeight = static_cast<uint32_t>(static_cast<uint64_t>(tile.width) * height / width);
+                        } else {
+                            drawWidth = static_cast<uint32_t>(static_cast<uint64_t>(tile.height) * width / height);
+                        }
+                    }
+                    GLint x0 = static_cast<GLint>(tile.x + (tile.width - drawWidth) / 2);
+                    GLint y0 = static_cast<GLint>(tile.y + (tile.height - drawHeight) / 2);
+                    g_gl.blitFramebuffer(0, 0, static_cast<GLint>(width), static_cast<GLint>(height),
+                                         x0, y0, x0 + static_cast<GLint>(drawWidth), y0 + static_cast<GLint>(drawHeight),
+                                         GL_COLOR_BUFFER_BIT,
+                                         drawWidth == width && drawHeight == height ? GL_NEAREST : GL_LINEAR);
+                });
+            if (drawn) {
+                frame.seq = state.current.seq;
+                frame.pts = state.current.pts;
+            } else if (state.current.is_valid) {
+                // Slot gone in a resize: nothing left to release
+                state.current = TextureInfo{};
+            }
+            frames.push_back(frame);
+        }
+        g_gl.framebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+        g_gl.bindFramebuffer(GL_FRAMEBUFFER, 0);
+
+        // Each tile's next render into the slot just read waits on this
+        for (auto& state : m_tiles) {
+            if (!state.current.is_valid) continue;
+            if (state.readFence) g_gl.deleteSync(state.readFence);
+            state.readFence = g_gl.fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+    }
+
+    uint64_t renderDoneUs = nowUs();
+    TextureInfo info = m_atlas->unlockAndExport();
+    if (!info.is_valid) {
+        return true;
+    }
+    // Nothing else to do on this thread: wait for the GPU before handing over
+    while (m_running && !m_atlas->waitForExport(info, ATLAS_FENCE_WAIT_NS)) {}
+
+    info.seq = frameSeq;
+    info.pts = std::numeric_limits<double>::quiet_NaN();
+    info.renderStartUs = startUs;
+    info.renderDoneUs = renderDoneUs;
+    info.exportUs = nowUs();
+    {
+        std::lock_guard<std::mutex> lock(m_outputMutex);
+        m_frameTiles[info.generation] = std::move(frames);
+    }
+
+    TextureInfo replaced;
+    bool notify = m_mailbox.post(info, replaced);
+    if (replaced.is_valid) {
+        // Coalesced away before JS saw it — the slot is ours again
+        std::lock_guard<std::mutex> lock(m_outputMutex);
+        m_atlas->releaseTexture(replaced.handle, replaced.generation);
+        m_frameTiles.erase(replaced.generation);
+    }
+    if (notify) {
+        std::lock_guard<std::mutex> lock(m_callbackMutex);
+        if (!m_frameCallback || !m_frameCallback()) {
+            m_mailbox.cancelNotify();
+        }
+    }
+
+    m_framesComposited.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+} // namespace mpv_texture
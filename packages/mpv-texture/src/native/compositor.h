@@ -0,0 +1,161 @@
+/*
+ * Multiview compositor: N players, one exported atlas texture
+ *
+ * Players attached to a compositor render into plain GL tile textures in
+ * the share group (no platform export) on their own render threads, as
+ * usual. The compositor's thread takes each player's newest tile frame,
+ * blits them into their regions of one shared atlas surface and exports
+ * that: one TextureInfo, one import and one sync per display frame for the
+ * whole grid instead of one per player.
+ *
+ * Reads and writes of tile textures cross GL contexts and are ordered on
+ * the GPU with fences: a tile frame is only handed over once its render
+ * fence signaled, and a released tile slot is only rendered into again
+ * after the player's context waited (glWaitSync) on the fence of the
+ * compositor's last blit from it.
+ */
+
+#ifndef COMPOSITOR_H_
+#define COMPOSITOR_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "frame_mailbox.h"
+#include "gl_context.h"
+#include "texture_share.h"
+
+namespace mpv_texture {
+
+class MpvContext;
+class TileTextureShare;
+
+struct CompositorConfig {
+    uint32_t width = 1920;   // Atlas size
+    uint32_t height = 1080;
+    uint32_t maxFps = 60;    // Composites per second at most (0 = unlimited)
+};
+
+// A region of the atlas and the player drawn into it
+struct CompositorTile {
+    uint32_t id;             // Caller's player id, echoed in TileFrame
+    MpvContext* player;
+    uint32_t x;              // Top-left origin, pixels
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+};
+
+// What a tile showed in one exported atlas frame
+struct TileFrame {
+    uint32_t id;
+    uint32_t x;
+    uint32_t y;
+    uint32_t width;
+    uint32_t height;
+    uint64_t seq;            // The player's TextureInfo::seq, 0 = nothing yet (black)
+    double pts;
+};
+
+class Compositor {
+public:
+    Compositor() = default;
+    ~Compositor();
+
+    Compositor(const Compositor&) = delete;
+    Compositor& operator=(const Compositor&) = delete;
+
+    bool create(const CompositorConfig& config);
+    void destroy();
+    bool isInitialized() const { return m_initialized; }
+
+    // Regions of the atlas, replacing the previous layout. Each player's
+    // output size is set to its region, so tiles blit 1:1. Regions are
+    // clipped to the atlas; players not attached to this compositor are
+    // ignored.
+    void setLayout(const std::vector<CompositorTile>& tiles);
+
+    // Same contract as MpvContext's frame callback / takeFrame / releaseFrame.
+    // `tiles` receives the layout the frame was composed with.
+    void setFrameCallback(std::function<bool()> callback);
+    bool takeFrame(TextureInfo& info, uint64_t& dropped, std::vector<TileFrame>& tiles);
+    void releaseFrame(uint64_t handle, uint64_t generation);
+
+    // Atlas frames exported, and composites skipped because every atlas
+    // slot was still held by the consumer
+    uint64_t framesComposited() const { return m_framesComposited.load(std::memory_order_relaxed); }
+    uint64_t lockFailures() const { return m_lockFailures.load(std::memory_order_relaxed); }
+
+    // MpvContext side (see MpvContext::attachCompositor)
+    // Texture share for a player's tiles; owned by the player
+    static ITextureShare* createTileShare();
+    // The player's tile share is ready: it may now be placed in the layout
+    void attach(MpvContext* player, ITextureShare* share);
+    // The player published a tile frame
+    void tileReady();
+    // The player is going away: drop its tiles and frames before its
+    // textures are freed
+    void detach(MpvContext* player);
+
+private:
+    struct TileState {
+        CompositorTile tile;
+        TileTextureShare* share;
+        TextureInfo current{};   // Frame taken from the player, is_valid set once there is one
+        void* readFence = nullptr;  // Last blit from `current` (GLsync)
+    };
+
+    void renderLoop();
+    // Compose and export one atlas frame; false if no atlas slot was free
+    bool composite(uint64_t frameSeq);
+    // Hand a tile frame back to its player, ordered after `fence`
+    void releaseTile(TileState& state);
+
+    CompositorConfig m_config;
+    GLContext m_glContext;
+    ITextureShare* m_atlas = nullptr;
+    unsigned int m_readFbo = 0;  // Compositor context only: source of the blits
+
+    std::thread m_renderThread;
+    std::atomic<bool> m_running{false};
+    std::atomic<bool> m_initialized{false};
+
+    // Wakeups from tile renders, layout changes and atlas releases
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCV;
+    bool m_dirty = false;
+    bool m_slotStarved = false;
+
+    // Attached players' tile shares and the current layout (guarded by
+    // m_layoutMutex, which the render thread holds while composing)
+    std::mutex m_layoutMutex;
+    std::unordered_map<MpvContext*, TileTextureShare*> m_shares;
+    std::vector<TileState> m_tiles;
+    // Tiles dropped from the layout, whose frames the render thread hands
+    // back; fences of detached players, deleted there (GL context needed)
+    std::vector<TileState> m_retired;
+    std::vector<void*> m_staleFences;
+
+    FrameMailbox m_mailbox;
+    // Layout of every exported atlas frame not yet taken, by generation
+    // (guarded by m_outputMutex, which also guards m_atlas against
+    // releaseFrame() racing destroy)
+    std::mutex m_outputMutex;
+    std::unordered_map<uint64_t, std::vector<TileFrame>> m_frameTiles;
+
+    std::function<bool()> m_frameCallback;
+    std::mutex m_callbackMutex;
+
+    std::atomic<uint64_t> m_framesComposited{0};
+    std::atomic<uint64_t> m_lockFailures{0};
+};
+
+} // namespace mpv_texture
+
+#endif // COMPOSITOR_H_
@@ -0,0 +1,113 @@
+/*
+ * Single-slot "latest frame wins" mailbox between the render thread and JS
+ *
+ * The render thread posts every exported frame; at most one delivery to the
+ * consumer is outstanding at a time. If the consumer is slow (main thread
+ * stalled by GC, EPG import, ...) newer frames overwrite the pending one and
+ * are counted as dropped, so the consumer always picks up the newest frame
+ * instead of a backlog of textures whose slots have since been rewritten.
+ */
+
+#ifndef FRAME_MAILBOX_H_
+#define FRAME_MAILBOX_H_
+
+#include <cstdint>
+#include <mutex>
+
+#include "render_stats.h"
+#include "texture_share.h"
+
+namespace mpv_texture {
+
+class FrameMailbox {
+public:
+    // Render thread: publish a frame. Returns true if the consumer must be
+    // notified (no delivery is scheduled yet); the caller then schedules one.
+    // An overwritten, never-delivered frame is returned through `replaced`
+    // (is_valid set) so its slot can be released.
+    bool post(const TextureInfo& info, TextureInfo& replaced) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        replaced = TextureInfo{};
+        if (m_hasFrame) {
+            replaced = m_frame;
+            m_dropped++;
+            m_droppedSinceTake++;
+        }
+        m_frame = info;
+        m_postedAtUs = nowUs();
+        m_hasFrame = true;
+        if (m_notifyScheduled) {
+            return false;
+        }
+        m_notifyScheduled = true;
+        return true;
+    }
+
+    // Request a notification for a frame that is already pending (its original
+    // notification was suppressed). Returns true if the caller must notify.
+    bool renotify() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_hasFrame || m_notifyScheduled) {
+            return false;
+        }
+        m_notifyScheduled = true;
+        return true;
+    }
+
+    // Render thread: the scheduled notification could not be queued
+    void cancelNotify() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_notifyScheduled = false;
+    }
+
+    // Consumer: take the pending frame. `dropped` receives the number of frames
+    // coalesced away since the previous take, `postedAtUs` when the frame was
+    // posted (nowUs clock). Returns false if the pending frame was invalidated
+    // before it could be delivered.
+    bool take(TextureInfo& info, uint64_t& dropped, uint64_t& postedAtUs) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_notifyScheduled = false;
+        if (!m_hasFrame) {
+            return false;
+        }
+        info = m_frame;
+        dropped = m_droppedSinceTake;
+        postedAtUs = m_postedAtUs;
+        m_hasFrame = false;
+        m_droppedSinceTake = 0;
+        return true;
+    }
+
+    // Render thread: discard the pending frame before its texture set is
+    // resized or destroyed. The discarded frame is returned through
+    // `discarded` (is_valid set) so its slot can be released, as for post().
+    void invalidate(TextureInfo& discarded) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        discarded = TextureInfo{};
+        if (m_hasFrame) {
+            discarded = m_frame;
+            m_dropped++;
+            m_droppedSinceTake++;
+        }
+        m_hasFrame = false;
+    }
+
+    // Total frames that were never delivered
+    uint64_t droppedCount() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_dropped;
+    }
+
+private:
+    std::mutex m_mutex;
+    TextureInfo m_frame{};
+    uint64_t m_postedAtUs = 0;
+    bool m_hasFrame = false;
+    bool m_notifyScheduled = false;
+    uint64_t m_dropped = 0;
+    uint64_t m_droppedSinceTake = 0;
+};
+
+} // namespace mpv_texture
+
+#endif // FRAME_MAILBOX_H_
@@ -0,0 +1,89 @@
+/*
+ * Frame record in memory shared with JS
+ *
+ * The allocation-free alternative to a TextureInfo object per frame: the
+ * delivery call writes the frame it took from the mailbox into a fixed
+ * layout of float64 values that JS views through a typed array (index.ts
+ * mirrors the layout), then passes only the sequence number. Writer and
+ * reader are both the JS thread, so there is no sequence lock; a record is
+ * valid until the next delivery overwrites it.
+ *
+ * Handles are stored as float64, which is exact below 2^53: dma-buf fds, NT
+ * handles and user-space IOSurfaceRef pointers all are. DRM modifiers use
+ * all 64 bits (vendor in the top byte) and are stored as raw uint64 bits.
+ */
+
+#ifndef FRAME_RECORD_H_
+#define FRAME_RECORD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "texture_share.h"
+
+namespace mpv_texture {
+
+class FrameRecord {
+public:
+    // float64 slot indices. FORMAT and TRANSFER hold the TextureFormat /
+    // TextureTransfer values; PTS is NaN if unknown.
+    enum Slot : uint32_t {
+        SEQ = 0,
+        HANDLE,
+        WIDTH,
+        HEIGHT,
+        FORMAT,
+        TRANSFER,
+        PTS,
+        RENDER_START_US,
+        RENDER_DONE_US,
+        EXPORT_US,
+        DROPPED,
+        STRIDE,
+        OFFSET,
+        MODIFIER,   // uint64 bits (read through a BigUint64Array view)
+        GENERATION,
+        SLOT_COUNT
+    };
+
+    static const size_t SIZE_BYTES = SLOT_COUNT * sizeof(double);
+
+    // Point at SIZE_BYTES of 8-byte aligned memory that outlives every write
+    void attach(void* memory) {
+        m_slots = static_cast<double*>(memory);
+        for (uint32_t i = 0; i < SLOT_COUNT; i++) {
+            m_slots[i] = 0;
+        }
+    }
+
+    bool attached() const { return m_slots != nullptr; }
+
+    void write(const TextureInfo& info, uint64_t dropped) {
+        if (!m_slots) return;
+        m_slots[SEQ] = static_cast<double>(info.seq);
+        m_slots[HANDLE] = static_cast<double>(info.handle);
+        m_slots[WIDTH] = info.width;
+        m_slots[HEIGHT] = info.height;
+        m_slots[FORMAT] = static_cast<double>(info.format);
+        m_slots[TRANSFER] = static_cast<double>(info.transfer);
+        m_slots[PTS] = info.pts;
+        m_slots[RENDER_START_US] = static_cast<double>(info.renderStartUs);
+        m_slots[RENDER_DONE_US] = static_cast<double>(info.renderDoneUs);
+        m_slots[EXPORT_US] = static_cast<double>(info.exportUs);
+        m_slots[DROPPED] = static_cast<double>(dropped);
+        m_slots[STRIDE] = info.stride;
+        m_slots[OFFSET] = info.offset;
+        std::memcpy(&m_slots[MODIFIER], &info.modifier, sizeof(info.modifier));
+        m_slots[GENERATION] = static_cast<double>(info.generation);
+    }
+
+private:
+    double* m_slots = nullptr;
+};
+
+static_assert(sizeof(double) == sizeof(uint64_t), "modifier slot holds raw uint64 bits");
+
+} // namespace mpv_texture
+
+#endif // FRAME_RECORD_H_
@@ -0,0 +1,86 @@
+/*
+ * Per-frame latency trace (bounded lock-free event ring)
+ *
+ * With tracing on, every stage a frame passes through is recorded as one
+ * event: mpv's render call, GPU completion, the hop from the mailbox to the
+ * consumer, and how long the consumer held the slot. Events come from the
+ * render thread (render, gpu, drop) and the consumer thread (deliver, hold,
+ * present), so writers claim slots with a fetch_add; like LogRing, each slot
+ * carries a sequence number that readers check to drop torn entries. With
+ * tracing off the hot path costs one relaxed load.
+ */
+
+#ifndef FRAME_TRACE_H_
+#define FRAME_TRACE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace mpv_texture {
+
+enum class TraceStage : uint32_t {
+    RENDER,   // mpv_render_context_render call
+    GPU,      // Render submitted -> export fence signaled
+    DELIVER,  // Published to the mailbox -> taken by the consumer
+    HOLD,     // Taken -> slot released by the consumer
+    DROP,     // Coalesced away in the mailbox (instant)
+    PRESENT,  // Consumer reported a frame on screen (instant, no frame)
+};
+
+struct TraceRecord {
+    uint64_t frame;    // TextureInfo::seq (0 for PRESENT)
+    uint64_t startUs;  // nowUs clock
+    uint64_t endUs;    // == startUs for instants
+    double pts;        // Playback position of the frame, NaN if unknown
+    TraceStage stage;
+};
+
+class FrameTrace {
+public:
+    static const uint64_t CAPACITY = 8192;  // Power of two; ~25 s at 60 fps (5 events a frame)
+
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    void record(TraceStage stage, uint64_t frame, uint64_t startUs, uint64_t endUs, double pts) {
+        uint64_t pos = m_head.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = m_slots[pos & (CAPACITY - 1)];
+
+        slot.seq.store(2 * pos + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.record = TraceRecord{frame, startUs, endUs, pts, stage};
+        slot.seq.store(2 * pos + 2, std::memory_order_release);
+    }
+
+    // Retained events, oldest first. Slots still being written are skipped.
+    void dump(std::vector<TraceRecord>& out) const {
+        uint64_t head = m_head.load(std::memory_order_acquire);
+        uint64_t start = head > CAPACITY ? head - CAPACITY : 0;
+        for (uint64_t pos = start; pos < head; pos++) {
+            const Slot& slot = m_slots[pos & (CAPACITY - 1)];
+            uint64_t seq = slot.seq.load(std::memory_order_acquire);
+            if (seq != 2 * pos + 2) continue;
+            TraceRecord record;
+            std::memcpy(&record, &slot.record, sizeof(record));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) != seq) continue;
+            out.push_back(record);
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        TraceRecord record{};
+    };
+
+    std::atomic<bool> m_enabled{false};
+    std::atomic<uint64_t> m_head{0};
+    Slot m_slots[CAPACITY];
+};
+
+} // namespace mpv_texture
+
+#endif // FRAME_TRACE_H_
@@ -0,0 +1,714 @@
+/*
+ * Offscreen OpenGL context implementation
+ */
+
+#include "gl_context.h"
+#include <cstring>
+#include <iostream>
+#include <mutex>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <gl/GL.h>
+#include "win32/angle_egl.h"
+#include "win32/d3d_device.h"
+#elif defined(__APPLE__)
+#define GL_SILENCE_DEPRECATION
+#include <OpenGL/gl3.h>
+#include <OpenGL/OpenGL.h>
+#include <dlfcn.h>
+#else
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/gl.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace mpv_texture {
+
+// Share group root — created by the first player, destroyed by the last.
+// Guarded by g_shareMutex; per-player contexts never touch it after creation.
+static std::mutex g_shareMutex;
+static int g_shareRefs = 0;
+
+#ifdef _WIN32
+static const char* kWindowClass = "MpvTextureDummyWindow";
+static HWND g_rootWindow = nullptr;
+static HDC g_rootHdc = nullptr;
+static HGLRC g_rootContext = nullptr;
+
+static bool createDummyWindow(HWND& window, HDC& hdc) {
+    // Register dummy window class (once per process)
+    static bool classRegistered = false;
+    if (!classRegistered) {
+        WNDCLASSA wc = {};
+        wc.lpfnWndProc = DefWindowProcA;
+        wc.hInstance = GetModuleHandle(nullptr);
+        wc.lpszClassName = kWindowClass;
+        RegisterClassA(&wc);
+        classRegistered = true;
+    }
+
+    // Create hidden window
+    window = CreateWindowExA(
+        0, kWindowClass, "", 0,
+        0, 0, 1, 1, nullptr, nullptr,
+        GetModuleHandle(nullptr), nullptr
+    );
+    if (!window) {
+        std::cerr << "[GLContext] Failed to create dummy window" << std::endl;
+        return false;
+    }
+
+    hdc = GetDC(window);
+    if (!hdc) {
+        std::cerr << "[GLContext] Failed to get DC" << std::endl;
+        return false;
+    }
+
+    // Set pixel format (must match across the share group)
+    PIXELFORMATDESCRIPTOR pfd = {};
+    pfd.nSize = sizeof(pfd);
+    pfd.nVersion = 1;
+    pfd.dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER;
+    pfd.iPixelType = PFD_TYPE_RGBA;
+    pfd.cColorBits = 32;
+    pfd.cDepthBits = 24;
+    pfd.iLayerType = PFD_MAIN_PLANE;
+
+    int pixelFormat = ChoosePixelFormat(hdc, &pfd);
+    if (!pixelFormat || !SetPixelFormat(hdc, pixelFormat, &pfd)) {
+        std::cerr << "[GLContext] Failed to set pixel format" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+static void destroyDummyWindow(HWND& window, HDC& hdc) {
+    if (hdc && window) {
+        ReleaseDC(window, hdc);
+        hdc = nullptr;
+    }
+    if (window) {
+        DestroyWindow(window);
+        window = nullptr;
+    }
+}
+
+static bool createWglRoot() {
+    if (!createDummyWindow(g_rootWindow, g_rootHdc)) {
+        destroyDummyWindow(g_rootWindow, g_rootHdc);
+        return false;
+    }
+    g_rootContext = wglCreateContext(g_rootHdc);
+    if (!g_rootContext) {
+        std::cerr << "[GLContext] Failed to create share group root context" << std::endl;
+        destroyDummyWindow(g_rootWindow, g_rootHdc);
+        return false;
+    }
+    return true;
+}
+
+static void destroyWglRoot() {
+    if (g_rootContext) {
+        wglDeleteContext(g_rootContext);
+        g_rootContext = nullptr;
+    }
+    destroyDummyWindow(g_rootWindow, g_rootHdc);
+}
+
+// ANGLE route: GLES 3 on ANGLE's D3D11 backend, running on the shared D3D11
+// device, so GL renders straight into the D3D11 textures Electron imports.
+// Needs no WGL_NV_DX_interop, which is what Intel / AMD drivers lack.
+// Fixed while any context exists; contexts never mix routes.
+static bool g_angle = false;
+static const AngleEGL* g_egl = nullptr;
+static EGLDeviceEXT g_eglDevice = nullptr;
+static EGLDisplay g_eglDisplay = nullptr;
+static EGLConfig g_eglConfig = nullptr;
+static EGLContext g_angleRoot = nullptr;
+
+static const EGLint kAngleContextAttributes[] = {
+    EGL_CONTEXT_CLIENT_VERSION, 3,
+    EGL_NONE
+};
+
+static void destroyAngleRoot() {
+    if (g_angleRoot) {
+        g_egl->destroyContext(g_eglDisplay, g_angleRoot);
+        g_angleRoot = nullptr;
+    }
+    if (g_eglDisplay) {
+        g_egl->terminate(g_eglDisplay);
+        g_eglDisplay = nullptr;
+    }
+    if (g_eglDevice) {
+        g_egl->releaseDeviceANGLE(g_eglDevice);
+        g_eglDevice = nullptr;
+        releaseD3DDevice();
+    }
+    g_eglConfig = nullptr;
+}
+
+static bool createAngleRoot() {
+    g_egl = loadAngleEGL();
+    if (!g_egl) {
+        std::cerr << "[GLContext] ANGLE (libEGL.dll) not available" << std::endl;
+        return false;
+    }
+
+    const char* clientExtensions = g_egl->queryString(nullptr, EGL_EXTENSIONS);
+    if (!hasEGLExtension(clientExtensions, "EGL_ANGLE_device_creation_d3d11")) {
+        std::cerr << "[GLContext] ANGLE lacks EGL_ANGLE_device_creation_d3d11" << std::endl;
+        return false;
+    }
+
+    // Hand ANGLE the shared device; the texture share creates its textures there
+    ID3D11Device* device = nullptr;
+    ID3D11DeviceContext* context = nullptr;
+    if (!acquireD3DDevice(AdapterPreference::Default, &device, &context)) {
+        return false;
+    }
+    g_eglDevice = g_egl->createDeviceANGLE(EGL_D3D11_DEVICE_ANGLE, device, nullptr);
+    if (!g_eglDevice) {
+        std::cerr << "[GLContext] eglCreateDeviceANGLE failed: " << std::hex << g_egl->getError() << std::dec << std::endl;
+        releaseD3DDevice();
+        return false;
+    }
+
+    EGLint major = 0;
+    EGLint minor = 0;
+    g_eglDisplay = g_egl->getPlatformDisplayEXT(EGL_PLATFORM_DEVICE_EXT, g_eglDevice, nullptr);
+    if (!g_eglDisplay || !g_egl->initialize(g_eglDisplay, &major, &minor)) {
+        std::cerr << "[GLContext] Failed to initialize ANGLE display: "
+                  << std::hex << g_egl->getError() << std::dec << std::endl;
+        g_eglDisplay = nullptr;
+        destroyAngleRoot();
+        return false;
+    }
+
+    const char* extensions = g_egl->queryString(g_eglDisplay, EGL_EXTENSIONS);
+    if (!hasEGLExtension(extensions, "EGL_KHR_surfaceless_context") ||
+        !hasEGLExtension(extensions, "EGL_ANGLE_image_d3d11_texture")) {
+        std::cerr << "[GLContext] ANGLE lacks surfaceless contexts or D3D11 texture images" << std::endl;
+        destroyAngleRoot();
+        return false;
+    }
+
+    const EGLint configAttributes[] = {
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_ALPHA_SIZE, 8,
+        EGL_NONE
+    };
+    EGLint numConfigs = 0;
+    if (!g_egl->bindAPI(EGL_OPENGL_ES_API) ||
+        !g_egl->chooseConfig(g_eglDisplay, configAttributes, &g_eglConfig, 1, &numConfigs) || numConfigs == 0) {
+        std::cerr << "[GLContext] No ANGLE config for OpenGL ES 3" << std::endl;
+        destroyAngleRoot();
+        return false;
+    }
+
+    g_angleRoot = g_egl->createContext(g_eglDisplay, g_eglConfig, nullptr, kAngleContextAttributes);
+    if (!g_angleRoot) {
+        std::cerr << "[GLContext] Failed to create ANGLE share group root context: "
+                  << std::hex << g_egl->getError() << std::dec << std::endl;
+        destroyAngleRoot();
+        return false;
+    }
+
+    std::cout << "[GLContext] ANGLE EGL " << major << "." << minor << " initialized on D3D11" << std::endl;
+    return true;
+}
+
+// Caller holds g_shareMutex
+static bool acquireShareRoot() {
+    if (g_shareRefs == 0) {
+        // ANGLE unless the default GPU is NVIDIA, where WGL_NV_DX_interop is
+        // reliable and desktop GL keeps mpv's full feature set. Either route
+        // falls back to WGL.
+        g_angle = !isDefaultAdapterNvidia() && createAngleRoot();
+        if (!g_angle && !createWglRoot()) {
+            return false;
+        }
+    }
+    g_shareRefs++;
+    return true;
+}
+
+// Caller holds g_shareMutex
+static void releaseShareRoot() {
+    if (g_shareRefs == 0 || --g_shareRefs > 0) {
+        return;
+    }
+    if (g_angle) {
+        destroyAngleRoot();
+    } else {
+        destroyWglRoot();
+    }
+    g_angle = false;
+}
+#endif
+
+#ifdef __APPLE__
+static CGLPixelFormatObj g_pixelFormat = nullptr;
+static CGLContextObj g_rootContext = nullptr;
+
+// Caller holds g_shareMutex
+static CGLContextObj acquireShareRoot() {
+    if (g_shareRefs == 0) {
+        // Create a minimal OpenGL context for offscreen rendering
+        CGLPixelFormatAttribute attributes[] = {
+            kCGLPFAOpenGLProfile, (CGLPixelFormatAttribute)kCGLOGLPVersion_3_2_Core,
+            kCGLPFAColorSize, (CGLPixelFormatAttribute)24,
+            kCGLPFAAlphaSize, (CGLPixelFormatAttribute)8,
+            kCGLPFAAccelerated,
+            kCGLPFANoRecovery,
+            (CGLPixelFormatAttribute)0
+        };
+
+        GLint numFormats = 0;
+        CGLError err = CGLChoosePixelFormat(attributes, &g_pixelFormat, &numFormats);
+        if (err != kCGLNoError || numFormats == 0) {
+            std::cerr << "[GLContext] Failed to choose pixel format: " << err << std::endl;
+            g_pixelFormat = nullptr;
+            return nullptr;
+        }
+
+        err = CGLCreateContext(g_pixelFormat, nullptr, &g_rootContext);
+        if (err != kCGLNoError) {
+            std::cerr << "[GLContext] Failed to create share group root context: " << err << std::endl;
+            CGLDestroyPixelFormat(g_pixelFormat);
+            g_pixelFormat = nullptr;
+            g_rootContext = nullptr;
+            return nullptr;
+        }
+    }
+    g_shareRefs++;
+    return g_rootContext;
+}
+
+// Caller holds g_shareMutex
+static void releaseShareRoot() {
+    if (g_shareRefs == 0 || --g_shareRefs > 0) {
+        return;
+    }
+    if (g_rootContext) {
+        CGLDestroyContext(g_rootContext);
+        g_rootContext = nullptr;
+    }
+    if (g_pixelFormat) {
+        CGLDestroyPixelFormat(g_pixelFormat);
+        g_pixelFormat = nullptr;
+    }
+}
+#endif
+
+#if !defined(_WIN32) && !defined(__APPLE__)
+static EGLDisplay g_display = EGL_NO_DISPLAY;
+static EGLConfig g_config = nullptr;
+static EGLContext g_rootContext = EGL_NO_CONTEXT;
+static int g_drmFd = -1;
+
+static const EGLint kContextAttributes[] = {
+    EGL_CONTEXT_MAJOR_VERSION, 3,
+    EGL_CONTEXT_MINOR_VERSION, 2,
+    EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+    EGL_NONE
+};
+
+// Headless display: no X11 / Wayland connection needed (kiosk, set-top box)
+static EGLDisplay openDisplay() {
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (getPlatformDisplay) {
+        EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if (display != EGL_NO_DISPLAY) {
+            return display;
+        }
+    }
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+// Open the render node behind the display (EGL_EXT_device_query)
+static int openRenderNode(EGLDisplay display) {
+    auto queryDisplayAttrib = reinterpret_cast<PFNEGLQUERYDISPLAYATTRIBEXTPROC>(
+        eglGetProcAddress("eglQueryDisplayAttribEXT"));
+    auto queryDeviceString = reinterpret_cast<PFNEGLQUERYDEVICESTRINGEXTPROC>(
+        eglGetProcAddress("eglQueryDeviceStringEXT"));
+    if (!queryDisplayAttrib || !queryDeviceString) {
+        return -1;
+    }
+
+    EGLAttrib device = 0;
+    if (!queryDisplayAttrib(display, EGL_DEVICE_EXT, &device) || !device) {
+        return -1;
+    }
+    const char* path = queryDeviceString(reinterpret_cast<EGLDeviceEXT>(device), EGL_DRM_RENDER_NODE_FILE_EXT);
+    if (!path) {
+        return -1;
+    }
+
+    int fd = open(path, O_RDWR | O_CLOEXEC);
+    if (fd >= 0) {
+        std::cout << "[GLContext] Using DRM render node " << path << std::endl;
+    }
+    return fd;
+}
+
+// Caller holds g_shareMutex
+static EGLContext acquireShareRoot() {
+    if (g_shareRefs == 0) {
+        EGLDisplay display = openDisplay();
+        EGLint major = 0;
+        EGLint minor = 0;
+        if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+            std::cerr << "[GLContext] Failed to initialize EGL display" << std::endl;
+            return EGL_NO_CONTEXT;
+        }
+
+        const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+        if (!extensions || !strstr(extensions, "EGL_KHR_surfaceless_context")) {
+            std::cerr << "[GLContext] EGL_KHR_surfaceless_context not supported" << std::endl;
+            eglTerminate(display);
+            return EGL_NO_CONTEXT;
+        }
+
+        const EGLint configAttributes[] = {
+            EGL_SURFACE_TYPE, EGL_DONT_CARE,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_NONE
+        };
+        EGLint numConfigs = 0;
+        if (!eglBindAPI(EGL_OPENGL_API) ||
+            !eglChooseConfig(display, configAttributes, &g_config, 1, &numConfigs) || numConfigs == 0) {
+            std::cerr << "[GLContext] No EGL config for desktop OpenGL" << std::endl;
+            eglTerminate(display);
+            return EGL_NO_CONTEXT;
+        }
+
+        g_rootContext = eglCreateContext(display, g_config, EGL_NO_CONTEXT, kContextAttributes);
+        if (g_rootContext == EGL_NO_CONTEXT) {
+            std::cerr << "[GLContext] Failed to create share group root context: "
+                      << std::hex << eglGetError() << std::dec << std::endl;
+            eglTerminate(display);
+            return EGL_NO_CONTEXT;
+        }
+
+        g_display = display;
+        g_drmFd = openRenderNode(display);
+        std::cout << "[GLContext] EGL " << major << "." << minor << " initialized" << std::endl;
+    }
+    g_shareRefs++;
+    return g_rootContext;
+}
+
+// Caller holds g_shareMutex
+static void releaseShareRoot() {
+    if (g_shareRefs == 0 || --g_shareRefs > 0) {
+        return;
+    }
+    if (g_rootContext != EGL_NO_CONTEXT) {
+        eglDestroyContext(g_display, g_rootContext);
+        g_rootContext = EGL_NO_CONTEXT;
+    }
+    if (g_drmFd >= 0) {
+        close(g_drmFd);
+        g_drmFd = -1;
+    }
+    if (g_display != EGL_NO_DISPLAY) {
+        eglTerminate(g_display);
+        g_display = EGL_NO_DISPLAY;
+    }
+    g_config = nullptr;
+}
+#endif
+
+GLContext::~GLContext() {
+    destroy();
+}
+
+bool GLContext::create() {
+    if (m_context) {
+        return true;
+    }
+
+#ifdef _WIN32
+    std::lock_guard<std::mutex> lock(g_shareMutex);
+
+    if (!acquireShareRoot()) {
+        return false;
+    }
+
+    if (g_angle) {
+        EGLContext context = g_egl->createContext(g_eglDisplay, g_eglConfig, g_angleRoot, kAngleContextAttributes);
+        if (!context) {
+            std::cerr << "[GLContext] Failed to create ANGLE context: "
+                      << std::hex << g_egl->getError() << std::dec << std::endl;
+            releaseShareRoot();
+            return false;
+        }
+
+        m_context = context;
+
+        if (!makeCurrent()) {
+            g_egl->destroyContext(g_eglDisplay, context);
+            m_context = nullptr;
+            releaseShareRoot();
+            return false;
+        }
+
+        // opengl32's glGetString has no context here; go through ANGLE
+        auto getString = reinterpret_cast<const GLubyte*(APIENTRY*)(GLenum)>(getProcAddress("glGetString"));
+        const char* renderer = getString ? reinterpret_cast<const char*>(getString(GL_RENDERER)) : nullptr;
+        std::cout << "[GLContext] OpenGL Renderer: " << (renderer ? renderer : "unknown") << std::endl;
+        std::cout << "[GLContext] Windows ANGLE context created (share group size " << g_shareRefs << ")" << std::endl;
+        return true;
+    }
+
+    HGLRC root = g_rootContext;
+
+    HWND window = nullptr;
+    HDC hdc = nullptr;
+    if (!createDummyWindow(window, hdc)) {
+        destroyDummyWindow(window, hdc);
+        releaseShareRoot();
+        return false;
+    }
+
+    // Create OpenGL context and join the share group before it owns any objects
+    HGLRC hglrc = wglCreateContext(hdc);
+    if (!hglrc) {
+        std::cerr << "[GLContext] Failed to create GL context" << std::endl;
+        destroyDummyWindow(window, hdc);
+        releaseShareRoot();
+        return false;
+    }
+    if (!wglShareLists(root, hglrc)) {
+        std::cerr << "[GLContext] Failed to join share group, error: " << GetLastError() << std::endl;
+        wglDeleteContext(hglrc);
+        destroyDummyWindow(window, hdc);
+        releaseShareRoot();
+        return false;
+    }
+
+    m_window = window;
+    m_hdc = hdc;
+    m_context = hglrc;
+
+    // Make it current
+    if (!makeCurrent()) {
+        std::cerr << "[GLContext] Failed to make GL context current" << std::endl;
+        wglDeleteContext(hglrc);
+        destroyDummyWindow(window, hdc);
+        m_window = nullptr;
+        m_hdc = nullptr;
+        m_context = nullptr;
+        releaseShareRoot();
+        return false;
+    }
+
+    // Check which GPU the OpenGL context is using
+    const char* vendor = (const char*)glGetString(GL_VENDOR);
+    const char* renderer = (const char*)glGetString(GL_RENDERER);
+    std::cout << "[GLContext] OpenGL Vendor: " << (vendor ? vendor : "unknown") << std::endl;
+    std::cout << "[GLContext] OpenGL Renderer: " << (renderer ? renderer : "unknown") << std::endl;
+
+    // Check if we're on NVIDIA - WGL_NV_DX_interop requires both D3D and GL on same GPU
+    if (renderer && strstr(renderer, "NVIDIA") == nullptr) {
+        std::cerr << "[GLContext] WARNING: OpenGL is not on NVIDIA GPU. WGL_NV_DX_interop may fail." << std::endl;
+        std::cerr << "[GLContext] Set NVIDIA as preferred GPU for this app in NVIDIA Control Panel." << std::endl;
+    }
+
+    std::cout << "[GLContext] Windows GL context created (share group size " << g_shareRefs << ")" << std::endl;
+    return true;
+#elif defined(__APPLE__)
+    std::lock_guard<std::mutex> lock(g_shareMutex);
+
+    CGLContextObj root = acquireShareRoot();
+    if (!root) {
+        return false;
+    }
+
+    CGLContextObj context = nullptr;
+    CGLError err = CGLCreateContext(g_pixelFormat, root, &context);
+    if (err != kCGLNoError) {
+        std::cerr << "[GLContext] Failed to create CGL context: " << err << std::endl;
+        releaseShareRoot();
+        return false;
+    }
+
+    m_context = context;
+
+    if (!makeCurrent()) {
+        CGLDestroyContext(context);
+        m_context = nullptr;
+        releaseShareRoot();
+        return false;
+    }
+
+    std::cout << "[GLContext] macOS CGL context created (share group size " << g_shareRefs << ")" << std::endl;
+    return true;
+#else
+    std::lock_guard<std::mutex> lock(g_shareMutex);
+
+    EGLContext root = acquireShareRoot();
+    if (root == EGL_NO_CONTEXT) {
+        return false;
+    }
+
+    EGLContext context = eglCreateContext(g_display, g_config, root, kContextAttributes);
+    if (context == EGL_NO_CONTEXT) {
+        std::cerr << "[GLContext] Failed to create EGL context: "
+                  << std::hex << eglGetError() << std::dec << std::endl;
+        releaseShareRoot();
+        return false;
+    }
+
+    m_context = context;
+
+    if (!makeCurrent()) {
+        eglDestroyContext(g_display, context);
+        m_context = nullptr;
+        releaseShareRoot();
+        return false;
+    }
+
+    const char* renderer = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    std::cout << "[GLContext] OpenGL Renderer: " << (renderer ? renderer : "unknown") << std::endl;
+    std::cout << "[GLContext] Linux EGL context created (share group size " << g_shareRefs << ")" << std::endl;
+    return true;
+#endif
+}
+
+void GLContext::destroy() {
+    if (!m_context) {
+        return;
+    }
+
+#ifdef _WIN32
+    releaseCurrent();
+    if (g_angle) {
+        g_egl->destroyContext(g_eglDisplay, static_cast<EGLContext>(m_context));
+    } else {
+        wglDeleteContext(static_cast<HGLRC>(m_context));
+    }
+    HWND window = static_cast<HWND>(m_window);
+    HDC hdc = static_cast<HDC>(m_hdc);
+    destroyDummyWindow(window, hdc);
+    m_window = nullptr;
+    m_hdc = nullptr;
+#elif defined(__APPLE__)
+    releaseCurrent();
+    CGLDestroyContext(static_cast<CGLContextObj>(m_context));
+#else
+    releaseCurrent();
+    eglDestroyContext(g_display, static_cast<EGLContext>(m_context));
+#endif
+    m_context = nullptr;
+
+    std::lock_guard<std::mutex> lock(g_shareMutex);
+    releaseShareRoot();
+}
+
+bool GLContext::makeCurrent() {
+#ifdef _WIN32
+    if (g_angle) {
+        if (!m_context) return false;
+        // The bound API is per thread
+        g_egl->bindAPI(EGL_OPENGL_ES_API);
+        if (!g_egl->makeCurrent(g_eglDisplay, nullptr, nullptr, static_cast<EGLContext>(m_context))) {
+            std::cerr << "[GLContext] Failed to make ANGLE context current: "
+                      << std::hex << g_egl->getError() << std::dec << std::endl;
+            return false;
+        }
+        return true;
+    }
+    if (!m_hdc || !m_context) return false;
+    return wglMakeCurrent(static_cast<HDC>(m_hdc), static_cast<HGLRC>(m_context)) == TRUE;
+#elif defined(__APPLE__)
+    if (!m_context) return false;
+    CGLError err = CGLSetCurrentContext(static_cast<CGLContextObj>(m_context));
+    if (err != kCGLNoError) {
+        std::cerr << "[GLContext] Failed to set CGL context current: " << err << std::endl;
+        return false;
+    }
+    return true;
+#else
+    if (!m_context) return false;
+    // The bound API is per thread; render threads start out with OpenGL ES
+    eglBindAPI(EGL_OPENGL_API);
+    if (!eglMakeCurrent(g_display, EGL_NO_SURFACE, EGL_NO_SURFACE, static_cast<EGLContext>(m_context))) {
+        std::cerr << "[GLContext] Failed to make EGL context current: "
+                  << std::hex << eglGetError() << std::dec << std::endl;
+        return false;
+    }
+    return true;
+#endif
+}
+
+void GLContext::releaseCurrent() {
+#ifdef _WIN32
+    if (g_angle) {
+        g_egl->makeCurrent(g_eglDisplay, nullptr, nullptr, nullptr);
+    } else {
+        wglMakeCurrent(nullptr, nullptr);
+    }
+#elif defined(__APPLE__)
+    CGLSetCurrentContext(nullptr);
+#else
+    eglMakeCurrent(g_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+#endif
+}
+
+void* GLContext::getProcAddress(const char* name) {
+#ifdef _WIN32
+    if (g_angle) {
+        // ANGLE resolves core GLES functions as well
+        return g_egl->getProcAddress(name);
+    }
+    void* addr = reinterpret_cast<void*>(wglGetProcAddress(name));
+    if (!addr) {
+        // Try loading from opengl32.dll for core functions
+        static HMODULE gl = LoadLibraryA("opengl32.dll");
+        if (gl) {
+            addr = reinterpret_cast<void*>(GetProcAddress(gl, name));
+        }
+    }
+    return addr;
+#elif defined(__APPLE__)
+    return dlsym(RTLD_DEFAULT, name);
+#else
+    return reinterpret_cast<void*>(eglGetProcAddress(name));
+#endif
+}
+
+bool GLContext::isANGLE() {
+#ifdef _WIN32
+    return g_angle;
+#else
+    return false;
+#endif
+}
+
+void* GLContext::eglDisplay() {
+#ifdef _WIN32
+    return g_angle ? g_eglDisplay : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+int GLContext::drmRenderFd() {
+#if !defined(_WIN32) && !defined(__APPLE__)
+    return g_drmFd;
+#else
+    return -1;
+#endif
+}
+
+} // namespace mpv_texture
@@ -0,0 +1,66 @@
+/*
+ * Offscreen OpenGL context owned by one player
+ *
+ * Every context joins a single process-wide share group (CGL share group on
+ * macOS, wglShareLists or a shared ANGLE context on Windows, a shared EGL
+ * context on Linux). The share
+ * group root is created with the first player and destroyed with the last,
+ * so N players pay for one set of driver state instead of N.
+ */
+
+#ifndef GL_CONTEXT_H_
+#define GL_CONTEXT_H_
+
+namespace mpv_texture {
+
+class GLContext {
+public:
+    GLContext() = default;
+    ~GLContext();
+
+    GLContext(const GLContext&) = delete;
+    GLContext& operator=(const GLContext&) = delete;
+
+    // Create the context (joining the shared group) and make it current
+    // on the calling thread
+    bool create();
+    void destroy();
+
+    // OpenGL contexts can only be current on one thread at a time
+    bool makeCurrent();
+    void releaseCurrent();
+
+    // Platform-specific handle (HGLRC or ANGLE EGLContext on Win, CGLContextObj on Mac,
+    // EGLContext on Linux)
+    void* nativeHandle() const { return m_context; }
+
+    // GL function loader for mpv_opengl_init_params
+    static void* getProcAddress(const char* name);
+
+    // Windows: true if the share group runs on ANGLE (GLES 3 on the shared
+    // D3D11 device) instead of desktop GL through WGL. Decided by the first
+    // context; valid while any context exists. False on other platforms.
+    static bool isANGLE();
+
+    // ANGLE's EGLDisplay while isANGLE(), nullptr otherwise
+    static void* eglDisplay();
+
+    // Linux: DRM render node of the GPU the share group runs on, for mpv's
+    // VAAPI interop (MPV_RENDER_PARAM_DRM_DISPLAY_V2). -1 if unknown or
+    // on other platforms. Valid while any context exists.
+    static int drmRenderFd();
+
+private:
+    void* m_context = nullptr;
+
+#ifdef _WIN32
+    // Each context gets its own hidden window/DC so render threads never
+    // share an HDC
+    void* m_window = nullptr;
+    void* m_hdc = nullptr;
+#endif
+};
+
+} // namespace mpv_texture
+
+#endif // GL_CONTEXT_H_
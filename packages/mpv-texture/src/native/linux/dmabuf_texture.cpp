@@ -0,0 +1,393 @@
+/*
+ * Linux dma-buf texture sharing implementation (EGL)
+ * Triple-buffered: mpv writes to one texture while Electron reads another.
+ * Each slot is a GL texture exported once as a dma-buf
+ * (EGL_MESA_image_dma_buf_export); its fd, stride and modifier are handed to
+ * Electron as a native pixmap. Exports are fenced (GLsync) and a texture is
+ * only rewritten after Electron has released it.
+ */
+
+#ifdef __linux__
+
+#include "../texture_share.h"
+#include "../slot_tracker.h"
+#include "../surface_pool.h"
+#define GL_GLEXT_PROTOTYPES
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/gl.h>
+#include <GL/glext.h>
+#include <unistd.h>
+#include <array>
+#include <cstring>
+#include <iostream>
+
+namespace mpv_texture {
+
+static const int BUFFER_COUNT = 3;
+
+struct DmaBufSlot {
+    GLuint glTexture = 0;
+    GLuint glFBO = 0;
+    EGLImageKHR image = EGL_NO_IMAGE_KHR;
+    // Exported once at creation and owned by the slot; Electron duplicates
+    // the fd on import, so the same fd is handed out for every frame
+    int fd = -1;
+    EGLint stride = 0;
+    EGLint offset = 0;
+    uint64_t modifier = 0;
+    GLsync fence = nullptr;  // Signals when mpv's render into this slot is done
+};
+
+using DmaBufSet = std::array<DmaBufSlot, BUFFER_COUNT>;
+
+class DmaBufTextureShare : public ITextureShare {
+public:
+    DmaBufTextureShare() = default;
+    ~DmaBufTextureShare() override { destroy(); }
+
+    bool initialize(void* gl_context) override {
+        m_context = static_cast<EGLContext>(gl_context);
+        m_display = eglGetCurrentDisplay();
+        if (m_display == EGL_NO_DISPLAY || m_context == EGL_NO_CONTEXT) {
+            std::cerr << "[DmaBuf] No current EGL context" << std::endl;
+            return false;
+        }
+
+        const char* extensions = eglQueryString(m_display, EGL_EXTENSIONS);
+        if (!extensions || !strstr(extensions, "EGL_MESA_image_dma_buf_export") ||
+            !strstr(extensions, "EGL_KHR_gl_texture_2D_image")) {
+            std::cerr << "[DmaBuf] EGL_MESA_image_dma_buf_export / EGL_KHR_gl_texture_2D_image not supported"
+                      << std::endl;
+            return false;
+        }
+
+        m_eglCreateImageKHR = reinterpret_cast<PFNEGLCREATEIMAGEKHRPROC>(
+            eglGetProcAddress("eglCreateImageKHR"));
+        m_eglDestroyImageKHR = reinterpret_cast<PFNEGLDESTROYIMAGEKHRPROC>(
+            eglGetProcAddress("eglDestroyImageKHR"));
+        m_eglExportDMABUFImageQueryMESA = reinterpret_cast<PFNEGLEXPORTDMABUFIMAGEQUERYMESAPROC>(
+            eglGetProcAddress("eglExportDMABUFImageQueryMESA"));
+        m_eglExportDMABUFImageMESA = reinterpret_cast<PFNEGLEXPORTDMABUFIMAGEMESAPROC>(
+            eglGetProcAddress("eglExportDMABUFImageMESA"));
+        if (!m_eglCreateImageKHR || !m_eglDestroyImageKHR ||
+            !m_eglExportDMABUFImageQueryMESA || !m_eglExportDMABUFImageMESA) {
+            std::cerr << "[DmaBuf] Failed to load EGL image export functions" << std::endl;
+            return false;
+        }
+
+        m_initialized = true;
+        return true;
+    }
+
+    bool createTexture(uint32_t width, uint32_t height, TextureFormat format) override {
+        if (!m_initialized) return false;
+
+        if (isPlanar(format)) {
+            // Multi-plane YUV dma-bufs would need a conversion pass per plane
+            std::cerr << "[DmaBuf] Planar export not supported" << std::endl;
+            return false;
+        }
+
+        for (int i = 0; i < BUFFER_COUNT; i++) {
+            if (!createSlot(m_slots[i], width, height)) {
+                for (int j = 0; j <= i; j++) {
+                    destroySlot(m_slots[j]);
+                }
+                return false;
+            }
+        }
+
+        bindSlots(width, height);
+        std::cout << "[DmaBuf] Created " << BUFFER_COUNT << " triple-buffered textures "
+                  << width << "x" << height << " (modifier 0x" << std::hex << m_slots[0].modifier
+                  << std::dec << ")" << std::endl;
+        return true;
+    }
+
+    bool resizeTexture(uint32_t width, uint32_t height, TextureFormat format) override {
+        if (isPlanar(format)) {
+            std::cerr << "[DmaBuf] Planar export not supported" << std::endl;
+            return false;
+        }
+        if (width == m_width && height == m_height) {
+            return true;
+        }
+
+        // Park the outgoing set instead of tearing it down; slots Electron
+        // still holds stay owned by it until released
+        m_locked = false;
+        m_tracker.park();
+        for (auto& slot : m_slots) {
+            dropFence(slot);
+        }
+        if (m_slots[0].fd >= 0) {
+            m_pool.put(SurfaceKey{m_width, m_height, TextureFormat::RGBA8},
+                       setBytes(m_width, m_height), std::move(m_slots),
+                       [this](DmaBufSet& set) { destroySet(set); });
+        }
+        m_slots = DmaBufSet{};
+        // Nothing bound until a set is: a failed resize must not look current
+        m_width = 0;
+        m_height = 0;
+
+        if (m_pool.take(SurfaceKey{width, height, TextureFormat::RGBA8}, m_slots)) {
+            bindSlots(width, height);
+            std::cout << "[DmaBuf] Reused pooled textures " << width << "x" << height << std::endl;
+            return true;
+        }
+
+        return createTexture(width, height, format);
+    }
+
+    void setPoolBudget(uint64_t bytes) override {
+        m_pool.setBudget(bytes);
+    }
+
+    uint32_t getGLTexture() const override {
+        return m_slots[m_writeIndex].glTexture;
+    }
+
+    uint32_t getGLFBO() const override {
+        return m_slots[m_writeIndex].glFBO;
+    }
+
+    uint32_t getGLInternalFormat() const override {
+        return GL_RGBA8;
+    }
+
+    bool lockTexture() override {
+        // Only slots Electron has released are eligible
+        int index = m_tracker.acquire(m_lastExported);
+        if (index < 0) return false;
+
+        auto& slot = m_slots[index];
+        if (slot.fd < 0) {
+            m_tracker.abandon(index);
+            return false;
+        }
+        dropFence(slot);
+
+        m_writeIndex = index;
+        m_locked = true;
+        return true;
+    }
+
+    TextureInfo unlockAndExport() override {
+        TextureInfo info = {};
+
+        if (!m_locked) {
+            return info;
+        }
+
+        m_locked = false;
+
+        auto& slot = m_slots[m_writeIndex];
+
+        // Fence the render and submit it; waitForExport() checks the fence.
+        // The consumer's access is ordered by the dma-buf's implicit sync.
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
+
+        info.handle = static_cast<uint64_t>(slot.fd);
+        info.width = m_width;
+        info.height = m_height;
+        info.format = TextureFormat::RGBA8;
+        info.stride = static_cast<uint32_t>(slot.stride);
+        info.offset = static_cast<uint32_t>(slot.offset);
+        info.modifier = slot.modifier;
+        info.is_valid = true;
+
+        info.generation = m_tracker.markExported(m_writeIndex);
+        m_lastExported = m_writeIndex;
+
+        return info;
+    }
+
+    void abandonTexture() override {
+        if (!m_locked) return;
+        m_locked = false;
+        m_tracker.abandon(m_writeIndex);
+    }
+
+    bool waitForExport(const TextureInfo& info, uint64_t timeoutNs) override {
+        for (auto& slot : m_slots) {
+            if (static_cast<uint64_t>(slot.fd) != info.handle) continue;
+            if (!slot.fence) return true;
+
+            GLenum result = glClientWaitSync(slot.fence, 0, timeoutNs);
+            if (result == GL_TIMEOUT_EXPIRED) {
+                return false;
+            }
+            if (result == GL_WAIT_FAILED) {
+                std::cerr << "[DmaBuf] glClientWaitSync failed" << std::endl;
+            }
+            dropFence(slot);
+            return true;
+        }
+        return true;  // Slot no longer exists (resized); nothing to wait for
+    }
+
+    void releaseTexture(uint64_t handle, uint64_t generation) override {
+        // Called from the JS thread — only flips slot ownership, no GL calls
+        m_tracker.release(handle, generation);
+    }
+
+    void destroy() override {
+        m_locked = false;
+        m_tracker.clear();
+
+        destroySet(m_slots);
+        m_pool.clear([this](DmaBufSet& set) { destroySet(set); });
+
+        m_initialized = false;
+    }
+
+private:
+    static uint64_t setBytes(uint32_t width, uint32_t height) {
+        return static_cast<uint64_t>(width) * height * 4 * BUFFER_COUNT;
+    }
+
+    // Make m_slots the active set: handles known to the tracker, slots free
+    // unless Electron still holds them from before the set was parked
+    void bindSlots(uint32_t width, uint32_t height) {
+        m_width = width;
+        m_height = height;
+
+        uint64_t handles[BUFFER_COUNT];
+        for (int i = 0; i < BUFFER_COUNT; i++) {
+            handles[i] = static_cast<uint64_t>(m_slots[i].fd);
+        }
+        m_tracker.reset(handles);
+
+        m_writeIndex = 0;
+        m_lastExported = BUFFER_COUNT - 1;
+    }
+
+    bool createSlot(DmaBufSlot& slot, uint32_t width, uint32_t height) {
+        // Create the texture; it must be complete (no mipmaps) before an
+        // EGLImage can be made from it
+        glGenTextures(1, &slot.glTexture);
+        glBindTexture(GL_TEXTURE_2D, slot.glTexture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        // Create FBO
+        glGenFramebuffers(1, &slot.glFBO);
+        glBindFramebuffer(GL_FRAMEBUFFER, slot.glFBO);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, slot.glTexture, 0);
+
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "[DmaBuf] FBO incomplete: " << std::hex << status << std::dec << std::endl;
+            return false;
+        }
+
+        // Wrap the texture in an EGLImage and export it as a dma-buf
+        const EGLint imageAttributes[] = {
+            EGL_GL_TEXTURE_LEVEL_KHR, 0,
+            EGL_NONE
+        };
+        slot.image = m_eglCreateImageKHR(m_display, m_context, EGL_GL_TEXTURE_2D_KHR,
+                                         reinterpret_cast<EGLClientBuffer>(static_cast<uintptr_t>(slot.glTexture)),
+                                         imageAttributes);
+        if (slot.image == EGL_NO_IMAGE_KHR) {
+            std::cerr << "[DmaBuf] Failed to create EGLImage: " << std::hex << eglGetError() << std::dec << std::endl;
+            return false;
+        }
+
+        int fourcc = 0;
+        int planes = 0;
+        EGLuint64KHR modifier = 0;
+        if (!m_eglExportDMABUFImageQueryMESA(m_display, slot.image, &fourcc, &planes, &modifier)) {
+            std::cerr << "[DmaBuf] Failed to query dma-buf export" << std::endl;
+            return false;
+        }
+        if (planes != 1) {
+            // e.g. compression metadata in an aux plane; Electron takes one plane here
+            std::cerr << "[DmaBuf] Unsupported " << planes << "-plane export (modifier 0x"
+                      << std::hex << modifier << std::dec << ")" << std::endl;
+            return false;
+        }
+
+        if (!m_eglExportDMABUFImageMESA(m_display, slot.image, &slot.fd, &slot.stride, &slot.offset)) {
+            std::cerr << "[DmaBuf] Failed to export dma-buf" << std::endl;
+            slot.fd = -1;
+            return false;
+        }
+        slot.modifier = modifier;
+        return true;
+    }
+
+    void dropFence(DmaBufSlot& slot) {
+        if (slot.fence) {
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+        }
+    }
+
+    void destroySlot(DmaBufSlot& slot) {
+        dropFence(slot);
+        if (slot.fd >= 0) {
+            close(slot.fd);
+            slot.fd = -1;
+        }
+        if (slot.image != EGL_NO_IMAGE_KHR) {
+            m_eglDestroyImageKHR(m_display, slot.image);
+            slot.image = EGL_NO_IMAGE_KHR;
+        }
+        if (slot.glFBO) {
+            glDeleteFramebuffers(1, &slot.glFBO);
+            slot.glFBO = 0;
+        }
+        if (slot.glTexture) {
+            glDeleteTextures(1, &slot.glTexture);
+            slot.glTexture = 0;
+        }
+    }
+
+    void destroySet(DmaBufSet& set) {
+        for (auto& slot : set) {
+            // The fd number is free for reuse once closed
+            if (slot.fd >= 0) {
+                m_tracker.forget(static_cast<uint64_t>(slot.fd));
+            }
+            destroySlot(slot);
+        }
+    }
+
+    bool m_initialized = false;
+    bool m_locked = false;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+
+    EGLDisplay m_display = EGL_NO_DISPLAY;
+    EGLContext m_context = EGL_NO_CONTEXT;
+
+    // Triple-buffered texture slots
+    DmaBufSet m_slots;
+    SlotTracker<BUFFER_COUNT> m_tracker;
+
+    // Texture sets of previous resolutions, kept for switch-back
+    SurfacePool<DmaBufSet> m_pool;
+    int m_writeIndex = 0;
+    int m_lastExported = BUFFER_COUNT - 1;
+
+    // EGL extension functions
+    PFNEGLCREATEIMAGEKHRPROC m_eglCreateImageKHR = nullptr;
+    PFNEGLDESTROYIMAGEKHRPROC m_eglDestroyImageKHR = nullptr;
+    PFNEGLEXPORTDMABUFIMAGEQUERYMESAPROC m_eglExportDMABUFImageQueryMESA = nullptr;
+    PFNEGLEXPORTDMABUFIMAGEMESAPROC m_eglExportDMABUFImageMESA = nullptr;
+};
+
+// Factory function
+ITextureShare* createTextureShare() {
+    return new DmaBufTextureShare();
+}
+
+} // namespace mpv_texture
+
+#endif // __linux__
@@ -0,0 +1,111 @@
+/*
+ * Bounded lock-free log ring (single producer, readers never block it)
+ *
+ * The event thread appends mpv log messages into fixed-size slots; once the
+ * ring is full the oldest entries are overwritten, so it always holds the
+ * most recent history for bug reports. Each slot carries a sequence number
+ * (odd while being written) that readers check before and after copying, so
+ * a reader racing the writer drops the torn entry instead of returning it.
+ * Nothing on the write path allocates or locks.
+ */
+
+#ifndef LOG_RING_H_
+#define LOG_RING_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace mpv_texture {
+
+struct LogEntry {
+    uint64_t timeUs;    // nowUs() when the event thread received it
+    int level;          // mpv_log_level
+    char prefix[32];    // Module, e.g. "ffmpeg/demuxer" (truncated)
+    char text[216];     // Message without the trailing newline (truncated)
+};
+
+class LogRing {
+public:
+    static const uint64_t CAPACITY = 512;  // Power of two
+
+    // Event thread only
+    void push(uint64_t timeUs, int level, const char* prefix, const char* text) {
+        uint64_t pos = m_head.load(std::memory_order_relaxed);
+        Slot& slot = m_slots[pos & (CAPACITY - 1)];
+
+        slot.seq.store(2 * pos + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.entry.timeUs = timeUs;
+        slot.entry.level = level;
+        copyString(slot.entry.prefix, sizeof(slot.entry.prefix), prefix);
+        copyString(slot.entry.text, sizeof(slot.entry.text), text);
+        size_t length = strlen(slot.entry.text);
+        if (length > 0 && slot.entry.text[length - 1] == '\n') {
+            slot.entry.text[length - 1] = '\0';
+        }
+
+        slot.seq.store(2 * pos + 2, std::memory_order_release);
+        m_head.store(pos + 1, std::memory_order_release);
+    }
+
+    // Append everything written after `cursor` (a previous written() value,
+    // 0 for all retained history) to `out` and advance the cursor. Returns
+    // the number of entries lost to overwriting in between.
+    uint64_t readSince(uint64_t& cursor, std::vector<LogEntry>& out) const {
+        uint64_t head = m_head.load(std::memory_order_acquire);
+        uint64_t start = head > CAPACITY ? head - CAPACITY : 0;
+        uint64_t lost = cursor < start ? start - cursor : 0;
+        if (cursor > start) {
+            start = cursor;
+        }
+
+        for (uint64_t pos = start; pos < head; pos++) {
+            const Slot& slot = m_slots[pos & (CAPACITY - 1)];
+            uint64_t seq = slot.seq.load(std::memory_order_acquire);
+            if (seq != 2 * pos + 2) {
+                lost++;  // Already overwritten by a newer lap
+                continue;
+            }
+            LogEntry entry;
+            std::memcpy(&entry, &slot.entry, sizeof(entry));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) != seq) {
+                lost++;  // Overwritten while copying
+                continue;
+            }
+            out.push_back(entry);
+        }
+
+        cursor = head;
+        return lost;
+    }
+
+    // Total entries ever written
+    uint64_t written() const { return m_head.load(std::memory_order_acquire); }
+
+private:
+    static void copyString(char* dest, size_t size, const char* src) {
+        if (!src) {
+            dest[0] = '\0';
+            return;
+        }
+        size_t length = strnlen(src, size - 1);
+        std::memcpy(dest, src, length);
+        dest[length] = '\0';
+    }
+
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        LogEntry entry;
+    };
+
+    Slot m_slots[CAPACITY];
+    std::atomic<uint64_t> m_head{0};
+};
+
+} // namespace mpv_texture
+
+#endif // LOG_RING_H_
@@ -1,29 +1,77 @@
 /*
  * macOS IOSurface texture sharing implementation
- * Triple-buffered: mpv writes to one surface while Electron reads another
+ * Triple-buffered: mpv writes to one surface while Electron reads another.
+ * Each export is fenced (GLsync) and a surface is only rewritten after
+ * Electron has released it.
+ *
+ * NV12 / P010 export uses biplanar IOSurfaces ('420v' / 'x420'). mpv renders
+ * into one intermediate RGBA16F texture, which a shader pass converts into
+ * the luma and chroma planes of the slot being exported.
  */
 
 #ifdef __APPLE__
 
 #include "../texture_share.h"
+#include "../slot_tracker.h"
+#include "../surface_pool.h"
 #define GL_SILENCE_DEPRECATION
 #include <OpenGL/gl3.h>
 #include <OpenGL/OpenGL.h>
 #include <OpenGL/CGLIOSurface.h>
 #include <IOSurface/IOSurface.h>
 #include <CoreFoundation/CoreFoundation.h>
+#include <array>
 #include <iostream>
 
 namespace mpv_texture {
 
 static const int BUFFER_COUNT = 3;
 
+// CoreVideo pixel formats of the biplanar surfaces (video range)
+static const OSType PIXEL_FORMAT_NV12 = '420v';  // kCVPixelFormatType_420YpCbCr8BiPlanarVideoRange
+static const OSType PIXEL_FORMAT_P010 = 'x420';  // kCVPixelFormatType_420YpCbCr10BiPlanarVideoRange
+
 struct IOSurfaceSlot {
     IOSurfaceRef ioSurface = nullptr;
-    GLuint glTexture = 0;
+    GLuint glTexture = 0;    // BGRA surface (packed formats)
     GLuint glFBO = 0;
+    GLuint planeTextures[2] = {0, 0};  // Luma and CbCr planes (NV12 / P010)
+    GLuint planeFBOs[2] = {0, 0};
+    GLsync fence = nullptr;  // Signals when mpv's render into this slot is done
 };
 
+// RGB -> YUV conversion for the planar formats. One fullscreen triangle per
+// plane; the chroma pass samples the center of each 2x2 block with linear
+// filtering, which averages the four pixels.
+static const char* CONVERT_VERTEX_SHADER = R"(#version 150
+void main() {
+    vec2 pos = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    gl_Position = vec4(pos * 2.0 - 1.0, 0.0, 1.0);
+}
+)";
+
+static const char* CONVERT_FRAGMENT_SHADER = R"(#version 150
+uniform sampler2DRect rgb;
+uniform int chroma;        // 0: luma plane, 1: interleaved CbCr plane
+uniform vec3 lumaCoeffs;   // Kr, Kg, Kb
+uniform vec2 chromaScale;  // 1 / (2 (1 - Kb)), 1 / (2 (1 - Kr))
+uniform vec4 range;        // Luma offset / scale, chroma offset / scale
+out vec4 color;
+void main() {
+    if (chroma == 0) {
+        float y = dot(texture(rgb, gl_FragCoord.xy).rgb, lumaCoeffs);
+        color = vec4(range.x + range.y * y, 0.0, 0.0, 1.0);
+    } else {
+        vec3 c = texture(rgb, gl_FragCoord.xy * 2.0).rgb;
+        float y = dot(c, lumaCoeffs);
+        vec2 cbcr = vec2(c.b - y, c.r - y) * chromaScale;
+        color = vec4(range.z + range.w * cbcr, 0.0, 1.0);
+    }
+}
+)";
+
+using IOSurfaceSet = std::array<IOSurfaceSlot, BUFFER_COUNT>;
+
 class IOSurfaceTextureShare : public ITextureShare {
 public:
     IOSurfaceTextureShare() = default;
@@ -44,50 +92,98 @@ public:
         return true;
     }
 
-    bool createTexture(uint32_t width, uint32_t height) override {
+    bool createTexture(uint32_t width, uint32_t height, TextureFormat format) override {
         if (!m_initialized) return false;
 
-        m_width = width;
-        m_height = height;
+        format = nativeFormat(format);
+        if (isPlanar(format) && !createConverter()) {
+            return false;
+        }
 
         for (int i = 0; i < BUFFER_COUNT; i++) {
-            if (!createSlot(m_slots[i], width, height)) {
-                for (int j = 0; j < i; j++) {
+            if (!createSlot(m_slots[i], width, height, format)) {
+                for (int j = 0; j <= i; j++) {
                     destroySlot(m_slots[j]);
                 }
                 return false;
             }
         }
 
-        m_writeIndex = 0;
-        std::cout << "[IOSurface] Created " << BUFFER_COUNT << " triple-buffered textures "
-                  << width << "x" << height << std::endl;
+        if (!bindSlots(width, height, format)) {
+            destroySet(m_slots);
+            return false;
+        }
+        std::cout << "[IOSurface] Created " << BUFFER_COUNT << " triple-buffered "
+                  << formatName(format) << " textures " << width << "x" << height << std::endl;
         return true;
     }
 
-    bool resizeTexture(uint32_t width, uint32_t height) override {
-        if (width == m_width && height == m_height) {
+    bool resizeTexture(uint32_t width, uint32_t height, TextureFormat format) override {
+        format = nativeFormat(format);
+        if (width == m_width && height == m_height && format == m_format) {
             return true;
         }
 
-        for (int i = 0; i < BUFFER_COUNT; i++) {
-            destroySlot(m_slots[i]);
+        // Park the outgoing set instead of tearing it down; slots Electron
+        // still holds stay owned by it until released
+        m_locked = false;
+        m_tracker.park();
+        for (auto& slot : m_slots) {
+            dropFence(slot);
+        }
+        if (m_slots[0].ioSurface) {
+            m_pool.put(SurfaceKey{m_width, m_height, m_format},
+                       setBytes(m_width, m_height, m_format), std::move(m_slots),
+                       [this](IOSurfaceSet& set) { destroySet(set); });
+        }
+        m_slots = IOSurfaceSet{};
+        // Nothing bound until a set is: a failed resize must not look current
+        m_width = 0;
+        m_height = 0;
+
+        if (m_pool.take(SurfaceKey{width, height, format}, m_slots)) {
+            if (bindSlots(width, height, format)) {
+                std::cout << "[IOSurface] Reused pooled " << formatName(format) << " textures "
+                          << width << "x" << height << std::endl;
+                return true;
+            }
+            destroySet(m_slots);
         }
 
-        return createTexture(width, height);
+        return createTexture(width, height, format);
+    }
+
+    void setPoolBudget(uint64_t bytes) override {
+        m_pool.setBudget(bytes);
     }
 
     uint32_t getGLTexture() const override {
-        return m_slots[m_writeIndex].glTexture;
+        // Planar formats: mpv renders RGB into the intermediate target
+        return isPlanar(m_format) ? m_convert.rgbTexture : m_slots[m_writeIndex].glTexture;
     }
 
     uint32_t getGLFBO() const override {
-        return m_slots[m_writeIndex].glFBO;
+        return isPlanar(m_format) ? m_convert.rgbFBO : m_slots[m_writeIndex].glFBO;
+    }
+
+    uint32_t getGLInternalFormat() const override {
+        return isPlanar(m_format) ? GL_RGBA16F : GL_RGBA8;
     }
 
     bool lockTexture() override {
-        if (!m_slots[m_writeIndex].ioSurface) return false;
-        // No IOSurfaceLock needed — GPU-to-GPU sharing uses glFlush for sync
+        // Only slots Electron has released are eligible
+        int index = m_tracker.acquire(m_lastExported);
+        if (index < 0) return false;
+
+        auto& slot = m_slots[index];
+        if (!slot.ioSurface) {
+            m_tracker.abandon(index);
+            return false;
+        }
+        dropFence(slot);
+
+        // No IOSurfaceLock needed — GPU-to-GPU sharing is ordered by the fence
+        m_writeIndex = index;
         m_locked = true;
         return true;
     }
@@ -102,37 +198,136 @@ public:
         m_locked = false;
 
         auto& slot = m_slots[m_writeIndex];
+        if (isPlanar(m_format)) {
+            convertPlanes(slot);
+        }
+
+        // Fence the render and submit it; waitForExport() checks the fence
+        // instead of stalling the whole pipeline with glFinish
+        slot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glFlush();
 
         // Pass IOSurfaceRef as raw pointer — Electron's importSharedTexture expects
         // the ioSurface Buffer to contain the IOSurfaceRef pointer, not the IOSurfaceID.
         info.handle = reinterpret_cast<uint64_t>(slot.ioSurface);
         info.width = m_width;
         info.height = m_height;
-        info.format = TextureFormat::BGRA8;
+        info.format = m_format;
         info.is_valid = true;
 
-        // Swap to next buffer for next frame
-        m_writeIndex = (m_writeIndex + 1) % BUFFER_COUNT;
+        info.generation = m_tracker.markExported(m_writeIndex);
+        m_lastExported = m_writeIndex;
 
         return info;
     }
 
-    void releaseTexture() override {
-        // No-op with triple buffering - mpv always has a free slot to write to
+    void abandonTexture() override {
+        if (!m_locked) return;
+        m_locked = false;
+        m_tracker.abandon(m_writeIndex);
+    }
+
+    bool waitForExport(const TextureInfo& info, uint64_t timeoutNs) override {
+        for (auto& slot : m_slots) {
+            if (reinterpret_cast<uint64_t>(slot.ioSurface) != info.handle) continue;
+            if (!slot.fence) return true;
+
+            GLenum result = glClientWaitSync(slot.fence, 0, timeoutNs);
+            if (result == GL_TIMEOUT_EXPIRED) {
+                return false;
+            }
+            if (result == GL_WAIT_FAILED) {
+                std::cerr << "[IOSurface] glClientWaitSync failed" << std::endl;
+            }
+            dropFence(slot);
+            return true;
+        }
+        return true;  // Slot no longer exists (resized); nothing to wait for
+    }
+
+    void releaseTexture(uint64_t handle, uint64_t generation) override {
+        // Called from the JS thread — only flips slot ownership, no GL calls
+        m_tracker.release(handle, generation);
     }
 
     void destroy() override {
         m_locked = false;
+        m_tracker.clear();
 
-        for (int i = 0; i < BUFFER_COUNT; i++) {
-            destroySlot(m_slots[i]);
-        }
+        destroySet(m_slots);
+        m_pool.clear([this](IOSurfaceSet& set) { destroySet(set); });
+        destroyConverter();
 
         m_initialized = false;
     }
 
 private:
-    bool createSlot(IOSurfaceSlot& slot, uint32_t width, uint32_t height) {
+    // Packed requests map to the IOSurface native BGRA order
+    static TextureFormat nativeFormat(TextureFormat format) {
+        return isPlanar(format) ? format : TextureFormat::BGRA8;
+    }
+
+    static const char* formatName(TextureFormat format) {
+        switch (format) {
+            case TextureFormat::NV12: return "NV12";
+            case TextureFormat::P010: return "P010";
+            default: return "BGRA";
+        }
+    }
+
+    static uint64_t setBytes(uint32_t width, uint32_t height, TextureFormat format) {
+        uint64_t pixels = static_cast<uint64_t>(width) * height;
+        switch (format) {
+            case TextureFormat::NV12: return pixels * 3 / 2 * BUFFER_COUNT;
+            case TextureFormat::P010: return pixels * 3 * BUFFER_COUNT;
+            default: return pixels * 4 * BUFFER_COUNT;
+        }
+    }
+
+    // Make m_slots the active set: handles known to the tracker, slots free
+    // unless Electron still holds them from before the set was parked
+    bool bindSlots(uint32_t width, uint32_t height, TextureFormat format) {
+        // The intermediate RGB target follows the set; packed sets don't need it
+        if (isPlanar(format)) {
+            if (!resizeConverterTarget(width, height)) {
+                return false;
+            }
+        } else {
+            destroyConverterTarget();
+        }
+
+        m_width = width;
+        m_height = height;
+        m_format = format;
+
+        uint64_t handles[BUFFER_COUNT];
+        for (int i = 0; i < BUFFER_COUNT; i++) {
+            handles[i] = reinterpret_cast<uint64_t>(m_slots[i].ioSurface);
+        }
+        m_tracker.reset(handles);
+
+        m_writeIndex = 0;
+        m_lastExported = BUFFER_COUNT - 1;
+        return true;
+    }
+
+    static void setNumber(CFMutableDictionaryRef dict, CFStringRef key, int64_t value) {
+        CFNumberRef number = CFNumberCreate(kCFAllocatorDefault, kCFNumberSInt64Type, &value);
+        CFDictionarySetValue(dict, key, number);
+        CFRelease(number);
+    }
+
+    static CFMutableDictionaryRef createDictionary() {
+        return CFDictionaryCreateMutable(kCFAllocatorDefault, 0,
+                                         &kCFTypeDictionaryKeyCallBacks,
+                                         &kCFTypeDictionaryValueCallBacks);
+    }
+
+    bool createSlot(IOSurfaceSlot& slot, uint32_t width, uint32_t height, TextureFormat format) {
+        if (isPlanar(format)) {
+            return createPlanarSlot(slot, width, height, format);
+        }
+
         // Create IOSurface
         CFMutableDictionaryRef properties = CFDictionaryCreateMutable(
             kCFAllocatorDefault,
@@ -209,7 +404,271 @@ private:
         return true;
     }
 
+    // Biplanar 4:2:0 surface: full-size luma plane, half-size interleaved CbCr
+    bool createPlanarSlot(IOSurfaceSlot& slot, uint32_t width, uint32_t height, TextureFormat format) {
+        bool tenBit = format == TextureFormat::P010;
+        size_t sampleBytes = tenBit ? 2 : 1;
+        uint32_t chromaWidth = width / 2;
+        uint32_t chromaHeight = height / 2;
+
+        size_t lumaRow = IOSurfaceAlignProperty(kIOSurfacePlaneBytesPerRow, width * sampleBytes);
+        size_t chromaRow = IOSurfaceAlignProperty(kIOSurfacePlaneBytesPerRow, chromaWidth * sampleBytes * 2);
+        size_t lumaSize = IOSurfaceAlignProperty(kIOSurfacePlaneSize, lumaRow * height);
+        size_t chromaSize = IOSurfaceAlignProperty(kIOSurfacePlaneSize, chromaRow * chromaHeight);
+
+        CFMutableDictionaryRef luma = createDictionary();
+        setNumber(luma, kIOSurfacePlaneWidth, width);
+        setNumber(luma, kIOSurfacePlaneHeight, height);
+        setNumber(luma, kIOSurfacePlaneBytesPerElement, sampleBytes);
+        setNumber(luma, kIOSurfacePlaneBytesPerRow, lumaRow);
+        setNumber(luma, kIOSurfacePlaneOffset, 0);
+        setNumber(luma, kIOSurfacePlaneSize, lumaSize);
+
+        CFMutableDictionaryRef chroma = createDictionary();
+        setNumber(chroma, kIOSurfacePlaneWidth, chromaWidth);
+        setNumber(chroma, kIOSurfacePlaneHeight, chromaHeight);
+        setNumber(chroma, kIOSurfacePlaneBytesPerElement, sampleBytes * 2);
+        setNumber(chroma, kIOSurfacePlaneBytesPerRow, chromaRow);
+        setNumber(chroma, kIOSurfacePlaneOffset, lumaSize);
+        setNumber(chroma, kIOSurfacePlaneSize, chromaSize);
+
+        CFMutableArrayRef planes = CFArrayCreateMutable(kCFAllocatorDefault, 2, &kCFTypeArrayCallBacks);
+        CFArrayAppendValue(planes, luma);
+        CFArrayAppendValue(planes, chroma);
+        CFRelease(luma);
+        CFRelease(chroma);
+
+        CFMutableDictionaryRef properties = createDictionary();
+        setNumber(properties, kIOSurfaceWidth, width);
+        setNumber(properties, kIOSurfaceHeight, height);
+        setNumber(properties, kIOSurfacePixelFormat, tenBit ? PIXEL_FORMAT_P010 : PIXEL_FORMAT_NV12);
+        setNumber(properties, kIOSurfaceAllocSize, lumaSize + chromaSize);
+        CFDictionarySetValue(properties, kIOSurfacePlaneInfo, planes);
+        CFRelease(planes);
+
+        slot.ioSurface = IOSurfaceCreate(properties);
+        CFRelease(properties);
+
+        if (!slot.ioSurface) {
+            std::cerr << "[IOSurface] Failed to create " << formatName(format) << " IOSurface" << std::endl;
+            return false;
+        }
+
+        // One GL texture + FBO per plane; P010 samples are 16-bit with the
+        // 10 significant bits on top, so they are plain R16/RG16 to GL
+        GLenum type = tenBit ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE;
+        const struct {
+            GLenum internalFormat;
+            GLenum format;
+            uint32_t width;
+            uint32_t height;
+        } planeLayouts[2] = {
+            {static_cast<GLenum>(tenBit ? GL_R16 : GL_R8), GL_RED, width, height},
+            {static_cast<GLenum>(tenBit ? GL_RG16 : GL_RG8), GL_RG, chromaWidth, chromaHeight},
+        };
+
+        for (GLuint plane = 0; plane < 2; plane++) {
+            const auto& layout = planeLayouts[plane];
+            glGenTextures(1, &slot.planeTextures[plane]);
+            glBindTexture(GL_TEXTURE_RECTANGLE, slot.planeTextures[plane]);
+
+            CGLError err = CGLTexImageIOSurface2D(m_cglContext, GL_TEXTURE_RECTANGLE,
+                                                  layout.internalFormat, layout.width, layout.height,
+                                                  layout.format, type, slot.ioSurface, plane);
+            if (err != kCGLNoError) {
+                std::cerr << "[IOSurface] Failed to bind IOSurface plane " << plane
+                          << " to texture: " << err << std::endl;
+                return false;
+            }
+
+            glGenFramebuffers(1, &slot.planeFBOs[plane]);
+            glBindFramebuffer(GL_FRAMEBUFFER, slot.planeFBOs[plane]);
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_RECTANGLE,
+                                   slot.planeTextures[plane], 0);
+
+            GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+            if (status != GL_FRAMEBUFFER_COMPLETE) {
+                std::cerr << "[IOSurface] Plane " << plane << " FBO incomplete: "
+                          << std::hex << status << std::dec << std::endl;
+                glBindFramebuffer(GL_FRAMEBUFFER, 0);
+                return false;
+            }
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        return true;
+    }
+
+    static GLuint compileShader(GLenum type, const char* source) {
+        GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, nullptr);
+        glCompileShader(shader);
+
+        GLint ok = GL_FALSE;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+        if (!ok) {
+            char log[512] = {};
+            glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+            std::cerr << "[IOSurface] Conversion shader failed to compile: " << log << std::endl;
+            glDeleteShader(shader);
+            return 0;
+        }
+        return shader;
+    }
+
+    // Build the RGB -> YUV program once per context
+    bool createConverter() {
+        if (m_convert.program) return true;
+
+        GLuint vertex = compileShader(GL_VERTEX_SHADER, CONVERT_VERTEX_SHADER);
+        GLuint fragment = compileShader(GL_FRAGMENT_SHADER, CONVERT_FRAGMENT_SHADER);
+        if (!vertex || !fragment) {
+            if (vertex) glDeleteShader(vertex);
+            if (fragment) glDeleteShader(fragment);
+            return false;
+        }
+
+        GLuint program = glCreateProgram();
+        glAttachShader(program, vertex);
+        glAttachShader(program, fragment);
+        glLinkProgram(program);
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+
+        GLint ok = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &ok);
+        if (!ok) {
+            char log[512] = {};
+            glGetProgramInfoLog(program, sizeof(log), nullptr, log);
+            std::cerr << "[IOSurface] Conversion program failed to link: " << log << std::endl;
+            glDeleteProgram(program);
+            return false;
+        }
+
+        m_convert.program = program;
+        m_convert.chromaLoc = glGetUniformLocation(program, "chroma");
+        m_convert.lumaCoeffsLoc = glGetUniformLocation(program, "lumaCoeffs");
+        m_convert.chromaScaleLoc = glGetUniformLocation(program, "chromaScale");
+        m_convert.rangeLoc = glGetUniformLocation(program, "range");
+        glUseProgram(program);
+        glUniform1i(glGetUniformLocation(program, "rgb"), 0);
+        glUseProgram(0);
+
+        // Core profile needs a bound VAO even for attribute-less draws
+        glGenVertexArrays(1, &m_convert.vao);
+        return true;
+    }
+
+    // (Re)allocate the intermediate RGB target mpv renders into
+    bool resizeConverterTarget(uint32_t width, uint32_t height) {
+        if (m_convert.rgbTexture && m_convert.width == width && m_convert.height == height) {
+            return true;
+        }
+        destroyConverterTarget();
+
+        // Half float keeps 10-bit (and PQ-encoded HDR) precision until the planes
+        glGenTextures(1, &m_convert.rgbTexture);
+        glBindTexture(GL_TEXTURE_RECTANGLE, m_convert.rgbTexture);
+        glTexImage2D(GL_TEXTURE_RECTANGLE, 0, GL_RGBA16F, width, height, 0, GL_RGBA, GL_HALF_FLOAT, nullptr);
+        glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_RECTANGLE, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        glGenFramebuffers(1, &m_convert.rgbFBO);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_convert.rgbFBO);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_RECTANGLE,
+                               m_convert.rgbTexture, 0);
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            std::cerr << "[IOSurface] Conversion FBO incomplete: " << std::hex << status << std::dec << std::endl;
+            destroyConverterTarget();
+            return false;
+        }
+
+        m_convert.width = width;
+        m_convert.height = height;
+        return true;
+    }
+
+    // Convert the intermediate RGB render into the slot's planes
+    void convertPlanes(IOSurfaceSlot& slot) {
+        // BT.709 for NV12, BT.2020 for P010 (limited range, see TextureFormat)
+        bool bt2020 = m_format == TextureFormat::P010;
+        float kr = bt2020 ? 0.2627f : 0.2126f;
+        float kb = bt2020 ? 0.0593f : 0.0722f;
+
+        // Normalized limited-range codes; P010 keeps 10 bits in the top of 16
+        float range[4];
+        if (m_format == TextureFormat::P010) {
+            const float scale = 64.0f / 65535.0f;
+            range[0] = 64.0f * scale;
+            range[1] = 876.0f * scale;
+            range[2] = 512.0f * scale;
+            range[3] = 896.0f * scale;
+        } else {
+            range[0] = 16.0f / 255.0f;
+            range[1] = 219.0f / 255.0f;
+            range[2] = 128.0f / 255.0f;
+            range[3] = 224.0f / 255.0f;
+        }
+
+        glDisable(GL_BLEND);
+        glUseProgram(m_convert.program);
+        glUniform3f(m_convert.lumaCoeffsLoc, kr, 1.0f - kr - kb, kb);
+        glUniform2f(m_convert.chromaScaleLoc, 0.5f / (1.0f - kb), 0.5f / (1.0f - kr));
+        glUniform4fv(m_convert.rangeLoc, 1, range);
+        glBindVertexArray(m_convert.vao);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_RECTANGLE, m_convert.rgbTexture);
+
+        for (int plane = 0; plane < 2; plane++) {
+            glBindFramebuffer(GL_FRAMEBUFFER, slot.planeFBOs[plane]);
+            glViewport(0, 0, plane ? m_width / 2 : m_width, plane ? m_height / 2 : m_height);
+            glUniform1i(m_convert.chromaLoc, plane);
+            glDrawArrays(GL_TRIANGLES, 0, 3);
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glBindVertexArray(0);
+        glUseProgram(0);
+    }
+
+    void destroyConverterTarget() {
+        if (m_convert.rgbFBO) {
+            glDeleteFramebuffers(1, &m_convert.rgbFBO);
+            m_convert.rgbFBO = 0;
+        }
+        if (m_convert.rgbTexture) {
+            glDeleteTextures(1, &m_convert.rgbTexture);
+            m_convert.rgbTexture = 0;
+        }
+        m_convert.width = 0;
+        m_convert.height = 0;
+    }
+
+    void destroyConverter() {
+        destroyConverterTarget();
+        if (m_convert.vao) {
+            glDeleteVertexArrays(1, &m_convert.vao);
+            m_convert.vao = 0;
+        }
+        if (m_convert.program) {
+            glDeleteProgram(m_convert.program);
+            m_convert.program = 0;
+        }
+    }
+
+    void dropFence(IOSurfaceSlot& slot) {
+        if (slot.fence) {
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+        }
+    }
+
     void destroySlot(IOSurfaceSlot& slot) {
+        dropFence(slot);
         if (slot.glFBO) {
             glDeleteFramebuffers(1, &slot.glFBO);
             slot.glFBO = 0;
@@ -218,22 +677,60 @@ private:
             glDeleteTextures(1, &slot.glTexture);
             slot.glTexture = 0;
         }
+        for (int plane = 0; plane < 2; plane++) {
+            if (slot.planeFBOs[plane]) {
+                glDeleteFramebuffers(1, &slot.planeFBOs[plane]);
+                slot.planeFBOs[plane] = 0;
+            }
+            if (slot.planeTextures[plane]) {
+                glDeleteTextures(1, &slot.planeTextures[plane]);
+                slot.planeTextures[plane] = 0;
+            }
+        }
         if (slot.ioSurface) {
             CFRelease(slot.ioSurface);
             slot.ioSurface = nullptr;
         }
     }
 
+    void destroySet(IOSurfaceSet& set) {
+        for (auto& slot : set) {
+            // The pointer may be reused by a new surface
+            m_tracker.forget(reinterpret_cast<uint64_t>(slot.ioSurface));
+            destroySlot(slot);
+        }
+    }
+
     bool m_initialized = false;
     bool m_locked = false;
     uint32_t m_width = 0;
     uint32_t m_height = 0;
+    TextureFormat m_format = TextureFormat::BGRA8;
 
     CGLContextObj m_cglContext = nullptr;
 
+    // Planar export: conversion program and the RGB target mpv renders into
+    struct {
+        GLuint program = 0;
+        GLuint vao = 0;
+        GLint chromaLoc = -1;
+        GLint lumaCoeffsLoc = -1;
+        GLint chromaScaleLoc = -1;
+        GLint rangeLoc = -1;
+        GLuint rgbTexture = 0;
+        GLuint rgbFBO = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+    } m_convert;
+
     // Triple-buffered texture slots
-    IOSurfaceSlot m_slots[BUFFER_COUNT];
+    IOSurfaceSet m_slots;
+    SlotTracker<BUFFER_COUNT> m_tracker;
+
+    // Surface sets of previous resolutions, kept for switch-back
+    SurfacePool<IOSurfaceSet> m_pool;
     int m_writeIndex = 0;
+    int m_lastExported = BUFFER_COUNT - 1;
 };
 
 // Factory function
@@ -3,183 +3,266 @@
  */
 
 #include "mpv_context.h"
+#include "compositor.h"
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <iostream>
 
 #ifdef _WIN32
 #include <windows.h>
 #include <gl/GL.h>
-// WGL function types (wglGetProcAddress is in wingdi.h)
-typedef HGLRC(WINAPI* PFNWGLCREATECONTEXTATTRIBSARBPROC)(HDC, HGLRC, const int*);
-typedef BOOL(WINAPI* PFNWGLMAKECURRENTPROC)(HDC, HGLRC);
-typedef PROC(WINAPI* PFNWGLGETPROCADDRESSPROC)(LPCSTR);
 #elif defined(__APPLE__)
 #define GL_SILENCE_DEPRECATION
 #include <OpenGL/gl3.h>
-#include <OpenGL/OpenGL.h>
-#include <dlfcn.h>
 #else
 #include <GL/gl.h>
-#include <GL/glx.h>
 #endif
 
 namespace mpv_texture {
 
-MpvContext::MpvContext() = default;
-
-MpvContext::~MpvContext() {
-    destroy();
+// reply_userdata IDs for observed properties, so events dispatch on an
+// integer switch instead of a name comparison chain
+enum PropertyId : uint64_t {
+    PROP_PAUSE = 1,
+    PROP_VOLUME,
+    PROP_MUTE,
+    PROP_TIME_POS,
+    PROP_DURATION,
+    PROP_VIDEO_PARAMS,
+    PROP_SUB_TEXT,
+    PROP_SUB_ASS,
+    PROP_SUB_IMAGE,
+};
+
+// A promoted live standby further behind its buffered data than this jumps ahead
+static const double STANDBY_CATCHUP_SECS = 2.0;
+
+// Longest the render thread blocks on one export fence before re-checking
+// for new render requests
+static const uint64_t FENCE_WAIT_NS = 2000000;
+
+// Queued thumbnail captures per player beyond which requests are refused
+static const size_t MAX_PENDING_THUMBNAILS = 4;
+
+// Taken frames tracked for the trace's HOLD events; more than the deepest
+// slot ring, so only a leaked (never released) frame falls out
+static const size_t MAX_HELD_FRAMES = 16;
+
+// RenderMode::THROTTLED: minimum interval between rendered frames
+static const uint64_t THROTTLED_INTERVAL_US = 1000000;
+
+// How often the render thread checks readbacks while it would otherwise idle
+static const uint64_t THUMBNAIL_POLL_US = 2000;
+
+// displaySync: headroom kept between a paced render's expected completion and
+// its vsync, for scheduling jitter and the compositor picking the frame up
+static const uint64_t PACING_MARGIN_US = 3000;
+// A paced render due sooner than this starts right away
+static const uint64_t PACING_SLACK_US = 500;
+// Refresh rate changes smaller than this (relative) are not pushed to mpv
+static const double DISPLAY_FPS_TOLERANCE = 0.005;
+
+// Options set by every PlaybackProfile, and each profile's values (rows in
+// enum order, starting at DEFAULT). The default and vod rows probe as much
+// as lavf does on its own (5 MB; analyzeduration 0 = lavf's 5 s); video-sync
+// is left to displaySync.
+static const char* const PROFILE_OPTION_NAMES[] = {
+    "cache", "cache-secs", "cache-pause", "cache-pause-initial", "cache-pause-wait",
+    "demuxer-readahead-secs", "demuxer-max-bytes", "demuxer-max-back-bytes",
+    "demuxer-lavf-probesize", "demuxer-lavf-analyzeduration",
+    "network-timeout", "video-latency-hacks",
+};
+static const size_t PROFILE_OPTION_COUNT = sizeof(PROFILE_OPTION_NAMES) / sizeof(PROFILE_OPTION_NAMES[0]);
+
+static const struct {
+    const char* name;
+    const char* values[PROFILE_OPTION_COUNT];
+} PROFILE_OPTIONS[] = {
+    {"default",          {"auto", "3600000", "yes", "no", "1", "1", "150MiB", "50MiB", "5000000", "0", "60", "no"}},
+    {"low-latency-live", {"yes", "2", "no", "no", "1", "2", "32MiB", "0", "500000", "0.5", "5", "yes"}},
+    {"stable-live",      {"yes", "10", "yes", "no", "2", "10", "64MiB", "16MiB", "1000000", "1", "15", "no"}},
+    {"vod",              {"yes", "60", "yes", "yes", "1", "60", "256MiB", "128MiB", "5000000", "0", "30", "no"}},
+};
+
+static size_t profileIndex(PlaybackProfile profile) {
+    return static_cast<size_t>(profile) - static_cast<size_t>(PlaybackProfile::DEFAULT);
 }
 
-// Platform-specific GL context creation
-#ifdef _WIN32
-static HWND g_dummyWindow = nullptr;
-static HDC g_hdc = nullptr;
-static HGLRC g_hglrc = nullptr;
-
-static bool createWindowsGLContext() {
-    // Register dummy window class
-    WNDCLASSA wc = {};
-    wc.lpfnWndProc = DefWindowProcA;
-    wc.hInstance = GetModuleHandle(nullptr);
-    wc.lpszClassName = "MpvTextureDummyWindow";
-    RegisterClassA(&wc);
-
-    // Create hidden window
-    g_dummyWindow = CreateWindowExA(
-        0, "MpvTextureDummyWindow", "", 0,
-        0, 0, 1, 1, nullptr, nullptr,
-        GetModuleHandle(nullptr), nullptr
-    );
-    if (!g_dummyWindow) {
-        std::cerr << "[MpvContext] Failed to create dummy window" << std::endl;
-        return false;
+bool parsePlaybackProfile(const std::string& name, PlaybackProfile& out) {
+    for (size_t i = 0; i < sizeof(PROFILE_OPTIONS) / sizeof(PROFILE_OPTIONS[0]); i++) {
+        if (name == PROFILE_OPTIONS[i].name) {
+            out = static_cast<PlaybackProfile>(static_cast<size_t>(PlaybackProfile::DEFAULT) + i);
+            return true;
+        }
     }
+    return false;
+}
 
-    g_hdc = GetDC(g_dummyWindow);
-    if (!g_hdc) {
-        std::cerr << "[MpvContext] Failed to get DC" << std::endl;
-        return false;
+// Options fast render overrides, and the cheaper values it uses. Every
+// pass still runs; only its filters get cheaper, at some cost in quality.
+static const char* const FAST_RENDER_OPTIONS[][2] = {
+    {"scale", "bilinear"}, {"dscale", "bilinear"}, {"cscale", "bilinear"},
+    {"dither-depth", "no"}, {"deband", "no"}, {"correct-downscaling", "no"},
+    {"linear-downscaling", "no"}, {"sigmoid-upscaling", "no"}, {"hdr-compute-peak", "no"},
+};
+static const size_t FAST_RENDER_OPTION_COUNT = sizeof(FAST_RENDER_OPTIONS) / sizeof(FAST_RENDER_OPTIONS[0]);
+
+static const char* const RENDER_MODE_NAMES[] = {"active", "throttled", "suspended"};
+
+bool parseRenderMode(const std::string& name, RenderMode& out) {
+    for (size_t i = 0; i < sizeof(RENDER_MODE_NAMES) / sizeof(RENDER_MODE_NAMES[0]); i++) {
+        if (name == RENDER_MODE_NAMES[i]) {
+            out = static_cast<RenderMode>(i);
+            return true;
+        }
     }
+    return false;
+}
 
-    // Set pixel format
-    PIXELFORMATDESCRIPTOR pfd = {};
-    pfd.nSize = sizeof(pfd);
-    pfd.nVersion = 1;
-    pfd.dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER;
-    pfd.iPixelType = PFD_TYPE_RGBA;
-    pfd.cColorBits = 32;
-    pfd.cDepthBits = 24;
-    pfd.iLayerType = PFD_MAIN_PLANE;
-
-    int pixelFormat = ChoosePixelFormat(g_hdc, &pfd);
-    if (!pixelFormat || !SetPixelFormat(g_hdc, pixelFormat, &pfd)) {
-        std::cerr << "[MpvContext] Failed to set pixel format" << std::endl;
-        return false;
+// A profile as loadfile per-file options ("key=value,...")
+static std::string profileFileOptions(PlaybackProfile profile) {
+    std::string options;
+    const auto& entry = PROFILE_OPTIONS[profileIndex(profile)];
+    for (size_t i = 0; i < PROFILE_OPTION_COUNT; i++) {
+        if (!options.empty()) options += ',';
+        options += PROFILE_OPTION_NAMES[i];
+        options += '=';
+        options += entry.values[i];
     }
+    return options;
+}
 
-    // Create OpenGL context
-    g_hglrc = wglCreateContext(g_hdc);
-    if (!g_hglrc) {
-        std::cerr << "[MpvContext] Failed to create GL context" << std::endl;
-        return false;
+// Demuxer options for MpvConfig::timeshiftMB: cache on disk, bounded by
+// the budget both ways, and seekable even for live streams. The byte limits
+// bound readahead, so its time limits are out of the way. Also applied per
+// file after a load's profile, which would otherwise shrink the cache.
+static std::vector<std::pair<std::string, std::string>> timeshiftOptions(const MpvConfig& config) {
+    std::string bytes = std::to_string(config.timeshiftMB) + "MiB";
+    std::vector<std::pair<std::string, std::string>> options = {
+        {"cache", "yes"},
+        {"cache-on-disk", "yes"},
+        {"demuxer-max-bytes", bytes},
+        {"demuxer-max-back-bytes", bytes},
+        {"demuxer-readahead-secs", "86400"},
+        {"cache-secs", "86400"},
+    };
+    if (!config.timeshiftDir.empty()) {
+        options.emplace_back("demuxer-cache-dir", config.timeshiftDir);
     }
+    return options;
+}
 
-    // Make it current
-    if (!wglMakeCurrent(g_hdc, g_hglrc)) {
-        std::cerr << "[MpvContext] Failed to make GL context current" << std::endl;
-        return false;
+// "key=value,..." for loadfile; values are length-quoted (%n%value), so
+// paths may contain commas
+static std::string fileOptionString(const std::vector<std::pair<std::string, std::string>>& options) {
+    std::string result;
+    for (const auto& option : options) {
+        if (!result.empty()) result += ',';
+        result += option.first + "=%" + std::to_string(option.second.size()) + "%" + option.second;
     }
+    return result;
+}
 
-    // Check which GPU the OpenGL context is using
-    const char* vendor = (const char*)glGetString(GL_VENDOR);
-    const char* renderer = (const char*)glGetString(GL_RENDERER);
-    std::cout << "[MpvContext] OpenGL Vendor: " << (vendor ? vendor : "unknown") << std::endl;
-    std::cout << "[MpvContext] OpenGL Renderer: " << (renderer ? renderer : "unknown") << std::endl;
+// mpv's log level names, most severe first
+static const struct {
+    const char* name;
+    int level;
+} LOG_LEVEL_NAMES[] = {
+    {"no", MPV_LOG_LEVEL_NONE},
+    {"fatal", MPV_LOG_LEVEL_FATAL},
+    {"error", MPV_LOG_LEVEL_ERROR},
+    {"warn", MPV_LOG_LEVEL_WARN},
+    {"info", MPV_LOG_LEVEL_INFO},
+    {"v", MPV_LOG_LEVEL_V},
+    {"debug", MPV_LOG_LEVEL_DEBUG},
+    {"trace", MPV_LOG_LEVEL_TRACE},
+};
+
+static int logLevelFromName(const std::string& name) {
+    for (const auto& entry : LOG_LEVEL_NAMES) {
+        if (name == entry.name) return entry.level;
+    }
+    return -1;
+}
 
-    // Check if we're on NVIDIA - WGL_NV_DX_interop requires both D3D and GL on same GPU
-    if (renderer && strstr(renderer, "NVIDIA") == nullptr) {
-        std::cerr << "[MpvContext] WARNING: OpenGL is not on NVIDIA GPU. WGL_NV_DX_interop may fail." << std::endl;
-        std::cerr << "[MpvContext] Set NVIDIA as preferred GPU for this app in NVIDIA Control Panel." << std::endl;
+static const char* logLevelName(int level) {
+    for (const auto& entry : LOG_LEVEL_NAMES) {
+        if (level <= entry.level) return entry.name;
     }
+    return "trace";
+}
 
-    std::cout << "[MpvContext] Windows GL context created successfully" << std::endl;
+// Parse "module=level,..." ("all" sets the default). False on any bad item.
+static bool parseLogLevels(const std::string& spec, LogLevels& out) {
+    LogLevels levels;
+    size_t start = 0;
+    while (start <= spec.size()) {
+        size_t end = spec.find(',', start);
+        if (end == std::string::npos) end = spec.size();
+        std::string item = spec.substr(start, end - start);
+        start = end + 1;
+        if (item.empty()) continue;
+
+        size_t eq = item.find('=');
+        if (eq == std::string::npos || eq == 0) return false;
+        std::string module = item.substr(0, eq);
+        int level = logLevelFromName(item.substr(eq + 1));
+        if (level < 0) return false;
+
+        if (module == "all") {
+            levels.defaultLevel = level;
+            levels.modules.clear();  // Like msg-level: "all" resets earlier items
+        } else {
+            levels.modules.emplace_back(module, level);
+        }
+    }
+    out = std::move(levels);
     return true;
 }
 
-static void destroyWindowsGLContext() {
-    if (g_hglrc) {
-        wglMakeCurrent(nullptr, nullptr);
-        wglDeleteContext(g_hglrc);
-        g_hglrc = nullptr;
-    }
-    if (g_hdc && g_dummyWindow) {
-        ReleaseDC(g_dummyWindow, g_hdc);
-        g_hdc = nullptr;
-    }
-    if (g_dummyWindow) {
-        DestroyWindow(g_dummyWindow);
-        g_dummyWindow = nullptr;
+// Least severe level any module keeps: what mpv has to send us at all
+static int maxLogLevel(const LogLevels& levels) {
+    int level = levels.defaultLevel;
+    for (const auto& module : levels.modules) {
+        level = std::max(level, module.second);
     }
+    return level;
 }
-#endif
-
-#ifdef __APPLE__
-static CGLContextObj g_cglContext = nullptr;
-static CGLPixelFormatObj g_cglPixelFormat = nullptr;
-
-static bool createMacOSGLContext() {
-    // Create a minimal OpenGL context for offscreen rendering
-    CGLPixelFormatAttribute attributes[] = {
-        kCGLPFAOpenGLProfile, (CGLPixelFormatAttribute)kCGLOGLPVersion_3_2_Core,
-        kCGLPFAColorSize, (CGLPixelFormatAttribute)24,
-        kCGLPFAAlphaSize, (CGLPixelFormatAttribute)8,
-        kCGLPFAAccelerated,
-        kCGLPFANoRecovery,
-        (CGLPixelFormatAttribute)0
-    };
 
-    GLint numFormats = 0;
-    CGLError err = CGLChoosePixelFormat(attributes, &g_cglPixelFormat, &numFormats);
-    if (err != kCGLNoError || numFormats == 0) {
-        std::cerr << "[MpvContext] Failed to choose pixel format: " << err << std::endl;
-        return false;
+// Look up a key in an MPV_FORMAT_NODE_MAP
+static const mpv_node* findNode(const mpv_node* map, const char* key) {
+    if (!map || map->format != MPV_FORMAT_NODE_MAP || !map->u.list) return nullptr;
+    for (int i = 0; i < map->u.list->num; i++) {
+        if (strcmp(map->u.list->keys[i], key) == 0) {
+            return &map->u.list->values[i];
+        }
     }
+    return nullptr;
+}
 
-    err = CGLCreateContext(g_cglPixelFormat, nullptr, &g_cglContext);
-    if (err != kCGLNoError) {
-        std::cerr << "[MpvContext] Failed to create CGL context: " << err << std::endl;
-        CGLDestroyPixelFormat(g_cglPixelFormat);
-        g_cglPixelFormat = nullptr;
-        return false;
-    }
+static std::string nodeString(const mpv_node* map, const char* key) {
+    const mpv_node* node = findNode(map, key);
+    return node && node->format == MPV_FORMAT_STRING ? node->u.string : "";
+}
 
-    err = CGLSetCurrentContext(g_cglContext);
-    if (err != kCGLNoError) {
-        std::cerr << "[MpvContext] Failed to set CGL context current: " << err << std::endl;
-        CGLDestroyContext(g_cglContext);
-        CGLDestroyPixelFormat(g_cglPixelFormat);
-        g_cglContext = nullptr;
-        g_cglPixelFormat = nullptr;
-        return false;
-    }
+static int nodeInt(const mpv_node* map, const char* key) {
+    const mpv_node* node = findNode(map, key);
+    return node && node->format == MPV_FORMAT_INT64 ? static_cast<int>(node->u.int64) : 0;
+}
 
-    std::cout << "[MpvContext] macOS CGL context created successfully" << std::endl;
-    return true;
+static double nodeDouble(const mpv_node* map, const char* key) {
+    const mpv_node* node = findNode(map, key);
+    if (!node) return 0.0;
+    if (node->format == MPV_FORMAT_DOUBLE) return node->u.double_;
+    return node->format == MPV_FORMAT_INT64 ? static_cast<double>(node->u.int64) : 0.0;
 }
 
-static void destroyMacOSGLContext() {
-    if (g_cglContext) {
-        CGLSetCurrentContext(nullptr);
-        CGLDestroyContext(g_cglContext);
-        g_cglContext = nullptr;
-    }
-    if (g_cglPixelFormat) {
-        CGLDestroyPixelFormat(g_cglPixelFormat);
-        g_cglPixelFormat = nullptr;
-    }
+MpvContext::MpvContext() = default;
+
+MpvContext::~MpvContext() {
+    destroy();
 }
-#endif
 
 bool MpvContext::create(const MpvConfig& config) {
     if (m_initialized) {
@@ -187,33 +270,17 @@ bool MpvContext::create(const MpvConfig& config) {
     }
 
     m_config = config;
-
-#ifdef _WIN32
-    // Create Windows GL context first (required for WGL extensions)
-    if (!createWindowsGLContext()) {
-        if (m_errorCallback) {
-            m_errorCallback("Failed to create Windows GL context");
-        }
-        return false;
-    }
-    m_glContext = static_cast<void*>(g_hglrc);
-#elif defined(__APPLE__)
-    // Create macOS CGL context for IOSurface sharing
-    if (!createMacOSGLContext()) {
-        if (m_errorCallback) {
-            m_errorCallback("Failed to create macOS GL context");
-        }
-        return false;
+    m_trace.setEnabled(config.trace);
+    m_fastRender = config.fastRender;
+    if (m_compositor) {
+        // Tiles are blitted, which needs RGB
+        m_config.yuvExport = false;
     }
-    m_glContext = static_cast<void*>(g_cglContext);
-#endif
 
     // Create mpv handle
     m_mpv = mpv_create();
     if (!m_mpv) {
-        if (m_errorCallback) {
-            m_errorCallback("Failed to create mpv context");
-        }
+        reportStartError("Failed to create mpv context");
         return false;
     }
 
@@ -223,54 +290,197 @@ bool MpvContext::create(const MpvConfig& config) {
     mpv_set_option_string(m_mpv, "keep-open", "yes");
     mpv_set_option_string(m_mpv, "idle", "yes");
     mpv_set_option_string(m_mpv, "terminal", "no");
-    mpv_set_option_string(m_mpv, "msg-level", "all=v");
-
-    // Initialize mpv
-    if (mpv_initialize(m_mpv) < 0) {
-        if (m_errorCallback) {
-            m_errorCallback("Failed to initialize mpv");
+    if (config.standby) {
+        // Never produce audio or advance before promote()
+        mpv_set_option_string(m_mpv, "pause", "yes");
+        mpv_set_option_string(m_mpv, "mute", "yes");
+        m_standby = true;
+    }
+    if (config.profile != PlaybackProfile::INHERIT) {
+        const auto& entry = PROFILE_OPTIONS[profileIndex(config.profile)];
+        for (size_t i = 0; i < PROFILE_OPTION_COUNT; i++) {
+            mpv_set_option_string(m_mpv, PROFILE_OPTION_NAMES[i], entry.values[i]);
         }
-        mpv_destroy(m_mpv);
-        m_mpv = nullptr;
+    }
+    if (config.timeshiftMB > 0) {
+        for (const auto& option : timeshiftOptions(config)) {
+            mpv_set_option_string(m_mpv, option.first.c_str(), option.second.c_str());
+        }
+        // Seek within the cache on streams that are not seekable themselves
+        mpv_set_option_string(m_mpv, "force-seekable", "yes");
+        mpv_set_option_string(m_mpv, "demuxer-seekable-cache", "yes");
+    }
+    if (config.displaySync) {
+        // Resample audio/video to the display rate measured by the vsync
+        // clock (pushed as display-fps-override once locked). Frames are
+        // presented by us, so mpv should not shift its timing for a swap.
+        mpv_set_option_string(m_mpv, "video-sync", "display-resample");
+        mpv_set_option_string(m_mpv, "video-timing-offset", "0");
+    }
+    if (config.subtitleOverlay) {
+        // sub-text keeps updating while hidden
+        mpv_set_option_string(m_mpv, "sub-visibility", "no");
+        mpv_set_option_string(m_mpv, "osd-level", "0");
+        m_subtitleOverlay = true;
+        m_subtitlesDrawn = false;
+    }
+
+    // Only what the log ring keeps is sent to us; verbose chatter from
+    // unselected modules is filtered inside mpv, not on the event thread
+    if (!parseLogLevels(config.logLevels, m_logLevels)) {
+        std::cerr << "[MpvContext] Invalid logLevels \"" << config.logLevels << "\", using all=info" << std::endl;
+        m_logLevels = LogLevels{};
+    }
+    mpv_request_log_messages(m_mpv, logLevelName(maxLogLevel(m_logLevels)));
+
+    // mpv_initialize and everything touching GL run on the render thread,
+    // which owns the GL context for its whole life (on Windows the
+    // context's hidden window belongs to the thread that created it)
+    m_running = true;
+    m_renderThread = std::thread(&MpvContext::renderThreadMain, this);
+    m_initialized = true;
+
+    if (config.lazyStart) {
+        return true;
+    }
+    if (!start()) {
+        destroy();
         return false;
     }
+    return true;
+}
+
+bool MpvContext::start() {
+    if (!m_initialized) return false;
+    std::unique_lock<std::mutex> lock(m_startMutex);
+    if (m_startState == StartState::IDLE) {
+        m_startState = StartState::STARTING;
+        m_startCV.notify_all();
+    }
+    m_startCV.wait(lock, [this] {
+        return m_startState == StartState::READY || m_startState == StartState::FAILED;
+    });
+    return m_startState == StartState::READY;
+}
+
+bool MpvContext::isStarted() const {
+    std::lock_guard<std::mutex> lock(m_startMutex);
+    return m_startState == StartState::READY;
+}
+
+std::string MpvContext::startError() const {
+    std::lock_guard<std::mutex> lock(m_startMutex);
+    return m_startError;
+}
+
+void MpvContext::reportStartError(const std::string& error) {
+    std::cerr << "[MpvContext] " << error << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(m_startMutex);
+        if (m_startError.empty()) m_startError = error;
+    }
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    if (m_errorCallback) {
+        m_errorCallback(error);
+    }
+}
 
-    // Create texture sharing
-    m_textureShare = createTextureShare();
-    if (!m_textureShare) {
-        if (m_errorCallback) {
-            m_errorCallback("Failed to create texture share");
+void MpvContext::renderThreadMain() {
+    {
+        std::unique_lock<std::mutex> lock(m_startMutex);
+        m_startCV.wait(lock, [this] { return m_startState == StartState::STARTING || !m_running; });
+        if (m_startState != StartState::STARTING) {
+            // Destroyed before anything started
+            m_startState = StartState::FAILED;
+            m_startCV.notify_all();
+            return;
+        }
+    }
+
+    bool ok = startEngine();
+
+    DeferredLoad deferred;
+    std::string error;
+    {
+        std::lock_guard<std::mutex> lock(m_startMutex);
+        m_startState = ok ? StartState::READY : StartState::FAILED;
+        deferred = std::move(m_deferredLoad);
+        m_deferredLoad = DeferredLoad{};
+        error = m_startError;
+        m_startCV.notify_all();
+    }
+    if (ok) {
+        applyRenderPath();
+    }
+    if (deferred.pending) {
+        if (!ok) {
+            if (deferred.done) deferred.done(false, error);
+        } else if (!queueLoad(deferred.url, deferred.options, deferred.done) && deferred.done) {
+            deferred.done(false, "Failed to load URL");
         }
-        mpv_terminate_destroy(m_mpv);
-        m_mpv = nullptr;
-        return false;
     }
 
-    // Initialize texture sharing with current GL context
-    // Note: The GL context must be created and made current before calling this
-    if (!m_textureShare->initialize(m_glContext)) {
-        if (m_errorCallback) {
-            m_errorCallback("Failed to initialize texture sharing");
+    if (ok) {
+        renderLoop();
+    }
+
+    // Freed in this thread's context: every player lives in one share
+    // group, so leaked objects add up
+    if (m_renderCtx) {
+        mpv_render_context_free(m_renderCtx);
+        m_renderCtx = nullptr;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_frameMutex);
+        if (m_textureShare) {
+            m_textureShare->destroy();
+            delete m_textureShare;
+            m_textureShare = nullptr;
         }
-        delete m_textureShare;
-        m_textureShare = nullptr;
-        mpv_terminate_destroy(m_mpv);
-        m_mpv = nullptr;
+    }
+    m_glContext.destroy();
+}
+
+bool MpvContext::startEngine() {
+    uint64_t startUs = nowUs();
+
+    if (mpv_initialize(m_mpv) < 0) {
+        reportStartError("Failed to initialize mpv");
         return false;
     }
 
-    // Create shared texture
-    if (!m_textureShare->createTexture(config.width, config.height)) {
-        if (m_errorCallback) {
-            m_errorCallback("Failed to create shared texture");
-        }
-        m_textureShare->destroy();
-        delete m_textureShare;
-        m_textureShare = nullptr;
-        mpv_terminate_destroy(m_mpv);
-        m_mpv = nullptr;
+    // Create this player's GL context (joins the process-wide share group);
+    // it stays current on this thread
+    if (!m_glContext.create()) {
+        reportStartError("Failed to create GL context");
+        return false;
+    }
+
+    // Create texture sharing (compositor tiles stay inside the share group).
+    // Published under m_frameMutex once usable, for releaseFrame()
+    ITextureShare* share = m_compositor ? Compositor::createTileShare() : createTextureShare();
+    if (!share) {
+        reportStartError("Failed to create texture share");
         return false;
     }
+    if (!share->initialize(m_glContext.nativeHandle())) {
+        delete share;
+        reportStartError("Failed to initialize texture sharing");
+        return false;
+    }
+
+    share->setPoolBudget(m_config.texturePoolBudget);
+
+    if (!share->createTexture(m_config.width, m_config.height, TextureFormat::RGBA8)) {
+        share->destroy();
+        delete share;
+        reportStartError("Failed to create shared texture");
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_frameMutex);
+        m_textureShare = share;
+    }
 
     // Create render context
     mpv_opengl_init_params gl_init_params{
@@ -279,22 +489,28 @@ bool MpvContext::create(const MpvConfig& config) {
     };
 
     int advanced_control = 1;
+
+    // Linux: hand mpv the render node so VAAPI frames map into GL zero-copy
+    // (no KMS output, offscreen only)
+    mpv_opengl_drm_params_v2 drm_params{
+        .fd = -1,
+        .crtc_id = -1,
+        .connector_id = -1,
+        .atomic_request_ptr = nullptr,
+        .render_fd = GLContext::drmRenderFd(),
+    };
+
     mpv_render_param params[] = {
         {MPV_RENDER_PARAM_API_TYPE, const_cast<char*>(MPV_RENDER_API_TYPE_OPENGL)},
         {MPV_RENDER_PARAM_OPENGL_INIT_PARAMS, &gl_init_params},
         {MPV_RENDER_PARAM_ADVANCED_CONTROL, &advanced_control},
+        {drm_params.render_fd >= 0 ? MPV_RENDER_PARAM_DRM_DISPLAY_V2 : MPV_RENDER_PARAM_INVALID, &drm_params},
         {MPV_RENDER_PARAM_INVALID, nullptr}
     };
 
     if (mpv_render_context_create(&m_renderCtx, m_mpv, params) < 0) {
-        if (m_errorCallback) {
-            m_errorCallback("Failed to create mpv render context");
-        }
-        m_textureShare->destroy();
-        delete m_textureShare;
-        m_textureShare = nullptr;
-        mpv_terminate_destroy(m_mpv);
-        m_mpv = nullptr;
+        m_renderCtx = nullptr;
+        reportStartError("Failed to create mpv render context");
         return false;
     }
 
@@ -305,30 +521,39 @@ bool MpvContext::create(const MpvConfig& config) {
     mpv_set_wakeup_callback(m_mpv, wakeupCallback, this);
 
     // Observe properties
-    mpv_observe_property(m_mpv, 1, "pause", MPV_FORMAT_FLAG);
-    mpv_observe_property(m_mpv, 2, "volume", MPV_FORMAT_DOUBLE);
-    mpv_observe_property(m_mpv, 3, "mute", MPV_FORMAT_FLAG);
-    mpv_observe_property(m_mpv, 4, "time-pos", MPV_FORMAT_DOUBLE);
-    mpv_observe_property(m_mpv, 5, "duration", MPV_FORMAT_DOUBLE);
-    mpv_observe_property(m_mpv, 6, "width", MPV_FORMAT_INT64);
-    mpv_observe_property(m_mpv, 7, "height", MPV_FORMAT_INT64);
-
-    // Start threads
-    m_running = true;
+    mpv_observe_property(m_mpv, PROP_PAUSE, "pause", MPV_FORMAT_FLAG);
+    mpv_observe_property(m_mpv, PROP_VOLUME, "volume", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(m_mpv, PROP_MUTE, "mute", MPV_FORMAT_FLAG);
+    mpv_observe_property(m_mpv, PROP_TIME_POS, "time-pos", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(m_mpv, PROP_DURATION, "duration", MPV_FORMAT_DOUBLE);
+    // Size and format arrive together so a resolution change is one resize
+    mpv_observe_property(m_mpv, PROP_VIDEO_PARAMS, "video-params", MPV_FORMAT_NODE);
+    mpv_observe_property(m_mpv, PROP_SUB_TEXT, "sub-text", MPV_FORMAT_STRING);
+    mpv_observe_property(m_mpv, PROP_SUB_ASS, "sub-text/ass", MPV_FORMAT_STRING);
+    mpv_observe_property(m_mpv, PROP_SUB_IMAGE, "current-tracks/sub/image", MPV_FORMAT_FLAG);
+
+    // Events may already be queued before the first wakeup, so start with
+    // a drain
+    {
+        std::lock_guard<std::mutex> lock(m_eventMutex);
+        m_eventsPending = true;
+    }
     m_eventThread = std::thread(&MpvContext::eventLoop, this);
 
-#ifdef _WIN32
-    // Release GL context from main thread so render thread can use it
-    // (OpenGL contexts can only be current on one thread at a time)
-    wglMakeCurrent(nullptr, nullptr);
-#elif defined(__APPLE__)
-    // Release CGL context from main thread so render thread can use it
-    CGLSetCurrentContext(nullptr);
-#endif
+    if (m_config.displaySync) {
+        // Without a source (Linux) the clock runs on reportPresentation()
+        m_vsyncSource = createVsyncSource();
+        if (m_vsyncSource && !m_vsyncSource->start(&m_vsync)) {
+            delete m_vsyncSource;
+            m_vsyncSource = nullptr;
+        }
+    }
 
-    m_renderThread = std::thread(&MpvContext::renderLoop, this);
+    if (m_compositor) {
+        m_compositor->attach(this, m_textureShare);
+    }
 
-    m_initialized = true;
+    std::cout << "[MpvContext] Started in " << (nowUs() - startUs) / 1000 << " ms" << std::endl;
     return true;
 }
 
@@ -337,14 +562,39 @@ void MpvContext::destroy() {
         return;
     }
 
-    m_running = false;
+    // A start in progress finishes first, so everything it creates is torn
+    // down below
+    {
+        std::unique_lock<std::mutex> lock(m_startMutex);
+        m_startCV.wait(lock, [this] { return m_startState != StartState::STARTING; });
+    }
+
+    // Out of the layout before the tile textures go
+    if (m_compositor) {
+        m_compositor->detach(this);
+    }
+
+    if (m_vsyncSource) {
+        m_vsyncSource->stop();
+        delete m_vsyncSource;
+        m_vsyncSource = nullptr;
+    }
+
+    {
+        // Also wakes a render thread that never started
+        std::lock_guard<std::mutex> lock(m_startMutex);
+        m_running = false;
+        m_startCV.notify_all();
+    }
     m_needsRender = true;
     m_renderCV.notify_one();
 
-    // Stop mpv first to unblock event loop
-    if (m_mpv) {
-        mpv_wakeup(m_mpv);
+    // Wake the event thread immediately (it blocks until mpv signals)
+    {
+        std::lock_guard<std::mutex> lock(m_eventMutex);
+        m_eventsPending = true;
     }
+    m_eventCV.notify_one();
 
     if (m_eventThread.joinable()) {
         m_eventThread.join();
@@ -354,44 +604,99 @@ void MpvContext::destroy() {
         m_renderThread.join();
     }
 
-    if (m_renderCtx) {
-        mpv_render_context_free(m_renderCtx);
-        m_renderCtx = nullptr;
+    m_vsync.reset();
+
+    // No more events will arrive to settle outstanding loads
+    abortPendingLoads("Player destroyed");
+
+    // The render thread is gone: nothing will capture queued thumbnails
+    std::vector<ThumbnailRequest> thumbnails;
+    {
+        std::lock_guard<std::mutex> lock(m_thumbnailMutex);
+        thumbnails.swap(m_thumbnailRequests);
+    }
+    for (auto& request : thumbnails) {
+        request.done(false, "Player destroyed", ThumbnailImage{});
     }
 
+    // The render thread freed the render context and textures on exit
     if (m_mpv) {
+        mpv_set_wakeup_callback(m_mpv, nullptr, nullptr);
         mpv_terminate_destroy(m_mpv);
         m_mpv = nullptr;
     }
 
-    if (m_textureShare) {
-        m_textureShare->destroy();
-        delete m_textureShare;
-        m_textureShare = nullptr;
-    }
-
-#ifdef _WIN32
-    destroyWindowsGLContext();
-    m_glContext = nullptr;
-#elif defined(__APPLE__)
-    destroyMacOSGLContext();
-    m_glContext = nullptr;
-#endif
-
     m_initialized = false;
 }
 
-bool MpvContext::load(const std::string& url, const std::string& options) {
+bool MpvContext::load(const std::string& url, const std::string& options, PlaybackProfile profile,
+                      LoadCallback done) {
     if (!m_mpv) return false;
 
+    // Per-file options are reset when the file ends, so the player's own
+    // profile is back in effect for the next plain load
+    std::string fileOptions;
+    if (profile != PlaybackProfile::INHERIT && profile != m_config.profile) {
+        fileOptions = profileFileOptions(profile);
+        if (m_config.timeshiftMB > 0) {
+            fileOptions += ',' + fileOptionString(timeshiftOptions(m_config));
+        }
+    }
     if (!options.empty()) {
-        const char* cmd[] = {"loadfile", url.c_str(), "replace", options.c_str(), nullptr};
-        int result = mpv_command(m_mpv, cmd);
-        return result >= 0;
+        if (!fileOptions.empty()) fileOptions += ',';
+        fileOptions += options;  // Later keys win
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_startMutex);
+        if (m_startState == StartState::FAILED) {
+            return false;
+        }
+        if (m_startState != StartState::READY) {
+            // Not started yet (lazyStart): this load starts the player and is
+            // queued once mpv is up. A newer load replaces it, as in mpv.
+            DeferredLoad replaced = std::move(m_deferredLoad);
+            m_deferredLoad = DeferredLoad{true, url, fileOptions, std::move(done)};
+            if (m_startState == StartState::IDLE) {
+                m_startState = StartState::STARTING;
+                m_startCV.notify_all();
+            }
+            lock.unlock();
+            if (replaced.pending && replaced.done) {
+                replaced.done(false, "Load aborted");
+            }
+            return true;
+        }
+    }
+    return queueLoad(url, fileOptions, std::move(done));
+}
+
+bool MpvContext::queueLoad(const std::string& url, const std::string& fileOptions, LoadCallback done) {
+    std::lock_guard<std::mutex> lock(m_loadMutex);
+    uint64_t id = m_nextLoadId++;
+
+    // Queued on mpv's core thread; completion arrives as events. Named
+    // arguments, because mpv 0.38 inserted an index before the positional
+    // options argument.
+    const char* keys[] = {"name", "url", "flags", "options"};
+    const char* values[] = {"loadfile", url.c_str(), "replace", fileOptions.c_str()};
+    mpv_node args[4];
+    int count = fileOptions.empty() ? 3 : 4;
+    for (int i = 0; i < count; i++) {
+        args[i].format = MPV_FORMAT_STRING;
+        args[i].u.string = const_cast<char*>(values[i]);
+    }
+    mpv_node_list list{count, args, const_cast<char**>(keys)};
+    mpv_node cmd;
+    cmd.format = MPV_FORMAT_NODE_MAP;
+    cmd.u.list = &list;
+    int result = mpv_command_node_async(m_mpv, id, &cmd);
+    if (result < 0) {
+        return false;
     }
-    const char* cmd[] = {"loadfile", url.c_str(), nullptr};
-    int result = mpv_command(m_mpv, cmd);
-    return result >= 0;
+
+    m_pendingLoads.push_back(PendingLoad{id, -1, nowUs(), std::move(done)});
+    return true;
 }
 
 void MpvContext::play() {
@@ -419,6 +724,54 @@ void MpvContext::seek(double position) {
     mpv_command(m_mpv, cmd);
 }
 
+bool MpvContext::timeshiftRange(TimeshiftRange& out) const {
+    if (!m_mpv || !isStarted()) return false;
+
+    mpv_node state;
+    if (mpv_get_property(m_mpv, "demuxer-cache-state", MPV_FORMAT_NODE, &state) < 0) {
+        return false;
+    }
+    // After seeks the cache can hold several ranges; the one reaching
+    // furthest ends at the live edge
+    bool found = false;
+    const mpv_node* ranges = findNode(&state, "seekable-ranges");
+    if (ranges && ranges->format == MPV_FORMAT_NODE_ARRAY && ranges->u.list) {
+        for (int i = 0; i < ranges->u.list->num; i++) {
+            const mpv_node* range = &ranges->u.list->values[i];
+            double start = nodeDouble(range, "start");
+            double end = nodeDouble(range, "end");
+            if (end > start && (!found || end > out.end)) {
+                out.start = start;
+                out.end = end;
+                found = true;
+            }
+        }
+    }
+    mpv_free_node_contents(&state);
+    if (!found) {
+        return false;
+    }
+
+    out.position = m_timePos.load(std::memory_order_relaxed);
+    if (std::isnan(out.position)) {
+        out.position = out.start;
+    }
+    return true;
+}
+
+bool MpvContext::seekLive(double secondsBehindLive) {
+    TimeshiftRange range;
+    if (!timeshiftRange(range)) return false;
+
+    double target = range.end - std::max(0.0, secondsBehindLive);
+    target = std::max(range.start, std::min(range.end, target));
+    // Keyframe seeks land on cached packets without decoding up to the
+    // exact time, and never past the live edge
+    std::string targetStr = std::to_string(target);
+    const char* cmd[] = {"seek", targetStr.c_str(), "absolute+keyframes", nullptr};
+    return mpv_command_async(m_mpv, 0, cmd) >= 0;
+}
+
 void MpvContext::setVolume(double volume) {
     if (!m_mpv) return;
     mpv_set_property(m_mpv, "volume", MPV_FORMAT_DOUBLE, &volume);
@@ -430,54 +783,411 @@ void MpvContext::toggleMute() {
     mpv_command(m_mpv, cmd);
 }
 
-void MpvContext::setFrameCallback(FrameCallback callback) {
-    std::lock_guard<std::mutex> lock(m_callbackMutex);
-    m_frameCallback = std::move(callback);
+void MpvContext::setStandby(bool standby) {
+    if (!m_mpv) return;
+
+    m_standby = standby;
+    int flag = standby ? 1 : 0;
+    mpv_set_property(m_mpv, "pause", MPV_FORMAT_FLAG, &flag);
+    mpv_set_property(m_mpv, "mute", MPV_FORMAT_FLAG, &flag);
+
+    if (!standby && m_mailbox.renotify()) {
+        // Hand over the frame decoded while hidden
+        if (m_compositor) {
+            m_compositor->tileReady();
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_callbackMutex);
+        if (!m_frameCallback || !m_frameCallback()) {
+            m_mailbox.cancelNotify();
+        }
+    }
 }
 
-void MpvContext::setStatusCallback(StatusCallback callback) {
-    std::lock_guard<std::mutex> lock(m_callbackMutex);
-    m_statusCallback = std::move(callback);
+void MpvContext::setRenderMode(RenderMode mode, bool dropVideo) {
+    if (!m_mpv) return;
+
+    bool drop = dropVideo && mode == RenderMode::SUSPENDED;
+    if (drop && !m_videoDropped) {
+        char* vid = mpv_get_property_string(m_mpv, "vid");
+        m_droppedVid = vid ? vid : "auto";
+        mpv_free(vid);
+        {
+            std::lock_guard<std::mutex> lock(m_loadMutex);
+            m_droppedEntryId = m_playingEntryId;
+        }
+        mpv_set_property_string(m_mpv, "vid", "no");
+        m_videoDropped = true;
+    } else if (!drop && m_videoDropped) {
+        // Track IDs belong to a file: after a load, let mpv pick again
+        std::string vid = m_droppedVid;
+        {
+            std::lock_guard<std::mutex> lock(m_loadMutex);
+            if (m_playingEntryId != m_droppedEntryId) vid = "auto";
+        }
+        mpv_set_property_string(m_mpv, "vid", vid.c_str());
+        m_videoDropped = false;
+    }
+
+    m_renderMode.store(mode, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(m_renderMutex);
+    m_needsRender = true;
+    m_renderCV.notify_one();
 }
 
-void MpvContext::setErrorCallback(ErrorCallback callback) {
-    std::lock_guard<std::mutex> lock(m_callbackMutex);
-    m_errorCallback = std::move(callback);
+void MpvContext::setSubtitleOverlay(bool enabled) {
+    if (!m_mpv) return;
+    m_subtitleOverlay.store(enabled, std::memory_order_relaxed);
+    mpv_set_property_string(m_mpv, "osd-level", enabled ? "0" : "1");
+    applySubtitleVisibility();
 }
 
-void MpvContext::releaseFrame() {
-    std::lock_guard<std::mutex> lock(m_frameMutex);
-    if (m_frameInUse) {
-        m_textureShare->releaseTexture();
-        m_frameInUse = false;
+void MpvContext::applySubtitleVisibility() {
+    bool bitmap;
+    {
+        std::lock_guard<std::mutex> lock(m_statusMutex);
+        bitmap = m_status.subtitleBitmap;
+    }
+    bool draw = !m_subtitleOverlay.load(std::memory_order_relaxed) || bitmap;
+
+    std::lock_guard<std::mutex> lock(m_subtitleMutex);
+    if (draw != m_subtitlesDrawn) {
+        mpv_set_property_string(m_mpv, "sub-visibility", draw ? "yes" : "no");
+        m_subtitlesDrawn = draw;
     }
 }
 
-MpvStatus MpvContext::getStatus() const {
-    std::lock_guard<std::mutex> lock(m_statusMutex);
-    return m_status;
+void MpvContext::setFastRender(bool enabled) {
+    if (!m_mpv) return;
+    m_fastRender.store(enabled, std::memory_order_relaxed);
+    applyRenderPath();
 }
 
-void MpvContext::eventLoop() {
-    while (m_running) {
-        mpv_event* event = mpv_wait_event(m_mpv, 0.1);
-        if (event->event_id == MPV_EVENT_NONE) {
-            continue;
+void MpvContext::applyRenderPath() {
+    if (!m_fastRender.load(std::memory_order_relaxed) && !m_fastRenderActive.load(std::memory_order_relaxed)) {
+        return;
+    }
+    // Before startup there is nothing to render; startEngine applies it
+    if (!isStarted()) {
+        return;
+    }
+
+    bool nativeSize;
+    {
+        std::lock_guard<std::mutex> lock(m_statusMutex);
+        nativeSize = m_outputWidth == 0 ||
+                     (m_outputWidth == static_cast<uint32_t>(m_status.width) &&
+                      m_outputHeight == static_cast<uint32_t>(m_status.height));
+    }
+    bool cheap = m_fastRender.load(std::memory_order_relaxed) && nativeSize;
+
+    std::lock_guard<std::mutex> lock(m_renderPathMutex);
+    if (cheap) {
+        // User shaders were chosen for quality: leave their settings alone
+        char* shaders = mpv_get_property_string(m_mpv, "glsl-shaders");
+        if (shaders) {
+            cheap = shaders[0] == '\0';
+            mpv_free(shaders);
         }
-        if (event->event_id == MPV_EVENT_SHUTDOWN) {
-            break;
+    }
+    if (cheap == m_fastRenderActive.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    if (cheap) {
+        // Read fresh each time, so settings changed while scaling survive
+        m_savedRenderValues.assign(FAST_RENDER_OPTION_COUNT, std::string());
+        for (size_t i = 0; i < FAST_RENDER_OPTION_COUNT; i++) {
+            char* value = mpv_get_property_string(m_mpv, FAST_RENDER_OPTIONS[i][0]);
+            if (value) {
+                m_savedRenderValues[i] = value;
+                mpv_free(value);
+            }
+            mpv_set_property_string(m_mpv, FAST_RENDER_OPTIONS[i][0], FAST_RENDER_OPTIONS[i][1]);
+        }
+    } else {
+        for (size_t i = 0; i < FAST_RENDER_OPTION_COUNT && i < m_savedRenderValues.size(); i++) {
+            if (!m_savedRenderValues[i].empty()) {
+                mpv_set_property_string(m_mpv, FAST_RENDER_OPTIONS[i][0], m_savedRenderValues[i].c_str());
+            }
         }
-        handleEvent(event);
+    }
+    m_fastRenderActive.store(cheap, std::memory_order_relaxed);
+}
+
+void MpvContext::promote() {
+    if (!m_mpv) return;
+
+    double duration;
+    {
+        std::lock_guard<std::mutex> lock(m_statusMutex);
+        duration = m_status.duration;
+    }
+
+    // Live streams keep buffering while paused in standby; resume near the
+    // newest data instead of where the standby stopped. Seeking inside the
+    // demuxer cache needs no network round trip.
+    double cacheTime = 0.0;
+    double timePos = 0.0;
+    if (duration <= 0.0 &&
+        mpv_get_property(m_mpv, "demuxer-cache-time", MPV_FORMAT_DOUBLE, &cacheTime) >= 0 &&
+        mpv_get_property(m_mpv, "time-pos", MPV_FORMAT_DOUBLE, &timePos) >= 0 &&
+        cacheTime - timePos > STANDBY_CATCHUP_SECS) {
+        std::string target = std::to_string(cacheTime - 1.0);
+        const char* cmd[] = {"seek", target.c_str(), "absolute+keyframes", nullptr};
+        mpv_command_async(m_mpv, 0, cmd);
+    }
+
+    setStandby(false);
+}
+
+void MpvContext::setFrameCallback(FrameCallback callback) {
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    m_frameCallback = std::move(callback);
+}
+
+void MpvContext::setStatusCallback(StatusCallback callback) {
+    {
+        std::lock_guard<std::mutex> lock(m_callbackMutex);
+        m_statusCallback = std::move(callback);
+    }
+
+    // A new subscriber starts from a full snapshot
+    {
+        std::lock_guard<std::mutex> lock(m_statusMutex);
+        m_statusDirty = STATUS_ALL;
+    }
+    onWakeup();
+}
+
+void MpvContext::setErrorCallback(ErrorCallback callback) {
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    m_errorCallback = std::move(callback);
+}
+
+void MpvContext::setLogCallback(LogCallback callback) {
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    m_logCallback = std::move(callback);
+}
+
+bool MpvContext::setLogLevels(const std::string& spec) {
+    LogLevels levels;
+    if (!parseLogLevels(spec, levels)) {
+        return false;
+    }
+    int maxLevel = maxLogLevel(levels);
+    {
+        std::lock_guard<std::mutex> lock(m_logLevelsMutex);
+        m_pendingLogLevels = std::move(levels);
+        m_logLevelsChanged = true;
+    }
+    if (m_mpv) {
+        mpv_request_log_messages(m_mpv, logLevelName(maxLevel));
+    }
+    return true;
+}
+
+uint64_t MpvContext::drainLog(std::vector<LogEntry>& out) {
+    // Cleared first: entries logged after this point notify again
+    m_logNotifyPending = false;
+    return m_log.readSince(m_logCursor, out);
+}
+
+void MpvContext::dumpLog(std::vector<LogEntry>& out) const {
+    uint64_t cursor = 0;
+    m_log.readSince(cursor, out);
+}
+
+int MpvContext::logLevelFor(const char* prefix) const {
+    int level = m_logLevels.defaultLevel;
+    size_t prefixLength = strlen(prefix);
+    for (const auto& module : m_logLevels.modules) {
+        // "ffmpeg" also covers "ffmpeg/demuxer"
+        const std::string& name = module.first;
+        if (prefixLength >= name.size() && name.compare(0, name.size(), prefix, name.size()) == 0 &&
+            (prefixLength == name.size() || prefix[name.size()] == '/')) {
+            level = module.second;
+        }
+    }
+    return level;
+}
+
+void MpvContext::notifyLog() {
+    uint64_t head = m_log.written();
+    if (head == m_logCheckedHead) {
+        return;
+    }
+    m_logCheckedHead = head;
+    if (m_logNotifyPending.exchange(true)) {
+        return;  // The outstanding drain picks these up too
+    }
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    if (!m_logCallback || !m_logCallback()) {
+        m_logNotifyPending = false;
+    }
+}
+
+bool MpvContext::takeFrame(TextureInfo& info, uint64_t& dropped) {
+    uint64_t postedAtUs = 0;
+    if (!m_mailbox.take(info, dropped, postedAtUs)) {
+        return false;
+    }
+    uint64_t now = nowUs();
+    m_stats.framesDelivered.fetch_add(1, std::memory_order_relaxed);
+    m_stats.delivery.record(now - postedAtUs);
+
+    if (m_trace.enabled()) {
+        m_trace.record(TraceStage::DELIVER, info.seq, postedAtUs, now, info.pts);
+        std::lock_guard<std::mutex> lock(m_frameMutex);
+        // A handle should never be held twice; a stale entry means its
+        // release was missed (resize), so drop it
+        for (auto it = m_heldFrames.begin(); it != m_heldFrames.end(); ++it) {
+            if (it->handle == info.handle) {
+                m_heldFrames.erase(it);
+                break;
+            }
+        }
+        if (m_heldFrames.size() >= MAX_HELD_FRAMES) {
+            m_heldFrames.erase(m_heldFrames.begin());
+        }
+        m_heldFrames.push_back(HeldFrame{info.handle, info.seq, now, info.pts});
+    }
+    return true;
+}
+
+void MpvContext::resetStats() {
+    m_stats.reset();
+    m_droppedBaseline = m_mailbox.droppedCount();
+}
+
+bool MpvContext::captureThumbnail(uint32_t width, uint32_t height, ThumbnailCallback done) {
+    if (width == 0 && height == 0) return false;
+    {
+        // Checked under the lock so destroy() cannot miss a request
+        std::lock_guard<std::mutex> lock(m_thumbnailMutex);
+        if (!m_running || m_thumbnailRequests.size() >= MAX_PENDING_THUMBNAILS) {
+            return false;
+        }
+        m_thumbnailRequests.push_back(ThumbnailRequest{width, height, std::move(done)});
+    }
+
+    m_thumbnailRequested = true;
+    std::lock_guard<std::mutex> lock(m_renderMutex);
+    m_needsRender = true;
+    m_renderCV.notify_one();
+    return true;
+}
+
+void MpvContext::reportPresentation(uint64_t ageUs) {
+    bool tracing = m_trace.enabled();
+    if (!m_config.displaySync && !tracing) return;
+    uint64_t now = nowUs();
+    uint64_t presentedUs = ageUs < now ? now - ageUs : now;
+    if (tracing) {
+        m_trace.record(TraceStage::PRESENT, 0, presentedUs, presentedUs,
+                       std::numeric_limits<double>::quiet_NaN());
+    }
+    if (m_config.displaySync) {
+        m_vsync.addSample(presentedUs);
+    }
+}
+
+void MpvContext::releaseFrame(uint64_t handle, uint64_t generation) {
+    {
+        std::lock_guard<std::mutex> lock(m_frameMutex);
+        for (auto it = m_heldFrames.begin(); it != m_heldFrames.end(); ++it) {
+            if (it->handle == handle) {
+                m_trace.record(TraceStage::HOLD, it->seq, it->takenUs, nowUs(), it->pts);
+                m_heldFrames.erase(it);
+                break;
+            }
+        }
+        if (!m_textureShare) return;
+        m_textureShare->releaseTexture(handle, generation);
+    }
+
+    // A render may be parked waiting for a free slot
+    std::lock_guard<std::mutex> lock(m_renderMutex);
+    if (m_slotStarved) {
+        m_slotStarved = false;
+        m_needsRender = true;
+        m_renderCV.notify_one();
+    }
+}
+
+MpvStatus MpvContext::getStatus() const {
+    std::lock_guard<std::mutex> lock(m_statusMutex);
+    return m_status;
+}
+
+void MpvContext::eventLoop() {
+    while (m_running) {
+        // A throttled status field waiting for its interval bounds the sleep
+        bool throttledPending;
+        std::chrono::steady_clock::time_point flushAt;
+        {
+            std::lock_guard<std::mutex> lock(m_statusMutex);
+            throttledPending = (m_statusDirty & STATUS_THROTTLED) != 0;
+            flushAt = m_nextThrottledFlush;
+        }
+
+        // Sleep until mpv's wakeup callback (or destroy) signals us — no polling
+        {
+            std::unique_lock<std::mutex> lock(m_eventMutex);
+            auto ready = [this] { return m_eventsPending || !m_running; };
+            if (throttledPending) {
+                m_eventCV.wait_until(lock, flushAt, ready);
+            } else {
+                m_eventCV.wait(lock, ready);
+            }
+            m_eventsPending = false;
+        }
+        if (!m_running) break;
+
+        if (m_logLevelsChanged.exchange(false)) {
+            std::lock_guard<std::mutex> lock(m_logLevelsMutex);
+            m_logLevels = m_pendingLogLevels;
+        }
+
+        // Drain everything queued since the last wakeup in one batch.
+        // Events arriving mid-drain set m_eventsPending again, so none are lost.
+        for (;;) {
+            mpv_event* event = mpv_wait_event(m_mpv, 0);
+            if (event->event_id == MPV_EVENT_NONE) {
+                break;
+            }
+            if (event->event_id == MPV_EVENT_SHUTDOWN) {
+                return;
+            }
+            handleEvent(event);
+        }
+
+        // One coalesced status delivery and log notification per batch
+        flushStatus(false);
+        notifyLog();
     }
 }
 
 void MpvContext::handleEvent(mpv_event* event) {
     switch (event->event_id) {
         case MPV_EVENT_PROPERTY_CHANGE:
-            handlePropertyChange(static_cast<mpv_event_property*>(event->data));
+            handlePropertyChange(event->reply_userdata, static_cast<mpv_event_property*>(event->data));
+            break;
+        case MPV_EVENT_COMMAND_REPLY:
+            handleLoadReply(event);
+            break;
+        case MPV_EVENT_START_FILE: {
+            auto* start_file = static_cast<mpv_event_start_file*>(event->data);
+            std::lock_guard<std::mutex> lock(m_loadMutex);
+            m_playingEntryId = start_file->playlist_entry_id;
+            break;
+        }
+        case MPV_EVENT_FILE_LOADED:
+            handleFileLoaded();
             break;
         case MPV_EVENT_END_FILE: {
             auto* end_file = static_cast<mpv_event_end_file*>(event->data);
+            handleEndFile(end_file);
             if (end_file->reason == MPV_END_FILE_REASON_ERROR) {
                 std::lock_guard<std::mutex> lock(m_callbackMutex);
                 if (m_errorCallback) {
@@ -488,12 +1198,10 @@ void MpvContext::handleEvent(mpv_event* event) {
         }
         case MPV_EVENT_LOG_MESSAGE: {
             auto* msg = static_cast<mpv_event_log_message*>(event->data);
-            // Only report errors
-            if (msg->log_level <= MPV_LOG_LEVEL_ERROR) {
-                std::lock_guard<std::mutex> lock(m_callbackMutex);
-                if (m_errorCallback) {
-                    m_errorCallback(std::string(msg->prefix) + ": " + msg->text);
-                }
+            // mpv sends the most verbose level any module wants; the rest
+            // is dropped here without copying or locking
+            if (static_cast<int>(msg->log_level) <= logLevelFor(msg->prefix)) {
+                m_log.push(nowUs(), msg->log_level, msg->prefix, msg->text);
             }
             break;
         }
@@ -502,108 +1210,528 @@ void MpvContext::handleEvent(mpv_event* event) {
     }
 }
 
-void MpvContext::handlePropertyChange(mpv_event_property* prop) {
-    bool statusChanged = false;
-
+void MpvContext::handleLoadReply(mpv_event* event) {
+    std::vector<LoadCallback> failed;
+    std::vector<LoadCallback> loaded;
+    std::string error;
     {
-        std::lock_guard<std::mutex> lock(m_statusMutex);
-
-        if (strcmp(prop->name, "pause") == 0 && prop->format == MPV_FORMAT_FLAG) {
-            m_status.playing = !(*static_cast<int*>(prop->data));
-            statusChanged = true;
-        } else if (strcmp(prop->name, "volume") == 0 && prop->format == MPV_FORMAT_DOUBLE) {
-            m_status.volume = *static_cast<double*>(prop->data);
-            statusChanged = true;
-        } else if (strcmp(prop->name, "mute") == 0 && prop->format == MPV_FORMAT_FLAG) {
-            m_status.muted = *static_cast<int*>(prop->data);
-            statusChanged = true;
-        } else if (strcmp(prop->name, "time-pos") == 0 && prop->format == MPV_FORMAT_DOUBLE) {
-            m_status.position = *static_cast<double*>(prop->data);
-            statusChanged = true;
-        } else if (strcmp(prop->name, "duration") == 0 && prop->format == MPV_FORMAT_DOUBLE) {
-            m_status.duration = *static_cast<double*>(prop->data);
-            statusChanged = true;
-        } else if (strcmp(prop->name, "width") == 0 && prop->format == MPV_FORMAT_INT64) {
-            int newWidth = static_cast<int>(*static_cast<int64_t*>(prop->data));
-            if (newWidth > 0 && newWidth != m_status.width) {
-                m_status.width = newWidth;
-                // Signal render thread to resize (GL calls must happen there)
-                if (m_status.height > 0) {
-                    m_pendingWidth = static_cast<uint32_t>(m_status.width);
-                    m_pendingHeight = static_cast<uint32_t>(m_status.height);
-                    m_needsResize = true;
-                    m_renderCV.notify_one();  // Wake render thread for resize
-                }
+        std::lock_guard<std::mutex> lock(m_loadMutex);
+        for (auto it = m_pendingLoads.begin(); it != m_pendingLoads.end(); ++it) {
+            if (it->id != event->reply_userdata) continue;
+
+            if (event->error < 0) {
+                // Rejected outright (bad arguments, nothing to play)
+                error = std::string("Failed to load URL: ") + mpv_error_string(event->error);
+                failed.push_back(std::move(it->done));
+                m_pendingLoads.erase(it);
+                break;
             }
-            statusChanged = true;
-        } else if (strcmp(prop->name, "height") == 0 && prop->format == MPV_FORMAT_INT64) {
-            int newHeight = static_cast<int>(*static_cast<int64_t*>(prop->data));
-            if (newHeight > 0 && newHeight != m_status.height) {
-                m_status.height = newHeight;
-                // Signal render thread to resize (GL calls must happen there)
-                if (m_status.width > 0) {
-                    m_pendingWidth = static_cast<uint32_t>(m_status.width);
-                    m_pendingHeight = static_cast<uint32_t>(m_status.height);
-                    m_needsResize = true;
-                    m_renderCV.notify_one();  // Wake render thread for resize
+
+            // loadfile replies with the playlist entry it created
+            auto* cmd = static_cast<mpv_event_command*>(event->data);
+            const mpv_node* entry = cmd ? findNode(&cmd->result, "playlist_entry_id") : nullptr;
+            if (entry && entry->format == MPV_FORMAT_INT64) {
+                it->entryId = entry->u.int64;
+                if (it->entryId == m_loadedEntryId) {
+                    // Already loaded before the reply was processed
+                    loaded.push_back(std::move(it->done));
+                    m_pendingLoads.erase(it);
                 }
             }
-            statusChanged = true;
+            break;
         }
     }
 
-    if (statusChanged) {
-        // Copy status under its own lock, then release before acquiring callback lock.
-        // This avoids nested m_callbackMutex → m_statusMutex ordering that could
-        // deadlock if any other code path ever locks them in the opposite order.
-        MpvStatus statusCopy;
-        {
-            std::lock_guard<std::mutex> lock(m_statusMutex);
-            statusCopy = m_status;
+    for (auto& done : failed) {
+        if (done) done(false, error);
+    }
+    for (auto& done : loaded) {
+        if (done) done(true, "");
+    }
+}
+
+void MpvContext::handleFileLoaded() {
+    LoadCallback done;
+    bool found = false;
+    uint64_t now = nowUs();
+    {
+        std::lock_guard<std::mutex> lock(m_loadMutex);
+        m_loadedEntryId = m_playingEntryId;
+
+        // Match by playlist entry; libmpv without entry IDs in the reply falls
+        // back to the newest unmatched load
+        auto match = m_pendingLoads.end();
+        for (auto it = m_pendingLoads.begin(); it != m_pendingLoads.end(); ++it) {
+            if (it->entryId >= 0 && it->entryId == m_playingEntryId) {
+                match = it;
+                break;
+            }
+            if (it->entryId < 0) {
+                match = it;
+            }
         }
-        std::lock_guard<std::mutex> lock(m_callbackMutex);
-        if (m_statusCallback) {
-            m_statusCallback(statusCopy);
+        if (match != m_pendingLoads.end()) {
+            m_stats.loadToFileLoaded.record(now - match->startedAtUs);
+            m_firstFrameFromUs = match->startedAtUs;
+            done = std::move(match->done);
+            m_pendingLoads.erase(match);
+            found = true;
         }
     }
+
+    if (found && done) {
+        done(true, "");
+    }
 }
 
-void MpvContext::renderLoop() {
-#ifdef _WIN32
-    // Make GL context current on this thread (required for WGL operations)
-    if (g_hdc && g_hglrc) {
-        if (!wglMakeCurrent(g_hdc, g_hglrc)) {
-            std::cerr << "[MpvContext] Failed to make GL context current in render thread" << std::endl;
-            std::lock_guard<std::mutex> lock(m_callbackMutex);
-            if (m_errorCallback) {
-                m_errorCallback("Render thread failed: could not make GL context current");
+void MpvContext::handleEndFile(const mpv_event_end_file* endFile) {
+    LoadCallback done;
+    std::string error;
+    {
+        std::lock_guard<std::mutex> lock(m_loadMutex);
+        bool isError = endFile->reason == MPV_END_FILE_REASON_ERROR;
+        auto match = m_pendingLoads.end();
+        for (auto it = m_pendingLoads.begin(); it != m_pendingLoads.end(); ++it) {
+            if (it->entryId >= 0 && it->entryId == endFile->playlist_entry_id) {
+                match = it;
+                break;
             }
+            // Without entry IDs only an error can be attributed (to the oldest load)
+            if (it->entryId < 0 && isError && match == m_pendingLoads.end()) {
+                match = it;
+            }
+        }
+
+        if (match != m_pendingLoads.end()) {
+            // Ended before FILE_LOADED: failed to open, or replaced by a newer load
+            if (isError) {
+                error = std::string("Failed to load URL: ") + mpv_error_string(endFile->error);
+            } else {
+                error = "Load aborted";
+            }
+            done = std::move(match->done);
+            m_pendingLoads.erase(match);
+        }
+    }
+
+    if (done) {
+        done(false, error);
+    }
+}
+
+void MpvContext::abortPendingLoads(const std::string& error) {
+    std::vector<PendingLoad> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_loadMutex);
+        pending.swap(m_pendingLoads);
+    }
+    for (auto& load : pending) {
+        if (load.done) load.done(false, error);
+    }
+}
+
+void MpvContext::handlePropertyChange(uint64_t id, mpv_event_property* prop) {
+    // Property went unavailable (e.g. between files) — keep the last value,
+    // but don't stamp frames of the next file with the old position
+    if (prop->format == MPV_FORMAT_NONE) {
+        if (id == PROP_TIME_POS) {
+            m_timePos.store(std::numeric_limits<double>::quiet_NaN(), std::memory_order_relaxed);
+        }
+        // ... except subtitles, which are gone along with their track
+        if (id != PROP_SUB_TEXT && id != PROP_SUB_ASS && id != PROP_SUB_IMAGE) {
             return;
         }
-        std::cout << "[MpvContext] GL context made current in render thread" << std::endl;
     }
-#elif defined(__APPLE__)
-    // Make CGL context current on this thread
-    if (g_cglContext) {
-        CGLError err = CGLSetCurrentContext(g_cglContext);
-        if (err != kCGLNoError) {
-            std::cerr << "[MpvContext] Failed to make CGL context current in render thread: " << err << std::endl;
-            std::lock_guard<std::mutex> lock(m_callbackMutex);
-            if (m_errorCallback) {
-                m_errorCallback("Render thread failed: could not make CGL context current");
+
+    std::unique_lock<std::mutex> lock(m_statusMutex);
+    uint32_t changed = 0;
+
+    switch (id) {
+        case PROP_PAUSE: {
+            bool playing = !(*static_cast<int*>(prop->data));
+            if (playing != m_status.playing) {
+                m_status.playing = playing;
+                changed = STATUS_PLAYING;
+            }
+            break;
+        }
+        case PROP_VOLUME: {
+            double volume = *static_cast<double*>(prop->data);
+            if (volume != m_status.volume) {
+                m_status.volume = volume;
+                changed = STATUS_VOLUME;
             }
+            break;
+        }
+        case PROP_MUTE: {
+            bool muted = *static_cast<int*>(prop->data) != 0;
+            if (muted != m_status.muted) {
+                m_status.muted = muted;
+                changed = STATUS_MUTED;
+            }
+            break;
+        }
+        case PROP_TIME_POS:
+            m_status.position = *static_cast<double*>(prop->data);
+            m_timePos.store(m_status.position, std::memory_order_relaxed);
+            changed = STATUS_POSITION;
+            break;
+        case PROP_DURATION: {
+            double duration = *static_cast<double*>(prop->data);
+            if (duration != m_status.duration) {
+                m_status.duration = duration;
+                changed = STATUS_DURATION;
+            }
+            break;
+        }
+        case PROP_VIDEO_PARAMS:
+            if (applyVideoParams(static_cast<mpv_node*>(prop->data))) {
+                changed = STATUS_VIDEO;
+            }
+            break;
+        case PROP_SUB_TEXT:
+        case PROP_SUB_ASS: {
+            const char* text = prop->format == MPV_FORMAT_STRING ? *static_cast<char**>(prop->data) : nullptr;
+            std::string& field = id == PROP_SUB_TEXT ? m_status.subtitleText : m_status.subtitleAss;
+            if (field != (text ? text : "")) {
+                field = text ? text : "";
+                changed = STATUS_SUBTITLE;
+            }
+            break;
+        }
+        case PROP_SUB_IMAGE: {
+            bool bitmap = prop->format == MPV_FORMAT_FLAG && *static_cast<int*>(prop->data);
+            if (bitmap != m_status.subtitleBitmap) {
+                m_status.subtitleBitmap = bitmap;
+                changed = STATUS_SUBTITLE;
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    m_statusDirty |= changed;
+    if (changed) {
+        m_snapshot.writeStatus(m_status);
+    }
+
+    if (id == PROP_SUB_IMAGE && changed) {
+        // No text to hand over for image subtitles: let mpv draw them
+        lock.unlock();
+        applySubtitleVisibility();
+    } else if (id == PROP_VIDEO_PARAMS && changed) {
+        // A new decoded size may allow (or rule out) fast render
+        lock.unlock();
+        applyRenderPath();
+    }
+}
+
+void MpvContext::flushStatus(bool force) {
+    uint32_t due;
+    MpvStatus statusCopy;
+
+    // Copy status under its own lock, then release before acquiring callback lock.
+    // This avoids nested m_callbackMutex → m_statusMutex ordering that could
+    // deadlock if any other code path ever locks them in the opposite order.
+    {
+        std::lock_guard<std::mutex> lock(m_statusMutex);
+        auto now = std::chrono::steady_clock::now();
+
+        due = m_statusDirty & ~STATUS_THROTTLED;
+        // Throttled fields ride along with any immediate flush for free
+        if (force || due || now >= m_nextThrottledFlush) {
+            due |= m_statusDirty & STATUS_THROTTLED;
+        }
+        if (!due) {
             return;
         }
-        std::cout << "[MpvContext] CGL context made current in render thread" << std::endl;
+
+        m_statusDirty &= ~due;
+        if (due & STATUS_THROTTLED) {
+            m_nextThrottledFlush = now + std::chrono::milliseconds(m_config.statusIntervalMs);
+        }
+        statusCopy = m_status;
     }
-#endif
+
+    std::lock_guard<std::mutex> lock(m_callbackMutex);
+    if (m_statusCallback) {
+        m_statusCallback(statusCopy, due);
+    }
+}
+
+// Planar export format for a source pixel format: 4:2:0 maps onto NV12 / P010
+// without resampling chroma twice; anything else stays packed RGB
+static TextureFormat exportFormatFor(const std::string& pixelFormat) {
+    if (pixelFormat == "nv12" || pixelFormat == "yuv420p" || pixelFormat == "yuvj420p") {
+        return TextureFormat::NV12;
+    }
+    if (pixelFormat == "p010" || pixelFormat == "p016" || pixelFormat.rfind("yuv420p10", 0) == 0 ||
+        pixelFormat.rfind("yuv420p12", 0) == 0) {
+        return TextureFormat::P010;
+    }
+    return TextureFormat::RGBA8;
+}
+
+static TextureTransfer transferFor(const std::string& gamma) {
+    if (gamma == "pq") return TextureTransfer::PQ;
+    if (gamma == "hlg") return TextureTransfer::HLG;
+    return TextureTransfer::SDR;
+}
+
+bool MpvContext::applyVideoParams(const mpv_node* params) {
+    // Unavailable between files — keep the last size so the texture stays put
+    int width = nodeInt(params, "w");
+    int height = nodeInt(params, "h");
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+
+    // hw-pixelformat is the real layout behind a hwdec surface type like "videotoolbox"
+    std::string pixelFormat = nodeString(params, "hw-pixelformat");
+    if (pixelFormat.empty()) {
+        pixelFormat = nodeString(params, "pixelformat");
+    }
+
+    bool resized = width != m_status.width || height != m_status.height;
+    m_status.width = width;
+    m_status.height = height;
+    m_status.pixelFormat = pixelFormat;
+    m_status.colorMatrix = nodeString(params, "colormatrix");
+    m_status.colorLevels = nodeString(params, "colorlevels");
+    m_status.primaries = nodeString(params, "primaries");
+    m_status.gamma = nodeString(params, "gamma");
+
+    TextureFormat format = TextureFormat::RGBA8;
+    TextureTransfer transfer = TextureTransfer::SDR;
+    if (m_config.yuvExport && !m_yuvExportFailed) {
+        format = exportFormatFor(pixelFormat);
+        // Only the 10-bit export keeps HDR; NV12 gets mpv's SDR tone mapping
+        if (format == TextureFormat::P010) {
+            transfer = transferFor(m_status.gamma);
+        }
+    }
+    bool reformatted = format != m_exportFormat;
+    if (reformatted || transfer != m_exportTransfer) {
+        applyTargetColorspace(format, transfer);
+    }
+    m_exportFormat = format;
+    m_exportTransfer = transfer;
+
+    // An explicit output size pins the shared texture; mpv scales into it
+    if (m_outputWidth != 0) {
+        if (reformatted) {
+            requestResize(m_outputWidth, m_outputHeight, format);
+        }
+    } else if (resized || reformatted) {
+        requestResize(static_cast<uint32_t>(width), static_cast<uint32_t>(height), format);
+    }
+    return true;
+}
+
+void MpvContext::applyTargetColorspace(TextureFormat format, TextureTransfer transfer) {
+    // P010 frames are declared BT.2020 (see TextureFormat); HDR sources keep
+    // their transfer instead of being tone mapped down to SDR
+    const char* prim = format == TextureFormat::P010 ? "bt.2020" : "auto";
+    const char* trc = "auto";
+    if (format == TextureFormat::P010) {
+        trc = transfer == TextureTransfer::PQ ? "pq" : transfer == TextureTransfer::HLG ? "hlg" : "bt.1886";
+    }
+    mpv_set_property_async(m_mpv, 0, "target-prim", MPV_FORMAT_STRING, &prim);
+    mpv_set_property_async(m_mpv, 0, "target-trc", MPV_FORMAT_STRING, &trc);
+}
+
+void MpvContext::requestResize(uint32_t width, uint32_t height, TextureFormat format) {
+    if (isPlanar(format)) {
+        if (m_yuvExportFailed) {
+            format = TextureFormat::RGBA8;
+        } else {
+            // 4:2:0 chroma planes need even dimensions
+            width = (width + 1) & ~1u;
+            height = (height + 1) & ~1u;
+        }
+    }
+
+    // Signal render thread to resize (GL calls must happen there)
+    std::lock_guard<std::mutex> lock(m_renderMutex);
+    m_pendingWidth = width;
+    m_pendingHeight = height;
+    m_pendingFormat = format;
+    m_needsResize = true;
+    m_renderCV.notify_one();  // Wake render thread for resize
+}
+
+void MpvContext::setOutputSize(uint32_t width, uint32_t height) {
+    if (width == 0 || height == 0) {
+        width = 0;
+        height = 0;
+    }
+
+    uint32_t targetWidth = width;
+    uint32_t targetHeight = height;
+    TextureFormat format;
+    {
+        std::lock_guard<std::mutex> lock(m_statusMutex);
+        m_outputWidth = width;
+        m_outputHeight = height;
+        if (width == 0) {
+            // Auto: back to the decoded size (or the initial size before any video)
+            targetWidth = m_status.width > 0 ? m_status.width : m_config.width;
+            targetHeight = m_status.height > 0 ? m_status.height : m_config.height;
+        }
+        format = m_exportFormat;
+    }
+    requestResize(targetWidth, targetHeight, format);
+    applyRenderPath();
+}
+
+void MpvContext::renderLoop() {
+    // Per-player log throttles (render threads of different players run concurrently)
+    int lockFailCount = 0;
+    int frameCount = 0;
+
+    // Frame rendered and fenced but not yet complete on the GPU
+    TextureInfo inFlight{};
+    bool hasInFlight = false;
+
+    // mpv reported a frame we could not render yet (no free slot); it stays
+    // queued in mpv until we render, so retry without a new update flag
+    bool framePending = false;
+
+    // Stats timestamps (nowUs): mpv's request for the frame being rendered,
+    // and when the in-flight frame was fenced
+    uint64_t frameRequestedAtUs = 0;
+    uint64_t inFlightAtUs = 0;
+
+    // displaySync state (nowUs, 0 = none): when a deferred frame is due to
+    // render, the vsync the in-flight frame targets, and when to report the
+    // last paced render's swap to mpv
+    uint64_t renderAtUs = 0;
+    uint64_t inFlightVsyncUs = 0;
+    uint64_t swapAtUs = 0;
+    // Render start -> frame published, smoothed; sizes the just-in-time lead
+    double renderCostUs = 0;
+    uint64_t inFlightRenderUs = 0;
+    // Last refresh rate pushed to mpv
+    double displayFps = 0;
+
+    // Thumbnail readbacks in flight on the GPU
+    ThumbnailCapture thumbnails;
+
+    // TextureInfo::seq of the last exported frame
+    uint64_t frameSeq = 0;
+
+    // RenderMode last seen, and when THROTTLED may render again (nowUs)
+    RenderMode renderMode = RenderMode::ACTIVE;
+    uint64_t throttledAtUs = 0;
+
+    // Size of the shared texture set (render thread only)
+    uint32_t textureWidth = m_config.width;
+    uint32_t textureHeight = m_config.height;
+    TextureFormat textureFormat = TextureFormat::RGBA8;
+
+    // Hand a GPU-complete frame to the consumer via the mailbox
+    auto publish = [&](const TextureInfo& frame) {
+        if (frameCount < 10) {
+            std::cout << "[MpvContext] Frame " << frameCount << " exported: "
+                      << frame.width << "x" << frame.height << std::endl;
+        }
+        frameCount++;
+
+        if (m_firstFrameFromUs.load(std::memory_order_relaxed)) {
+            uint64_t from = m_firstFrameFromUs.exchange(0);
+            if (from) {
+                uint64_t elapsed = nowUs() - from;
+                m_stats.timeToFirstFrame.record(elapsed);
+                m_stats.lastFirstFrameUs.store(elapsed, std::memory_order_relaxed);
+            }
+        }
+
+        TextureInfo posted = frame;
+        posted.exportUs = nowUs();
+        bool tracing = m_trace.enabled();
+        if (tracing) {
+            m_trace.record(TraceStage::GPU, posted.seq, posted.renderDoneUs, posted.exportUs, posted.pts);
+        }
+
+        TextureInfo replaced;
+        bool notify = m_mailbox.post(posted, replaced);
+        if (replaced.is_valid) {
+            // Coalesced away before JS saw it — the slot is ours again
+            m_textureShare->releaseTexture(replaced.handle, replaced.generation);
+            if (tracing) {
+                m_trace.record(TraceStage::DROP, replaced.seq, posted.exportUs, posted.exportUs, replaced.pts);
+            }
+        }
+        if (notify && m_standby) {
+            // Hidden: keep the newest frame for promote(), don't deliver it
+            m_mailbox.cancelNotify();
+        } else if (notify && m_compositor) {
+            m_compositor->tileReady();
+        } else if (notify) {
+            std::lock_guard<std::mutex> cbLock(m_callbackMutex);
+            if (!m_frameCallback || !m_frameCallback()) {
+                m_mailbox.cancelNotify();
+            }
+        }
+
+        m_snapshot.writeStats(m_stats, framesDropped());
+    };
 
     while (m_running) {
-        // Wait for render update or resize request
+        // A paced frame's swap is reported at the vsync it was rendered for,
+        // so mpv's frame timing follows the display rather than our render
+        if (swapAtUs && nowUs() >= swapAtUs) {
+            mpv_render_context_report_swap(m_renderCtx);
+            swapAtUs = 0;
+        }
+
+        if (thumbnails.busy()) {
+            thumbnails.poll();
+        }
+
+        // Publish the in-flight frame once its fence signals. While a frame is
+        // in flight the bounded fence wait stands in for idling on the CV.
+        if (hasInFlight && m_textureShare->waitForExport(inFlight, FENCE_WAIT_NS)) {
+            uint64_t doneUs = nowUs();
+            m_stats.gpuComplete.record(doneUs - inFlightAtUs);
+            if (inFlightVsyncUs) {
+                double cost = static_cast<double>(doneUs - inFlightRenderUs);
+                renderCostUs = renderCostUs ? renderCostUs + (cost - renderCostUs) / 8 : cost;
+                if (doneUs > inFlightVsyncUs) {
+                    m_stats.framesLate.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+            publish(inFlight);
+            hasInFlight = false;
+        }
+
+        // Wait for render update or resize request, or until a deferred
+        // render or swap report is due
         {
             std::unique_lock<std::mutex> lock(m_renderMutex);
-            m_renderCV.wait(lock, [this] { return m_needsRender || m_needsResize || !m_running; });
+            auto ready = [this] { return m_needsRender || m_needsResize || !m_running; };
+            uint64_t deadlineUs = renderAtUs;
+            if (swapAtUs && (!deadlineUs || swapAtUs < deadlineUs)) {
+                deadlineUs = swapAtUs;
+            }
+            if (thumbnails.busy()) {
+                uint64_t pollAtUs = nowUs() + THUMBNAIL_POLL_US;
+                if (!deadlineUs || pollAtUs < deadlineUs) {
+                    deadlineUs = pollAtUs;
+                }
+            }
+            if (!hasInFlight && deadlineUs) {
+                uint64_t now = nowUs();
+                uint64_t waitUs = deadlineUs > now ? deadlineUs - now : 0;
+                m_renderCV.wait_for(lock, std::chrono::microseconds(waitUs), ready);
+            } else if (!hasInFlight) {
+                m_renderCV.wait(lock, ready);
+            }
             if (!m_running) break;
+            if (!ready() && !(renderAtUs && nowUs() >= renderAtUs)) {
+                continue;  // Keep waiting on the fence or the deadline
+            }
             m_needsRender = false;
         }
 
@@ -611,94 +1739,282 @@ void MpvContext::renderLoop() {
         if (m_needsResize && m_textureShare) {
             uint32_t newWidth = m_pendingWidth.load();
             uint32_t newHeight = m_pendingHeight.load();
-            if (newWidth > 0 && newHeight > 0) {
+            TextureFormat newFormat = m_pendingFormat.load();
+            m_needsResize = false;
+            if (newWidth > 0 && newHeight > 0 &&
+                (newWidth != textureWidth || newHeight != textureHeight || newFormat != textureFormat)) {
                 std::cout << "[MpvContext] Resizing texture to " << newWidth << "x" << newHeight << std::endl;
-                m_textureShare->resizeTexture(newWidth, newHeight);
+                // Frames JS will never receive hand their slots back first:
+                // the set may be pooled, and a parked slot still marked
+                // Exported would stay held until the reclaim timeout
+                TextureInfo discarded;
+                m_mailbox.invalidate(discarded);
+                if (discarded.is_valid) {
+                    m_textureShare->releaseTexture(discarded.handle, discarded.generation);
+                }
+                if (hasInFlight) {
+                    m_textureShare->releaseTexture(inFlight.handle, inFlight.generation);
+                    hasInFlight = false;
+                }
+                std::lock_guard<std::mutex> lock(m_frameMutex);
+                bool resized = m_textureShare->resizeTexture(newWidth, newHeight, newFormat);
+                if (!resized && isPlanar(newFormat)) {
+                    std::cerr << "[MpvContext] Planar export unavailable, falling back to RGB" << std::endl;
+                    m_yuvExportFailed = true;
+                    newFormat = TextureFormat::RGBA8;
+                    resized = m_textureShare->resizeTexture(newWidth, newHeight, newFormat);
+                }
+                if (resized) {
+                    textureWidth = newWidth;
+                    textureHeight = newHeight;
+                    textureFormat = newFormat;
+                }
+                m_stats.resizes.fetch_add(1, std::memory_order_relaxed);
+                // Redraw at the new size even if mpv has no new frame (paused)
+                framePending = true;
+                frameRequestedAtUs = 0;
             }
-            m_needsResize = false;
+        }
+
+        // A mode change redraws the current picture right away, so the view
+        // is current when it comes back on screen
+        RenderMode mode = m_renderMode.load(std::memory_order_relaxed);
+        if (mode != renderMode) {
+            renderMode = mode;
+            throttledAtUs = 0;
+            framePending = true;
+            frameRequestedAtUs = 0;
         }
 
         // Check if we can render
         uint64_t flags = mpv_render_context_update(m_renderCtx);
-        if (!(flags & MPV_RENDER_UPDATE_FRAME)) {
+        uint64_t updateAtUs = m_updateAtUs.exchange(0, std::memory_order_relaxed);
+        if (!framePending) {
+            // A starved frame keeps counting from its original request
+            frameRequestedAtUs = updateAtUs;
+        }
+        // A thumbnail request redraws the current picture if nothing newer comes
+        bool thumbnailWanted = m_thumbnailRequested.exchange(false);
+        if (!(flags & MPV_RENDER_UPDATE_FRAME) && !framePending && !thumbnailWanted) {
             continue;
         }
 
-        // No m_frameInUse check needed — triple buffering eliminates contention.
-        // macOS: IOSurface uses glFlush for GPU-to-GPU sync.
-        // Windows (future): keyed mutex / AcquireSync will handle sync instead.
+        // Off screen: retire mpv's frame without drawing it. THROTTLED still
+        // renders one a second, and a thumbnail always gets a real render.
+        if (renderMode != RenderMode::ACTIVE && !thumbnailWanted) {
+            uint64_t now = nowUs();
+            if (renderMode == RenderMode::SUSPENDED || now < throttledAtUs) {
+                if (flags & MPV_RENDER_UPDATE_FRAME) {
+                    if (swapAtUs) {
+                        mpv_render_context_report_swap(m_renderCtx);
+                        swapAtUs = 0;
+                    }
+                    mpv_opengl_fbo skip_fbo{
+                        .fbo = 0,
+                        .w = static_cast<int>(textureWidth),
+                        .h = static_cast<int>(textureHeight),
+                        .internal_format = 0
+                    };
+                    int skip = 1;
+                    int block = 0;
+                    mpv_render_param skip_params[] = {
+                        {MPV_RENDER_PARAM_OPENGL_FBO, &skip_fbo},
+                        {MPV_RENDER_PARAM_SKIP_RENDERING, &skip},
+                        {MPV_RENDER_PARAM_BLOCK_FOR_TARGET_TIME, &block},
+                        {MPV_RENDER_PARAM_INVALID, nullptr}
+                    };
+                    mpv_render_context_render(m_renderCtx, skip_params);
+                    m_stats.framesSkipped.fetch_add(1, std::memory_order_relaxed);
+                }
+                framePending = false;
+                renderAtUs = 0;
+                continue;
+            }
+            throttledAtUs = now + THROTTLED_INTERVAL_US;
+        }
+
+        // displaySync: hold the frame until just before its vsync, leaving
+        // room for the render to complete. The lead is capped so a slow
+        // render cannot push the frame a whole refresh early. Only the
+        // active mode paces; a throttled frame is not timed to a vsync.
+        uint64_t frameVsyncUs = 0;
+        if (renderMode == RenderMode::ACTIVE && m_config.displaySync && m_vsync.locked(nowUs())) {
+            double periodUs = std::max(m_vsync.periodUs(), static_cast<double>(VsyncClock::MIN_PERIOD_US));
+            m_stats.displayPeriodUs.store(static_cast<uint64_t>(periodUs), std::memory_order_relaxed);
+            double fps = 1e6 / periodUs;
+            if (std::fabs(fps - displayFps) > displayFps * DISPLAY_FPS_TOLERANCE) {
+                // Async: the render thread must not wait on mpv's core
+                mpv_set_property_async(m_mpv, 0, "display-fps-override", MPV_FORMAT_DOUBLE, &fps);
+                displayFps = fps;
+            }
+
+            uint64_t vsyncUs = 0;
+            if (nextFrameVsync(vsyncUs)) {
+                double lead = std::min(renderCostUs + PACING_MARGIN_US, periodUs * 3 / 4);
+                uint64_t leadUs = static_cast<uint64_t>(lead);
+                uint64_t renderAt = vsyncUs > leadUs ? vsyncUs - leadUs : 0;
+                if (renderAt > nowUs() + PACING_SLACK_US) {
+                    renderAtUs = renderAt;
+                    framePending = true;
+                    continue;
+                }
+                frameVsyncUs = vsyncUs;
+            }
+        }
+        renderAtUs = 0;
 
-        // Lock texture for rendering
+        // Lock a slot the consumer has released
         if (!m_textureShare->lockTexture()) {
-            static int lockFailCount = 0;
             if (lockFailCount < 5) {
-                std::cout << "[MpvContext] Failed to lock texture" << std::endl;
+                std::cout << "[MpvContext] Failed to lock texture (no free slot)" << std::endl;
                 lockFailCount++;
             }
+            m_stats.lockFailures.fetch_add(1, std::memory_order_relaxed);
+            // releaseFrame() wakes us once a slot comes back
+            framePending = true;
+            std::lock_guard<std::mutex> lock(m_renderMutex);
+            m_slotStarved = true;
             continue;
         }
+        framePending = false;
 
-        // Get FBO and dimensions
+        // Get FBO and dimensions. The FBO is the shared texture's size, not
+        // the video's: mpv scales (and letterboxes) the video into it.
         int fbo = m_textureShare->getGLFBO();
-        int width, height;
-        {
-            std::lock_guard<std::mutex> lock(m_statusMutex);
-            width = m_status.width > 0 ? m_status.width : m_config.width;
-            height = m_status.height > 0 ? m_status.height : m_config.height;
-        }
+        int width = static_cast<int>(textureWidth);
+        int height = static_cast<int>(textureHeight);
 
         // Render
         mpv_opengl_fbo fbo_params{
             .fbo = fbo,
             .w = width,
             .h = height,
-            .internal_format = 0  // Use default
+            // Lets mpv render (and dither) at the target's real depth
+            .internal_format = static_cast<int>(m_textureShare->getGLInternalFormat())
         };
 
         int flip_y = 1;
+        // A paced frame is already on time; don't let mpv sleep on it again
+        int block_for_target = frameVsyncUs ? 0 : 1;
         mpv_render_param params[] = {
             {MPV_RENDER_PARAM_OPENGL_FBO, &fbo_params},
             {MPV_RENDER_PARAM_FLIP_Y, &flip_y},
+            {MPV_RENDER_PARAM_BLOCK_FOR_TARGET_TIME, &block_for_target},
             {MPV_RENDER_PARAM_INVALID, nullptr}
         };
 
+        // mpv expects one swap per render: settle the previous paced one
+        if (swapAtUs) {
+            mpv_render_context_report_swap(m_renderCtx);
+            swapAtUs = 0;
+        }
+
+        uint64_t renderStartUs = nowUs();
+        double framePts = m_timePos.load(std::memory_order_relaxed);
+        // A paced frame's deliberate hold is not render latency
+        if (frameRequestedAtUs && !frameVsyncUs) {
+            m_stats.updateToRender.record(renderStartUs - frameRequestedAtUs);
+        }
+
         int result = mpv_render_context_render(m_renderCtx, params);
+        uint64_t renderDoneUs = nowUs();
+        m_stats.renderCall.record(renderDoneUs - renderStartUs);
         if (result < 0) {
-            m_textureShare->releaseTexture();
+            m_stats.renderFailures.fetch_add(1, std::memory_order_relaxed);
+            m_textureShare->abandonTexture();
             continue;
         }
 
-        // Report swap
-        mpv_render_context_report_swap(m_renderCtx);
+        // Start thumbnail readbacks from the fresh render, before the slot is
+        // handed over; they complete behind their own fences
+        std::vector<ThumbnailRequest> thumbnailRequests;
+        {
+            std::lock_guard<std::mutex> lock(m_thumbnailMutex);
+            thumbnailRequests.swap(m_thumbnailRequests);
+        }
+        for (auto& request : thumbnailRequests) {
+            uint32_t thumbWidth = request.width;
+            uint32_t thumbHeight = request.height;
+            if (thumbWidth == 0) {
+                thumbWidth = static_cast<uint32_t>(static_cast<uint64_t>(thumbHeight) * textureWidth / textureHeight);
+            } else if (thumbHeight == 0) {
+                thumbHeight = static_cast<uint32_t>(static_cast<uint64_t>(thumbWidth) * textureHeight / textureWidth);
+            }
+            // Never upscale: the thumbnail holds no more detail than the texture
+            thumbWidth = std::max(1u, std::min(thumbWidth, textureWidth));
+            thumbHeight = std::max(1u, std::min(thumbHeight, textureHeight));
+            thumbnails.capture(static_cast<unsigned int>(fbo), textureWidth, textureHeight,
+                               thumbWidth, thumbHeight, std::move(request.done));
+        }
 
-        // Flush GL commands to ensure rendering is complete before export.
-        // macOS: glFlush is sufficient for GPU-to-GPU IOSurface sharing.
-        glFlush();
+        // Report swap
+        if (frameVsyncUs) {
+            swapAtUs = frameVsyncUs;
+            m_stats.framesPaced.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            mpv_render_context_report_swap(m_renderCtx);
+        }
 
-        // Unlock and export texture
+        // Unlock and export texture. The backend fences the render (macOS) or
+        // hands the keyed mutex over (Windows) — no glFlush/glFinish here.
         TextureInfo info = m_textureShare->unlockAndExport();
-        if (info.is_valid) {
-            static int frameCount = 0;
-            if (frameCount < 10) {
-                std::cout << "[MpvContext] Frame " << frameCount << " exported: "
-                          << info.width << "x" << info.height << std::endl;
-            }
-            frameCount++;
+        if (!info.is_valid) {
+            continue;
+        }
+        if (isPlanar(info.format)) {
+            info.transfer = m_exportTransfer.load(std::memory_order_relaxed);
+        }
+        info.seq = ++frameSeq;
+        info.pts = framePts;
+        info.renderStartUs = renderStartUs;
+        info.renderDoneUs = renderDoneUs;
+        if (m_trace.enabled()) {
+            m_trace.record(TraceStage::RENDER, info.seq, renderStartUs, renderDoneUs, framePts);
+        }
 
-            std::lock_guard<std::mutex> lock(m_frameMutex);
-            m_currentFrame = info;
-            m_frameInUse = true;
+        m_stats.framesRendered.fetch_add(1, std::memory_order_relaxed);
 
-            // Notify callback
-            std::lock_guard<std::mutex> cbLock(m_callbackMutex);
-            if (m_frameCallback) {
-                m_frameCallback(info);
-            }
+        if (hasInFlight) {
+            // Previous frame still not complete on the GPU: superseded
+            m_textureShare->releaseTexture(inFlight.handle, inFlight.generation);
+            m_stats.framesSuperseded.fetch_add(1, std::memory_order_relaxed);
         }
+        inFlight = info;
+        inFlightAtUs = nowUs();
+        inFlightRenderUs = renderStartUs;
+        inFlightVsyncUs = frameVsyncUs;
+        hasInFlight = true;
     }
+
+    thumbnails.destroy("Player destroyed");
+}
+
+bool MpvContext::nextFrameVsync(uint64_t& vsyncUs) {
+    mpv_render_frame_info info{};
+    mpv_render_param param = {MPV_RENDER_PARAM_NEXT_FRAME_INFO, &info};
+    if (mpv_render_context_get_info(m_renderCtx, param) < 0) {
+        return false;
+    }
+    if (!(info.flags & MPV_RENDER_FRAME_INFO_PRESENT) ||
+        (info.flags & MPV_RENDER_FRAME_INFO_REDRAW) || info.target_time <= 0) {
+        return false;
+    }
+
+    // target_time is on mpv's clock; move it onto nowUs()
+    int64_t skewUs = mpv_get_time_us(m_mpv) - static_cast<int64_t>(nowUs());
+    int64_t targetUs = info.target_time - skewUs;
+    if (targetUs <= 0) {
+        return false;
+    }
+    vsyncUs = m_vsync.nearestVsync(static_cast<uint64_t>(targetUs));
+    return vsyncUs != 0;
 }
 
 void MpvContext::onRenderUpdate() {
+    // Keep the oldest outstanding request so coalesced updates count from the first
+    uint64_t expected = 0;
+    m_updateAtUs.compare_exchange_strong(expected, nowUs(), std::memory_order_relaxed);
+
     std::lock_guard<std::mutex> lock(m_renderMutex);
     m_needsRender = true;
     m_renderCV.notify_one();
@@ -706,22 +2022,7 @@ void MpvContext::onRenderUpdate() {
 
 void* MpvContext::getProcAddress(void* ctx, const char* name) {
     (void)ctx; // Unused for now
-
-#ifdef _WIN32
-    void* addr = reinterpret_cast<void*>(wglGetProcAddress(name));
-    if (!addr) {
-        // Try loading from opengl32.dll for core functions
-        static HMODULE gl = LoadLibraryA("opengl32.dll");
-        if (gl) {
-            addr = reinterpret_cast<void*>(GetProcAddress(gl, name));
-        }
-    }
-    return addr;
-#elif defined(__APPLE__)
-    return dlsym(RTLD_DEFAULT, name);
-#else
-    return reinterpret_cast<void*>(glXGetProcAddressARB(reinterpret_cast<const GLubyte*>(name)));
-#endif
+    return GLContext::getProcAddress(name);
 }
 
 void MpvContext::renderUpdateCallback(void* ctx) {
@@ -729,8 +2030,18 @@ void MpvContext::renderUpdateCallback(void* ctx) {
     self->onRenderUpdate();
 }
 
+void MpvContext::onWakeup() {
+    {
+        std::lock_guard<std::mutex> lock(m_eventMutex);
+        m_eventsPending = true;
+    }
+    m_eventCV.notify_one();
+}
+
 void MpvContext::wakeupCallback(void* ctx) {
-    (void)ctx; // Event loop uses mpv_wait_event with timeout, so no explicit wakeup needed
+    // Called from mpv's threads — must not call back into the mpv API
+    auto* self = static_cast<MpvContext*>(ctx);
+    self->onWakeup();
 }
 
 } // namespace mpv_texture
@@ -11,14 +11,30 @@
 #include <string>
 #include <functional>
 #include <atomic>
+#include <chrono>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <limits>
+#include <utility>
+#include <vector>
 
+#include "frame_mailbox.h"
+#include "frame_trace.h"
+#include "gl_context.h"
+#include "log_ring.h"
+#include "render_stats.h"
+#include "status_snapshot.h"
+#include "surface_pool.h"
 #include "texture_share.h"
+#include "thumbnail_capture.h"
+#include "vsync_clock.h"
+#include "vsync_source.h"
 
 namespace mpv_texture {
 
+class Compositor;
+
 // Status information for the renderer
 struct MpvStatus {
     bool playing;
@@ -28,12 +44,88 @@ struct MpvStatus {
     double duration;
     int width;
     int height;
+    // Source format from video-params (empty until the first frame is decoded)
+    std::string pixelFormat;    // Underlying format, e.g. "yuv420p", "nv12", "p010"
+    std::string colorMatrix;    // e.g. "bt.709", "bt.2020-ncl"
+    std::string colorLevels;    // "limited" or "full"
+    std::string primaries;      // e.g. "bt.709", "bt.2020"
+    std::string gamma;          // Transfer function, e.g. "bt.1886", "pq", "hlg"
+    // Current subtitle (empty between lines / without a subtitle track).
+    // Only text subtitles have text; subtitleBitmap is set for image tracks
+    // (PGS, DVB, VobSub), which the overlay mode burns into the video.
+    std::string subtitleText;   // Plain text, formatting stripped
+    std::string subtitleAss;    // The same line as an ASS event text, with tags
+    bool subtitleBitmap;
+};
+
+// MpvStatus fields, as a dirty mask. Status callbacks only carry what changed.
+enum StatusField : uint32_t {
+    STATUS_PLAYING  = 1u << 0,
+    STATUS_VOLUME   = 1u << 1,
+    STATUS_MUTED    = 1u << 2,
+    STATUS_POSITION = 1u << 3,
+    STATUS_DURATION = 1u << 4,
+    STATUS_VIDEO    = 1u << 5,  // width, height and the video-params format fields
+    STATUS_SUBTITLE = 1u << 6,  // subtitleText, subtitleAss, subtitleBitmap
+    STATUS_ALL      = (1u << 7) - 1,
 };
 
+// Fields that change continuously and are delivered at most every
+// MpvConfig::statusIntervalMs; everything else flushes immediately
+static const uint32_t STATUS_THROTTLED = STATUS_POSITION;
+
 // Callback types
-using FrameCallback = std::function<void(const TextureInfo&)>;
-using StatusCallback = std::function<void(const MpvStatus&)>;
+// FrameCallback only signals that takeFrame() has a frame; it returns false
+// if the notification could not be scheduled.
+using FrameCallback = std::function<bool()>;
+// StatusCallback receives the full status plus a StatusField mask of the
+// fields that changed since the previous call
+using StatusCallback = std::function<void(const MpvStatus&, uint32_t changed)>;
 using ErrorCallback = std::function<void(const std::string&)>;
+// LogCallback only signals that drainLog() has entries; it returns false if
+// the notification could not be scheduled
+using LogCallback = std::function<bool()>;
+// Completion of an async load(): ok once the file is loaded, otherwise the reason
+using LoadCallback = std::function<void(bool ok, const std::string& error)>;
+
+// Log filter: most verbose mpv_log_level kept, per module
+struct LogLevels {
+    int defaultLevel = MPV_LOG_LEVEL_INFO;
+    std::vector<std::pair<std::string, int>> modules;  // Later entries win
+};
+
+// Presets for demuxer caching, stream probing and network timeouts, chosen
+// per kind of stream. All of them set the same options (see
+// PROFILE_OPTIONS), so a per-load profile fully overrides the player's.
+enum class PlaybackProfile {
+    INHERIT,           // load(): keep the player's profile
+    DEFAULT,           // mpv's own defaults, tuned for local files
+    LOW_LATENCY_LIVE,  // Short probe and buffer: fastest start, least slack
+    STABLE_LIVE,       // Moderate probe, buffered against network hiccups
+    VOD,               // Full probe, deep readahead and seek-back cache
+};
+
+// "default", "low-latency-live", "stable-live" or "vod"
+bool parsePlaybackProfile(const std::string& name, PlaybackProfile& out);
+
+// How much of the render pipeline runs while the video is (partly) off
+// screen (see MpvContext::setRenderMode)
+enum class RenderMode {
+    ACTIVE,     // Render and export every frame
+    THROTTLED,  // Export about one frame a second (previews, thumbnails)
+    SUSPENDED,  // Export nothing; frames are retired without rendering
+};
+
+// "active", "throttled" or "suspended"
+bool parseRenderMode(const std::string& name, RenderMode& out);
+
+// The part of a live stream that can be seeked to without the network
+// (see MpvContext::timeshiftRange). Times are on the time-pos scale.
+struct TimeshiftRange {
+    double start;     // Oldest buffered time
+    double end;       // Newest buffered time: the live edge
+    double position;  // Current playback position
+};
 
 // Configuration for creating the context
 struct MpvConfig {
@@ -41,6 +133,42 @@ struct MpvConfig {
     uint32_t height = 1080;
     std::string hwdec = "auto";  // Hardware decoding: auto, d3d11va, videotoolbox, etc.
     std::string vo = "libmpv";   // Video output
+    // GPU memory kept for texture sets of previous resolutions (ABR switch-back)
+    uint64_t texturePoolBudget = DEFAULT_POOL_BUDGET_BYTES;
+    // Minimum interval between position updates (0 = every change)
+    uint32_t statusIntervalMs = 250;
+    // Start as a hidden standby player (see MpvContext::setStandby)
+    bool standby = false;
+    // Export 4:2:0 sources as NV12 (8-bit) or P010 (10-bit, HDR) planes
+    // instead of packed RGB, chosen from video-params
+    bool yuvExport = false;
+    // mpv log messages kept in the log ring, in msg-level syntax
+    // ("all=warn,ffmpeg=error"); see MpvContext::setLogLevels
+    std::string logLevels = "all=info";
+    // Pace rendering to the display: mpv resamples to the measured refresh
+    // rate and each frame is rendered just in time for the vsync it is
+    // shown on (see MpvContext::reportPresentation)
+    bool displaySync = false;
+    // Options applied from the start; load() can pick another per file
+    PlaybackProfile profile = PlaybackProfile::DEFAULT;
+    // Record per-frame latency events from the start (see setTrace)
+    bool trace = false;
+    // Deliver subtitles as status text instead of drawing them (see
+    // setSubtitleOverlay)
+    bool subtitleOverlay = false;
+    // Leave mpv_initialize, the GL context and the texture slots to the
+    // first load() (or start()), so a player that is never used costs only
+    // an idle thread
+    bool lazyStart = false;
+    // Cheaper, lower-quality render settings while frames are exported at
+    // their decoded size (see setFastRender)
+    bool fastRender = false;
+    // Timeshift buffer in MiB (0 = off): the demuxer cache goes to disk and
+    // keeps this much behind the playback position for rewinds, and as much
+    // ahead so a paused live stream keeps recording (see timeshiftRange)
+    uint32_t timeshiftMB = 0;
+    // Directory of the cache files (empty = mpv's default cache directory)
+    std::string timeshiftDir;
 };
 
 class MpvContext {
@@ -49,39 +177,196 @@ public:
     ~MpvContext();
 
     // Lifecycle
+    // Safe on any thread and blocking: mpv is initialized and the GL
+    // context, texture slots and render context are created on the render
+    // thread, which create() waits for. With lazyStart it returns at once
+    // and the first load() starts the player in the background.
     bool create(const MpvConfig& config);
+    // Start a lazyStart player now; blocks until it is up. False if startup
+    // failed (see startError). Calls after the first just report the result.
+    bool start();
+    bool isStarted() const;
+    // Why startup failed, empty otherwise
+    std::string startError() const;
+    // Render into tiles of `compositor` instead of an exported texture (see
+    // Compositor); call before create(). Frames then go to the compositor,
+    // not the frame callback, and YUV export is off. The compositor must
+    // outlive the player.
+    void attachCompositor(Compositor* compositor) { m_compositor = compositor; }
     void destroy();
     bool isInitialized() const { return m_initialized; }
 
     // Playback control
-    bool load(const std::string& url, const std::string& options = "");
+    // Queue a loadfile without blocking. `done` fires from the event thread on
+    // MPV_EVENT_FILE_LOADED, or with an error if the file ends (fails, is
+    // replaced by another load, player destroyed) before loading. Returns
+    // false if the command could not be queued; `done` is then never called.
+    // A `profile` other than INHERIT applies to this file only; `options`
+    // (per-file mpv options, "key=value,...") take precedence over it.
+    bool load(const std::string& url, const std::string& options = "",
+              PlaybackProfile profile = PlaybackProfile::INHERIT, LoadCallback done = nullptr);
     void play();
     void pause();
     void stop();
     void seek(double position);
+    // Timeshift: the buffered window around the playback position, from
+    // demuxer-cache-state; false before there is one. Any player has it (a
+    // few seconds of demuxer cache); timeshiftMB makes it minutes long.
+    bool timeshiftRange(TimeshiftRange& out) const;
+    // Seek to `secondsBehindLive` before the newest buffered data (0 =
+    // catch up with live), clamped to the range. Stays inside the cache, so
+    // no network round trip. False if there is no range.
+    bool seekLive(double secondsBehindLive);
     void setVolume(double volume);
     void toggleMute();
 
+    // Standby: a hidden player that pre-opens a stream for instant zapping.
+    // Playback is paused and muted once the first frame is decoded (keeping
+    // the demuxer cache warm), and frames are held back from the consumer.
+    void setStandby(bool standby);
+    bool isStandby() const { return m_standby; }
+    // Leave standby and start playing; the already-decoded frame is delivered
+    // immediately. A live stream that idled in standby first skips ahead to
+    // the newest buffered data.
+    void promote();
+
+    // Scale rendering down while the video is not visible (window minimized,
+    // player hidden). Playback, audio and status carry on in every mode:
+    // frames that are not drawn are retired with SKIP_RENDERING, so mpv's
+    // timing stays intact and no GPU work or export happens. Thumbnail
+    // captures still render. With dropVideo, SUSPENDED also deselects the
+    // video track (vid=no) so nothing is decoded either; leaving it selects
+    // the track again, and the picture returns with the next keyframe.
+    void setRenderMode(RenderMode mode, bool dropVideo = false);
+    RenderMode renderMode() const { return m_renderMode.load(std::memory_order_relaxed); }
+
+    // Keep subtitles and the OSD out of the video plane. mpv stops drawing
+    // them (sub-visibility=no, osd-level=0), so a new subtitle line no
+    // longer forces a re-render and re-export of the whole frame, and the
+    // text arrives through the status callback (STATUS_SUBTITLE) for the
+    // consumer to layer on top itself. Image subtitles have no text and
+    // stay burned in.
+    void setSubtitleOverlay(bool enabled);
+    bool subtitleOverlay() const { return m_subtitleOverlay.load(std::memory_order_relaxed); }
+
+    // Fast render trades picture quality for GPU time. While the texture is
+    // the decoded size (no output size set, or one equal to it) and no
+    // glsl-shaders are loaded, the scalers drop to bilinear and dithering,
+    // debanding and HDR peak detection are off, so banding and HDR tone
+    // mapping can get worse. The player's own settings come back as soon as
+    // mpv has to scale. No pass is removed: libmpv does not hand out decoder
+    // surfaces, so mpv still renders and converts every frame, OSD and
+    // subtitles included unless subtitleOverlay is on.
+    void setFastRender(bool enabled);
+    // Whether the cheaper settings are in effect right now
+    bool fastRenderActive() const { return m_fastRenderActive.load(std::memory_order_relaxed); }
+
+    // Size the shared texture to the on-screen target (physical pixels) and
+    // let mpv's scaler do the single downscale. 0x0 returns to auto, where
+    // the texture follows the decoded video size.
+    void setOutputSize(uint32_t width, uint32_t height);
+
     // Callbacks
     void setFrameCallback(FrameCallback callback);
     void setStatusCallback(StatusCallback callback);
     void setErrorCallback(ErrorCallback callback);
+    void setLogCallback(LogCallback callback);
+
+    // Log ring (see LogRing). Levels use mpv's msg-level syntax: a module
+    // name ("all" for the default) and a level from "no" to "trace", e.g.
+    // "all=warn,ffmpeg=error,cplayer=v". Applies from the next event batch;
+    // returns false (nothing changed) if the spec does not parse.
+    bool setLogLevels(const std::string& spec);
+    // Entries logged since the previous drain. Returns the number of entries
+    // overwritten before they could be drained.
+    uint64_t drainLog(std::vector<LogEntry>& out);
+    // All retained history, oldest first (leaves the drain position alone)
+    void dumpLog(std::vector<LogEntry>& out) const;
 
     // Frame management
-    void releaseFrame();
+    // Take the newest exported frame from the mailbox (see FrameMailbox)
+    bool takeFrame(TextureInfo& info, uint64_t& dropped);
+    // Hand a taken frame's slot back for reuse (consumer is done with it).
+    // Every frame delivered to the consumer must be released exactly once.
+    // `generation` is TextureInfo::generation (0 = the handle's current
+    // export, for callers that only kept the handle).
+    void releaseFrame(uint64_t handle, uint64_t generation);
+
+    // Render pipeline counters (see RenderStats); safe from any thread
+    const RenderStats& stats() const { return m_stats; }
+    // Frames coalesced away in the mailbox since the last resetStats()
+    uint64_t framesDropped() { return m_mailbox.droppedCount() - m_droppedBaseline; }
+    void resetStats();
+
+    // Capture the current picture scaled to width x height (0 for one side
+    // keeps the aspect ratio) as RGBA. The render thread reads it back
+    // asynchronously; `done` fires from the render thread. Returns false if
+    // the capture could not be queued; `done` is then never called.
+    bool captureThumbnail(uint32_t width, uint32_t height, ThumbnailCallback done);
+
+    // Presentation feedback from the consumer: a frame reached the screen
+    // `ageUs` ago. Feeds the vsync clock where the platform has no vsync
+    // source (Linux) and refines it elsewhere.
+    void reportPresentation(uint64_t ageUs);
+
+    // Latency trace (see FrameTrace): while enabled, each frame's render,
+    // GPU, delivery and hold times, drops and presentation reports are
+    // recorded in a bounded ring. Cheap enough to leave on while debugging.
+    void setTrace(bool enabled) { m_trace.setEnabled(enabled); }
+    // Retained events, oldest first
+    void dumpTrace(std::vector<TraceRecord>& out) const { m_trace.dump(out); }
 
     // Get current status
     MpvStatus getStatus() const;
 
+    // Mirror the numeric status fields and the stats counters into caller
+    // memory (StatusSnapshot::SIZE_BYTES, 8-byte aligned) that stays valid
+    // until destroy() returns. Call before create().
+    void attachStatusSnapshot(void* memory) { m_snapshot.attach(memory); }
+
 private:
     // Event handling thread
     void eventLoop();
     void handleEvent(mpv_event* event);
-    void handlePropertyChange(mpv_event_property* prop);
+    void handleLoadReply(mpv_event* event);
+    void handleFileLoaded();
+    void handleEndFile(const mpv_event_end_file* endFile);
+    // Fail every outstanding load (player going away)
+    void abortPendingLoads(const std::string& error);
+    // Most verbose level kept for a log module (event thread)
+    int logLevelFor(const char* prefix) const;
+    // Tell the consumer about entries logged in this event batch
+    void notifyLog();
+    void handlePropertyChange(uint64_t id, mpv_event_property* prop);
+    // Render thread: wait for start(), bring mpv and GL up, render, and free
+    // the GL side again on the way out
+    void renderThreadMain();
+    bool startEngine();
+    void reportStartError(const std::string& error);
+    // Issue a loadfile (player started)
+    bool queueLoad(const std::string& url, const std::string& fileOptions, LoadCallback done);
+    // Deliver dirty status fields that are due (all of them if force)
+    void flushStatus(bool force);
+    // Apply a video-params node (caller holds m_statusMutex)
+    bool applyVideoParams(const mpv_node* params);
+    // Set sub-visibility for the overlay mode and the current track type
+    void applySubtitleVisibility();
+    // Apply fast render or restore the player's own settings, for the flag
+    // and the current output / video size (not with m_statusMutex held)
+    void applyRenderPath();
+    // Ask the render thread to resize (or reformat) the shared texture
+    void requestResize(uint32_t width, uint32_t height, TextureFormat format);
+    // Point mpv's output colorspace at what the export format carries
+    void applyTargetColorspace(TextureFormat format, TextureTransfer transfer);
+
+    void onWakeup();
 
     // Render thread
     void renderLoop();
     void onRenderUpdate();
+    // The vsync (nowUs) mpv wants the next frame shown on; false if the next
+    // render has no target time (paused, redraw) or the clock is not locked
+    bool nextFrameVsync(uint64_t& vsyncUs);
 
     // Static callback for mpv
     static void* getProcAddress(void* ctx, const char* name);
@@ -101,6 +386,11 @@ private:
     std::atomic<bool> m_running{false};
     std::atomic<bool> m_initialized{false};
 
+    // Event synchronization (signalled by mpv's wakeup callback)
+    std::mutex m_eventMutex;
+    std::condition_variable m_eventCV;
+    bool m_eventsPending = false;
+
     // Render synchronization
     std::mutex m_renderMutex;
     std::condition_variable m_renderCV;
@@ -110,15 +400,142 @@ private:
     std::atomic<bool> m_needsResize{false};
     std::atomic<uint32_t> m_pendingWidth{0};
     std::atomic<uint32_t> m_pendingHeight{0};
+    std::atomic<TextureFormat> m_pendingFormat{TextureFormat::RGBA8};
 
-    // Frame synchronization
+    // Export format chosen from video-params (guarded by m_statusMutex), and
+    // the transfer function the render thread tags exported frames with
+    TextureFormat m_exportFormat = TextureFormat::RGBA8;
+    std::atomic<TextureTransfer> m_exportTransfer{TextureTransfer::SDR};
+    // The backend could not create planar textures; stay on RGB
+    std::atomic<bool> m_yuvExportFailed{false};
+
+    // Explicit output size from setOutputSize(), 0 = auto (follow the video)
+    std::atomic<uint32_t> m_outputWidth{0};
+    std::atomic<uint32_t> m_outputHeight{0};
+
+    // Latest-frame handoff to the consumer
+    FrameMailbox m_mailbox;
+    // Consumer of the mailbox instead of JS, if attached
+    Compositor* m_compositor = nullptr;
+
+    // Guards m_textureShare against releaseFrame() racing a resize/destroy
     std::mutex m_frameMutex;
-    std::atomic<bool> m_frameInUse{false};
-    TextureInfo m_currentFrame{};
+
+    FrameTrace m_trace;
+    // Frames taken by the consumer while tracing, for the HOLD event on
+    // release (guarded by m_frameMutex; bounded by the slot count)
+    struct HeldFrame {
+        uint64_t handle;
+        uint64_t seq;
+        uint64_t takenUs;
+        double pts;
+    };
+    std::vector<HeldFrame> m_heldFrames;
+    // Latest time-pos for TextureInfo::pts, written by the event thread so
+    // the render thread never asks mpv's core
+    std::atomic<double> m_timePos{std::numeric_limits<double>::quiet_NaN()};
+
+    // Startup (see start()): a lazyStart player stays IDLE until the first
+    // load, which waits in m_deferredLoad (guarded by m_startMutex) until
+    // the render thread has brought mpv up
+    enum class StartState { IDLE, STARTING, READY, FAILED };
+    struct DeferredLoad {
+        bool pending = false;
+        std::string url;
+        std::string options;
+        LoadCallback done;
+    };
+    mutable std::mutex m_startMutex;
+    std::condition_variable m_startCV;
+    StartState m_startState = StartState::IDLE;
+    std::string m_startError;
+    DeferredLoad m_deferredLoad;
+
+    // In-flight load() calls, oldest first (guarded by m_loadMutex)
+    struct PendingLoad {
+        uint64_t id;            // reply_userdata of the loadfile command
+        int64_t entryId;        // Playlist entry from the command reply, -1 until known
+        uint64_t startedAtUs;
+        LoadCallback done;
+    };
+    std::mutex m_loadMutex;
+    std::vector<PendingLoad> m_pendingLoads;
+    uint64_t m_nextLoadId = 1;
+    int64_t m_playingEntryId = -1;  // From MPV_EVENT_START_FILE
+    int64_t m_loadedEntryId = -1;   // Last entry that reached FILE_LOADED
+    // Load start of the current file until its first frame is published (0 = none)
+    std::atomic<uint64_t> m_firstFrameFromUs{0};
+
+    std::atomic<bool> m_standby{false};
+
+    std::atomic<RenderMode> m_renderMode{RenderMode::ACTIVE};
+    // setRenderMode(SUSPENDED, true) state (JS thread only): the vid value
+    // to restore, and the playlist entry it belongs to
+    bool m_videoDropped = false;
+    std::string m_droppedVid;
+    int64_t m_droppedEntryId = -1;
+
+    RenderStats m_stats;
+    // Status written by the event thread, stats by the render thread
+    StatusSnapshot m_snapshot;
+    // When mpv last asked for a render that has not started yet (nowUs, 0 = none)
+    std::atomic<uint64_t> m_updateAtUs{0};
+    std::atomic<uint64_t> m_droppedBaseline{0};
+
+    // Display refresh clock for displaySync, fed by m_vsyncSource and
+    // reportPresentation()
+    VsyncClock m_vsync;
+    VsyncSource* m_vsyncSource = nullptr;
+
+    LogRing m_log;
+    LogLevels m_logLevels;  // Event thread only
+    // Set by setLogLevels(), picked up by the event thread
+    LogLevels m_pendingLogLevels;
+    std::mutex m_logLevelsMutex;
+    std::atomic<bool> m_logLevelsChanged{false};
+    // Ring position of the last drain (JS thread) and of the last notify check
+    // (event thread); a notification is outstanding while m_logNotifyPending
+    uint64_t m_logCursor = 0;
+    uint64_t m_logCheckedHead = 0;
+    std::atomic<bool> m_logNotifyPending{false};
+
+    // Thumbnail captures waiting for the next render (guarded by
+    // m_thumbnailMutex), and a flag that makes the render thread redraw
+    // for them when mpv has no new frame (paused)
+    struct ThumbnailRequest {
+        uint32_t width;
+        uint32_t height;
+        ThumbnailCallback done;
+    };
+    std::mutex m_thumbnailMutex;
+    std::vector<ThumbnailRequest> m_thumbnailRequests;
+    std::atomic<bool> m_thumbnailRequested{false};
+
+    // Render skipped because every slot was held by the consumer
+    // (guarded by m_renderMutex)
+    bool m_slotStarved = false;
+
+    // Subtitle overlay mode, and whether mpv currently draws subtitles
+    // (sub-visibility as last set; event thread and setSubtitleOverlay)
+    std::atomic<bool> m_subtitleOverlay{false};
+    std::mutex m_subtitleMutex;
+    bool m_subtitlesDrawn = true;
+
+    // Fast render flag, whether its settings are applied, and the player's
+    // own values of the options it overrides, read when first applied
+    // (guarded by m_renderPathMutex)
+    std::atomic<bool> m_fastRender{false};
+    std::atomic<bool> m_fastRenderActive{false};
+    std::mutex m_renderPathMutex;
+    std::vector<std::string> m_savedRenderValues;
 
     // Current state
     MpvStatus m_status{};
     mutable std::mutex m_statusMutex;
+    // Fields changed but not yet delivered, and when throttled fields may
+    // flush next (guarded by m_statusMutex)
+    uint32_t m_statusDirty = 0;
+    std::chrono::steady_clock::time_point m_nextThrottledFlush{};
 
     // Callbacks
     // Lock ordering: never hold m_callbackMutex while acquiring m_statusMutex
@@ -127,13 +544,14 @@ private:
     FrameCallback m_frameCallback;
     StatusCallback m_statusCallback;
     ErrorCallback m_errorCallback;
+    LogCallback m_logCallback;
     std::mutex m_callbackMutex;
 
     // Config
     MpvConfig m_config;
 
-    // Platform-specific GL context handle
-    void* m_glContext = nullptr;
+    // This player's GL context (shares objects with every other player)
+    GLContext m_glContext;
 };
 
 } // namespace mpv_texture
@@ -0,0 +1,217 @@
+/*
+ * Columnar M3U playlist parser implementation
+ *
+ * Delimiters are found with memchr, which the C runtimes implement with
+ * vector instructions, so the scan over a 50 MB playlist is memory-bound.
+ */
+
+#include "m3u_parser.h"
+#include "text_util.h"
+#include <cstring>
+
+namespace mpv_texture {
+
+void M3UPlaylist::reserve(size_t channels) {
+    for (auto* column : { &name, &url, &tvgId, &tvgName, &tvgLogo, &group }) {
+        column->reserve(channels);
+    }
+    channelNumber.reserve(channels);
+    duration.reserve(channels);
+    // Names and URLs are mostly unique, the other columns mostly repeats
+    strings.reserve(channels * 3);
+}
+
+namespace {
+
+// Typical #EXTINF + URL pair; only sizes the initial reservation
+const size_t BYTES_PER_CHANNEL_ESTIMATE = 200;
+
+bool equalsIgnoreCase(const char* a, const char* lowerB, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        char c = a[i];
+        if (c >= 'A' && c <= 'Z') {
+            c = static_cast<char>(c - 'A' + 'a');
+        }
+        if (c != lowerB[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Attributes read from the #EXTM3U / #EXTINF lines
+enum Attribute { TVG_ID, TVG_NAME, TVG_LOGO, GROUP_TITLE, TVG_CHNO, URL_TVG, X_TVG_URL, ATTRIBUTE_COUNT };
+
+const char* const ATTRIBUTE_NAMES[ATTRIBUTE_COUNT] = {
+    "tvg-id", "tvg-name", "tvg-logo", "group-title", "tvg-chno", "url-tvg", "x-tvg-url"
+};
+
+struct AttributeValues {
+    std::string_view value[ATTRIBUTE_COUNT];
+    bool found[ATTRIBUTE_COUNT] = {};
+};
+
+// One pass over every `="` in `s`, matching the names before it. Gives the
+// leftmost match per attribute, as /name="([^"]*)"/i does; with
+// `skipEmpty` an empty value keeps looking, as /name="([^"]+)"/i does.
+void findAttributes(std::string_view s, const Attribute* wanted, size_t count, bool skipEmpty,
+                    AttributeValues& out) {
+    const char* begin = s.data();
+    const char* end = begin + s.size();
+    const char* p = begin;
+    size_t remaining = count;
+    while (remaining > 0 && p < end) {
+        const char* eq = static_cast<const char*>(memchr(p, '=', end - p));
+        if (!eq || eq + 1 >= end) {
+            break;
+        }
+        p = eq + 1;
+        if (*p != '"') {
+            continue;
+        }
+        const char* valueBegin = p + 1;
+        const char* quote = static_cast<const char*>(memchr(valueBegin, '"', end - valueBegin));
+        if (!quote) {
+            break;  // No closing quote anywhere further on either
+        }
+        for (size_t i = 0; i < count; i++) {
+            Attribute attribute = wanted[i];
+            if (out.found[attribute]) {
+                continue;
+            }
+            const char* name = ATTRIBUTE_NAMES[attribute];
+            size_t length = strlen(name);
+            if (static_cast<size_t>(eq - begin) < length || !equalsIgnoreCase(eq - length, name, length)) {
+                continue;
+            }
+            if (skipEmpty && quote == valueBegin) {
+                continue;
+            }
+            out.value[attribute] = std::string_view(valueBegin, quote - valueBegin);
+            out.found[attribute] = true;
+            remaining--;
+        }
+    }
+}
+
+// parseInt(): optional whitespace and sign, then digits; false for NaN
+bool parseInteger(std::string_view s, int32_t& out) {
+    s.remove_prefix(leadingSpace(s));
+    bool negative = false;
+    if (!s.empty() && (s[0] == '-' || s[0] == '+')) {
+        negative = s[0] == '-';
+        s.remove_prefix(1);
+    }
+    int64_t value = 0;
+    size_t digits = 0;
+    while (digits < s.size() && s[digits] >= '0' && s[digits] <= '9') {
+        if (value <= INT32_MAX) {
+            value = value * 10 + (s[digits] - '0');
+        }
+        digits++;
+    }
+    if (digits == 0) {
+        return false;
+    }
+    if (negative) {
+        value = -value;
+    }
+    // Clamp: INT32_MIN itself is reserved for CHANNEL_NUMBER_NONE
+    if (value > INT32_MAX) value = INT32_MAX;
+    if (value <= INT32_MIN) value = INT32_MIN + 1;
+    out = static_cast<int32_t>(value);
+    return true;
+}
+
+struct ExtInf {
+    std::string_view displayName;
+    AttributeValues attributes;
+    int32_t duration = -1;
+    int32_t channelNumber = CHANNEL_NUMBER_NONE;
+};
+
+void parseExtInf(std::string_view line, ExtInf& out) {
+    out = ExtInf{};
+    std::string_view content = line.substr(8);  // After "#EXTINF:"
+
+    // Display name: everything after the last comma
+    std::string_view attributes = content;
+    size_t comma = content.rfind(',');
+    if (comma != std::string_view::npos) {
+        out.displayName = trim(content.substr(comma + 1));
+        attributes = content.substr(0, comma);
+    }
+
+    // Duration: /^(-?\d+)/ (no leading whitespace or '+')
+    if (!attributes.empty() && (attributes[0] == '-' || (attributes[0] >= '0' && attributes[0] <= '9'))) {
+        int32_t duration;
+        if (parseInteger(attributes, duration)) {
+            out.duration = duration;
+        }
+    }
+
+    static const Attribute wanted[] = { TVG_ID, TVG_NAME, TVG_LOGO, GROUP_TITLE, TVG_CHNO };
+    findAttributes(attributes, wanted, sizeof(wanted) / sizeof(wanted[0]), false, out.attributes);
+
+    int32_t number;
+    if (out.attributes.found[TVG_CHNO] && parseInteger(out.attributes.value[TVG_CHNO], number)) {
+        out.channelNumber = number;
+    }
+}
+
+} // namespace
+
+void parseM3U(const char* data, size_t size, M3UPlaylist& out) {
+    out.reserve(size / BYTES_PER_CHANNEL_ESTIMATE);
+
+    ExtInf current;
+    bool haveMetadata = false;
+
+    const char* p = data;
+    const char* end = data + size;
+    while (p < end) {
+        const char* newline = static_cast<const char*>(memchr(p, '\n', end - p));
+        const char* lineEnd = newline ? newline : end;
+        std::string_view line = trim(std::string_view(p, lineEnd - p));
+        p = newline ? newline + 1 : end;
+
+        if (line.empty()) {
+            continue;
+        }
+
+        if (startsWith(line, "#EXTM3U")) {
+            static const Attribute wanted[] = { URL_TVG, X_TVG_URL };
+            AttributeValues header;
+            findAttributes(line, wanted, 2, true, header);
+            out.hasEpgUrl = header.found[URL_TVG] || header.found[X_TVG_URL];
+            out.epgUrl = header.found[URL_TVG] ? header.value[URL_TVG] : header.value[X_TVG_URL];
+            continue;
+        }
+
+        if (startsWith(line, "#EXTINF:")) {
+            parseExtInf(line, current);
+            haveMetadata = true;
+            continue;
+        }
+
+        if (line[0] == '#') {
+            continue;
+        }
+
+        if (haveMetadata &&
+            (startsWith(line, "http://") || startsWith(line, "https://") || startsWith(line, "rtmp://"))) {
+            const AttributeValues& attributes = current.attributes;
+            out.name.push_back(out.strings.intern(current.displayName));
+            out.url.push_back(out.strings.intern(line));
+            out.tvgId.push_back(out.strings.intern(attributes.value[TVG_ID]));
+            out.tvgName.push_back(out.strings.intern(attributes.value[TVG_NAME]));
+            out.tvgLogo.push_back(out.strings.intern(attributes.value[TVG_LOGO]));
+            out.group.push_back(out.strings.intern(attributes.value[GROUP_TITLE]));
+            out.channelNumber.push_back(current.channelNumber);
+            out.duration.push_back(current.duration);
+            haveMetadata = false;
+        }
+    }
+}
+
+} // namespace mpv_texture
@@ -0,0 +1,55 @@
+/*
+ * Columnar M3U playlist parser
+ *
+ * Scans an in-memory (usually memory-mapped) playlist once, line by line,
+ * and records each channel as indices into a string table rather than as an
+ * object: repeated values — group titles, logos, EPG ids — are stored once.
+ * Strings are views into the input, so the input must outlive the result.
+ *
+ * Semantics match parseM3U() in local-adapter/src/m3u-parser.ts: lines are
+ * trimmed, #EXTINF attributes are matched case-insensitively, and a channel
+ * is emitted for the first http://, https:// or rtmp:// line after an
+ * #EXTINF. Deriving ids and categories is left to the caller.
+ */
+
+#ifndef M3U_PARSER_H_
+#define M3U_PARSER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "string_table.h"
+
+namespace mpv_texture {
+
+// No tvg-chno (or one that isn't a number)
+constexpr int32_t CHANNEL_NUMBER_NONE = INT32_MIN;
+
+struct M3UPlaylist {
+    StringTable strings;
+    std::string_view epgUrl;  // url-tvg / x-tvg-url from #EXTM3U (empty if none)
+    bool hasEpgUrl = false;
+
+    // One entry per channel, in file order (string table indices)
+    std::vector<uint32_t> name;     // Display name after the last comma
+    std::vector<uint32_t> url;
+    std::vector<uint32_t> tvgId;
+    std::vector<uint32_t> tvgName;
+    std::vector<uint32_t> tvgLogo;
+    std::vector<uint32_t> group;    // group-title
+    std::vector<int32_t> channelNumber;
+    std::vector<int32_t> duration;
+
+    size_t size() const { return url.size(); }
+    void reserve(size_t channels);
+};
+
+// Parse `size` bytes of UTF-8 playlist text into `out` (never fails: lines
+// that aren't understood are skipped, as in the JS parser)
+void parseM3U(const char* data, size_t size, M3UPlaylist& out);
+
+} // namespace mpv_texture
+
+#endif // M3U_PARSER_H_
@@ -0,0 +1,132 @@
+/*
+ * Read-only memory-mapped file implementation
+ */
+
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace mpv_texture {
+
+#ifdef _WIN32
+bool MappedFile::open(const std::string& path, std::string& error) {
+    close();
+
+    int length = MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, nullptr, 0);
+    std::wstring widePath(length > 0 ? length : 1, L'\0');
+    MultiByteToWideChar(CP_UTF8, 0, path.c_str(), -1, &widePath[0], length);
+
+    HANDLE file = CreateFileW(widePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = "Failed to open file (error " + std::to_string(GetLastError()) + ")";
+        return false;
+    }
+    m_file = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        error = "Failed to get file size";
+        close();
+        return false;
+    }
+    if (size.QuadPart == 0) {
+        return true;  // Nothing to map; an empty playlist
+    }
+    if (static_cast<unsigned long long>(size.QuadPart) > SIZE_MAX) {
+        error = "File too large to map";
+        close();
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        error = "Failed to map file (error " + std::to_string(GetLastError()) + ")";
+        close();
+        return false;
+    }
+    m_mapping = mapping;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        error = "Failed to map file view (error " + std::to_string(GetLastError()) + ")";
+        close();
+        return false;
+    }
+    m_data = static_cast<const char*>(view);
+    m_size = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+    if (m_file) {
+        CloseHandle(m_file);
+        m_file = nullptr;
+    }
+    m_size = 0;
+}
+#else
+bool MappedFile::open(const std::string& path, std::string& error) {
+    close();
+
+    m_fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (m_fd < 0) {
+        error = std::string("Failed to open file: ") + strerror(errno);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(m_fd, &st) != 0) {
+        error = std::string("Failed to stat file: ") + strerror(errno);
+        close();
+        return false;
+    }
+    if (st.st_size == 0) {
+        return true;  // mmap rejects length 0; an empty playlist
+    }
+
+    void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, m_fd, 0);
+    if (data == MAP_FAILED) {
+        error = std::string("Failed to map file: ") + strerror(errno);
+        close();
+        return false;
+    }
+    // One front-to-back pass
+    madvise(data, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+    m_data = static_cast<const char*>(data);
+    m_size = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (m_data) {
+        munmap(const_cast<char*>(m_data), m_size);
+        m_data = nullptr;
+    }
+    if (m_fd >= 0) {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    m_size = 0;
+}
+#endif
+
+} // namespace mpv_texture
@@ -0,0 +1,44 @@
+/*
+ * Read-only memory-mapped file
+ *
+ * Lets the playlist parser scan a large download in place: pages are read
+ * on demand by the OS and never copied into the JS heap.
+ */
+
+#ifndef MAPPED_FILE_H_
+#define MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+namespace mpv_texture {
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map `path` (UTF-8) for reading; on failure `error` says why
+    bool open(const std::string& path, std::string& error);
+    void close();
+
+    const char* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    const char* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;     // HANDLE
+    void* m_mapping = nullptr;  // HANDLE
+#else
+    int m_fd = -1;
+#endif
+};
+
+} // namespace mpv_texture
+
+#endif // MAPPED_FILE_H_
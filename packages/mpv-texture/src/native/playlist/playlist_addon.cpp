@@ -0,0 +1,263 @@
+/*
+ * N-API entry point for the native playlist / guide parsers (playlist_parser.node)
+ *
+ * Built as its own target with no mpv or GPU dependencies, so it is usable
+ * on every platform, including those where mpv_texture is only the stub.
+ * Parsing runs on the libuv thread pool (XMLTV fans out further onto its
+ * own threads); the JS thread only turns the string table and columns
+ * into JS values.
+ */
+
+#include <napi.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "m3u_parser.h"
+#include "mapped_file.h"
+#include "xmltv_parser.h"
+
+using namespace mpv_texture;
+
+namespace {
+
+// Strings created per handle scope while building the table
+const size_t STRING_BATCH = 4096;
+
+template <typename TypedArray, typename T>
+TypedArray ColumnToJS(Napi::Env env, const std::vector<T>& column) {
+    TypedArray array = TypedArray::New(env, column.size());
+    if (!column.empty()) {
+        std::memcpy(array.Data(), column.data(), column.size() * sizeof(T));
+    }
+    return array;
+}
+
+Napi::Array StringsToJS(Napi::Env env, const std::vector<std::string_view>& strings) {
+    Napi::Array array = Napi::Array::New(env, strings.size());
+    for (size_t start = 0; start < strings.size(); start += STRING_BATCH) {
+        Napi::HandleScope scope(env);
+        size_t end = std::min(strings.size(), start + STRING_BATCH);
+        for (size_t i = start; i < end; i++) {
+            array.Set(static_cast<uint32_t>(i), Napi::String::New(env, strings[i].data(), strings[i].size()));
+        }
+    }
+    return array;
+}
+
+// Maps a file and parses it on the thread pool, settling a promise. The
+// parse results keep string_views into the mapping, which lives until the
+// worker is destroyed after OnOK.
+class FileWorker : public Napi::AsyncWorker {
+public:
+    FileWorker(Napi::Env env, const char* name, std::string path)
+        : Napi::AsyncWorker(env, name),
+          m_deferred(Napi::Promise::Deferred::New(env)),
+          m_path(std::move(path)) {}
+
+    Napi::Promise Promise() const { return m_deferred.Promise(); }
+
+protected:
+    virtual void Parse(const char* data, size_t size) = 0;
+    virtual Napi::Value Result(Napi::Env env) = 0;
+
+    void Execute() override {
+        std::string error;
+        if (!m_file.open(m_path, error)) {
+            SetError(error);
+            return;
+        }
+        Parse(m_file.data(), m_file.size());
+    }
+
+    void OnOK() override {
+        m_deferred.Resolve(Result(Env()));
+    }
+
+    void OnError(const Napi::Error& error) override {
+        m_deferred.Reject(error.Value());
+    }
+
+private:
+    Napi::Promise::Deferred m_deferred;
+    std::string m_path;
+    MappedFile m_file;
+};
+
+class ParseM3UFileWorker : public FileWorker {
+public:
+    ParseM3UFileWorker(Napi::Env env, std::string path)
+        : FileWorker(env, "parseM3UFile", std::move(path)) {}
+
+protected:
+    void Parse(const char* data, size_t size) override {
+        parseM3U(data, size, m_playlist);
+    }
+
+    Napi::Value Result(Napi::Env env) override {
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("count", Napi::Number::New(env, static_cast<double>(m_playlist.size())));
+        result.Set("epgUrl", m_playlist.hasEpgUrl
+            ? Napi::String::New(env, m_playlist.epgUrl.data(), m_playlist.epgUrl.size())
+            : env.Null());
+        result.Set("strings", StringsToJS(env, m_playlist.strings.strings()));
+        result.Set("name", ColumnToJS<Napi::Uint32Array>(env, m_playlist.name));
+        result.Set("url", ColumnToJS<Napi::Uint32Array>(env, m_playlist.url));
+        result.Set("tvgId", ColumnToJS<Napi::Uint32Array>(env, m_playlist.tvgId));
+        result.Set("tvgName", ColumnToJS<Napi::Uint32Array>(env, m_playlist.tvgName));
+        result.Set("tvgLogo", ColumnToJS<Napi::Uint32Array>(env, m_playlist.tvgLogo));
+        result.Set("group", ColumnToJS<Napi::Uint32Array>(env, m_playlist.group));
+        result.Set("channelNumber", ColumnToJS<Napi::Int32Array>(env, m_playlist.channelNumber));
+        result.Set("duration", ColumnToJS<Napi::Int32Array>(env, m_playlist.duration));
+        return result;
+    }
+
+private:
+    M3UPlaylist m_playlist;
+};
+
+class ScanXmltvChannelsWorker : public FileWorker {
+public:
+    ScanXmltvChannelsWorker(Napi::Env env, std::string path, unsigned threads)
+        : FileWorker(env, "scanXmltvChannels", std::move(path)),
+          m_threads(threads) {}
+
+protected:
+    void Parse(const char* data, size_t size) override {
+        scanXmltvChannels(data, size, m_threads, m_channels);
+    }
+
+    // Few enough (thousands) for plain objects; matching needs them as such
+    Napi::Value Result(Napi::Env env) override {
+        const auto& channels = m_channels.channels;
+        Napi::Array result = Napi::Array::New(env, channels.size());
+        for (size_t i = 0; i < channels.size(); i++) {
+            Napi::HandleScope scope(env);
+            Napi::Object channel = Napi::Object::New(env);
+            channel.Set("id", Napi::String::New(env, channels[i].id.data(), channels[i].id.size()));
+            channel.Set("displayNames", StringsToJS(env, channels[i].displayNames));
+            result.Set(static_cast<uint32_t>(i), channel);
+        }
+        return result;
+    }
+
+private:
+    unsigned m_threads;
+    XmltvChannelList m_channels;
+};
+
+class ParseXmltvProgrammesWorker : public FileWorker {
+public:
+    ParseXmltvProgrammesWorker(Napi::Env env, std::string path, std::vector<std::string> channelIds, bool filtered,
+                               unsigned threads)
+        : FileWorker(env, "parseXmltvProgrammes", std::move(path)),
+          m_channelIds(std::move(channelIds)),
+          m_filtered(filtered),
+          m_threads(threads) {}
+
+protected:
+    void Parse(const char* data, size_t size) override {
+        std::unordered_set<std::string_view> filter(m_channelIds.begin(), m_channelIds.end());
+        parseXmltvProgrammes(data, size, m_filtered ? &filter : nullptr, m_threads, m_guide);
+    }
+
+    Napi::Value Result(Napi::Env env) override {
+        const auto& strings = m_guide.strings.strings();
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("count", Napi::Number::New(env, static_cast<double>(m_guide.size())));
+        result.Set("skipped", Napi::Number::New(env, static_cast<double>(m_guide.skipped)));
+        result.Set("strings", StringsToJS(env, strings));
+
+        Napi::Array channels = Napi::Array::New(env, m_guide.channels.size());
+        for (size_t i = 0; i < m_guide.channels.size(); i++) {
+            std::string_view id = strings[m_guide.channels[i]];
+            channels.Set(static_cast<uint32_t>(i), Napi::String::New(env, id.data(), id.size()));
+        }
+        result.Set("channels", channels);
+        result.Set("offsets", ColumnToJS<Napi::Uint32Array>(env, m_guide.offsets));
+        result.Set("title", ColumnToJS<Napi::Uint32Array>(env, m_guide.title));
+        result.Set("description", ColumnToJS<Napi::Uint32Array>(env, m_guide.description));
+        result.Set("start", ColumnToJS<Napi::Float64Array>(env, m_guide.start));
+        result.Set("stop", ColumnToJS<Napi::Float64Array>(env, m_guide.stop));
+        return result;
+    }
+
+private:
+    std::vector<std::string> m_channelIds;
+    bool m_filtered;
+    unsigned m_threads;
+    XmltvGuide m_guide;
+};
+
+bool PathArgument(const Napi::CallbackInfo& info, std::string& path) {
+    if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(info.Env(), "Path must be a string").ThrowAsJavaScriptException();
+        return false;
+    }
+    path = info[0].As<Napi::String>().Utf8Value();
+    return true;
+}
+
+// Optional thread count at `index` (the parser caps it); 0 when absent or
+// not a positive number leaves the choice to the parser
+unsigned ThreadsArgument(const Napi::CallbackInfo& info, size_t index) {
+    if (info.Length() <= index || !info[index].IsNumber()) {
+        return 0;
+    }
+    double threads = info[index].As<Napi::Number>().DoubleValue();
+    return threads >= 1 ? static_cast<unsigned>(std::min(threads, 256.0)) : 0;
+}
+
+Napi::Value Queue(FileWorker* worker) {
+    Napi::Promise promise = worker->Promise();
+    worker->Queue();  // Deletes itself after OnOK / OnError
+    return promise;
+}
+
+// parseM3UFile(path) -> Promise<M3UColumns>
+Napi::Value ParseM3UFile(const Napi::CallbackInfo& info) {
+    std::string path;
+    if (!PathArgument(info, path)) return info.Env().Undefined();
+    return Queue(new ParseM3UFileWorker(info.Env(), std::move(path)));
+}
+
+// scanXmltvChannels(path, threads?) -> Promise<{ id, displayNames }[]>
+Napi::Value ScanXmltvChannels(const Napi::CallbackInfo& info) {
+    std::string path;
+    if (!PathArgument(info, path)) return info.Env().Undefined();
+    return Queue(new ScanXmltvChannelsWorker(info.Env(), std::move(path), ThreadsArgument(info, 1)));
+}
+
+// parseXmltvProgrammes(path, channelIds | null, threads?) -> Promise<GuideColumns>
+Napi::Value ParseXmltvProgrammes(const Napi::CallbackInfo& info) {
+    Napi::Env env = info.Env();
+    std::string path;
+    if (!PathArgument(info, path)) return env.Undefined();
+
+    std::vector<std::string> channelIds;
+    bool filtered = info.Length() > 1 && info[1].IsArray();
+    if (filtered) {
+        Napi::Array ids = info[1].As<Napi::Array>();
+        channelIds.reserve(ids.Length());
+        for (uint32_t i = 0; i < ids.Length(); i++) {
+            Napi::Value id = ids.Get(i);
+            if (id.IsString()) {
+                channelIds.push_back(id.As<Napi::String>().Utf8Value());
+            }
+        }
+    }
+    return Queue(new ParseXmltvProgrammesWorker(env, std::move(path), std::move(channelIds), filtered,
+                                                ThreadsArgument(info, 2)));
+}
+
+} // namespace
+
+Napi::Object Init(Napi::Env env, Napi::Object exports) {
+    exports.Set("parseM3UFile", Napi::Function::New(env, ParseM3UFile));
+    exports.Set("scanXmltvChannels", Napi::Function::New(env, ScanXmltvChannels));
+    exports.Set("parseXmltvProgrammes", Napi::Function::New(env, ParseXmltvProgrammes));
+    return exports;
+}
+
+NODE_API_MODULE(playlist_parser, Init)
@@ -0,0 +1,92 @@
+/*
+ * Interned string table for the playlist / guide parsers
+ *
+ * Values are string_views into memory the caller keeps alive (the mapped
+ * file or a TextArena); each distinct value is stored once and referred to
+ * by index. Index 0 is always the empty string.
+ */
+
+#ifndef STRING_TABLE_H_
+#define STRING_TABLE_H_
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace mpv_texture {
+
+class TextArena;
+
+class StringTable {
+public:
+    StringTable() { m_strings.emplace_back(); }
+
+    uint32_t intern(std::string_view value) {
+        if (value.empty()) {
+            return 0;
+        }
+        auto it = m_index.find(value);
+        if (it != m_index.end()) {
+            return it->second;
+        }
+        uint32_t index = static_cast<uint32_t>(m_strings.size());
+        m_strings.push_back(value);
+        m_index.emplace(value, index);
+        return index;
+    }
+
+    // As intern(), copying a new value into `arena` first (for values in
+    // temporary buffers)
+    uint32_t intern(std::string_view value, TextArena& arena);
+
+    void reserve(size_t count) {
+        m_strings.reserve(count);
+        m_index.reserve(count);
+    }
+
+    const std::vector<std::string_view>& strings() const { return m_strings; }
+
+private:
+    std::vector<std::string_view> m_strings;
+    std::unordered_map<std::string_view, uint32_t> m_index;
+};
+
+// Backing store for strings that had to be rewritten (entity decoding).
+// Allocates in large blocks that never move, so views stay valid for the
+// arena's lifetime.
+class TextArena {
+public:
+    std::string_view store(std::string_view value) {
+        if (value.empty()) {
+            return {};
+        }
+        if (m_blocks.empty() || m_blocks.back().capacity() - m_blocks.back().size() < value.size()) {
+            m_blocks.emplace_back();
+            m_blocks.back().reserve(value.size() > BLOCK_SIZE ? value.size() : BLOCK_SIZE);
+        }
+        std::vector<char>& block = m_blocks.back();
+        size_t offset = block.size();
+        block.insert(block.end(), value.begin(), value.end());
+        return std::string_view(block.data() + offset, value.size());
+    }
+
+private:
+    static const size_t BLOCK_SIZE = 1 << 20;
+    std::vector<std::vector<char>> m_blocks;
+};
+
+inline uint32_t StringTable::intern(std::string_view value, TextArena& arena) {
+    if (value.empty()) {
+        return 0;
+    }
+    auto it = m_index.find(value);
+    if (it != m_index.end()) {
+        return it->second;
+    }
+    return intern(arena.store(value));
+}
+
+} // namespace mpv_texture
+
+#endif // STRING_TABLE_H_
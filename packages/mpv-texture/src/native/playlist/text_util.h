@@ -0,0 +1,79 @@
+/*
+ * Text helpers shared by the playlist and guide parsers
+ */
+
+#ifndef TEXT_UTIL_H_
+#define TEXT_UTIL_H_
+
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+namespace mpv_texture {
+
+// The whitespace String.prototype.trim() removes that provider data
+// contains: ASCII whitespace, a UTF-8 BOM and no-break spaces
+inline size_t leadingSpace(std::string_view s) {
+    size_t i = 0;
+    while (i < s.size()) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c == ' ' || (c >= '\t' && c <= '\r')) {
+            i++;
+        } else if (c == 0xEF && s.size() - i >= 3 &&
+                   static_cast<unsigned char>(s[i + 1]) == 0xBB && static_cast<unsigned char>(s[i + 2]) == 0xBF) {
+            i += 3;
+        } else if (c == 0xC2 && s.size() - i >= 2 && static_cast<unsigned char>(s[i + 1]) == 0xA0) {
+            i += 2;
+        } else {
+            break;
+        }
+    }
+    return i;
+}
+
+inline size_t trailingSpace(std::string_view s) {
+    size_t n = s.size();
+    while (n > 0) {
+        unsigned char c = static_cast<unsigned char>(s[n - 1]);
+        if (c == ' ' || (c >= '\t' && c <= '\r')) {
+            n--;
+        } else if (c == 0xBF && n >= 3 &&
+                   static_cast<unsigned char>(s[n - 2]) == 0xBB && static_cast<unsigned char>(s[n - 3]) == 0xEF) {
+            n -= 3;
+        } else if (c == 0xA0 && n >= 2 && static_cast<unsigned char>(s[n - 2]) == 0xC2) {
+            n -= 2;
+        } else {
+            break;
+        }
+    }
+    return s.size() - n;
+}
+
+inline std::string_view trim(std::string_view s) {
+    s.remove_prefix(leadingSpace(s));
+    s.remove_suffix(trailingSpace(s));
+    return s;
+}
+
+inline bool startsWith(std::string_view s, std::string_view prefix) {
+    return s.size() >= prefix.size() && memcmp(s.data(), prefix.data(), prefix.size()) == 0;
+}
+
+// First occurrence of `needle` in [p, end), memchr on its first byte
+inline const char* findText(const char* p, const char* end, std::string_view needle) {
+    while (p < end && static_cast<size_t>(end - p) >= needle.size()) {
+        p = static_cast<const char*>(memchr(p, needle[0], (end - p) - needle.size() + 1));
+        if (!p) {
+            return nullptr;
+        }
+        if (memcmp(p, needle.data(), needle.size()) == 0) {
+            return p;
+        }
+        p++;
+    }
+    return nullptr;
+}
+
+} // namespace mpv_texture
+
+#endif // TEXT_UTIL_H_
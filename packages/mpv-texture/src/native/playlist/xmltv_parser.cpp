@@ -0,0 +1,481 @@
+/*
+ * Multi-threaded XMLTV guide parser implementation
+ */
+
+#include "xmltv_parser.h"
+#include "text_util.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+namespace mpv_texture {
+
+namespace {
+
+const unsigned MAX_THREADS = 8;
+// Below this a range isn't worth a thread
+const size_t MIN_BYTES_PER_THREAD = 4 * 1024 * 1024;
+
+const double INVALID_TIME = std::numeric_limits<double>::quiet_NaN();
+
+// An explicit request is only capped (so tests can split small documents);
+// the hardware default is also limited by size
+unsigned threadCount(unsigned requested, size_t size) {
+    if (requested) {
+        return std::min(requested, MAX_THREADS);
+    }
+    unsigned threads = std::max(1u, std::min(std::thread::hardware_concurrency(), MAX_THREADS));
+    size_t bySize = std::max<size_t>(1, size / MIN_BYTES_PER_THREAD);
+    return static_cast<unsigned>(std::min<size_t>(threads, bySize));
+}
+
+const char* findElementStart(const char* p, const char* end) {
+    while ((p = static_cast<const char*>(memchr(p, '<', end - p))) != nullptr) {
+        std::string_view rest(p, end - p);
+        if (startsWith(rest, "<programme ") || startsWith(rest, "<channel ")) {
+            return p;
+        }
+        p++;
+    }
+    return end;
+}
+
+// Range boundaries, each (but the first) at the start of an element
+std::vector<const char*> splitAtElements(const char* data, size_t size, unsigned parts) {
+    const char* end = data + size;
+    std::vector<const char*> bounds{ data };
+    for (unsigned i = 1; i < parts; i++) {
+        const char* nominal = data + size / parts * i;
+        bounds.push_back(findElementStart(std::max(nominal, bounds.back()), end));
+    }
+    bounds.push_back(end);
+    return bounds;
+}
+
+// Run fn(index, begin, end) for every range, one thread per range
+template <typename Fn>
+void forEachRange(const std::vector<const char*>& bounds, Fn fn) {
+    size_t ranges = bounds.size() - 1;
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < ranges; i++) {
+        threads.emplace_back([&, i] { fn(i, bounds[i], bounds[i + 1]); });
+    }
+    fn(0, bounds[0], bounds[1]);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// extractAttr(): name="value" or name='value' in an opening tag
+std::string_view attribute(std::string_view tag, std::string_view name) {
+    for (char quote : { '"', '\'' }) {
+        std::string key(name);
+        key += '=';
+        key += quote;
+        const char* begin = tag.data();
+        const char* end = begin + tag.size();
+        const char* found = findText(begin, end, key);
+        if (!found) {
+            continue;
+        }
+        const char* value = found + key.size();
+        const char* close = static_cast<const char*>(memchr(value, quote, end - value));
+        if (!close) {
+            continue;
+        }
+        return std::string_view(value, close - value);
+    }
+    return {};
+}
+
+// extractChild(): the text between <name ...> and </name>
+std::string_view childText(std::string_view block, std::string_view name) {
+    const char* begin = block.data();
+    const char* end = begin + block.size();
+    std::string open = "<" + std::string(name);
+    const char* p = findText(begin, end, open);
+    if (!p) return {};
+    const char* tagEnd = static_cast<const char*>(memchr(p, '>', end - p));
+    if (!tagEnd) return {};
+    std::string close = "</" + std::string(name) + ">";
+    const char* closing = findText(tagEnd + 1, end, close);
+    if (!closing) return {};
+    return std::string_view(tagEnd + 1, closing - (tagEnd + 1));
+}
+
+void appendUtf8(std::string& out, uint32_t codePoint) {
+    if (codePoint < 0x80) {
+        out += static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        out += static_cast<char>(0xC0 | (codePoint >> 6));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        out += static_cast<char>(0xE0 | (codePoint >> 12));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (codePoint >> 18));
+        out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+}
+
+void replaceAll(std::string& s, std::string_view from, char to) {
+    size_t pos = s.find(from.data(), 0, from.size());
+    if (pos == std::string::npos) {
+        return;
+    }
+    std::string out;
+    out.reserve(s.size());
+    size_t last = 0;
+    while (pos != std::string::npos) {
+        out.append(s, last, pos - last);
+        out += to;
+        last = pos + from.size();
+        pos = s.find(from.data(), last, from.size());
+    }
+    out.append(s, last, std::string::npos);
+    s.swap(out);
+}
+
+// One &#ddd; or &#xhh; at `pos`: its UTF-16 code unit (String.fromCharCode
+// keeps the low 16 bits) and length, or false
+bool numericEntity(const std::string& s, size_t pos, bool hex, uint32_t& unit, size_t& length) {
+    size_t i = pos + 2;
+    if (hex) {
+        if (i >= s.size() || s[i] != 'x') return false;
+        i++;
+    }
+    size_t digitsStart = i;
+    uint32_t value = 0;
+    while (i < s.size()) {
+        char c = s[i];
+        uint32_t digit;
+        if (c >= '0' && c <= '9') digit = c - '0';
+        else if (hex && c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+        else if (hex && c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+        else break;
+        value = (value * (hex ? 16 : 10) + digit) & 0xFFFF;
+        i++;
+    }
+    if (i == digitsStart || i >= s.size() || s[i] != ';') {
+        return false;
+    }
+    unit = value;
+    length = i + 1 - pos;
+    return true;
+}
+
+void replaceNumeric(std::string& s, bool hex) {
+    size_t pos = s.find("&#");
+    if (pos == std::string::npos) {
+        return;
+    }
+    std::string out;
+    out.reserve(s.size());
+    size_t last = 0;
+    while (pos != std::string::npos) {
+        uint32_t unit;
+        size_t length;
+        if (!numericEntity(s, pos, hex, unit, length)) {
+            pos = s.find("&#", pos + 1);
+            continue;
+        }
+        out.append(s, last, pos - last);
+        last = pos + length;
+
+        uint32_t codePoint = unit;
+        if (unit >= 0xD800 && unit <= 0xDBFF) {
+            // A pair written as two entities becomes one character in JS
+            uint32_t low;
+            size_t lowLength;
+            if (last < s.size() && s.compare(last, 2, "&#") == 0 &&
+                numericEntity(s, last, hex, low, lowLength) && low >= 0xDC00 && low <= 0xDFFF) {
+                codePoint = 0x10000 + ((unit - 0xD800) << 10) + (low - 0xDC00);
+                last += lowLength;
+            } else {
+                codePoint = 0xFFFD;
+            }
+        } else if (unit >= 0xDC00 && unit <= 0xDFFF) {
+            codePoint = 0xFFFD;
+        }
+        appendUtf8(out, codePoint);
+        pos = s.find("&#", last);
+    }
+    out.append(s, last, std::string::npos);
+    s.swap(out);
+}
+
+// decodeEntities(): the same replacements in the same order (so "&amp;lt;"
+// decodes twice, as it does in JS). Returns `value` itself when there is
+// nothing to decode, otherwise a view of `scratch`.
+std::string_view decodeEntities(std::string_view value, std::string& scratch) {
+    if (value.empty() || !memchr(value.data(), '&', value.size())) {
+        return value;
+    }
+    scratch.assign(value.data(), value.size());
+    replaceAll(scratch, "&amp;", '&');
+    replaceAll(scratch, "&lt;", '<');
+    replaceAll(scratch, "&gt;", '>');
+    replaceAll(scratch, "&quot;", '"');
+    replaceAll(scratch, "&apos;", '\'');
+    replaceNumeric(scratch, false);
+    replaceNumeric(scratch, true);
+    return scratch;
+}
+
+// A decoded value outlives the next decode only once copied out of `scratch`
+bool inScratch(std::string_view decoded, const std::string& scratch) {
+    return decoded.data() >= scratch.data() && decoded.data() < scratch.data() + scratch.size();
+}
+
+std::string_view keep(std::string_view decoded, const std::string& scratch, TextArena& arena) {
+    return inScratch(decoded, scratch) ? arena.store(decoded) : decoded;
+}
+
+uint32_t internDecoded(StringTable& strings, std::string_view decoded, const std::string& scratch,
+                       TextArena& arena) {
+    return inScratch(decoded, scratch) ? strings.intern(decoded, arena) : strings.intern(decoded);
+}
+
+bool digits(std::string_view s, size_t pos, size_t count, int& value) {
+    value = 0;
+    for (size_t i = pos; i < pos + count; i++) {
+        if (s[i] < '0' || s[i] > '9') return false;
+        value = value * 10 + (s[i] - '0');
+    }
+    return true;
+}
+
+int64_t daysFromCivil(int64_t year, int month, int day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int64_t yearOfEra = year - era * 400;
+    int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+// parseDate() + new Date(): "YYYYMMDDhhmmss[ ][+-]hhmm" to epoch ms. False
+// when the format doesn't match (the programme is dropped); NaN for fields
+// out of range (an Invalid Date in JS).
+bool parseTime(std::string_view s, double& out) {
+    int year, month, day, hour, minute, second;
+    if (s.size() < 14 || !digits(s, 0, 4, year) || !digits(s, 4, 2, month) || !digits(s, 6, 2, day) ||
+        !digits(s, 8, 2, hour) || !digits(s, 10, 2, minute) || !digits(s, 12, 2, second)) {
+        return false;
+    }
+    size_t i = 14;
+    while (i < s.size() && (s[i] == ' ' || (s[i] >= '\t' && s[i] <= '\r'))) {
+        i++;
+    }
+    int offsetMinutes = 0;
+    bool offsetValid = true;
+    if (i < s.size()) {
+        int tzHour, tzMinute;
+        if (s.size() - i != 5 || (s[i] != '+' && s[i] != '-') ||
+            !digits(s, i + 1, 2, tzHour) || !digits(s, i + 3, 2, tzMinute)) {
+            return false;
+        }
+        offsetValid = tzHour <= 23 && tzMinute <= 59;
+        offsetMinutes = (s[i] == '-' ? -1 : 1) * (tzHour * 60 + tzMinute);
+    }
+
+    if (!offsetValid || month < 1 || month > 12 || day < 1 || day > 31 || minute > 59 || second > 59 ||
+        hour > 24 || (hour == 24 && (minute || second))) {
+        out = INVALID_TIME;
+        return true;
+    }
+    int64_t days = daysFromCivil(year, month, 1) + day - 1;
+    int64_t seconds = days * 86400 + hour * 3600 + minute * 60 + second - offsetMinutes * 60;
+    out = static_cast<double>(seconds) * 1000.0;
+    return true;
+}
+
+void scanChannelRange(const char* begin, const char* rangeEnd, const char* end,
+                      std::vector<XmltvChannel>& out, TextArena& arena) {
+    std::string scratch;
+    const char* p = begin;
+    while (p < rangeEnd) {
+        const char* start = findText(p, rangeEnd, "<channel ");
+        if (!start) break;
+        const char* close = findText(start, end, "</channel>");
+        if (!close) break;
+        p = close + 10;
+
+        const char* tagEnd = static_cast<const char*>(memchr(start, '>', p - start));
+        std::string_view id = attribute(std::string_view(start, tagEnd + 1 - start), "id");
+        if (id.empty()) continue;
+
+        XmltvChannel channel;
+        channel.id = keep(decodeEntities(id, scratch), scratch, arena);
+        const char* pos = tagEnd + 1;
+        while (true) {
+            const char* nameStart = findText(pos, p, "<display-name");
+            if (!nameStart) break;
+            const char* nameTagEnd = static_cast<const char*>(memchr(nameStart, '>', p - nameStart));
+            if (!nameTagEnd) break;
+            const char* nameClose = findText(nameTagEnd + 1, p, "</display-name>");
+            if (!nameClose) break;
+            std::string_view text(nameTagEnd + 1, nameClose - (nameTagEnd + 1));
+            std::string_view name = trim(decodeEntities(text, scratch));
+            if (!name.empty()) {
+                channel.displayNames.push_back(keep(name, scratch, arena));
+            }
+            pos = nameClose + 15;
+        }
+        out.push_back(std::move(channel));
+    }
+}
+
+struct Programme {
+    uint32_t channel;
+    uint32_t title;
+    uint32_t description;
+    double start;
+    double stop;
+};
+
+struct ProgrammeRange {
+    StringTable strings;
+    std::unique_ptr<TextArena> arena = std::make_unique<TextArena>();
+    std::vector<Programme> programmes;
+    uint64_t skipped = 0;
+};
+
+void parseProgrammeRange(const char* begin, const char* rangeEnd, const char* end,
+                         const std::unordered_set<std::string_view>* filter, ProgrammeRange& out) {
+    std::string scratch;
+    std::string channelScratch;
+    const char* p = begin;
+    while (p < rangeEnd) {
+        const char* start = findText(p, rangeEnd, "<programme ");
+        if (!start) break;
+        const char* close = findText(start, end, "</programme>");
+        if (!close) break;
+        p = close + 12;
+        std::string_view block(start, p - start);
+
+        const char* tagEnd = static_cast<const char*>(memchr(start, '>', p - start));
+        std::string_view tag(start, tagEnd + 1 - start);
+
+        std::string_view channelId = attribute(tag, "channel");
+        if (channelId.empty()) continue;
+        std::string_view decodedChannel = decodeEntities(channelId, channelScratch);
+        if (filter && !filter->count(decodedChannel)) {
+            out.skipped++;
+            continue;
+        }
+        std::string_view startText = attribute(tag, "start");
+        std::string_view stopText = attribute(tag, "stop");
+        if (startText.empty() || stopText.empty()) continue;
+        double startMs, stopMs;
+        if (!parseTime(startText, startMs) || !parseTime(stopText, stopMs)) continue;
+
+        std::string_view title = decodeEntities(childText(block, "title"), scratch);
+        if (title.empty()) continue;
+        Programme programme;
+        programme.channel = internDecoded(out.strings, decodedChannel, channelScratch, *out.arena);
+        programme.title = internDecoded(out.strings, title, scratch, *out.arena);
+        std::string_view description = decodeEntities(childText(block, "desc"), scratch);
+        programme.description = internDecoded(out.strings, description, scratch, *out.arena);
+        programme.start = startMs;
+        programme.stop = stopMs;
+        out.programmes.push_back(programme);
+    }
+}
+
+} // namespace
+
+void scanXmltvChannels(const char* data, size_t size, unsigned threads, XmltvChannelList& out) {
+    auto bounds = splitAtElements(data, size, threadCount(threads, size));
+    size_t ranges = bounds.size() - 1;
+    std::vector<std::vector<XmltvChannel>> found(ranges);
+    std::vector<std::unique_ptr<TextArena>> arenas;
+    for (size_t i = 0; i < ranges; i++) {
+        arenas.push_back(std::make_unique<TextArena>());
+    }
+
+    forEachRange(bounds, [&](size_t index, const char* begin, const char* end) {
+        scanChannelRange(begin, end, data + size, found[index], *arenas[index]);
+    });
+
+    for (size_t i = 0; i < ranges; i++) {
+        for (auto& channel : found[i]) {
+            out.channels.push_back(std::move(channel));
+        }
+        out.arenas.push_back(std::move(arenas[i]));
+    }
+}
+
+void parseXmltvProgrammes(const char* data, size_t size, const std::unordered_set<std::string_view>* filter,
+                          unsigned threads, XmltvGuide& out) {
+    auto bounds = splitAtElements(data, size, threadCount(threads, size));
+    std::vector<ProgrammeRange> ranges(bounds.size() - 1);
+
+    forEachRange(bounds, [&](size_t index, const char* begin, const char* end) {
+        parseProgrammeRange(begin, end, data + size, filter, ranges[index]);
+    });
+
+    // Merge the per-range tables; channel order is first appearance
+    size_t total = 0;
+    for (const auto& range : ranges) {
+        total += range.programmes.size();
+    }
+    std::vector<Programme> programmes;
+    programmes.reserve(total);
+    std::unordered_map<uint32_t, uint32_t> channelRank;
+
+    for (auto& range : ranges) {
+        const auto& local = range.strings.strings();
+        std::vector<uint32_t> remap(local.size());
+        for (size_t i = 0; i < local.size(); i++) {
+            remap[i] = out.strings.intern(local[i]);
+        }
+        for (Programme programme : range.programmes) {
+            programme.channel = remap[programme.channel];
+            programme.title = remap[programme.title];
+            programme.description = remap[programme.description];
+            if (channelRank.emplace(programme.channel, static_cast<uint32_t>(out.channels.size())).second) {
+                out.channels.push_back(programme.channel);
+            }
+            programmes.push_back(programme);
+        }
+        out.skipped += range.skipped;
+        out.arenas.push_back(std::move(range.arena));
+    }
+
+    // Per channel, by start time (invalid times last, file order on ties)
+    for (auto& programme : programmes) {
+        programme.channel = channelRank[programme.channel];
+    }
+    auto startKey = [](double start) {
+        return std::isnan(start) ? std::numeric_limits<double>::infinity() : start;
+    };
+    std::stable_sort(programmes.begin(), programmes.end(), [&](const Programme& a, const Programme& b) {
+        if (a.channel != b.channel) return a.channel < b.channel;
+        return startKey(a.start) < startKey(b.start);
+    });
+
+    out.offsets.assign(out.channels.size() + 1, 0);
+    out.title.reserve(programmes.size());
+    out.description.reserve(programmes.size());
+    out.start.reserve(programmes.size());
+    out.stop.reserve(programmes.size());
+    for (const auto& programme : programmes) {
+        out.offsets[programme.channel + 1]++;
+        out.title.push_back(programme.title);
+        out.description.push_back(programme.description);
+        out.start.push_back(programme.start);
+        out.stop.push_back(programme.stop);
+    }
+    for (size_t i = 1; i < out.offsets.size(); i++) {
+        out.offsets[i] += out.offsets[i - 1];
+    }
+}
+
+} // namespace mpv_texture
@@ -0,0 +1,72 @@
+/*
+ * Multi-threaded XMLTV guide parser
+ *
+ * The (memory-mapped, already decompressed) document is cut into ranges at
+ * element starts and each range is scanned on its own thread. Threads share
+ * nothing while parsing: each has its own string table and arena for
+ * entity-decoded text, and the tables are merged once at the end, so every
+ * distinct title/description/channel id is stored once. Programmes come
+ * out grouped per channel and sorted by start time.
+ *
+ * Element and field extraction matches streamParseXmltv() in
+ * electron/src/epg-parse-worker.ts, including its entity decoding; times
+ * are epoch milliseconds instead of ISO strings.
+ */
+
+#ifndef XMLTV_PARSER_H_
+#define XMLTV_PARSER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "string_table.h"
+
+namespace mpv_texture {
+
+struct XmltvChannel {
+    std::string_view id;
+    std::vector<std::string_view> displayNames;  // Trimmed, empty ones dropped
+};
+
+struct XmltvChannelList {
+    std::vector<XmltvChannel> channels;  // Document order
+    std::vector<std::unique_ptr<TextArena>> arenas;
+};
+
+struct XmltvGuide {
+    StringTable strings;
+
+    // Distinct programme channel ids (string indices) in first-seen order;
+    // programmes of channels[i] are [offsets[i], offsets[i + 1])
+    std::vector<uint32_t> channels;
+    std::vector<uint32_t> offsets;
+
+    // One entry per programme
+    std::vector<uint32_t> title;
+    std::vector<uint32_t> description;
+    std::vector<double> start;  // Epoch ms
+    std::vector<double> stop;
+
+    uint64_t skipped = 0;  // Programmes of channels outside the filter
+
+    std::vector<std::unique_ptr<TextArena>> arenas;
+
+    size_t size() const { return title.size(); }
+};
+
+// Every <channel> element. `threads` 0 picks from the hardware and the
+// document size; otherwise that many ranges are used (at most 8).
+void scanXmltvChannels(const char* data, size_t size, unsigned threads, XmltvChannelList& out);
+
+// Every <programme> with a channel, valid start/stop and non-empty title;
+// with `filter`, only those whose channel id is in it
+void parseXmltvProgrammes(const char* data, size_t size, const std::unordered_set<std::string_view>* filter,
+                          unsigned threads, XmltvGuide& out);
+
+} // namespace mpv_texture
+
+#endif // XMLTV_PARSER_H_
@@ -0,0 +1,160 @@
+/*
+ * Lock-free per-player render pipeline counters
+ *
+ * Written by the render thread and the JS thread, read by getStats(). Every
+ * field is an independent relaxed atomic: a snapshot is not a consistent cut
+ * across counters, which is fine for diagnostics and keeps the hot path free
+ * of locks.
+ */
+
+#ifndef RENDER_STATS_H_
+#define RENDER_STATS_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace mpv_texture {
+
+// Monotonic timestamp in microseconds
+inline uint64_t nowUs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+struct HistogramSnapshot {
+    uint64_t count;
+    double meanUs;
+    uint64_t maxUs;
+    // Percentiles are bucket upper bounds (power-of-two resolution)
+    uint64_t p50Us;
+    uint64_t p95Us;
+    uint64_t p99Us;
+};
+
+// Latency histogram with power-of-two microsecond buckets:
+// bucket i holds samples in [2^i, 2^(i+1)) us, the last one everything above
+class LatencyHistogram {
+public:
+    static const int BUCKET_COUNT = 21;  // Up to ~1s, then overflow
+
+    void record(uint64_t us) {
+        int bucket = 0;
+        while (bucket < BUCKET_COUNT - 1 && (us >> (bucket + 1)) != 0) {
+            bucket++;
+        }
+        m_buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        m_sum.fetch_add(us, std::memory_order_relaxed);
+
+        uint64_t max = m_max.load(std::memory_order_relaxed);
+        while (us > max && !m_max.compare_exchange_weak(max, us, std::memory_order_relaxed)) {
+        }
+    }
+
+    HistogramSnapshot snapshot() const {
+        HistogramSnapshot snap{};
+        uint64_t buckets[BUCKET_COUNT];
+        uint64_t total = 0;
+        for (int i = 0; i < BUCKET_COUNT; i++) {
+            buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+            total += buckets[i];
+        }
+
+        snap.count = total;
+        snap.maxUs = m_max.load(std::memory_order_relaxed);
+        if (total == 0) {
+            return snap;
+        }
+        snap.meanUs = static_cast<double>(m_sum.load(std::memory_order_relaxed)) / total;
+        snap.p50Us = percentile(buckets, total, 0.50, snap.maxUs);
+        snap.p95Us = percentile(buckets, total, 0.95, snap.maxUs);
+        snap.p99Us = percentile(buckets, total, 0.99, snap.maxUs);
+        return snap;
+    }
+
+    void reset() {
+        for (auto& bucket : m_buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        m_sum.store(0, std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    static uint64_t percentile(const uint64_t (&buckets)[BUCKET_COUNT], uint64_t total,
+                               double p, uint64_t max) {
+        uint64_t target = static_cast<uint64_t>(p * total);
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKET_COUNT; i++) {
+            seen += buckets[i];
+            if (seen > target) {
+                uint64_t upper = (2ull << i) - 1;
+                return upper < max ? upper : max;
+            }
+        }
+        return max;
+    }
+
+    std::atomic<uint64_t> m_buckets[BUCKET_COUNT] = {};
+    std::atomic<uint64_t> m_sum{0};
+    std::atomic<uint64_t> m_max{0};
+};
+
+struct RenderStats {
+    // Frames rendered and exported by mpv
+    std::atomic<uint64_t> framesRendered{0};
+    // Frames taken by the JS consumer
+    std::atomic<uint64_t> framesDelivered{0};
+    // Frames replaced in flight before their fence signaled
+    std::atomic<uint64_t> framesSuperseded{0};
+    // Frames retired without rendering (RenderMode other than ACTIVE)
+    std::atomic<uint64_t> framesSkipped{0};
+    // lockTexture() found no free slot (consumer holding all of them)
+    std::atomic<uint64_t> lockFailures{0};
+    std::atomic<uint64_t> renderFailures{0};
+    std::atomic<uint64_t> resizes{0};
+    // Most recent load() -> first published frame
+    std::atomic<uint64_t> lastFirstFrameUs{0};
+    // displaySync: frames rendered for a target vsync, and those published
+    // after it had passed
+    std::atomic<uint64_t> framesPaced{0};
+    std::atomic<uint64_t> framesLate{0};
+    // Measured display refresh period (0 = not locked)
+    std::atomic<uint64_t> displayPeriodUs{0};
+
+    // mpv update callback -> start of mpv_render_context_render
+    LatencyHistogram updateToRender;
+    // mpv_render_context_render call (CPU submission)
+    LatencyHistogram renderCall;
+    // Export fence inserted -> fence signaled (GPU completes the render)
+    LatencyHistogram gpuComplete;
+    // Frame published to the mailbox -> taken by JS
+    LatencyHistogram delivery;
+    // load() -> MPV_EVENT_FILE_LOADED
+    LatencyHistogram loadToFileLoaded;
+    // load() -> first frame of the new file published
+    LatencyHistogram timeToFirstFrame;
+
+    void reset() {
+        framesRendered.store(0, std::memory_order_relaxed);
+        framesDelivered.store(0, std::memory_order_relaxed);
+        framesSuperseded.store(0, std::memory_order_relaxed);
+        framesSkipped.store(0, std::memory_order_relaxed);
+        lockFailures.store(0, std::memory_order_relaxed);
+        renderFailures.store(0, std::memory_order_relaxed);
+        resizes.store(0, std::memory_order_relaxed);
+        lastFirstFrameUs.store(0, std::memory_order_relaxed);
+        framesPaced.store(0, std::memory_order_relaxed);
+        framesLate.store(0, std::memory_order_relaxed);
+        updateToRender.reset();
+        renderCall.reset();
+        gpuComplete.reset();
+        delivery.reset();
+        loadToFileLoaded.reset();
+        timeToFirstFrame.reset();
+    }
+};
+
+} // namespace mpv_texture
+
+#endif // RENDER_STATS_H_
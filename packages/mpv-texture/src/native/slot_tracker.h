@@ -0,0 +1,182 @@
+/*
+ * Ownership tracking for shared texture slots
+ *
+ * A slot is Free, being rendered into by mpv (Rendering), or handed to the
+ * consumer (Exported). Exported slots only become Free again when the
+ * consumer releases them (releaseFrame from JS), so the render thread never
+ * rewrites a surface Chromium may still be reading.
+ *
+ * Every export gets a generation, quoted back on release: platform handles
+ * repeat (a slot is exported again, a closed fd number is reused), and a
+ * late release of an earlier export must not free the current one. Sets
+ * parked by a resize keep their exported slots here until released, and
+ * get them back when the set is bound again.
+ *
+ * Used by the platform ITextureShare backends. Release arrives from the JS
+ * thread while acquire runs on the render thread, hence the mutex.
+ */
+
+#ifndef SLOT_TRACKER_H_
+#define SLOT_TRACKER_H_
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace mpv_texture {
+
+template <int N>
+class SlotTracker {
+public:
+    // An exported slot the consumer never released (renderer crash, lost
+    // callback) is reclaimed after this long so playback cannot wedge.
+    static constexpr std::chrono::milliseconds kReclaimAfter{1000};
+
+    // Render thread: pick the next free slot after `previous` (round-robin).
+    // Returns -1 if every slot is still owned by the consumer.
+    int acquire(int previous) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int i = 1; i <= N; i++) {
+            int index = (previous + i) % N;
+            if (m_state[index] == State::Free) {
+                m_state[index] = State::Rendering;
+                return index;
+            }
+        }
+
+        // Last resort: reclaim the oldest stale export
+        int oldest = -1;
+        auto now = std::chrono::steady_clock::now();
+        for (int i = 0; i < N; i++) {
+            if (m_state[i] == State::Exported && now - m_exportedAt[i] > kReclaimAfter &&
+                (oldest < 0 || m_exportedAt[i] < m_exportedAt[oldest])) {
+                oldest = i;
+            }
+        }
+        if (oldest >= 0) {
+            if (m_reclaimCount++ < 5) {
+                std::cerr << "[SlotTracker] Reclaiming slot " << oldest
+                          << " never released by consumer" << std::endl;
+            }
+            m_state[oldest] = State::Rendering;
+        }
+        return oldest;
+    }
+
+    // Render thread: rendering into `index` was abandoned
+    void abandon(int index) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_state[index] == State::Rendering) {
+            m_state[index] = State::Free;
+        }
+    }
+
+    // Render thread: `index` now belongs to the consumer. Returns the
+    // export's generation (TextureInfo::generation).
+    uint64_t markExported(int index) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_state[index] = State::Exported;
+        m_exportedAt[index] = std::chrono::steady_clock::now();
+        m_generation[index] = ++m_nextGeneration;
+        return m_generation[index];
+    }
+
+    // Any thread: consumer is done with the export `generation` of `handle`
+    // (0 = whichever export the handle has). Returns the slot index, or -1
+    // if no current export matches (stale release). A match in a parked set
+    // is dropped, so the slot is free once its set is bound again.
+    int release(uint64_t handle, uint64_t generation) {
+        if (handle == 0) return -1;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int i = 0; i < N; i++) {
+            if (m_handle[i] == handle) {
+                if (m_state[i] != State::Exported || (generation != 0 && m_generation[i] != generation)) {
+                    return -1;
+                }
+                m_state[i] = State::Free;
+                return i;
+            }
+        }
+        for (auto it = m_parked.begin(); it != m_parked.end(); ++it) {
+            if (it->handle == handle && (generation == 0 || it->generation == generation)) {
+                m_parked.erase(it);
+                break;
+            }
+        }
+        return -1;
+    }
+
+    // Render thread: the bound set is being parked (resize). Its exported
+    // slots stay owned by the consumer; nothing is bound afterwards.
+    void park() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int i = 0; i < N; i++) {
+            if (m_state[i] == State::Exported) {
+                m_parked.push_back(Parked{m_handle[i], m_generation[i], m_exportedAt[i]});
+            }
+            m_handle[i] = 0;
+            m_state[i] = State::Free;
+        }
+    }
+
+    // Render thread: a parked set is destroyed; its handles are void
+    void forget(uint64_t handle) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto it = m_parked.begin(); it != m_parked.end();) {
+            it = it->handle == handle ? m_parked.erase(it) : it + 1;
+        }
+    }
+
+    // Render thread: bind slot handles after (re)allocation. Slots are Free,
+    // except those of a parked set the consumer still holds.
+    void reset(const uint64_t (&handles)[N]) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int i = 0; i < N; i++) {
+            m_handle[i] = handles[i];
+            m_state[i] = State::Free;
+            for (auto it = m_parked.begin(); it != m_parked.end(); ++it) {
+                if (it->handle == handles[i] && handles[i] != 0) {
+                    m_state[i] = State::Exported;
+                    m_generation[i] = it->generation;
+                    m_exportedAt[i] = it->exportedAt;
+                    m_parked.erase(it);
+                    break;
+                }
+            }
+        }
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (int i = 0; i < N; i++) {
+            m_handle[i] = 0;
+            m_state[i] = State::Free;
+        }
+        m_parked.clear();
+    }
+
+private:
+    enum class State { Free, Rendering, Exported };
+
+    // An export of a parked set the consumer has not released yet
+    struct Parked {
+        uint64_t handle;
+        uint64_t generation;
+        std::chrono::steady_clock::time_point exportedAt;
+    };
+
+    std::mutex m_mutex;
+    State m_state[N] = {};
+    uint64_t m_handle[N] = {};
+    uint64_t m_generation[N] = {};
+    std::chrono::steady_clock::time_point m_exportedAt[N] = {};
+    std::vector<Parked> m_parked;
+    uint64_t m_nextGeneration = 0;
+    int m_reclaimCount = 0;
+};
+
+} // namespace mpv_texture
+
+#endif // SLOT_TRACKER_H_
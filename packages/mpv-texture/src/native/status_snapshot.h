@@ -0,0 +1,123 @@
+/*
+ * Seqlock status/stats snapshot in memory shared with JS
+ *
+ * A fixed layout of float64 values behind two uint32 sequence numbers, read
+ * from JS through typed-array views (index.ts mirrors the layout). Each
+ * block has a single writer — status from the event thread, stats from the
+ * render thread — so writers never lock and readers never block them: a
+ * reader retries while the sequence is odd or changed under it.
+ *
+ * Layout (bytes): 0 status seq, 4 stats seq, then float64 slots from 8.
+ */
+
+#ifndef STATUS_SNAPSHOT_H_
+#define STATUS_SNAPSHOT_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "render_stats.h"
+
+namespace mpv_texture {
+
+class StatusSnapshot {
+public:
+    // float64 slot indices (slot 0 holds the two sequence numbers)
+    enum Slot : uint32_t {
+        // Status block
+        PLAYING = 1,
+        VOLUME,
+        MUTED,
+        POSITION,
+        DURATION,
+        WIDTH,
+        HEIGHT,
+        // Stats block
+        FRAMES_RENDERED,
+        FRAMES_DELIVERED,
+        FRAMES_DROPPED,
+        FRAMES_SUPERSEDED,
+        LOCK_FAILURES,
+        RENDER_FAILURES,
+        RESIZES,
+        LAST_FIRST_FRAME_US,
+        FRAMES_PACED,
+        FRAMES_LATE,
+        DISPLAY_PERIOD_US,
+        SLOT_COUNT
+    };
+
+    static const size_t SIZE_BYTES = SLOT_COUNT * sizeof(double);
+
+    // Point at SIZE_BYTES of 8-byte aligned memory that outlives every
+    // writer. Call before the writer threads start.
+    void attach(void* memory) {
+        m_statusSeq = new (memory) std::atomic<uint32_t>(0);
+        m_statsSeq = new (static_cast<uint8_t*>(memory) + 4) std::atomic<uint32_t>(0);
+        m_slots = static_cast<double*>(memory);
+        for (uint32_t i = 1; i < SLOT_COUNT; i++) {
+            m_slots[i] = 0;
+        }
+    }
+
+    bool attached() const { return m_slots != nullptr; }
+
+    // Event thread. Takes an MpvStatus (templated so this header does not
+    // depend on mpv_context.h).
+    template <typename Status>
+    void writeStatus(const Status& status) {
+        if (!m_slots) return;
+        begin(m_statusSeq);
+        m_slots[PLAYING] = status.playing ? 1 : 0;
+        m_slots[VOLUME] = status.volume;
+        m_slots[MUTED] = status.muted ? 1 : 0;
+        m_slots[POSITION] = status.position;
+        m_slots[DURATION] = status.duration;
+        m_slots[WIDTH] = status.width;
+        m_slots[HEIGHT] = status.height;
+        end(m_statusSeq);
+    }
+
+    // Render thread
+    void writeStats(const RenderStats& stats, uint64_t framesDropped) {
+        if (!m_slots) return;
+        auto load = [](const std::atomic<uint64_t>& value) {
+            return static_cast<double>(value.load(std::memory_order_relaxed));
+        };
+        begin(m_statsSeq);
+        m_slots[FRAMES_RENDERED] = load(stats.framesRendered);
+        m_slots[FRAMES_DELIVERED] = load(stats.framesDelivered);
+        m_slots[FRAMES_DROPPED] = static_cast<double>(framesDropped);
+        m_slots[FRAMES_SUPERSEDED] = load(stats.framesSuperseded);
+        m_slots[LOCK_FAILURES] = load(stats.lockFailures);
+        m_slots[RENDER_FAILURES] = load(stats.renderFailures);
+        m_slots[RESIZES] = load(stats.resizes);
+        m_slots[LAST_FIRST_FRAME_US] = load(stats.lastFirstFrameUs);
+        m_slots[FRAMES_PACED] = load(stats.framesPaced);
+        m_slots[FRAMES_LATE] = load(stats.framesLate);
+        m_slots[DISPLAY_PERIOD_US] = load(stats.displayPeriodUs);
+        end(m_statsSeq);
+    }
+
+private:
+    static void begin(std::atomic<uint32_t>* seq) {
+        seq->store(seq->load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    static void end(std::atomic<uint32_t>* seq) {
+        seq->store(seq->load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    std::atomic<uint32_t>* m_statusSeq = nullptr;
+    std::atomic<uint32_t>* m_statsSeq = nullptr;
+    double* m_slots = nullptr;
+};
+
+static_assert(sizeof(std::atomic<uint32_t>) == 4, "sequence numbers must be plain uint32 for JS");
+
+} // namespace mpv_texture
+
+#endif // STATUS_SNAPSHOT_H_
@@ -1,25 +1,25 @@
 /**
- * stub.cpp — No-op native addon for non-macOS platforms.
+ * stub.cpp — No-op native addon for platforms without a texture-share backend.
  *
  * Why this exists:
- *   The mpv-texture native addon uses IOSurface for GPU texture sharing,
- *   which is macOS-only. Windows and Linux use external mpv via the --wid
- *   flag instead and never load this addon.
+ *   The mpv-texture native addon shares GPU textures via DXGI (Windows),
+ *   IOSurface (macOS) or dma-buf (Linux). Windows builds without the mpv
+ *   dev files (scripts/setup-mpv-win.ps1), and Linux builds without the
+ *   libmpv/EGL dev packages, can't build it and use external mpv instead.
  *
  *   However, electron-builder's @electron/rebuild scans for packages with
  *   "gypfile": true and runs node-gyp rebuild on ALL platforms. Without
- *   this stub, the Windows build fails because mpv.lib doesn't exist
- *   (and shouldn't — Windows doesn't use the native addon).
+ *   this stub, those builds fail because mpv.lib / libmpv don't exist.
  *
- *   This stub lets node-gyp succeed on non-macOS platforms by producing
- *   a valid .node file that exports nothing. The preload layer
- *   (preload.cts) gates native addon usage to darwin only, so this
- *   stub is never loaded at runtime.
+ *   This stub lets node-gyp succeed on those platforms by producing a
+ *   valid .node file that exports nothing. The stub exports no create(),
+ *   so the bridge fails to initialize and main.ts falls back to external
+ *   mpv.
  *
  * See also:
  *   - binding.gyp: conditionally compiles this stub vs the real addon
  *   - packages/electron/src/preload.cts: platform gate for sharedTexture
- *   - packages/electron/src/main.ts: USE_NATIVE_MPV = process.platform === 'darwin'
+ *   - packages/electron/src/main.ts: USE_NATIVE_MPV (darwin, linux and win32)
  */
 
 #include <napi.h>
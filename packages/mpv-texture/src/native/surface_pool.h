@@ -0,0 +1,100 @@
+/*
+ * Pool of idle shared-surface sets keyed by (width, height, format)
+ *
+ * Adaptive HLS flips between renditions (720p <-> 1080p) all the time. Instead
+ * of destroying a backend's surfaces on resize, the outgoing set is parked
+ * here and handed back when the stream switches back to that size. Parked
+ * sets are evicted least-recently-used first once they exceed the memory
+ * budget.
+ *
+ * Render thread only (the GL context owning the surfaces must be current
+ * when a set is evicted), so no locking.
+ */
+
+#ifndef SURFACE_POOL_H_
+#define SURFACE_POOL_H_
+
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <utility>
+
+#include "texture_share.h"
+
+namespace mpv_texture {
+
+// Default budget for parked surface sets: two triple-buffered 1080p BGRA sets
+static const uint64_t DEFAULT_POOL_BUDGET_BYTES = 64ull * 1024 * 1024;
+
+struct SurfaceKey {
+    uint32_t width;
+    uint32_t height;
+    TextureFormat format;
+
+    bool operator==(const SurfaceKey& other) const {
+        return width == other.width && height == other.height && format == other.format;
+    }
+};
+
+template <typename Set>
+class SurfacePool {
+public:
+    void setBudget(uint64_t bytes) { m_budget = bytes; }
+    uint64_t budget() const { return m_budget; }
+    uint64_t pooledBytes() const { return m_bytes; }
+
+    // Take a parked set matching `key`. Returns false if none is pooled.
+    bool take(const SurfaceKey& key, Set& out) {
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->key == key) {
+                out = std::move(it->set);
+                m_bytes -= it->bytes;
+                m_entries.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Park a set, then evict the oldest sets until the pool fits the budget.
+    // A set larger than the whole budget is destroyed right away.
+    template <typename Destroy>
+    void put(const SurfaceKey& key, uint64_t bytes, Set&& set, Destroy destroy) {
+        m_entries.push_front(Entry{key, bytes, std::move(set)});
+        m_bytes += bytes;
+
+        while (m_bytes > m_budget && !m_entries.empty()) {
+            Entry& victim = m_entries.back();
+            std::cout << "[SurfacePool] Evicting " << victim.key.width << "x" << victim.key.height
+                      << " (" << (victim.bytes >> 20) << " MB)" << std::endl;
+            destroy(victim.set);
+            m_bytes -= victim.bytes;
+            m_entries.pop_back();
+        }
+    }
+
+    template <typename Destroy>
+    void clear(Destroy destroy) {
+        for (auto& entry : m_entries) {
+            destroy(entry.set);
+        }
+        m_entries.clear();
+        m_bytes = 0;
+    }
+
+private:
+    struct Entry {
+        SurfaceKey key;
+        uint64_t bytes;
+        Set set;
+    };
+
+    // Most recently parked first
+    std::list<Entry> m_entries;
+    uint64_t m_bytes = 0;
+    uint64_t m_budget = DEFAULT_POOL_BUDGET_BYTES;
+};
+
+} // namespace mpv_texture
+
+#endif // SURFACE_POOL_H_
@@ -1,6 +1,7 @@
 /*
  * Platform-agnostic texture sharing interface
- * Implementations: win32/dxgi_texture.cpp, macos/iosurface_texture.mm
+ * Implementations: win32/dxgi_texture.cpp, macos/iosurface_texture.mm,
+ * linux/dmabuf_texture.cpp
  */
 
 #ifndef TEXTURE_SHARE_H_
@@ -13,17 +14,46 @@ namespace mpv_texture {
 // Texture format for shared textures
 enum class TextureFormat {
     RGBA8,    // Standard RGBA
-    NV12,     // YUV 4:2:0 (hardware decode output)
-    BGRA8     // BGRA (macOS IOSurface native format)
+    NV12,     // YUV 4:2:0 (hardware decode output), BT.709 limited range
+    BGRA8,    // BGRA (macOS IOSurface native format)
+    P010      // 10-bit YUV 4:2:0 in 16-bit MSBs, BT.2020 limited range
+};
+
+inline bool isPlanar(TextureFormat format) {
+    return format == TextureFormat::NV12 || format == TextureFormat::P010;
+}
+
+// Transfer function of the exported pixels
+enum class TextureTransfer {
+    SDR,      // sRGB / BT.1886
+    PQ,       // SMPTE ST 2084 (HDR10)
+    HLG       // ARIB STD-B67
 };
 
 // Information about an exported texture
 struct TextureInfo {
-    uint64_t handle;        // Platform-specific handle (HANDLE on Win, IOSurfaceRef pointer on Mac)
+    uint64_t handle;        // Platform-specific handle (HANDLE on Win, IOSurfaceRef pointer on Mac,
+                            // dma-buf fd on Linux)
     uint32_t width;
     uint32_t height;
     TextureFormat format;
+    TextureTransfer transfer;
     bool is_valid;
+    // Linux dma-buf layout (single plane); zero elsewhere
+    uint32_t stride;
+    uint32_t offset;
+    uint64_t modifier;      // DRM format modifier
+    // Export generation, unique per backend: handles repeat, so releases
+    // quote it to name this export and not a later one of the same handle
+    uint64_t generation;
+    // Frame timeline, filled in by the render loop (backends leave it zero).
+    // Times are nowUs(); pts is the playback position when the render
+    // started (the latest time-pos, so approximate), NaN if unknown.
+    uint64_t seq;           // Per-player frame number, from 1
+    double pts;
+    uint64_t renderStartUs; // mpv_render_context_render called
+    uint64_t renderDoneUs;  // ... returned (GPU work submitted)
+    uint64_t exportUs;      // GPU complete, posted to the mailbox
 };
 
 // Abstract interface for platform-specific texture sharing
@@ -32,14 +62,22 @@ public:
     virtual ~ITextureShare() = default;
 
     // Initialize the texture sharing system
-    // gl_context: Platform-specific GL context (HGLRC on Win, CGLContextObj on Mac)
+    // gl_context: Platform-specific GL context (HGLRC on Win, CGLContextObj on Mac,
+    // EGLContext on Linux)
     virtual bool initialize(void* gl_context) = 0;
 
-    // Create a shared texture of the given size
-    virtual bool createTexture(uint32_t width, uint32_t height) = 0;
+    // Create a shared texture of the given size and format. RGBA8 and BGRA8
+    // both select the backend's native packed format. For NV12/P010 mpv
+    // renders into an intermediate RGB target that unlockAndExport()
+    // converts into the planes.
+    virtual bool createTexture(uint32_t width, uint32_t height, TextureFormat format) = 0;
+
+    // Resize (or change the format of) the shared texture. The outgoing
+    // surfaces are parked in a pool and reused if the stream switches back.
+    virtual bool resizeTexture(uint32_t width, uint32_t height, TextureFormat format) = 0;
 
-    // Resize the shared texture
-    virtual bool resizeTexture(uint32_t width, uint32_t height) = 0;
+    // Memory budget for parked surface sets (0 disables pooling)
+    virtual void setPoolBudget(uint64_t bytes) = 0;
 
     // Get the OpenGL texture ID for mpv to render into
     virtual uint32_t getGLTexture() const = 0;
@@ -47,15 +85,31 @@ public:
     // Get the OpenGL FBO ID
     virtual uint32_t getGLFBO() const = 0;
 
-    // Lock the texture for rendering (call before mpv_render_context_render)
+    // Internal format of the FBO (lets mpv skip dithering to 8 bit), 0 if unknown
+    virtual uint32_t getGLInternalFormat() const = 0;
+
+    // Lock a free slot for rendering (call before mpv_render_context_render).
+    // Returns false if every slot is still held by the consumer.
+    // Windows: acquires the slot's keyed mutex.
     virtual bool lockTexture() = 0;
 
     // Unlock and export the texture (call after mpv_render_context_render)
-    // Returns the texture info for sharing with Electron
+    // Returns the texture info for sharing with Electron. The slot stays
+    // owned by the consumer until releaseTexture() is called with its handle.
+    // macOS: inserts a GLsync fence; Windows: releases the keyed mutex.
     virtual TextureInfo unlockAndExport() = 0;
 
-    // Release a previously exported texture
-    virtual void releaseTexture() = 0;
+    // Unlock without exporting (rendering failed); the slot becomes free again
+    virtual void abandonTexture() = 0;
+
+    // Wait up to timeoutNs for the GPU to finish rendering an exported slot.
+    // Returns true once the frame may be handed to the consumer.
+    virtual bool waitForExport(const TextureInfo& info, uint64_t timeoutNs) = 0;
+
+    // Return an exported slot for reuse (consumer is done with it).
+    // `generation` is the export's TextureInfo::generation; 0 releases
+    // whichever export the handle has. Safe to call from any thread.
+    virtual void releaseTexture(uint64_t handle, uint64_t generation) = 0;
 
     // Clean up all resources
     virtual void destroy() = 0;
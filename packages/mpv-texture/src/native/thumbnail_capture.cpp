@@ -0,0 +1,234 @@
+/*
+ * Asynchronous thumbnail readback implementation
+ */
+
+#include "thumbnail_capture.h"
+#include "gl_context.h"
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <gl/GL.h>
+#elif defined(__APPLE__)
+#define GL_SILENCE_DEPRECATION
+#include <OpenGL/gl3.h>
+#else
+#include <GL/gl.h>
+#endif
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+// GL 3 / GLES 3 constants missing from the Windows 1.1 header
+#ifndef GL_FRAMEBUFFER
+#define GL_FRAMEBUFFER 0x8D40
+#define GL_READ_FRAMEBUFFER 0x8CA8
+#define GL_DRAW_FRAMEBUFFER 0x8CA9
+#define GL_RENDERBUFFER 0x8D41
+#define GL_COLOR_ATTACHMENT0 0x8CE0
+#define GL_FRAMEBUFFER_COMPLETE 0x8CD5
+#endif
+#ifndef GL_PIXEL_PACK_BUFFER
+#define GL_PIXEL_PACK_BUFFER 0x88EB
+#define GL_STREAM_READ 0x88E1
+#endif
+#ifndef GL_MAP_READ_BIT
+#define GL_MAP_READ_BIT 0x0001
+#endif
+#ifndef GL_SYNC_GPU_COMMANDS_COMPLETE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE 0x9117
+#define GL_ALREADY_SIGNALED 0x911A
+#define GL_CONDITION_SATISFIED 0x911C
+#define GL_WAIT_FAILED 0x911D
+#endif
+#ifndef GL_RGBA8
+#define GL_RGBA8 0x8058
+#endif
+
+namespace mpv_texture {
+
+// Resolved through GLContext::getProcAddress so one code path serves desktop
+// GL and ANGLE's GLES 3 alike. Sync objects are plain pointers here.
+struct ThumbnailGL {
+    void (APIENTRY* genFramebuffers)(GLsizei, GLuint*);
+    void (APIENTRY* deleteFramebuffers)(GLsizei, const GLuint*);
+    void (APIENTRY* bindFramebuffer)(GLenum, GLuint);
+    void (APIENTRY* framebufferRenderbuffer)(GLenum, GLenum, GLenum, GLuint);
+    GLenum (APIENTRY* checkFramebufferStatus)(GLenum);
+    void (APIENTRY* genRenderbuffers)(GLsizei, GLuint*);
+    void (APIENTRY* deleteRenderbuffers)(GLsizei, const GLuint*);
+    void (APIENTRY* bindRenderbuffer)(GLenum, GLuint);
+    void (APIENTRY* renderbufferStorage)(GLenum, GLenum, GLsizei, GLsizei);
+    void (APIENTRY* blitFramebuffer)(GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLbitfield, GLenum);
+    void (APIENTRY* genBuffers)(GLsizei, GLuint*);
+    void (APIENTRY* deleteBuffers)(GLsizei, const GLuint*);
+    void (APIENTRY* bindBuffer)(GLenum, GLuint);
+    void (APIENTRY* bufferData)(GLenum, intptr_t, const void*, GLenum);
+    void* (APIENTRY* mapBufferRange)(GLenum, intptr_t, intptr_t, GLbitfield);
+    GLboolean (APIENTRY* unmapBuffer)(GLenum);
+    void (APIENTRY* readPixels)(GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, void*);
+    void (APIENTRY* flush)(void);
+    void* (APIENTRY* fenceSync)(GLenum, GLbitfield);
+    GLenum (APIENTRY* clientWaitSync)(void*, GLbitfield, uint64_t);
+    void (APIENTRY* deleteSync)(void*);
+};
+
+static ThumbnailGL g_gl;
+
+template <typename T>
+static bool loadFunction(T& function, const char* name) {
+    function = reinterpret_cast<T>(GLContext::getProcAddress(name));
+    return function != nullptr;
+}
+
+// Loaded once by the first capture (any render thread, its context
+// current): every player's context has the same driver and version
+static bool loadGL() {
+    static const bool loaded = [] {
+        bool ok = loadFunction(g_gl.genFramebuffers, "glGenFramebuffers") &&
+            loadFunction(g_gl.deleteFramebuffers, "glDeleteFramebuffers") &&
+            loadFunction(g_gl.bindFramebuffer, "glBindFramebuffer") &&
+            loadFunction(g_gl.framebufferRenderbuffer, "glFramebufferRenderbuffer") &&
+            loadFunction(g_gl.checkFramebufferStatus, "glCheckFramebufferStatus") &&
+            loadFunction(g_gl.genRenderbuffers, "glGenRenderbuffers") &&
+            loadFunction(g_gl.deleteRenderbuffers, "glDeleteRenderbuffers") &&
+            loadFunction(g_gl.bindRenderbuffer, "glBindRenderbuffer") &&
+            loadFunction(g_gl.renderbufferStorage, "glRenderbufferStorage") &&
+            loadFunction(g_gl.blitFramebuffer, "glBlitFramebuffer") &&
+            loadFunction(g_gl.genBuffers, "glGenBuffers") &&
+            loadFunction(g_gl.deleteBuffers, "glDeleteBuffers") &&
+            loadFunction(g_gl.bindBuffer, "glBindBuffer") &&
+            loadFunction(g_gl.bufferData, "glBufferData") &&
+            loadFunction(g_gl.mapBufferRange, "glMapBufferRange") &&
+            loadFunction(g_gl.unmapBuffer, "glUnmapBuffer") &&
+            loadFunction(g_gl.readPixels, "glReadPixels") &&
+            loadFunction(g_gl.flush, "glFlush") &&
+            loadFunction(g_gl.fenceSync, "glFenceSync") &&
+            loadFunction(g_gl.clientWaitSync, "glClientWaitSync") &&
+            loadFunction(g_gl.deleteSync, "glDeleteSync");
+        if (!ok) {
+            std::cerr << "[Thumbnail] GL 3 readback functions unavailable" << std::endl;
+        }
+        return ok;
+    }();
+    return loaded;
+}
+
+void ThumbnailCapture::capture(unsigned int sourceFbo, uint32_t sourceWidth, uint32_t sourceHeight,
+                               uint32_t width, uint32_t height, ThumbnailCallback done) {
+    if (!loadGL()) {
+        done(false, "Thumbnail readback not supported", ThumbnailImage{});
+        return;
+    }
+
+    Readback readback;
+    readback.width = width;
+    readback.height = height;
+
+    g_gl.genRenderbuffers(1, &readback.renderbuffer);
+    g_gl.bindRenderbuffer(GL_RENDERBUFFER, readback.renderbuffer);
+    g_gl.renderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    g_gl.bindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    g_gl.genFramebuffers(1, &readback.fbo);
+    g_gl.bindFramebuffer(GL_DRAW_FRAMEBUFFER, readback.fbo);
+    g_gl.framebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, readback.renderbuffer);
+    if (g_gl.checkFramebufferStatus(GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        g_gl.bindFramebuffer(GL_FRAMEBUFFER, 0);
+        release(readback);
+        done(false, "Failed to create thumbnail framebuffer", ThumbnailImage{});
+        return;
+    }
+
+    // The GPU does the downscale
+    g_gl.bindFramebuffer(GL_READ_FRAMEBUFFER, sourceFbo);
+    g_gl.blitFramebuffer(0, 0, sourceWidth, sourceHeight, 0, 0, width, height,
+                         GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+    // Into the pack buffer: glReadPixels returns immediately. RGBA8 rows
+    // are always 4-byte aligned, so the default pack alignment is tight.
+    size_t bytes = static_cast<size_t>(width) * height * 4;
+    g_gl.genBuffers(1, &readback.buffer);
+    g_gl.bindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+    g_gl.bufferData(GL_PIXEL_PACK_BUFFER, static_cast<intptr_t>(bytes), nullptr, GL_STREAM_READ);
+    g_gl.bindFramebuffer(GL_READ_FRAMEBUFFER, readback.fbo);
+    g_gl.readPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    g_gl.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    g_gl.bindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    readback.fence = g_gl.fenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    g_gl.flush();  // Get the copy queued; poll() only ever checks the fence
+    if (!readback.fence) {
+        release(readback);
+        done(false, "Failed to fence thumbnail readback", ThumbnailImage{});
+        return;
+    }
+
+    readback.done = std::move(done);
+    m_pending.push_back(std::move(readback));
+}
+
+void ThumbnailCapture::poll() {
+    for (size_t i = 0; i < m_pending.size();) {
+        Readback& readback = m_pending[i];
+        GLenum result = g_gl.clientWaitSync(readback.fence, 0, 0);
+        if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED && result != GL_WAIT_FAILED) {
+            i++;
+            continue;
+        }
+
+        bool ok = false;
+        ThumbnailImage image;
+        if (result != GL_WAIT_FAILED) {
+            size_t bytes = static_cast<size_t>(readback.width) * readback.height * 4;
+            g_gl.bindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+            const void* mapped = g_gl.mapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<intptr_t>(bytes), GL_MAP_READ_BIT);
+            if (mapped) {
+                image.width = readback.width;
+                image.height = readback.height;
+                image.rgba.resize(bytes);
+                std::memcpy(image.rgba.data(), mapped, bytes);
+                g_gl.unmapBuffer(GL_PIXEL_PACK_BUFFER);
+                ok = true;
+            }
+            g_gl.bindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        }
+
+        ThumbnailCallback done = std::move(readback.done);
+        release(readback);
+        m_pending.erase(m_pending.begin() + i);
+        done(ok, ok ? "" : "Thumbnail readback failed", std::move(image));
+    }
+}
+
+void ThumbnailCapture::destroy(const std::string& error) {
+    std::vector<Readback> pending;
+    pending.swap(m_pending);
+    for (auto& readback : pending) {
+        release(readback);
+        readback.done(false, error, ThumbnailImage{});
+    }
+}
+
+void ThumbnailCapture::release(Readback& readback) {
+    if (readback.fence) {
+        g_gl.deleteSync(readback.fence);
+        readback.fence = nullptr;
+    }
+    if (readback.buffer) {
+        g_gl.deleteBuffers(1, &readback.buffer);
+        readback.buffer = 0;
+    }
+    if (readback.fbo) {
+        g_gl.deleteFramebuffers(1, &readback.fbo);
+        readback.fbo = 0;
+    }
+    if (readback.renderbuffer) {
+        g_gl.deleteRenderbuffers(1, &readback.renderbuffer);
+        readback.renderbuffer = 0;
+    }
+}
+
+} // namespace mpv_texture
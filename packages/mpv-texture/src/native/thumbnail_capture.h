@@ -0,0 +1,69 @@
+/*
+ * Asynchronous thumbnail readback (render thread only)
+ *
+ * A capture blits the frame just rendered into a small RGBA8 framebuffer and
+ * starts a glReadPixels into a pixel-pack buffer. The copy runs on the GPU
+ * behind a fence; poll() maps the buffer only once the fence has signaled,
+ * so neither the capture nor the readback stalls the next render.
+ */
+
+#ifndef THUMBNAIL_CAPTURE_H_
+#define THUMBNAIL_CAPTURE_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace mpv_texture {
+
+struct ThumbnailImage {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::vector<uint8_t> rgba;  // Tightly packed, top row first
+};
+
+// Completion of a capture: ok with the image, otherwise the reason
+using ThumbnailCallback = std::function<void(bool ok, const std::string& error, ThumbnailImage&& image)>;
+
+class ThumbnailCapture {
+public:
+    ThumbnailCapture() = default;
+    ~ThumbnailCapture() = default;
+
+    ThumbnailCapture(const ThumbnailCapture&) = delete;
+    ThumbnailCapture& operator=(const ThumbnailCapture&) = delete;
+
+    // Scale `sourceFbo` (sourceWidth x sourceHeight) into width x height and
+    // start reading it back. `done` fires from a later poll() or destroy().
+    void capture(unsigned int sourceFbo, uint32_t sourceWidth, uint32_t sourceHeight,
+                 uint32_t width, uint32_t height, ThumbnailCallback done);
+
+    // Complete every readback whose fence has signaled (never blocks)
+    void poll();
+
+    // Readbacks waiting on the GPU
+    bool busy() const { return !m_pending.empty(); }
+
+    // Free GL objects and fail pending readbacks (GL context current)
+    void destroy(const std::string& error);
+
+private:
+    struct Readback {
+        unsigned int fbo = 0;
+        unsigned int renderbuffer = 0;
+        unsigned int buffer = 0;
+        void* fence = nullptr;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        ThumbnailCallback done;
+    };
+
+    void release(Readback& readback);
+
+    std::vector<Readback> m_pending;
+};
+
+} // namespace mpv_texture
+
+#endif // THUMBNAIL_CAPTURE_H_
@@ -0,0 +1,98 @@
+/*
+ * Display refresh clock: period and phase of the vsync frames are shown on
+ *
+ * Fed with vsync timestamps (nowUs clock) from a platform source (see
+ * vsync_source.h) and/or presentation feedback from JS. Samples may skip
+ * vblanks (a stalled main thread, a paused rAF loop); such intervals are
+ * folded back onto the current period estimate instead of stretching it.
+ */
+
+#ifndef VSYNC_CLOCK_H_
+#define VSYNC_CLOCK_H_
+
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+
+namespace mpv_texture {
+
+class VsyncClock {
+public:
+    static const uint64_t MIN_PERIOD_US = 4000;     // 250 Hz
+    static const uint64_t MAX_PERIOD_US = 50000;    // 20 Hz
+    // Intervals spanning more vblanks than this only re-phase the clock
+    static const uint64_t MAX_SKIPPED = 8;
+    // Samples within the tolerance before the estimate is trusted
+    static const int LOCK_SAMPLES = 8;
+    // Without samples for this long the clock stops being trusted
+    static const uint64_t STALE_US = 500000;
+
+    void addSample(uint64_t vsyncUs) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_lastUs && vsyncUs <= m_lastUs) {
+            return;  // Duplicate or out of order (two sources racing)
+        }
+        if (m_lastUs) {
+            double interval = static_cast<double>(vsyncUs - m_lastUs);
+            if (m_periodUs == 0 || interval < m_periodUs * 0.75) {
+                // First interval, or the estimate was a multiple of the real period
+                if (interval >= MIN_PERIOD_US && interval <= MAX_PERIOD_US) {
+                    m_periodUs = interval;
+                    m_goodSamples = 0;
+                }
+            } else {
+                double count = std::floor(interval / m_periodUs + 0.5);
+                if (count <= MAX_SKIPPED) {
+                    double measured = interval / count;
+                    if (std::fabs(measured - m_periodUs) < m_periodUs * 0.1) {
+                        m_periodUs += (measured - m_periodUs) / 16;
+                        if (m_goodSamples < LOCK_SAMPLES) {
+                            m_goodSamples++;
+                        }
+                    }
+                }
+            }
+        }
+        m_lastUs = vsyncUs;
+    }
+
+    // True once the period is known and samples keep arriving
+    bool locked(uint64_t atUs) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_goodSamples >= LOCK_SAMPLES && atUs < m_lastUs + STALE_US;
+    }
+
+    // Refresh period in microseconds, 0 until locked
+    double periodUs() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_goodSamples >= LOCK_SAMPLES ? m_periodUs : 0;
+    }
+
+    // The vsync nearest to `atUs` (0 until locked)
+    uint64_t nearestVsync(uint64_t atUs) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_goodSamples < LOCK_SAMPLES) {
+            return 0;
+        }
+        double offset = static_cast<double>(atUs) - static_cast<double>(m_lastUs);
+        double vsync = static_cast<double>(m_lastUs) + std::floor(offset / m_periodUs + 0.5) * m_periodUs;
+        return vsync > 0 ? static_cast<uint64_t>(vsync) : 0;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lastUs = 0;
+        m_periodUs = 0;
+        m_goodSamples = 0;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    uint64_t m_lastUs = 0;
+    double m_periodUs = 0;
+    int m_goodSamples = 0;
+};
+
+} // namespace mpv_texture
+
+#endif // VSYNC_CLOCK_H_
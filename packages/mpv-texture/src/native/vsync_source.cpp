@@ -0,0 +1,150 @@
+/*
+ * Platform display vsync source implementation
+ */
+
+#include "vsync_source.h"
+#include "render_stats.h"
+#include <atomic>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <dxgi.h>
+#include <thread>
+#elif defined(__APPLE__)
+#include <CoreVideo/CoreVideo.h>
+#include <mach/mach_time.h>
+#endif
+
+namespace mpv_texture {
+
+#ifdef _WIN32
+// A thread parked in WaitForVBlank on the primary output (the display
+// Chromium composites on)
+class DXGIVsyncSource : public VsyncSource {
+public:
+    ~DXGIVsyncSource() override { stop(); }
+
+    bool start(VsyncClock* clock) override {
+        if (m_thread.joinable()) {
+            return true;
+        }
+
+        IDXGIFactory1* factory = nullptr;
+        if (FAILED(CreateDXGIFactory1(__uuidof(IDXGIFactory1), (void**)&factory))) {
+            return false;
+        }
+        IDXGIAdapter1* adapter = nullptr;
+        if (factory->EnumAdapters1(0, &adapter) != DXGI_ERROR_NOT_FOUND) {
+            adapter->EnumOutputs(0, &m_output);
+            adapter->Release();
+        }
+        factory->Release();
+        if (!m_output) {
+            std::cerr << "[Vsync] No DXGI output to wait on" << std::endl;
+            return false;
+        }
+
+        m_running = true;
+        m_thread = std::thread([this, clock] {
+            while (m_running) {
+                if (FAILED(m_output->WaitForVBlank())) {
+                    // Output gone (display off, mode change): don't spin
+                    Sleep(100);
+                    continue;
+                }
+                clock->addSample(nowUs());
+            }
+        });
+        std::cout << "[Vsync] Tracking DXGI vblank" << std::endl;
+        return true;
+    }
+
+    void stop() override {
+        m_running = false;
+        if (m_thread.joinable()) {
+            m_thread.join();  // At most one vblank away
+        }
+        if (m_output) {
+            m_output->Release();
+            m_output = nullptr;
+        }
+    }
+
+private:
+    IDXGIOutput* m_output = nullptr;
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+};
+
+VsyncSource* createVsyncSource() {
+    return new DXGIVsyncSource();
+}
+#elif defined(__APPLE__)
+// CVDisplayLink on the main display; callbacks run on CoreVideo's thread
+class DisplayLinkVsyncSource : public VsyncSource {
+public:
+    ~DisplayLinkVsyncSource() override { stop(); }
+
+    bool start(VsyncClock* clock) override {
+        if (m_link) {
+            return true;
+        }
+
+        mach_timebase_info_data_t timebase;
+        mach_timebase_info(&timebase);
+        m_hostToUs = static_cast<double>(timebase.numer) / timebase.denom / 1000.0;
+        m_clock = clock;
+
+        if (CVDisplayLinkCreateWithActiveCGDisplays(&m_link) != kCVReturnSuccess) {
+            std::cerr << "[Vsync] Failed to create CVDisplayLink" << std::endl;
+            m_link = nullptr;
+            return false;
+        }
+        CVDisplayLinkSetOutputCallback(m_link, displayLinkCallback, this);
+        if (CVDisplayLinkStart(m_link) != kCVReturnSuccess) {
+            std::cerr << "[Vsync] Failed to start CVDisplayLink" << std::endl;
+            CVDisplayLinkRelease(m_link);
+            m_link = nullptr;
+            return false;
+        }
+        std::cout << "[Vsync] Tracking CVDisplayLink" << std::endl;
+        return true;
+    }
+
+    void stop() override {
+        if (m_link) {
+            // Blocks until an in-progress callback has returned
+            CVDisplayLinkStop(m_link);
+            CVDisplayLinkRelease(m_link);
+            m_link = nullptr;
+        }
+    }
+
+private:
+    static CVReturn displayLinkCallback(CVDisplayLinkRef, const CVTimeStamp* now, const CVTimeStamp*,
+                                        CVOptionFlags, CVOptionFlags*, void* ctx) {
+        auto* self = static_cast<DisplayLinkVsyncSource*>(ctx);
+        // `now` is the most recent vsync in host time; map it onto nowUs()
+        uint64_t hostNow = mach_absolute_time();
+        uint64_t ageUs = hostNow > now->hostTime
+            ? static_cast<uint64_t>((hostNow - now->hostTime) * self->m_hostToUs) : 0;
+        self->m_clock->addSample(nowUs() - ageUs);
+        return kCVReturnSuccess;
+    }
+
+    CVDisplayLinkRef m_link = nullptr;
+    VsyncClock* m_clock = nullptr;
+    double m_hostToUs = 0;
+};
+
+VsyncSource* createVsyncSource() {
+    return new DisplayLinkVsyncSource();
+}
+#else
+VsyncSource* createVsyncSource() {
+    return nullptr;
+}
+#endif
+
+} // namespace mpv_texture
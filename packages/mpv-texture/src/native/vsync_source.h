@@ -0,0 +1,30 @@
+/*
+ * Platform display vsync source
+ * CVDisplayLink on macOS, DXGI IDXGIOutput::WaitForVBlank on Windows. Linux
+ * has none (render nodes carry no vblank events); there the clock is fed by
+ * JS presentation feedback only (MpvContext::reportPresentation).
+ */
+
+#ifndef VSYNC_SOURCE_H_
+#define VSYNC_SOURCE_H_
+
+#include "vsync_clock.h"
+
+namespace mpv_texture {
+
+class VsyncSource {
+public:
+    virtual ~VsyncSource() = default;
+
+    // Start feeding vsync timestamps into `clock`, which must outlive the
+    // source. Returns false if the display cannot be tracked.
+    virtual bool start(VsyncClock* clock) = 0;
+    virtual void stop() = 0;
+};
+
+// Factory function - nullptr where the platform has no source
+VsyncSource* createVsyncSource();
+
+} // namespace mpv_texture
+
+#endif // VSYNC_SOURCE_H_
@@ -0,0 +1,150 @@
+/*
+ * Minimal EGL declarations for ANGLE
+ *
+ * ANGLE is loaded at runtime from the libEGL.dll Electron ships next to its
+ * executable, so the build needs no ANGLE SDK. A missing or too old ANGLE
+ * just disables the route and GLContext falls back to WGL.
+ */
+
+#ifndef ANGLE_EGL_H_
+#define ANGLE_EGL_H_
+
+#ifdef _WIN32
+
+#include <windows.h>
+#include <cstdint>
+#include <cstring>
+
+namespace mpv_texture {
+
+typedef void* EGLDisplay;
+typedef void* EGLConfig;
+typedef void* EGLContext;
+typedef void* EGLSurface;
+typedef void* EGLImage;
+typedef void* EGLDeviceEXT;
+typedef void* EGLClientBuffer;
+typedef int32_t EGLint;
+typedef unsigned int EGLBoolean;
+typedef unsigned int EGLenum;
+typedef intptr_t EGLAttrib;
+
+// EGL constants
+#define EGL_NONE 0x3038
+#define EGL_EXTENSIONS 0x3055
+#define EGL_ALPHA_SIZE 0x3021
+#define EGL_BLUE_SIZE 0x3022
+#define EGL_GREEN_SIZE 0x3023
+#define EGL_RED_SIZE 0x3024
+#define EGL_RENDERABLE_TYPE 0x3040
+#define EGL_OPENGL_ES3_BIT 0x0040
+#define EGL_CONTEXT_CLIENT_VERSION 0x3098
+#define EGL_OPENGL_ES_API 0x30A0
+#define EGL_PLATFORM_DEVICE_EXT 0x313F
+
+// ANGLE extensions
+#define EGL_D3D11_DEVICE_ANGLE 0x33A1       // EGL_ANGLE_device_d3d
+#define EGL_D3D11_TEXTURE_ANGLE 0x3484      // EGL_ANGLE_image_d3d11_texture
+
+// EGL entry points (EGLAPIENTRY is __stdcall on Windows)
+typedef void*(WINAPI* PFNEGLGETPROCADDRESSPROC)(const char*);
+typedef EGLint(WINAPI* PFNEGLGETERRORPROC)(void);
+typedef const char*(WINAPI* PFNEGLQUERYSTRINGPROC)(EGLDisplay, EGLint);
+typedef EGLBoolean(WINAPI* PFNEGLINITIALIZEPROC)(EGLDisplay, EGLint*, EGLint*);
+typedef EGLBoolean(WINAPI* PFNEGLTERMINATEPROC)(EGLDisplay);
+typedef EGLBoolean(WINAPI* PFNEGLBINDAPIPROC)(EGLenum);
+typedef EGLBoolean(WINAPI* PFNEGLCHOOSECONFIGPROC)(EGLDisplay, const EGLint*, EGLConfig*, EGLint, EGLint*);
+typedef EGLContext(WINAPI* PFNEGLCREATECONTEXTPROC)(EGLDisplay, EGLConfig, EGLContext, const EGLint*);
+typedef EGLBoolean(WINAPI* PFNEGLDESTROYCONTEXTPROC)(EGLDisplay, EGLContext);
+typedef EGLBoolean(WINAPI* PFNEGLMAKECURRENTPROC)(EGLDisplay, EGLSurface, EGLSurface, EGLContext);
+typedef EGLDisplay(WINAPI* PFNEGLGETPLATFORMDISPLAYEXTPROC)(EGLenum, void*, const EGLint*);
+typedef EGLDeviceEXT(WINAPI* PFNEGLCREATEDEVICEANGLEPROC)(EGLint, void*, const EGLAttrib*);
+typedef EGLBoolean(WINAPI* PFNEGLRELEASEDEVICEANGLEPROC)(EGLDeviceEXT);
+typedef EGLImage(WINAPI* PFNEGLCREATEIMAGEKHRPROC)(EGLDisplay, EGLContext, EGLenum, EGLClientBuffer, const EGLint*);
+typedef EGLBoolean(WINAPI* PFNEGLDESTROYIMAGEKHRPROC)(EGLDisplay, EGLImage);
+
+struct AngleEGL {
+    PFNEGLGETPROCADDRESSPROC getProcAddress = nullptr;
+    PFNEGLGETERRORPROC getError = nullptr;
+    PFNEGLQUERYSTRINGPROC queryString = nullptr;
+    PFNEGLINITIALIZEPROC initialize = nullptr;
+    PFNEGLTERMINATEPROC terminate = nullptr;
+    PFNEGLBINDAPIPROC bindAPI = nullptr;
+    PFNEGLCHOOSECONFIGPROC chooseConfig = nullptr;
+    PFNEGLCREATECONTEXTPROC createContext = nullptr;
+    PFNEGLDESTROYCONTEXTPROC destroyContext = nullptr;
+    PFNEGLMAKECURRENTPROC makeCurrent = nullptr;
+    // Extensions, resolved through eglGetProcAddress
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplayEXT = nullptr;
+    PFNEGLCREATEDEVICEANGLEPROC createDeviceANGLE = nullptr;
+    PFNEGLRELEASEDEVICEANGLEPROC releaseDeviceANGLE = nullptr;
+    PFNEGLCREATEIMAGEKHRPROC createImageKHR = nullptr;
+    PFNEGLDESTROYIMAGEKHRPROC destroyImageKHR = nullptr;
+};
+
+// Load libEGL.dll once per process. nullptr if it or an entry point is missing.
+// The module is never unloaded: mpv's ANGLE code resolves the same instance.
+inline const AngleEGL* loadAngleEGL() {
+    static const AngleEGL* loaded = []() -> const AngleEGL* {
+        HMODULE module = LoadLibraryA("libEGL.dll");
+        if (!module) {
+            return nullptr;
+        }
+
+        static AngleEGL egl;
+        egl.getProcAddress = reinterpret_cast<PFNEGLGETPROCADDRESSPROC>(GetProcAddress(module, "eglGetProcAddress"));
+        egl.getError = reinterpret_cast<PFNEGLGETERRORPROC>(GetProcAddress(module, "eglGetError"));
+        egl.queryString = reinterpret_cast<PFNEGLQUERYSTRINGPROC>(GetProcAddress(module, "eglQueryString"));
+        egl.initialize = reinterpret_cast<PFNEGLINITIALIZEPROC>(GetProcAddress(module, "eglInitialize"));
+        egl.terminate = reinterpret_cast<PFNEGLTERMINATEPROC>(GetProcAddress(module, "eglTerminate"));
+        egl.bindAPI = reinterpret_cast<PFNEGLBINDAPIPROC>(GetProcAddress(module, "eglBindAPI"));
+        egl.chooseConfig = reinterpret_cast<PFNEGLCHOOSECONFIGPROC>(GetProcAddress(module, "eglChooseConfig"));
+        egl.createContext = reinterpret_cast<PFNEGLCREATECONTEXTPROC>(GetProcAddress(module, "eglCreateContext"));
+        egl.destroyContext = reinterpret_cast<PFNEGLDESTROYCONTEXTPROC>(GetProcAddress(module, "eglDestroyContext"));
+        egl.makeCurrent = reinterpret_cast<PFNEGLMAKECURRENTPROC>(GetProcAddress(module, "eglMakeCurrent"));
+        if (!egl.getProcAddress || !egl.getError || !egl.queryString || !egl.initialize ||
+            !egl.terminate || !egl.bindAPI || !egl.chooseConfig || !egl.createContext ||
+            !egl.destroyContext || !egl.makeCurrent) {
+            return nullptr;
+        }
+
+        egl.getPlatformDisplayEXT = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            egl.getProcAddress("eglGetPlatformDisplayEXT"));
+        egl.createDeviceANGLE = reinterpret_cast<PFNEGLCREATEDEVICEANGLEPROC>(
+            egl.getProcAddress("eglCreateDeviceANGLE"));
+        egl.releaseDeviceANGLE = reinterpret_cast<PFNEGLRELEASEDEVICEANGLEPROC>(
+            egl.getProcAddress("eglReleaseDeviceANGLE"));
+        egl.createImageKHR = reinterpret_cast<PFNEGLCREATEIMAGEKHRPROC>(
+            egl.getProcAddress("eglCreateImageKHR"));
+        egl.destroyImageKHR = reinterpret_cast<PFNEGLDESTROYIMAGEKHRPROC>(
+            egl.getProcAddress("eglDestroyImageKHR"));
+        if (!egl.getPlatformDisplayEXT || !egl.createDeviceANGLE || !egl.releaseDeviceANGLE ||
+            !egl.createImageKHR || !egl.destroyImageKHR) {
+            return nullptr;
+        }
+        return &egl;
+    }();
+    return loaded;
+}
+
+// Whole-word match in an EGL extension string
+inline bool hasEGLExtension(const char* extensions, const char* name) {
+    if (!extensions) {
+        return false;
+    }
+    size_t length = strlen(name);
+    for (const char* p = strstr(extensions, name); p; p = strstr(p + length, name)) {
+        bool start = p == extensions || p[-1] == ' ';
+        bool end = p[length] == '\0' || p[length] == ' ';
+        if (start && end) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace mpv_texture
+
+#endif // _WIN32
+
+#endif // ANGLE_EGL_H_
@@ -0,0 +1,161 @@
+/*
+ * Shared D3D11 device implementation
+ */
+
+#ifdef _WIN32
+
+#include "d3d_device.h"
+#include <windows.h>
+#include <d3d10.h>    // For ID3D10Multithread
+#include <dxgi.h>
+#include <iostream>
+#include <mutex>
+#include <string>
+
+namespace mpv_texture {
+
+static const UINT NVIDIA_VENDOR_ID = 0x10DE;
+
+// Guarded by g_deviceMutex
+static std::mutex g_deviceMutex;
+static ID3D11Device* g_d3dDevice = nullptr;
+static ID3D11DeviceContext* g_d3dContext = nullptr;
+static int g_deviceRefs = 0;
+
+bool isDefaultAdapterNvidia() {
+    IDXGIFactory1* factory = nullptr;
+    if (FAILED(CreateDXGIFactory1(__uuidof(IDXGIFactory1), (void**)&factory))) {
+        return false;
+    }
+
+    bool nvidia = false;
+    IDXGIAdapter1* adapter = nullptr;
+    if (factory->EnumAdapters1(0, &adapter) != DXGI_ERROR_NOT_FOUND) {
+        DXGI_ADAPTER_DESC1 desc;
+        if (SUCCEEDED(adapter->GetDesc1(&desc))) {
+            nvidia = desc.VendorId == NVIDIA_VENDOR_ID;
+        }
+        adapter->Release();
+    }
+    factory->Release();
+    return nvidia;
+}
+
+// The first NVIDIA adapter, or nullptr (caller releases)
+static IDXGIAdapter1* findNvidiaAdapter() {
+    IDXGIFactory1* factory = nullptr;
+    if (FAILED(CreateDXGIFactory1(__uuidof(IDXGIFactory1), (void**)&factory))) {
+        return nullptr;
+    }
+
+    IDXGIAdapter1* found = nullptr;
+    IDXGIAdapter1* adapter = nullptr;
+    for (UINT i = 0; !found && factory->EnumAdapters1(i, &adapter) != DXGI_ERROR_NOT_FOUND; i++) {
+        DXGI_ADAPTER_DESC1 desc;
+        if (SUCCEEDED(adapter->GetDesc1(&desc)) && desc.VendorId == NVIDIA_VENDOR_ID) {
+            std::wcout << L"[DXGI] Using NVIDIA adapter: " << desc.Description << std::endl;
+            found = adapter;
+        } else {
+            adapter->Release();
+        }
+    }
+    factory->Release();
+    return found;
+}
+
+static HRESULT createDevice(IDXGIAdapter1* adapter, UINT flags) {
+    D3D_FEATURE_LEVEL featureLevels[] = {
+        D3D_FEATURE_LEVEL_11_1,
+        D3D_FEATURE_LEVEL_11_0,
+        D3D_FEATURE_LEVEL_10_1,
+        D3D_FEATURE_LEVEL_10_0
+    };
+
+    return D3D11CreateDevice(
+        adapter,
+        adapter ? D3D_DRIVER_TYPE_UNKNOWN : D3D_DRIVER_TYPE_HARDWARE,  // Must be UNKNOWN when specifying adapter
+        nullptr,
+        flags,
+        featureLevels,
+        ARRAYSIZE(featureLevels),
+        D3D11_SDK_VERSION,
+        &g_d3dDevice,
+        nullptr,
+        &g_d3dContext
+    );
+}
+
+static bool createSharedDevice(AdapterPreference preference) {
+    IDXGIAdapter1* adapter = nullptr;
+    if (preference == AdapterPreference::NVIDIA) {
+        adapter = findNvidiaAdapter();
+        if (!adapter) {
+            std::cerr << "[DXGI] NVIDIA adapter not found, using default" << std::endl;
+        }
+    }
+
+    UINT flags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
+#ifdef _DEBUG
+    flags |= D3D11_CREATE_DEVICE_DEBUG;
+#endif
+
+    // Video support lets mpv's d3d11va decoder (ANGLE route) and the planar
+    // export video processor run on this device; not every driver offers it
+    HRESULT hr = createDevice(adapter, flags | D3D11_CREATE_DEVICE_VIDEO_SUPPORT);
+    if (FAILED(hr)) {
+        hr = createDevice(adapter, flags);
+    }
+    if (adapter) {
+        adapter->Release();
+    }
+
+    if (FAILED(hr)) {
+        std::cerr << "[DXGI] Failed to create D3D11 device: " << std::hex << hr << std::endl;
+        return false;
+    }
+
+    // Render threads of different players submit concurrently
+    ID3D10Multithread* multithread = nullptr;
+    if (SUCCEEDED(g_d3dDevice->QueryInterface(__uuidof(ID3D10Multithread), (void**)&multithread))) {
+        multithread->SetMultithreadProtected(TRUE);
+        multithread->Release();
+    }
+
+    std::cout << "[DXGI] Created shared D3D11 device" << std::endl;
+    return true;
+}
+
+static void destroySharedDevice() {
+    if (g_d3dContext) {
+        g_d3dContext->Release();
+        g_d3dContext = nullptr;
+    }
+    if (g_d3dDevice) {
+        g_d3dDevice->Release();
+        g_d3dDevice = nullptr;
+    }
+}
+
+bool acquireD3DDevice(AdapterPreference preference, ID3D11Device** device, ID3D11DeviceContext** context) {
+    std::lock_guard<std::mutex> lock(g_deviceMutex);
+    if (g_deviceRefs == 0 && !createSharedDevice(preference)) {
+        destroySharedDevice();
+        return false;
+    }
+    g_deviceRefs++;
+    *device = g_d3dDevice;
+    *context = g_d3dContext;
+    return true;
+}
+
+void releaseD3DDevice() {
+    std::lock_guard<std::mutex> lock(g_deviceMutex);
+    if (g_deviceRefs == 0 || --g_deviceRefs > 0) {
+        return;
+    }
+    destroySharedDevice();
+}
+
+} // namespace mpv_texture
+
+#endif // _WIN32
@@ -0,0 +1,36 @@
+/*
+ * Process-wide D3D11 device shared by every player
+ *
+ * On the ANGLE route the GL share group renders on this device directly; on
+ * the WGL route it is the device WGL_NV_DX_interop maps GL textures onto.
+ * Reference counted: created by the first user, released by the last.
+ */
+
+#ifndef D3D_DEVICE_H_
+#define D3D_DEVICE_H_
+
+#ifdef _WIN32
+
+#include <d3d11.h>
+
+namespace mpv_texture {
+
+enum class AdapterPreference {
+    Default,    // DXGI adapter 0, the one Chromium composites on
+    NVIDIA      // WGL_NV_DX_interop needs D3D and GL on the same NVIDIA GPU
+};
+
+// True if DXGI adapter 0 is an NVIDIA GPU
+bool isDefaultAdapterNvidia();
+
+// Take a reference to the shared device, creating it on first use. The
+// preference only applies to the call that creates the device. The returned
+// pointers are borrowed and stay valid until the matching releaseD3DDevice().
+bool acquireD3DDevice(AdapterPreference preference, ID3D11Device** device, ID3D11DeviceContext** context);
+void releaseD3DDevice();
+
+} // namespace mpv_texture
+
+#endif // _WIN32
+
+#endif // D3D_DEVICE_H_
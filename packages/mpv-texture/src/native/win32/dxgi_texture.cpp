@@ -1,26 +1,38 @@
 /*
- * REFERENCE CODE — NOT CURRENTLY COMPILED
- *
- * Windows DXGI texture sharing implementation using WGL_NV_DX_interop.
+ * Windows DXGI texture sharing implementation
  * Triple-buffered: mpv writes to one texture while Electron reads another.
+ * Producer/consumer access is serialized with each texture's keyed mutex and
+ * a texture is only rewritten after Electron has released it.
+ *
+ * GL reaches the shared D3D11 textures one of two ways, following the route
+ * GLContext picked for the share group:
+ *   - ANGLE: each texture is wrapped in an EGLImage on ANGLE's own D3D11
+ *     device (EGL_ANGLE_image_d3d11_texture) and mpv renders straight into
+ *     it. Works on any D3D11 GPU (Intel / AMD iGPUs included).
+ *   - WGL: desktop GL with WGL_NV_DX_interop registrations, reliable on NVIDIA.
  *
- * Kept as reference for future Windows native mpv porting.
- * Currently, Windows uses external mpv via --wid flag (see main.ts).
- * This file is excluded from the build — binding.gyp compiles stub.cpp
- * on non-macOS platforms.
+ * NV12 / P010 export: mpv renders into one intermediate RGB texture, and the
+ * D3D11 video processor converts it into the shared planar texture of the
+ * slot being exported (VideoProcessorBlt).
  *
- * To activate: add to binding.gyp OS=='win' condition and provide
- * mpv dev libraries via scripts/setup-mpv-win.ps1.
+ * Requires the mpv dev libraries from scripts/setup-mpv-win.ps1.
  */
 
 #ifdef _WIN32
 
 #include "../texture_share.h"
+#include "../gl_context.h"
+#include "../slot_tracker.h"
+#include "../surface_pool.h"
+#include "angle_egl.h"
+#include "d3d_device.h"
 #include <windows.h>
 #include <d3d11.h>
+#include <d3d11_1.h>  // For ID3D11VideoContext1 (DXGI color spaces, HDR)
 #include <dxgi.h>
 #include <dxgi1_2.h>  // For IDXGIResource1 (NT shared handles)
 #include <gl/GL.h>
+#include <array>
 #include <iostream>
 
 // WGL_NV_DX_interop extension functions
@@ -42,6 +54,9 @@ typedef GLenum(APIENTRY* PFNGLCHECKFRAMEBUFFERSTATUSPROC)(GLenum);
 typedef void(APIENTRY* PFNGLGENTEXTURESPROC)(GLsizei, GLuint*);
 typedef void(APIENTRY* PFNGLDELETETEXTURESPROC)(GLsizei, const GLuint*);
 typedef void(APIENTRY* PFNGLBINDTEXTUREPROC)(GLenum, GLuint);
+typedef void(APIENTRY* PFNGLTEXIMAGE2DPROC)(GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const void*);
+typedef void(APIENTRY* PFNGLFLUSHPROC)(void);
+typedef void(APIENTRY* PFNGLEGLIMAGETARGETTEXTURE2DOESPROC)(GLenum, void*);
 
 // OpenGL constants
 #define GL_FRAMEBUFFER 0x8D40
@@ -49,6 +64,8 @@ typedef void(APIENTRY* PFNGLBINDTEXTUREPROC)(GLenum, GLuint);
 #define GL_FRAMEBUFFER_COMPLETE 0x8CD5
 #define GL_TEXTURE_2D 0x0DE1
 #define GL_RGBA8 0x8058
+#define GL_RGB10_A2 0x8059
+#define GL_UNSIGNED_INT_2_10_10_10_REV 0x8368
 #define GL_RGBA 0x1908
 #define GL_UNSIGNED_BYTE 0x1401
 
@@ -61,180 +78,201 @@ namespace mpv_texture {
 
 static const int BUFFER_COUNT = 3;
 
+// Keyed mutex key shared with Chromium's shared-image import, which acquires
+// and releases key 0 around its own access
+static const UINT64 KEYED_MUTEX_KEY = 0;
+
+// Bound the wait for the consumer to hand a texture back
+static const DWORD KEYED_MUTEX_TIMEOUT_MS = 100;
+
+// GL side of a D3D11 texture mpv renders into
+struct GLTarget {
+    GLuint texture = 0;
+    GLuint fbo = 0;
+    HANDLE wglDxObject = nullptr;   // WGL route: interop registration
+    EGLImage eglImage = nullptr;    // ANGLE route: image over the D3D11 texture
+};
+
 // Per-texture resources for triple buffering
 struct TextureSlot {
     ID3D11Texture2D* d3dTexture = nullptr;
     IDXGIKeyedMutex* keyedMutex = nullptr;
     HANDLE sharedHandle = nullptr;
-    GLuint glTexture = 0;
-    GLuint glFBO = 0;
-    HANDLE wglDxObject = nullptr;
+    GLTarget gl;
+    // Planar formats: no GL side, the video processor writes through this view
+    ID3D11VideoProcessorOutputView* outputView = nullptr;
 };
 
+using TextureSet = std::array<TextureSlot, BUFFER_COUNT>;
+
 class DXGITextureShare : public ITextureShare {
 public:
     DXGITextureShare() = default;
     ~DXGITextureShare() override { destroy(); }
 
     bool initialize(void* gl_context) override {
-        m_hglrc = static_cast<HGLRC>(gl_context);
+        m_angle = GLContext::isANGLE();
+
+        if (m_angle) {
+            m_egl = loadAngleEGL();
+            m_eglDisplay = GLContext::eglDisplay();
+            m_glEGLImageTargetTexture2DOES = reinterpret_cast<PFNGLEGLIMAGETARGETTEXTURE2DOESPROC>(
+                GLContext::getProcAddress("glEGLImageTargetTexture2DOES"));
+            if (!m_egl || !m_eglDisplay || !m_glEGLImageTargetTexture2DOES) {
+                std::cerr << "[DXGI] ANGLE D3D11 texture import unavailable" << std::endl;
+                return false;
+            }
+        } else {
+            m_hglrc = static_cast<HGLRC>(gl_context);
 
-        // Load WGL extension functions
-        if (!loadWGLExtensions()) {
-            std::cerr << "[DXGI] Failed to load WGL_NV_DX_interop extension" << std::endl;
-            return false;
+            // Load WGL extension functions
+            if (!loadWGLExtensions()) {
+                std::cerr << "[DXGI] Failed to load WGL_NV_DX_interop extension" << std::endl;
+                return false;
+            }
         }
 
-        // Load OpenGL extension functions
+        // Load OpenGL functions (from ANGLE or opengl32, whichever is current)
         if (!loadGLExtensions()) {
             std::cerr << "[DXGI] Failed to load OpenGL extensions" << std::endl;
             return false;
         }
 
-        // Create D3D11 device on the NVIDIA adapter (required for WGL_NV_DX_interop)
-        D3D_FEATURE_LEVEL featureLevels[] = {
-            D3D_FEATURE_LEVEL_11_1,
-            D3D_FEATURE_LEVEL_11_0,
-            D3D_FEATURE_LEVEL_10_1,
-            D3D_FEATURE_LEVEL_10_0
-        };
-
-        UINT flags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
-#ifdef _DEBUG
-        flags |= D3D11_CREATE_DEVICE_DEBUG;
-#endif
-
-        // Enumerate adapters to find NVIDIA GPU
-        IDXGIFactory1* factory = nullptr;
-        IDXGIAdapter1* nvidiaAdapter = nullptr;
-        HRESULT hr = CreateDXGIFactory1(__uuidof(IDXGIFactory1), (void**)&factory);
-
-        if (SUCCEEDED(hr)) {
-            IDXGIAdapter1* adapter = nullptr;
-            for (UINT i = 0; factory->EnumAdapters1(i, &adapter) != DXGI_ERROR_NOT_FOUND; i++) {
-                DXGI_ADAPTER_DESC1 desc;
-                adapter->GetDesc1(&desc);
-
-                // Check for NVIDIA in the description
-                std::wstring descStr(desc.Description);
-                if (descStr.find(L"NVIDIA") != std::wstring::npos) {
-                    nvidiaAdapter = adapter;
-                    std::wcout << L"[DXGI] Using NVIDIA adapter: " << desc.Description << std::endl;
-                    break;
-                }
-                adapter->Release();
-            }
-            factory->Release();
-        }
-
-        // Create device on NVIDIA adapter, or fall back to default
-        if (nvidiaAdapter) {
-            hr = D3D11CreateDevice(
-                nvidiaAdapter,
-                D3D_DRIVER_TYPE_UNKNOWN,  // Must be UNKNOWN when specifying adapter
-                nullptr,
-                flags,
-                featureLevels,
-                ARRAYSIZE(featureLevels),
-                D3D11_SDK_VERSION,
-                &m_d3dDevice,
-                nullptr,
-                &m_d3dContext
-            );
-            nvidiaAdapter->Release();
-        } else {
-            std::cerr << "[DXGI] NVIDIA adapter not found, using default" << std::endl;
-            hr = D3D11CreateDevice(
-                nullptr,
-                D3D_DRIVER_TYPE_HARDWARE,
-                nullptr,
-                flags,
-                featureLevels,
-                ARRAYSIZE(featureLevels),
-                D3D11_SDK_VERSION,
-                &m_d3dDevice,
-                nullptr,
-                &m_d3dContext
-            );
-        }
-
-        if (FAILED(hr)) {
-            std::cerr << "[DXGI] Failed to create D3D11 device: " << std::hex << hr << std::endl;
+        // All players render through one D3D11 device. On the ANGLE route
+        // GLContext created it and ANGLE renders on it.
+        if (!acquireD3DDevice(AdapterPreference::NVIDIA, &m_d3dDevice, &m_d3dContext)) {
             return false;
         }
 
-        // Open WGL/DX interop device
-        m_wglDxDevice = m_wglDXOpenDeviceNV(m_d3dDevice);
-        if (!m_wglDxDevice) {
-            std::cerr << "[DXGI] Failed to open WGL/DX interop device" << std::endl;
-            return false;
+        if (!m_angle) {
+            // Open WGL/DX interop device
+            m_wglDxDevice = m_wglDXOpenDeviceNV(m_d3dDevice);
+            if (!m_wglDxDevice) {
+                std::cerr << "[DXGI] Failed to open WGL/DX interop device" << std::endl;
+                return false;
+            }
         }
 
+        std::cout << "[DXGI] Rendering through " << (m_angle ? "ANGLE (D3D11)" : "WGL_NV_DX_interop") << std::endl;
         m_initialized = true;
         return true;
     }
 
-    bool createTexture(uint32_t width, uint32_t height) override {
+    bool createTexture(uint32_t width, uint32_t height, TextureFormat format) override {
         if (!m_initialized) return false;
 
-        m_width = width;
-        m_height = height;
+        format = nativeFormat(format);
+        // Planar output views are created against the converter's enumerator
+        if (isPlanar(format) && !prepareConverter(width, height, format)) {
+            return false;
+        }
 
         for (int i = 0; i < BUFFER_COUNT; i++) {
-            if (!createSlot(m_slots[i], width, height)) {
-                // Clean up any slots already created
-                for (int j = 0; j < i; j++) {
+            if (!createSlot(m_slots[i], width, height, format)) {
+                // Clean up any slots already created (and the partial one)
+                for (int j = 0; j <= i; j++) {
                     destroySlot(m_slots[j]);
                 }
                 return false;
             }
         }
 
-        m_writeIndex = 0;
-        std::cout << "[DXGI] Created " << BUFFER_COUNT << " triple-buffered textures "
-                  << width << "x" << height << std::endl;
+        if (!bindSlots(width, height, format)) {
+            destroySet(m_slots);
+            return false;
+        }
+        std::cout << "[DXGI] Created " << BUFFER_COUNT << " triple-buffered " << formatName(format)
+                  << " textures " << width << "x" << height << std::endl;
         return true;
     }
 
-    bool resizeTexture(uint32_t width, uint32_t height) override {
-        if (width == m_width && height == m_height) {
+    bool resizeTexture(uint32_t width, uint32_t height, TextureFormat format) override {
+        format = nativeFormat(format);
+        if (width == m_width && height == m_height && format == m_format) {
             return true;
         }
 
-        // Destroy all slots and recreate
-        for (int i = 0; i < BUFFER_COUNT; i++) {
-            destroySlot(m_slots[i]);
+        // Park the outgoing set (textures, FBOs, GL bindings) instead
+        // of tearing it down; slots Electron still holds stay owned by it
+        // until released
+        if (m_locked) {
+            unlockSlot(m_slots[m_writeIndex]);
+        }
+        m_tracker.park();
+        if (m_slots[0].d3dTexture) {
+            m_pool.put(SurfaceKey{m_width, m_height, m_format},
+                       setBytes(m_width, m_height, m_format), std::move(m_slots),
+                       [this](TextureSet& set) { destroySet(set); });
+        }
+        m_slots = TextureSet{};
+        // Nothing bound until a set is: a failed resize must not look current
+        m_width = 0;
+        m_height = 0;
+
+        if (m_pool.take(SurfaceKey{width, height, format}, m_slots)) {
+            if (bindSlots(width, height, format)) {
+                std::cout << "[DXGI] Reused pooled " << formatName(format) << " textures "
+                          << width << "x" << height << std::endl;
+                return true;
+            }
+            destroySet(m_slots);
         }
 
-        return createTexture(width, height);
+        return createTexture(width, height, format);
+    }
+
+    void setPoolBudget(uint64_t bytes) override {
+        m_pool.setBudget(bytes);
     }
 
     uint32_t getGLTexture() const override {
-        return m_slots[m_writeIndex].glTexture;
+        // Planar formats: mpv renders RGB into the converter's input
+        return renderTarget(m_slots[m_writeIndex]).texture;
     }
 
     uint32_t getGLFBO() const override {
-        return m_slots[m_writeIndex].glFBO;
+        return renderTarget(m_slots[m_writeIndex]).fbo;
+    }
+
+    uint32_t getGLInternalFormat() const override {
+        return m_format == TextureFormat::P010 ? GL_RGB10_A2 : GL_RGBA8;
     }
 
     bool lockTexture() override {
-        auto& slot = m_slots[m_writeIndex];
-        if (!slot.wglDxObject) {
+        if (m_locked) {
+            return true;
+        }
+
+        // Only textures Electron has released are eligible
+        int index = m_tracker.acquire(m_lastExported);
+        if (index < 0) {
+            return false;
+        }
+
+        auto& slot = m_slots[index];
+        const GLTarget& target = renderTarget(slot);
+        if (!target.fbo || !slot.keyedMutex) {
             std::cerr << "[DXGI] lockTexture: No DX object" << std::endl;
+            m_tracker.abandon(index);
             return false;
         }
 
-        if (m_locked) {
-            return true;
+        // Take the texture back from the consumer. AcquireSync returns
+        // WAIT_TIMEOUT / WAIT_ABANDONED as success codes, so compare to S_OK.
+        HRESULT hr = slot.keyedMutex->AcquireSync(KEYED_MUTEX_KEY, KEYED_MUTEX_TIMEOUT_MS);
+        if (hr != S_OK) {
+            std::cerr << "[DXGI] AcquireSync failed: " << std::hex << hr << std::endl;
+            m_tracker.abandon(index);
+            return false;
         }
 
-        HANDLE objects[] = { slot.wglDxObject };
-        if (!m_wglDXLockObjectsNV(m_wglDxDevice, 1, objects)) {
-            DWORD err = GetLastError();
-            std::cerr << "[DXGI] Failed to lock DX object, error: " << err << std::endl;
+        if (!beginGL(target)) {
+            slot.keyedMutex->ReleaseSync(KEYED_MUTEX_KEY);
+            m_tracker.abandon(index);
             return false;
         }
 
+        m_writeIndex = index;
         m_locked = true;
         return true;
     }
@@ -247,73 +285,153 @@ public:
         }
 
         auto& slot = m_slots[m_writeIndex];
-
-        // Unlock via WGL interop
-        HANDLE objects[] = { slot.wglDxObject };
-        if (!m_wglDXUnlockObjectsNV(m_wglDxDevice, 1, objects)) {
-            std::cerr << "[DXGI] Failed to unlock DX object" << std::endl;
+        if (isPlanar(m_format)) {
+            // GL is done with the RGB render once it is unlocked / flushed;
+            // convert into the slot while we still hold its keyed mutex
+            unlockInterop(slot);
+            bool converted = convertPlanes(slot);
+            slot.keyedMutex->ReleaseSync(KEYED_MUTEX_KEY);
+            if (!converted) {
+                m_tracker.abandon(m_writeIndex);
+                return info;
+            }
+        } else {
+            unlockSlot(slot);
         }
 
-        m_locked = false;
-
         // Export this slot's handle
         info.handle = reinterpret_cast<uint64_t>(slot.sharedHandle);
         info.width = m_width;
         info.height = m_height;
-        info.format = TextureFormat::RGBA8;
+        info.format = m_format;
         info.is_valid = true;
 
-        // Swap to other buffer for next frame
-        m_writeIndex = (m_writeIndex + 1) % BUFFER_COUNT;
+        info.generation = m_tracker.markExported(m_writeIndex);
+        m_lastExported = m_writeIndex;
 
         return info;
     }
 
-    void releaseTexture() override {
-        // No-op with triple buffering - mpv always has a free slot to write to
+    void abandonTexture() override {
+        if (!m_locked) return;
+        unlockSlot(m_slots[m_writeIndex]);
+        m_tracker.abandon(m_writeIndex);
+    }
+
+    bool waitForExport(const TextureInfo& info, uint64_t timeoutNs) override {
+        // ReleaseSync already orders our GPU work before the consumer's
+        // AcquireSync — nothing to wait for on the CPU
+        (void)info;
+        (void)timeoutNs;
+        return true;
+    }
+
+    void releaseTexture(uint64_t handle, uint64_t generation) override {
+        // Called from the JS thread — only flips slot ownership
+        m_tracker.release(handle, generation);
     }
 
     void destroy() override {
         if (m_locked) {
-            auto& slot = m_slots[m_writeIndex];
-            if (slot.wglDxObject) {
-                HANDLE objects[] = { slot.wglDxObject };
-                m_wglDXUnlockObjectsNV(m_wglDxDevice, 1, objects);
-            }
-            m_locked = false;
+            unlockSlot(m_slots[m_writeIndex]);
         }
+        m_tracker.clear();
 
-        for (int i = 0; i < BUFFER_COUNT; i++) {
-            destroySlot(m_slots[i]);
-        }
+        // Interop registrations must go before the interop device
+        destroySet(m_slots);
+        m_pool.clear([this](TextureSet& set) { destroySet(set); });
+        destroyConverter();
 
         if (m_wglDxDevice) {
             m_wglDXCloseDeviceNV(m_wglDxDevice);
             m_wglDxDevice = nullptr;
         }
 
-        if (m_d3dContext) {
-            m_d3dContext->Release();
-            m_d3dContext = nullptr;
-        }
-
         if (m_d3dDevice) {
-            m_d3dDevice->Release();
+            releaseD3DDevice();
             m_d3dDevice = nullptr;
+            m_d3dContext = nullptr;
         }
 
         m_initialized = false;
     }
 
 private:
-    bool createSlot(TextureSlot& slot, uint32_t width, uint32_t height) {
+    // Packed requests map to the RGBA textures Chromium imports
+    static TextureFormat nativeFormat(TextureFormat format) {
+        return isPlanar(format) ? format : TextureFormat::RGBA8;
+    }
+
+    static const char* formatName(TextureFormat format) {
+        switch (format) {
+            case TextureFormat::NV12: return "NV12";
+            case TextureFormat::P010: return "P010";
+            default: return "RGBA";
+        }
+    }
+
+    static uint64_t setBytes(uint32_t width, uint32_t height, TextureFormat format) {
+        uint64_t pixels = static_cast<uint64_t>(width) * height;
+        switch (format) {
+            case TextureFormat::NV12: return pixels * 3 / 2 * BUFFER_COUNT;
+            case TextureFormat::P010: return pixels * 3 * BUFFER_COUNT;
+            default: return pixels * 4 * BUFFER_COUNT;
+        }
+    }
+
+    // What mpv renders through: the slot itself, or the converter input
+    const GLTarget& renderTarget(const TextureSlot& slot) const {
+        return isPlanar(m_format) ? m_convert.gl : slot.gl;
+    }
+
+    // Make m_slots the active set: handles known to the tracker, slots free
+    // unless Electron still holds them from before the set was parked
+    bool bindSlots(uint32_t width, uint32_t height, TextureFormat format) {
+        if (isPlanar(format)) {
+            if (!prepareConverter(width, height, format)) {
+                return false;
+            }
+        } else {
+            destroyConverterTarget();
+        }
+
+        m_width = width;
+        m_height = height;
+        m_format = format;
+
+        uint64_t handles[BUFFER_COUNT];
+        for (int i = 0; i < BUFFER_COUNT; i++) {
+            handles[i] = reinterpret_cast<uint64_t>(m_slots[i].sharedHandle);
+        }
+        m_tracker.reset(handles);
+
+        m_writeIndex = 0;
+        m_lastExported = BUFFER_COUNT - 1;
+        return true;
+    }
+
+    // End GL access to the render target (hands GL's writes to D3D)
+    void unlockInterop(TextureSlot& slot) {
+        endGL(renderTarget(slot));
+        m_locked = false;
+    }
+
+    // End GL access, then hand the keyed mutex to the consumer
+    void unlockSlot(TextureSlot& slot) {
+        unlockInterop(slot);
+        if (slot.keyedMutex) {
+            slot.keyedMutex->ReleaseSync(KEYED_MUTEX_KEY);
+        }
+    }
+
+    bool createSlot(TextureSlot& slot, uint32_t width, uint32_t height, TextureFormat format) {
         // Create D3D11 texture with NT shared handle (required for Electron's importSharedTexture)
         D3D11_TEXTURE2D_DESC desc = {};
         desc.Width = width;
         desc.Height = height;
         desc.MipLevels = 1;
         desc.ArraySize = 1;
-        desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        desc.Format = dxgiFormat(format);
         desc.SampleDesc.Count = 1;
         desc.Usage = D3D11_USAGE_DEFAULT;
         desc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
@@ -352,9 +470,22 @@ private:
             return false;
         }
 
+        if (isPlanar(format)) {
+            // Written by the video processor only — no GL registration
+            D3D11_VIDEO_PROCESSOR_OUTPUT_VIEW_DESC viewDesc = {};
+            viewDesc.ViewDimension = D3D11_VPOV_DIMENSION_TEXTURE2D;
+            hr = m_convert.videoDevice->CreateVideoProcessorOutputView(
+                slot.d3dTexture, m_convert.enumerator, &viewDesc, &slot.outputView);
+            if (FAILED(hr)) {
+                std::cerr << "[DXGI] Failed to create video processor output view: " << std::hex << hr << std::endl;
+                return false;
+            }
+            return true;
+        }
+
         // Set the share handle on the D3D resource BEFORE registering with WGL
         // Required by WGL_NV_DX_interop spec for shared resources
-        if (m_wglDXSetResourceShareHandleNV) {
+        if (!m_angle && m_wglDXSetResourceShareHandleNV) {
             if (!m_wglDXSetResourceShareHandleNV(slot.d3dTexture, slot.sharedHandle)) {
                 DWORD err = GetLastError();
                 std::cerr << "[DXGI] Failed to set share handle, error: " << err << std::endl;
@@ -362,65 +493,128 @@ private:
             }
         }
 
-        // Create OpenGL texture
-        glGenTextures(1, &slot.glTexture);
-        glBindTexture(GL_TEXTURE_2D, slot.glTexture);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-
-        // Register D3D texture with OpenGL via WGL_NV_DX_interop
-        slot.wglDxObject = m_wglDXRegisterObjectNV(
-            m_wglDxDevice,
-            slot.d3dTexture,
-            slot.glTexture,
-            GL_TEXTURE_2D,
-            WGL_ACCESS_WRITE_DISCARD_NV
-        );
-
-        if (!slot.wglDxObject) {
-            DWORD err = GetLastError();
-            std::cerr << "[DXGI] Failed to register DX object with WGL, error: " << err << std::endl;
+        // FBO setup happens under the keyed mutex — the texture is a keyed-mutex resource
+        if (slot.keyedMutex->AcquireSync(KEYED_MUTEX_KEY, KEYED_MUTEX_TIMEOUT_MS) != S_OK) {
+            std::cerr << "[DXGI] Failed to acquire keyed mutex for FBO setup" << std::endl;
             return false;
         }
+        bool attached = attachGL(slot.d3dTexture, width, height, false, slot.gl);
+        slot.keyedMutex->ReleaseSync(KEYED_MUTEX_KEY);
+        return attached;
+    }
 
-        // Lock for FBO setup
-        HANDLE objects[] = { slot.wglDxObject };
-        if (!m_wglDXLockObjectsNV(m_wglDxDevice, 1, objects)) {
-            std::cerr << "[DXGI] Failed to lock DX object for FBO setup" << std::endl;
+    // Wrap a D3D11 texture for GL and build an FBO on it. ANGLE: an EGLImage
+    // over the texture, no copy. WGL: a GL texture registered for interop.
+    bool attachGL(ID3D11Texture2D* texture, uint32_t width, uint32_t height, bool tenBit, GLTarget& target) {
+        m_glGenTextures(1, &target.texture);
+        m_glBindTexture(GL_TEXTURE_2D, target.texture);
+
+        if (m_angle) {
+            const EGLint attributes[] = { EGL_NONE };
+            target.eglImage = m_egl->createImageKHR(m_eglDisplay, nullptr, EGL_D3D11_TEXTURE_ANGLE,
+                                                    static_cast<EGLClientBuffer>(texture), attributes);
+            if (!target.eglImage) {
+                std::cerr << "[DXGI] Failed to create EGLImage for D3D11 texture: "
+                          << std::hex << m_egl->getError() << std::endl;
+                return false;
+            }
+            m_glEGLImageTargetTexture2DOES(GL_TEXTURE_2D, target.eglImage);
+        } else {
+            m_glTexImage2D(GL_TEXTURE_2D, 0, tenBit ? GL_RGB10_A2 : GL_RGBA8, width, height, 0, GL_RGBA,
+                           tenBit ? GL_UNSIGNED_INT_2_10_10_10_REV : GL_UNSIGNED_BYTE, nullptr);
+
+            // Register D3D texture with OpenGL via WGL_NV_DX_interop
+            target.wglDxObject = m_wglDXRegisterObjectNV(
+                m_wglDxDevice,
+                texture,
+                target.texture,
+                GL_TEXTURE_2D,
+                WGL_ACCESS_WRITE_DISCARD_NV
+            );
+            if (!target.wglDxObject) {
+                DWORD err = GetLastError();
+                std::cerr << "[DXGI] Failed to register DX object with WGL, error: " << err << std::endl;
+                return false;
+            }
+        }
+
+        if (!beginGL(target)) {
             return false;
         }
 
         // Create FBO
-        m_glGenFramebuffers(1, &slot.glFBO);
-        m_glBindFramebuffer(GL_FRAMEBUFFER, slot.glFBO);
-        m_glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, slot.glTexture, 0);
+        m_glGenFramebuffers(1, &target.fbo);
+        m_glBindFramebuffer(GL_FRAMEBUFFER, target.fbo);
+        m_glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.texture, 0);
 
         GLenum status = m_glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        m_glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-        // Unlock after FBO setup
-        m_wglDXUnlockObjectsNV(m_wglDxDevice, 1, objects);
+        endGL(target);
 
         if (status != GL_FRAMEBUFFER_COMPLETE) {
             std::cerr << "[DXGI] FBO incomplete: " << std::hex << status << std::endl;
             return false;
         }
+        return true;
+    }
 
-        m_glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    // Start GL access to a target (WGL: take the interop lock)
+    bool beginGL(const GLTarget& target) {
+        if (m_angle) {
+            // Same D3D11 device: nothing to lock
+            return true;
+        }
+        HANDLE objects[] = { target.wglDxObject };
+        if (!m_wglDXLockObjectsNV(m_wglDxDevice, 1, objects)) {
+            DWORD err = GetLastError();
+            std::cerr << "[DXGI] Failed to lock DX object, error: " << err << std::endl;
+            return false;
+        }
         return true;
     }
 
-    void destroySlot(TextureSlot& slot) {
-        if (slot.wglDxObject) {
-            m_wglDXUnregisterObjectNV(m_wglDxDevice, slot.wglDxObject);
-            slot.wglDxObject = nullptr;
+    // End GL access to a target. ANGLE: flush so its D3D11 work is submitted
+    // before the keyed mutex is released or the video processor reads it.
+    // WGL: drop the interop lock (flushes GL's writes for D3D).
+    void endGL(const GLTarget& target) {
+        if (m_angle) {
+            m_glFlush();
+            return;
+        }
+        if (target.wglDxObject) {
+            HANDLE objects[] = { target.wglDxObject };
+            if (!m_wglDXUnlockObjectsNV(m_wglDxDevice, 1, objects)) {
+                std::cerr << "[DXGI] Failed to unlock DX object" << std::endl;
+            }
+        }
+    }
+
+    void detachGL(GLTarget& target) {
+        if (target.wglDxObject) {
+            m_wglDXUnregisterObjectNV(m_wglDxDevice, target.wglDxObject);
+            target.wglDxObject = nullptr;
         }
-        if (slot.glFBO) {
-            m_glDeleteFramebuffers(1, &slot.glFBO);
-            slot.glFBO = 0;
+        if (target.fbo) {
+            m_glDeleteFramebuffers(1, &target.fbo);
+            target.fbo = 0;
         }
-        if (slot.glTexture) {
-            glDeleteTextures(1, &slot.glTexture);
-            slot.glTexture = 0;
+        if (target.texture) {
+            m_glDeleteTextures(1, &target.texture);
+            target.texture = 0;
         }
+        if (target.eglImage) {
+            m_egl->destroyImageKHR(m_eglDisplay, target.eglImage);
+            target.eglImage = nullptr;
+        }
+    }
+
+    void destroySlot(TextureSlot& slot) {
+        if (slot.outputView) {
+            slot.outputView->Release();
+            slot.outputView = nullptr;
+        }
+        detachGL(slot.gl);
         if (slot.keyedMutex) {
             slot.keyedMutex->Release();
             slot.keyedMutex = nullptr;
@@ -435,6 +629,205 @@ private:
         }
     }
 
+    void destroySet(TextureSet& set) {
+        for (auto& slot : set) {
+            // The handle value may be reused once closed
+            m_tracker.forget(reinterpret_cast<uint64_t>(slot.sharedHandle));
+            destroySlot(slot);
+        }
+    }
+
+    static DXGI_FORMAT dxgiFormat(TextureFormat format) {
+        switch (format) {
+            case TextureFormat::NV12: return DXGI_FORMAT_NV12;
+            case TextureFormat::P010: return DXGI_FORMAT_P010;
+            default: return DXGI_FORMAT_R8G8B8A8_UNORM;
+        }
+    }
+
+    // Video processor, RGB input texture (GL interop) and input view for a
+    // planar set of this size and format
+    bool prepareConverter(uint32_t width, uint32_t height, TextureFormat format) {
+        if (m_convert.processor && m_convert.width == width && m_convert.height == height &&
+            m_convert.format == format) {
+            return true;
+        }
+        destroyConverterTarget();
+
+        if (!m_convert.videoDevice) {
+            HRESULT hr = m_d3dDevice->QueryInterface(__uuidof(ID3D11VideoDevice), (void**)&m_convert.videoDevice);
+            if (SUCCEEDED(hr)) {
+                hr = m_d3dContext->QueryInterface(__uuidof(ID3D11VideoContext), (void**)&m_convert.videoContext);
+            }
+            if (FAILED(hr)) {
+                std::cerr << "[DXGI] D3D11 video processing unavailable: " << std::hex << hr << std::endl;
+                destroyConverter();
+                return false;
+            }
+        }
+
+        D3D11_VIDEO_PROCESSOR_CONTENT_DESC content = {};
+        content.InputFrameFormat = D3D11_VIDEO_FRAME_FORMAT_PROGRESSIVE;
+        content.InputWidth = width;
+        content.InputHeight = height;
+        content.OutputWidth = width;
+        content.OutputHeight = height;
+        content.Usage = D3D11_VIDEO_USAGE_PLAYBACK_NORMAL;
+
+        HRESULT hr = m_convert.videoDevice->CreateVideoProcessorEnumerator(&content, &m_convert.enumerator);
+        if (FAILED(hr)) {
+            std::cerr << "[DXGI] Failed to create video processor enumerator: " << std::hex << hr << std::endl;
+            return false;
+        }
+
+        // 10-bit RGB in for P010 so the conversion keeps the extra precision
+        DXGI_FORMAT inputFormat = format == TextureFormat::P010 ? DXGI_FORMAT_R10G10B10A2_UNORM
+                                                                : DXGI_FORMAT_R8G8B8A8_UNORM;
+        UINT inputSupport = 0;
+        UINT outputSupport = 0;
+        m_convert.enumerator->CheckVideoProcessorFormat(inputFormat, &inputSupport);
+        m_convert.enumerator->CheckVideoProcessorFormat(dxgiFormat(format), &outputSupport);
+        if (!(inputSupport & D3D11_VIDEO_PROCESSOR_FORMAT_SUPPORT_INPUT) ||
+            !(outputSupport & D3D11_VIDEO_PROCESSOR_FORMAT_SUPPORT_OUTPUT)) {
+            std::cerr << "[DXGI] Video processor cannot convert to " << formatName(format) << std::endl;
+            destroyConverterTarget();
+            return false;
+        }
+
+        hr = m_convert.videoDevice->CreateVideoProcessor(m_convert.enumerator, 0, &m_convert.processor);
+        if (FAILED(hr)) {
+            std::cerr << "[DXGI] Failed to create video processor: " << std::hex << hr << std::endl;
+            destroyConverterTarget();
+            return false;
+        }
+
+        if (!setConverterColorSpaces(format)) {
+            destroyConverterTarget();
+            return false;
+        }
+        // Plain conversion: no denoise / edge enhancement behind our back
+        m_convert.videoContext->VideoProcessorSetStreamAutoProcessingMode(m_convert.processor, 0, FALSE);
+
+        D3D11_TEXTURE2D_DESC desc = {};
+        desc.Width = width;
+        desc.Height = height;
+        desc.MipLevels = 1;
+        desc.ArraySize = 1;
+        desc.Format = inputFormat;
+        desc.SampleDesc.Count = 1;
+        desc.Usage = D3D11_USAGE_DEFAULT;
+        desc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+
+        hr = m_d3dDevice->CreateTexture2D(&desc, nullptr, &m_convert.rgbTexture);
+        if (FAILED(hr)) {
+            std::cerr << "[DXGI] Failed to create conversion texture: " << std::hex << hr << std::endl;
+            destroyConverterTarget();
+            return false;
+        }
+
+        D3D11_VIDEO_PROCESSOR_INPUT_VIEW_DESC inputDesc = {};
+        inputDesc.ViewDimension = D3D11_VPIV_DIMENSION_TEXTURE2D;
+        hr = m_convert.videoDevice->CreateVideoProcessorInputView(
+            m_convert.rgbTexture, m_convert.enumerator, &inputDesc, &m_convert.inputView);
+        if (FAILED(hr)) {
+            std::cerr << "[DXGI] Failed to create video processor input view: " << std::hex << hr << std::endl;
+            destroyConverterTarget();
+            return false;
+        }
+
+        // GL side: mpv renders into the conversion texture
+        if (!attachGL(m_convert.rgbTexture, width, height, format == TextureFormat::P010, m_convert.gl)) {
+            destroyConverterTarget();
+            return false;
+        }
+
+        m_convert.width = width;
+        m_convert.height = height;
+        m_convert.format = format;
+        return true;
+    }
+
+    // NV12: BT.709 limited range. P010: BT.2020 limited range; input and output
+    // are both tagged PQ so the processor converts the matrix only and HLG /
+    // SDR signals pass through unchanged as well.
+    bool setConverterColorSpaces(TextureFormat format) {
+        ID3D11VideoContext1* videoContext1 = nullptr;
+        if (SUCCEEDED(m_convert.videoContext->QueryInterface(__uuidof(ID3D11VideoContext1), (void**)&videoContext1))) {
+            bool bt2020 = format == TextureFormat::P010;
+            videoContext1->VideoProcessorSetStreamColorSpace1(
+                m_convert.processor, 0,
+                bt2020 ? DXGI_COLOR_SPACE_RGB_FULL_G2084_NONE_P2020 : DXGI_COLOR_SPACE_RGB_FULL_G22_NONE_P709);
+            videoContext1->VideoProcessorSetOutputColorSpace1(
+                m_convert.processor,
+                bt2020 ? DXGI_COLOR_SPACE_YCBCR_STUDIO_G2084_LEFT_P2020 : DXGI_COLOR_SPACE_YCBCR_STUDIO_G22_LEFT_P709);
+            videoContext1->Release();
+            return true;
+        }
+
+        if (format == TextureFormat::P010) {
+            std::cerr << "[DXGI] P010 export needs ID3D11VideoContext1" << std::endl;
+            return false;
+        }
+
+        // Pre-11.1 runtime: legacy color space description, BT.709 only
+        D3D11_VIDEO_PROCESSOR_COLOR_SPACE input = {};
+        input.RGB_Range = 0;  // Full range RGB
+        D3D11_VIDEO_PROCESSOR_COLOR_SPACE output = {};
+        output.YCbCr_Matrix = 1;  // BT.709
+        output.Nominal_Range = D3D11_VIDEO_PROCESSOR_NOMINAL_RANGE_16_235;
+        m_convert.videoContext->VideoProcessorSetStreamColorSpace(m_convert.processor, 0, &input);
+        m_convert.videoContext->VideoProcessorSetOutputColorSpace(m_convert.processor, &output);
+        return true;
+    }
+
+    // Convert the RGB render into the slot's planar texture (GPU, async)
+    bool convertPlanes(TextureSlot& slot) {
+        D3D11_VIDEO_PROCESSOR_STREAM stream = {};
+        stream.Enable = TRUE;
+        stream.pInputSurface = m_convert.inputView;
+
+        HRESULT hr = m_convert.videoContext->VideoProcessorBlt(m_convert.processor, slot.outputView, 0, 1, &stream);
+        if (FAILED(hr)) {
+            std::cerr << "[DXGI] VideoProcessorBlt failed: " << std::hex << hr << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void destroyConverterTarget() {
+        detachGL(m_convert.gl);
+        if (m_convert.inputView) {
+            m_convert.inputView->Release();
+            m_convert.inputView = nullptr;
+        }
+        if (m_convert.rgbTexture) {
+            m_convert.rgbTexture->Release();
+            m_convert.rgbTexture = nullptr;
+        }
+        if (m_convert.processor) {
+            m_convert.processor->Release();
+            m_convert.processor = nullptr;
+        }
+        if (m_convert.enumerator) {
+            m_convert.enumerator->Release();
+            m_convert.enumerator = nullptr;
+        }
+        m_convert.width = 0;
+        m_convert.height = 0;
+    }
+
+    void destroyConverter() {
+        destroyConverterTarget();
+        if (m_convert.videoContext) {
+            m_convert.videoContext->Release();
+            m_convert.videoContext = nullptr;
+        }
+        if (m_convert.videoDevice) {
+            m_convert.videoDevice->Release();
+            m_convert.videoDevice = nullptr;
+        }
+    }
+
     bool loadWGLExtensions() {
         // Get wglGetProcAddress
         HMODULE opengl32 = LoadLibraryA("opengl32.dll");
@@ -467,27 +860,25 @@ private:
     }
 
     bool loadGLExtensions() {
-        HMODULE opengl32 = LoadLibraryA("opengl32.dll");
-        if (!opengl32) return false;
-
-        auto wglGetProcAddress = reinterpret_cast<PROC(WINAPI*)(LPCSTR)>(
-            GetProcAddress(opengl32, "wglGetProcAddress"));
-        if (!wglGetProcAddress) return false;
-
-        m_glGenFramebuffers = reinterpret_cast<PFNGLGENFRAMEBUFFERSPROC>(
-            wglGetProcAddress("glGenFramebuffers"));
-        m_glDeleteFramebuffers = reinterpret_cast<PFNGLDELETEFRAMEBUFFERSPROC>(
-            wglGetProcAddress("glDeleteFramebuffers"));
-        m_glBindFramebuffer = reinterpret_cast<PFNGLBINDFRAMEBUFFERPROC>(
-            wglGetProcAddress("glBindFramebuffer"));
-        m_glFramebufferTexture2D = reinterpret_cast<PFNGLFRAMEBUFFERTEXTURE2DPROC>(
-            wglGetProcAddress("glFramebufferTexture2D"));
-        m_glCheckFramebufferStatus = reinterpret_cast<PFNGLCHECKFRAMEBUFFERSTATUSPROC>(
-            wglGetProcAddress("glCheckFramebufferStatus"));
+        auto load = [](const char* name) { return GLContext::getProcAddress(name); };
+
+        m_glGenFramebuffers = reinterpret_cast<PFNGLGENFRAMEBUFFERSPROC>(load("glGenFramebuffers"));
+        m_glDeleteFramebuffers = reinterpret_cast<PFNGLDELETEFRAMEBUFFERSPROC>(load("glDeleteFramebuffers"));
+        m_glBindFramebuffer = reinterpret_cast<PFNGLBINDFRAMEBUFFERPROC>(load("glBindFramebuffer"));
+        m_glFramebufferTexture2D = reinterpret_cast<PFNGLFRAMEBUFFERTEXTURE2DPROC>(load("glFramebufferTexture2D"));
+        m_glCheckFramebufferStatus = reinterpret_cast<PFNGLCHECKFRAMEBUFFERSTATUSPROC>(load("glCheckFramebufferStatus"));
+        // Core 1.1 entry points too: opengl32's exports go nowhere under ANGLE
+        m_glGenTextures = reinterpret_cast<PFNGLGENTEXTURESPROC>(load("glGenTextures"));
+        m_glDeleteTextures = reinterpret_cast<PFNGLDELETETEXTURESPROC>(load("glDeleteTextures"));
+        m_glBindTexture = reinterpret_cast<PFNGLBINDTEXTUREPROC>(load("glBindTexture"));
+        m_glTexImage2D = reinterpret_cast<PFNGLTEXIMAGE2DPROC>(load("glTexImage2D"));
+        m_glFlush = reinterpret_cast<PFNGLFLUSHPROC>(load("glFlush"));
 
         return m_glGenFramebuffers && m_glDeleteFramebuffers &&
                m_glBindFramebuffer && m_glFramebufferTexture2D &&
-               m_glCheckFramebufferStatus;
+               m_glCheckFramebufferStatus && m_glGenTextures &&
+               m_glDeleteTextures && m_glBindTexture &&
+               m_glTexImage2D && m_glFlush;
     }
 
     // State
@@ -495,18 +886,43 @@ private:
     bool m_locked = false;
     uint32_t m_width = 0;
     uint32_t m_height = 0;
+    TextureFormat m_format = TextureFormat::RGBA8;
 
     // Triple-buffered texture slots
-    TextureSlot m_slots[BUFFER_COUNT];
+    TextureSet m_slots;
+    SlotTracker<BUFFER_COUNT> m_tracker;
+
+    // Texture sets of previous resolutions, kept for switch-back
+    SurfacePool<TextureSet> m_pool;
     int m_writeIndex = 0;
+    int m_lastExported = BUFFER_COUNT - 1;
 
-    // D3D11 (shared across slots)
+    // D3D11 (process-wide shared device, see d3d_device.h)
     ID3D11Device* m_d3dDevice = nullptr;
     ID3D11DeviceContext* m_d3dContext = nullptr;
 
+    // Planar export: video processor and the RGB texture mpv renders into
+    struct {
+        ID3D11VideoDevice* videoDevice = nullptr;
+        ID3D11VideoContext* videoContext = nullptr;
+        ID3D11VideoProcessorEnumerator* enumerator = nullptr;
+        ID3D11VideoProcessor* processor = nullptr;
+        ID3D11Texture2D* rgbTexture = nullptr;
+        ID3D11VideoProcessorInputView* inputView = nullptr;
+        GLTarget gl;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        TextureFormat format = TextureFormat::RGBA8;
+    } m_convert;
+
     // OpenGL
     HGLRC m_hglrc = nullptr;
 
+    // ANGLE route (see GLContext::isANGLE)
+    bool m_angle = false;
+    const AngleEGL* m_egl = nullptr;
+    EGLDisplay m_eglDisplay = nullptr;
+
     // WGL/DX interop
     HANDLE m_wglDxDevice = nullptr;
 
@@ -525,6 +941,12 @@ private:
     PFNGLBINDFRAMEBUFFERPROC m_glBindFramebuffer = nullptr;
     PFNGLFRAMEBUFFERTEXTURE2DPROC m_glFramebufferTexture2D = nullptr;
     PFNGLCHECKFRAMEBUFFERSTATUSPROC m_glCheckFramebufferStatus = nullptr;
+    PFNGLGENTEXTURESPROC m_glGenTextures = nullptr;
+    PFNGLDELETETEXTURESPROC m_glDeleteTextures = nullptr;
+    PFNGLBINDTEXTUREPROC m_glBindTexture = nullptr;
+    PFNGLTEXIMAGE2DPROC m_glTexImage2D = nullptr;
+    PFNGLFLUSHPROC m_glFlush = nullptr;
+    PFNGLEGLIMAGETARGETTEXTURE2DOESPROC m_glEGLImageTargetTexture2DOES = nullptr;
 };
 
 // Factory function
@@ -0,0 +1,156 @@
+/**
+ * TypeScript bindings for the native playlist and guide parsers
+ *
+ * A separate addon (playlist_parser.node) with no mpv dependency, so it
+ * loads on every platform and independently of the mpv-texture addon.
+ * Import it from '@sbtltv/mpv-texture/dist/playlist.js'.
+ */
+
+import { join, dirname } from 'path';
+import { existsSync } from 'fs';
+
+/**
+ * A parsed M3U playlist, one column per field
+ *
+ * Channel i is made of `strings[name[i]]`, `strings[url[i]]` and so on;
+ * index 0 of the string table is the empty string (field absent). Repeated
+ * values such as groups and logos are stored once. Parsing follows
+ * parseM3U() in @sbtltv/local-adapter; ids and categories are left to it.
+ */
+export interface M3UColumns {
+  count: number;
+  /** url-tvg / x-tvg-url from the #EXTM3U header */
+  epgUrl: string | null;
+  strings: string[];
+  /** Display name after the #EXTINF comma */
+  name: Uint32Array;
+  url: Uint32Array;
+  tvgId: Uint32Array;
+  tvgName: Uint32Array;
+  tvgLogo: Uint32Array;
+  /** group-title */
+  group: Uint32Array;
+  /** tvg-chno, CHANNEL_NUMBER_NONE if missing or not a number */
+  channelNumber: Int32Array;
+  /** #EXTINF duration (-1 for live streams) */
+  duration: Int32Array;
+}
+
+/** channelNumber value for entries without a usable tvg-chno */
+export const CHANNEL_NUMBER_NONE = -2147483648;
+
+/** A <channel> element of an XMLTV guide */
+export interface XmltvChannelInfo {
+  id: string;
+  /** Trimmed <display-name> values in document order */
+  displayNames: string[];
+}
+
+/**
+ * Parsed XMLTV programmes, grouped per channel and sorted by start time
+ *
+ * Programmes of `channels[c]` are the indices `offsets[c]` up to
+ * `offsets[c + 1]`; programme i is `strings[title[i]]` from `start[i]` to
+ * `stop[i]` (epoch ms). Titles and descriptions are entity-decoded and
+ * stored once per distinct value; index 0 is the empty string.
+ */
+export interface EpgColumns {
+  count: number;
+  /** Programmes dropped by the channel filter */
+  skipped: number;
+  strings: string[];
+  channels: string[];
+  /** channels.length + 1 entries */
+  offsets: Uint32Array;
+  title: Uint32Array;
+  description: Uint32Array;
+  start: Float64Array;
+  stop: Float64Array;
+}
+
+interface PlaylistAddon {
+  parseM3UFile(path: string): Promise<M3UColumns>;
+  scanXmltvChannels(path: string, threads?: number): Promise<XmltvChannelInfo[]>;
+  parseXmltvProgrammes(path: string, channelIds: string[] | null, threads?: number): Promise<EpgColumns>;
+}
+
+const distDir = __dirname;
+const packageDir = dirname(distDir);
+
+const paths: string[] = [];
+if ((process as any).resourcesPath) {
+  paths.push(join((process as any).resourcesPath, 'mpv', 'playlist_parser.node'));
+}
+paths.push(
+  join(packageDir, 'build', 'Release', 'playlist_parser.node'),
+  join(distDir, 'playlist_parser.node'),
+);
+
+let addon: PlaylistAddon | null = null;
+for (const p of paths) {
+  if (existsSync(p)) {
+    try {
+      addon = require(p);
+      break;
+    } catch (e) {
+      console.warn(`[mpv-texture] Failed to load playlist parser from ${p}:`, e);
+    }
+  }
+}
+
+/**
+ * Whether the native parser was found (callers fall back to the JS parser)
+ */
+export function isPlaylistParserAvailable(): boolean {
+  return addon !== null;
+}
+
+/**
+ * Parse an M3U file off the JS thread
+ *
+ * The file is memory-mapped and scanned on the libuv thread pool; only the
+ * string table and the typed-array columns are created on the JS heap.
+ *
+ * @param path - Path of a UTF-8 M3U/M3U8 file
+ */
+export function parseM3UFile(path: string): Promise<M3UColumns> {
+  if (!addon) {
+    return Promise.reject(new Error('Native playlist parser not available'));
+  }
+  return addon.parseM3UFile(path);
+}
+
+/**
+ * List the channels of an (uncompressed) XMLTV file
+ *
+ * Cheap next to parseXmltvProgrammes(); used to work out which channel
+ * ids are worth keeping before the programmes are parsed.
+ *
+ * @param path - Path of the XMLTV file
+ * @param threads - Ranges to scan in parallel (0 picks from the CPU count and file size)
+ */
+export function scanXmltvChannels(path: string, threads = 0): Promise<XmltvChannelInfo[]> {
+  if (!addon) {
+    return Promise.reject(new Error('Native playlist parser not available'));
+  }
+  return addon.scanXmltvChannels(path, threads);
+}
+
+/**
+ * Parse the programmes of an (uncompressed) XMLTV file off the JS thread
+ *
+ * The file is memory-mapped, split at <programme> boundaries and parsed on
+ * several threads. Programmes without a channel, valid times or a title
+ * are dropped, as in the JS EPG worker.
+ *
+ * @param path - Path of the XMLTV file
+ * @param channelIds - Only keep programmes of these channels (null for all)
+ * @param threads - Ranges to parse in parallel, at most 8 (0 picks from the
+ *   CPU count and file size). The result doesn't depend on it.
+ */
+export function parseXmltvProgrammes(path: string, channelIds: string[] | null = null, threads = 0): Promise<EpgColumns> {
+  if (!addon) {
+    return Promise.reject(new Error('Native playlist parser not available'));
+  }
+  return addon.parseXmltvProgrammes(path, channelIds, threads);
+}
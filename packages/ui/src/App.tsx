@@ -86,7 +86,7 @@ async function tryLoadWithFallbacks(
   debugLog(`Attempting to load: ${primaryUrl} (isLive: ${isLive})${startPosition ? ` resume@${startPosition}s` : ''}`);
 
   // Try primary URL first
-  const result = await mpv.load(primaryUrl, startPosition);
+  const result = await mpv.load(primaryUrl, startPosition, isLive);
   if (!result.error) {
     debugLog(`Primary URL loaded successfully`);
     return { success: true, url: primaryUrl };
@@ -98,7 +98,7 @@ async function tryLoadWithFallbacks(
   debugLog(`Trying ${fallbacks.length} fallback URLs...`);
   for (const fallbackUrl of fallbacks) {
     debugLog(`Trying fallback: ${fallbackUrl}`);
-    const fallbackResult = await mpv.load(fallbackUrl, startPosition);
+    const fallbackResult = await mpv.load(fallbackUrl, startPosition, isLive);
     if (!fallbackResult.error) {
       debugLog(`Fallback succeeded: ${fallbackUrl}`);
       return { success: true, url: fallbackUrl };
@@ -237,7 +237,7 @@ function App() {
   }, []);
 
   // Control handlers
-  const handleLoadStream = async (channel: StoredChannel) => {
+  const handleLoadStream = async (channel: StoredChannel, neighbours: StoredChannel[] = []) => {
     debugLog(`handleLoadStream: ${channel.name} (${channel.stream_id})`);
     debugLog(`  URL: ${channel.direct_url}`);
     if (!window.mpv) {
@@ -257,6 +257,8 @@ function App() {
         : channel
       );
       setPlaying(true);
+      // Warm up the likely next zaps (no-op with external mpv)
+      window.mpv?.prepare(neighbours.map((ch) => ch.direct_url));
     }
   };
 
@@ -315,8 +317,8 @@ function App() {
   };
 
   // Play a channel
-  const handlePlayChannel = (channel: StoredChannel) => {
-    handleLoadStream(channel);
+  const handlePlayChannel = (channel: StoredChannel, neighbours: StoredChannel[] = []) => {
+    handleLoadStream(channel, neighbours);
   };
 
   // Play VOD content (movies/series)
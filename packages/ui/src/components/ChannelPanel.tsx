@@ -16,7 +16,8 @@ interface ChannelPanelProps {
   visible: boolean;
   categoryStripOpen: boolean;
   sidebarExpanded: boolean;
-  onPlayChannel: (channel: StoredChannel) => void;
+  /** `neighbours` are the channels above and below, pre-opened for zapping */
+  onPlayChannel: (channel: StoredChannel, neighbours: StoredChannel[]) => void;
   onClose: () => void;
 }
 
@@ -267,7 +268,10 @@ export function ChannelPanel({
               windowEnd={windowEnd}
               pixelsPerHour={pixelsPerHour}
               visibleHours={visibleHours}
-              onPlay={() => onPlayChannel(channel)}
+              onPlay={() => onPlayChannel(
+                channel,
+                [channels[index - 1], channels[index + 1]].filter((ch): ch is StoredChannel => !!ch),
+              )}
             />
           )}
           components={{
@@ -6,7 +6,7 @@
  * in the vertex shader to correct this.
  */
 
-import { useEffect, useRef, useCallback } from 'react';
+import { useEffect, useRef, useCallback, useState } from 'react';
 
 interface VideoCanvasProps {
   /** Whether the canvas should be visible */
@@ -170,6 +170,24 @@ export function VideoCanvas({ visible, className, flipY = false, flipX = false }
   const glStateRef = useRef<WebGLState | null>(null);
   const drawErrorCount = useRef(0);
   const contextLostRef = useRef(false);
+  // A presentation report is scheduled for the next animation frame
+  const presentPendingRef = useRef(false);
+  // Main process may still fall back to external mpv; only show once native is confirmed
+  const [nativeMode, setNativeMode] = useState(false);
+
+  useEffect(() => {
+    if (!window.sharedTexture?.isAvailable) return;
+
+    let cancelled = false;
+    window.mpv?.getMode()
+      .then((info) => {
+        if (!cancelled) setNativeMode(info.mode === 'native');
+      })
+      .catch(() => { /* stay hidden */ });
+    return () => {
+      cancelled = true;
+    };
+  }, []);
 
   // Handle frame - render immediately
   const handleFrame = useCallback((videoFrame: VideoFrame, _index: number) => {
@@ -217,6 +235,16 @@ export function VideoCanvas({ visible, className, flipY = false, flipX = false }
     }
 
     videoFrame.close();
+
+    // The drawn frame reaches the screen with the next vsync; its rAF
+    // timestamp feeds the native display clock (displaySync pacing)
+    if (!presentPendingRef.current) {
+      presentPendingRef.current = true;
+      requestAnimationFrame((timestamp) => {
+        presentPendingRef.current = false;
+        window.sharedTexture?.reportPresentation(performance.timeOrigin + timestamp);
+      });
+    }
   }, [flipY, flipX]);
 
 
@@ -309,12 +337,15 @@ export function VideoCanvas({ visible, className, flipY = false, flipX = false }
     return null;
   }
 
+  // Keep the canvas mounted (WebGL is set up once) but hidden unless frames can arrive
+  const shown = visible && nativeMode;
+
   return (
     <canvas
       ref={canvasRef}
       className={className}
       style={{
-        display: visible ? 'block' : 'none',
+        display: shown ? 'block' : 'none',
         width: '100%',
         height: '100%',
         objectFit: 'contain',
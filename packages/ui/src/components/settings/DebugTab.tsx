@@ -11,6 +11,7 @@ export function DebugTab({
   onDebugLoggingChange,
 }: DebugTabProps) {
   const [logPath, setLogPath] = useState<string>('');
+  const [traceMessage, setTraceMessage] = useState<string>('');
   const updateSettings = useUpdateSettings();
 
   useEffect(() => {
@@ -37,6 +38,16 @@ export function DebugTab({
     }
   }
 
+  async function handleSaveFrameTrace() {
+    if (!window.debug) return;
+    const result = await window.debug.dumpMpvTrace();
+    if (result.error) {
+      setTraceMessage(`Failed to save trace: ${result.error}`);
+    } else {
+      setTraceMessage(result.data ? `Saved ${result.data}` : 'No frames recorded yet (built-in player only)');
+    }
+  }
+
 
 
   return (
@@ -65,6 +76,16 @@ export function DebugTab({
             When enabled, detailed logs from mpv, the renderer, and main process
             are written to a file. This may slightly impact performance.
           </p>
+          {debugLoggingEnabled && (
+            <div style={{ marginTop: '0.75rem' }}>
+              <button onClick={handleSaveFrameTrace} className="sync-button">
+                Save Frame Trace
+              </button>
+              <p className="form-hint" style={{ marginTop: '0.5rem' }}>
+                {traceMessage || 'Timing of the last ~25 seconds of video frames, for chrome://tracing or ui.perfetto.dev.'}
+              </p>
+            </div>
+          )}
           <p className="form-hint" style={{ marginTop: '0.5rem' }}>
             Report issues on{' '}
             <a href="https://github.com/thesubtleties/sbtlTV/issues" target="_blank" rel="noopener noreferrer">
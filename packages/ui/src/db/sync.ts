@@ -5,6 +5,7 @@ import { matchChannelsToEpg } from '../services/epg-matcher';
 import type { Source, Channel, Category, Movie, Series } from '@sbtltv/core';
 import { getEnrichedMovieExports, getEnrichedTvExports, findBestMatch, extractMatchParams } from '../services/tmdb-exports';
 import { useUIStore } from '../stores/uiStore';
+import type { EpgColumns } from '../types/electron';
 
 // Debug logging helper - logs to console and optionally to debug file
 function debugLog(message: string, category = 'sync'): void {
@@ -130,6 +131,25 @@ async function parseEpgInWorker(data: string): Promise<EpgParseResult> {
   });
 }
 
+// Expand native guide columns (see EpgColumns) into program objects
+function programsFromColumns(guide: EpgColumns): XmltvProgram[] {
+  const { strings, channels, offsets, title, description, start, stop } = guide;
+  const programs: XmltvProgram[] = new Array(guide.count);
+  for (let c = 0; c < channels.length; c++) {
+    const channelId = channels[c];
+    for (let i = offsets[c]; i < offsets[c + 1]; i++) {
+      programs[i] = {
+        channel_id: channelId,
+        title: strings[title[i]],
+        description: strings[description[i]],
+        start: new Date(start[i]),
+        stop: new Date(stop[i]),
+      };
+    }
+  }
+  return programs;
+}
+
 // Fetch XMLTV from a single URL and parse it
 // Gzipped/large files: fetched, decompressed, and parsed entirely in main process worker thread
 // Provider channels are passed for filtered parsing (skip programmes for non-matching channels)
@@ -154,14 +174,16 @@ async function fetchXmltvFromUrl(epgUrl: string, providerChannels?: Channel[]):
     if (!response.data) {
       throw new Error(`Failed to fetch/parse XMLTV: ${response.error || 'unknown error'}`);
     }
-    // Convert ISO strings back to Dates (Dates don't survive IPC)
-    const programs: XmltvProgram[] = response.data.programs.map(p => ({
-      channel_id: p.channel_id,
-      title: p.title,
-      description: p.description,
-      start: new Date(p.start),
-      stop: new Date(p.stop),
-    }));
+    const programs = response.data.guide
+      ? programsFromColumns(response.data.guide)
+      // Convert ISO strings back to Dates (Dates don't survive IPC)
+      : (response.data.programs ?? []).map((p): XmltvProgram => ({
+        channel_id: p.channel_id,
+        title: p.title,
+        description: p.description,
+        start: new Date(p.start),
+        stop: new Date(p.stop),
+      }));
     debugLog(`Main process parsed ${response.data.channels.length} channels, ${programs.length} programs`, 'epg');
     return { programs, channels: response.data.channels };
   }
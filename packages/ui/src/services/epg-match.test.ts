@@ -0,0 +1,100 @@
+import { describe, it, expect } from 'vitest';
+import { buildMatchedXmltvIds, matchEpgChannels, type EpgChannel, type ProviderChannel } from '@sbtltv/local-adapter';
+
+function provider(name: string, epgId = '', streamId = name): ProviderChannel {
+  return { name, epg_channel_id: epgId, stream_id: streamId };
+}
+
+function match(xmltv: EpgChannel[], channels: ProviderChannel[], log: (msg: string) => void = () => {}): string[] {
+  return [...buildMatchedXmltvIds(xmltv, channels, log)].sort();
+}
+
+describe('buildMatchedXmltvIds', () => {
+  it('matches an exact tvg-id', () => {
+    const xmltv = [
+      { id: 'cnn.us', displayNames: ['CNN'] },
+      { id: 'bbcone.uk', displayNames: ['BBC One'] },
+    ];
+
+    expect(match(xmltv, [provider('Whatever', 'cnn.us')])).toEqual(['cnn.us']);
+  });
+
+  it('leaves unreferenced channels out', () => {
+    const xmltv = [
+      { id: 'cnn.us', displayNames: ['CNN'] },
+      { id: 'qvc.us', displayNames: ['QVC'] },
+    ];
+
+    expect(match(xmltv, [provider('CNN', 'cnn.us')])).toEqual(['cnn.us']);
+    expect(match(xmltv, [])).toEqual([]);
+  });
+
+  it('matches a bare call sign to the DT code of a local station', () => {
+    const xmltv = [{ id: 'WABC-DT (WABCDT).us', displayNames: ['ABC 7 New York'] }];
+
+    expect(match(xmltv, [provider('Local', 'wabc.us')])).toEqual(['WABC-DT (WABCDT).us']);
+  });
+
+  it('matches a normalized display name without a tvg-id', () => {
+    const xmltv = [{ id: 'bbcone.uk', displayNames: ['BBC One'] }];
+
+    // Country prefix and quality suffix are stripped
+    expect(match(xmltv, [provider('UK: BBC One HD')])).toEqual(['bbcone.uk']);
+  });
+
+  it('matches a call sign in the channel name', () => {
+    const xmltv = [{ id: 'ABC.7.NewYork (WABCDT).us', displayNames: ['ABC 7 New York HD'] }];
+
+    expect(match(xmltv, [provider('ABC 7 (WABC) New York')])).toEqual(['ABC.7.NewYork (WABCDT).us']);
+  });
+
+  it('skips ambiguous network call signs', () => {
+    const xmltv = [{ id: 'CNN (CNN).us', displayNames: ['Cable News'] }];
+
+    expect(match(xmltv, [provider('Breaking (CNN)')])).toEqual([]);
+  });
+
+  it('falls back to fuzzy name matching and logs it', () => {
+    const xmltv = [{ id: 'skysports1.uk', displayNames: ['Sky Sports 1'] }];
+    const messages: string[] = [];
+
+    expect(match(xmltv, [provider('Sky Sports')], msg => messages.push(msg))).toEqual(['skysports1.uk']);
+    expect(messages).toEqual(['[epg-match] Fuzzy fallback matched 1 additional channels']);
+  });
+
+  it('does not log when nothing needed the fuzzy fallback', () => {
+    const xmltv = [{ id: 'cnn.us', displayNames: ['CNN'] }];
+    const messages: string[] = [];
+
+    match(xmltv, [provider('CNN', 'cnn.us')], msg => messages.push(msg));
+    expect(messages).toEqual([]);
+  });
+});
+
+describe('matchEpgChannels', () => {
+  const xmltv = [
+    { id: 'cnn.us', displayNames: ['CNN'] },
+    { id: 'bbcone.uk', displayNames: ['BBC One'] },
+    { id: 'ABC.7.NewYork (WABCDT).us', displayNames: ['ABC 7 New York HD'] },
+    { id: 'skysports1.uk', displayNames: ['Sky Sports 1'] },
+  ];
+
+  it('reports the strategy and confidence of each match, once per stream', () => {
+    const matches: string[] = [];
+    matchEpgChannels(xmltv, [
+      provider('CNN', 'cnn.us'),
+      provider('CNN', 'cnn.us'),
+      provider('UK: BBC One HD'),
+      provider('Local (WABC)'),
+      provider('Sky Sports'),
+      provider('Unknown Channel'),
+    ], (ch, xmltvId, confidence, strategy) => matches.push(`${ch.name} → ${xmltvId} ${confidence} ${strategy}`));
+
+    expect(matches).toEqual([
+      'CNN → cnn.us exact exact_id',
+      'UK: BBC One HD → bbcone.uk high display_name',
+      'Local (WABC) → ABC.7.NewYork (WABCDT).us medium callsign',
+      'Sky Sports → skysports1.uk medium fuzzy',
+    ]);
+  });
+});
@@ -0,0 +1,181 @@
+import { describe, it, expect } from 'vitest';
+import { parseM3U, parseM3UColumns } from '@sbtltv/local-adapter';
+
+type M3UColumns = Parameters<typeof parseM3UColumns>[0];
+
+const SOURCE_ID = 'test-source';
+
+/** Mirrors CHANNEL_NUMBER_NONE in mpv-texture/src/playlist.ts */
+const CHANNEL_NUMBER_NONE = -2147483648;
+
+interface Entry {
+  name: string;
+  url: string;
+  tvgId?: string;
+  tvgName?: string;
+  tvgLogo?: string;
+  group?: string;
+  chno?: string;
+  duration?: number;
+}
+
+interface Header {
+  urlTvg?: string;
+  xTvgUrl?: string;
+  /** Write x-tvg-url before url-tvg */
+  xTvgFirst?: boolean;
+}
+
+/** The playlist as text, for parseM3U */
+function playlist(header: Header, entries: Entry[]): string {
+  const headerAttrs = [
+    header.urlTvg ? `url-tvg="${header.urlTvg}"` : '',
+    header.xTvgUrl ? `x-tvg-url="${header.xTvgUrl}"` : '',
+  ].filter(Boolean);
+  if (header.xTvgFirst) headerAttrs.reverse();
+
+  const lines = [['#EXTM3U', ...headerAttrs].join(' ')];
+  for (const e of entries) {
+    const attrs = [
+      e.tvgId ? `tvg-id="${e.tvgId}"` : '',
+      e.tvgName ? `tvg-name="${e.tvgName}"` : '',
+      e.tvgLogo ? `tvg-logo="${e.tvgLogo}"` : '',
+      e.group ? `group-title="${e.group}"` : '',
+      e.chno !== undefined ? `tvg-chno="${e.chno}"` : '',
+    ].filter(Boolean).join(' ');
+    lines.push(`#EXTINF:${e.duration ?? -1} ${attrs},${e.name}`);
+    lines.push(e.url);
+  }
+  return lines.join('\n');
+}
+
+/**
+ * The same playlist as the columns the native parser returns: interned
+ * strings with index 0 for absent fields, url-tvg before x-tvg-url, and
+ * CHANNEL_NUMBER_NONE for a missing or non-numeric tvg-chno
+ */
+function columns(header: Header, entries: Entry[]): M3UColumns {
+  const strings = [''];
+  const index = new Map<string, number>([['', 0]]);
+  const intern = (value: string | undefined): number => {
+    if (!value) return 0;
+    let i = index.get(value);
+    if (i === undefined) {
+      i = strings.length;
+      strings.push(value);
+      index.set(value, i);
+    }
+    return i;
+  };
+  const column = (field: (e: Entry) => string | undefined) => Uint32Array.from(entries, e => intern(field(e)));
+
+  return {
+    count: entries.length,
+    epgUrl: header.urlTvg ?? header.xTvgUrl ?? null,
+    strings,
+    name: column(e => e.name),
+    url: column(e => e.url),
+    tvgId: column(e => e.tvgId),
+    tvgName: column(e => e.tvgName),
+    tvgLogo: column(e => e.tvgLogo),
+    group: column(e => e.group),
+    channelNumber: Int32Array.from(entries, e => {
+      const num = e.chno === undefined ? NaN : parseInt(e.chno, 10);
+      return isNaN(num) ? CHANNEL_NUMBER_NONE : num;
+    }),
+    duration: Int32Array.from(entries, e => e.duration ?? -1),
+  };
+}
+
+/** Parse the playlist both ways */
+function parseBoth(header: Header, entries: Entry[]) {
+  return {
+    text: parseM3U(playlist(header, entries), SOURCE_ID),
+    cols: parseM3UColumns(columns(header, entries), SOURCE_ID),
+  };
+}
+
+const FIXTURE: Entry[] = [
+  { name: 'CNN HD', url: 'http://example.com/cnn', tvgId: 'cnn.us', tvgName: 'CNN', tvgLogo: 'http://example.com/cnn.png', group: 'News', chno: '101' },
+  { name: 'CNN HD', url: 'http://example.com/cnn', tvgId: 'cnn.us', tvgLogo: 'http://example.com/cnn.png', group: '1_FAVORITES' },
+  { name: 'CNN HD', url: 'http://example.com/cnn', group: 'News' },
+  { name: 'BBC One', url: 'http://example.com/bbc', tvgId: 'bbc.uk', group: 'News', chno: 'abc' },
+  { name: '', url: 'http://example.com/espn', tvgName: 'ESPN', group: 'Sports', chno: ' 7a' },
+  { name: 'CNN HD', url: 'http://example.com/cnn-sd', group: 'News', chno: '-3' },
+  { name: 'Radio', url: 'http://example.com/radio', duration: 0 },
+];
+
+describe('parseM3UColumns', () => {
+  it('matches parseM3U on the same playlist', () => {
+    const { text, cols } = parseBoth({ urlTvg: 'http://example.com/guide.xml' }, FIXTURE);
+
+    expect(cols).toEqual(text);
+    expect(cols.channels.map(c => c.stream_id)).toEqual(text.channels.map(c => c.stream_id));
+  });
+
+  it('merges a stream listed in several groups', () => {
+    const { text, cols } = parseBoth({}, FIXTURE);
+
+    for (const result of [text, cols]) {
+      const cnn = result.channels.filter(c => c.direct_url === 'http://example.com/cnn');
+      expect(cnn).toHaveLength(1);
+      // First occurrence wins; later ones only add their group once
+      expect(cnn[0].epg_channel_id).toBe('cnn.us');
+      expect(cnn[0].category_ids).toEqual([
+        `${SOURCE_ID}_news`,
+        `${SOURCE_ID}_1-favorites`,
+      ]);
+      expect(result.categories.map(c => c.category_name)).toEqual(['News', '1_FAVORITES', 'Sports']);
+    }
+    expect(cols.channels).toHaveLength(5);
+  });
+
+  it('parses tvg-chno like parseInt and drops non-numbers', () => {
+    const { text, cols } = parseBoth({}, FIXTURE);
+
+    for (const result of [text, cols]) {
+      const byUrl = new Map(result.channels.map(c => [c.direct_url, c]));
+      expect(byUrl.get('http://example.com/cnn')?.channel_num).toBe(101);
+      expect(byUrl.get('http://example.com/espn')?.channel_num).toBe(7);
+      expect(byUrl.get('http://example.com/cnn-sd')?.channel_num).toBe(-3);
+      expect(byUrl.get('http://example.com/bbc')).not.toHaveProperty('channel_num');
+      expect(byUrl.get('http://example.com/radio')).not.toHaveProperty('channel_num');
+    }
+  });
+
+  it('falls back to tvg-name for a missing display name', () => {
+    const { text, cols } = parseBoth({}, FIXTURE);
+
+    expect(text.channels.find(c => c.direct_url === 'http://example.com/espn')?.name).toBe('ESPN');
+    expect(cols.channels.find(c => c.direct_url === 'http://example.com/espn')?.name).toBe('ESPN');
+  });
+
+  describe('EPG url from the header', () => {
+    const URL_TVG = 'http://example.com/url-tvg.xml';
+    const X_TVG_URL = 'http://example.com/x-tvg-url.xml';
+
+    it('prefers url-tvg over x-tvg-url', () => {
+      const { text, cols } = parseBoth({ urlTvg: URL_TVG, xTvgUrl: X_TVG_URL }, FIXTURE);
+      expect(text.epgUrl).toBe(URL_TVG);
+      expect(cols.epgUrl).toBe(URL_TVG);
+    });
+
+    it('prefers url-tvg even when x-tvg-url comes first', () => {
+      const { text, cols } = parseBoth({ urlTvg: URL_TVG, xTvgUrl: X_TVG_URL, xTvgFirst: true }, FIXTURE);
+      expect(text.epgUrl).toBe(URL_TVG);
+      expect(cols.epgUrl).toBe(URL_TVG);
+    });
+
+    it('uses x-tvg-url on its own', () => {
+      const { text, cols } = parseBoth({ xTvgUrl: X_TVG_URL }, FIXTURE);
+      expect(text.epgUrl).toBe(X_TVG_URL);
+      expect(cols.epgUrl).toBe(X_TVG_URL);
+    });
+
+    it('is null without either attribute', () => {
+      const { text, cols } = parseBoth({}, FIXTURE);
+      expect(text.epgUrl).toBeNull();
+      expect(cols.epgUrl).toBeNull();
+    });
+  });
+});
@@ -0,0 +1,113 @@
+import { describe, it, expect, beforeAll, afterAll } from 'vitest';
+import { mkdtempSync, rmSync, writeFileSync, readFileSync } from 'node:fs';
+import { createRequire } from 'node:module';
+import { tmpdir } from 'node:os';
+import { join } from 'node:path';
+import { parseM3U, parseM3UColumns } from '@sbtltv/local-adapter';
+
+type M3UColumns = Parameters<typeof parseM3UColumns>[0];
+
+interface PlaylistAddon {
+  parseM3UFile(path: string): Promise<M3UColumns>;
+}
+
+/** playlist_parser.node from `pnpm --filter @sbtltv/mpv-texture build:native`, if built */
+function loadAddon(): PlaylistAddon | null {
+  try {
+    return createRequire(import.meta.url)('../../../mpv-texture/build/Release/playlist_parser.node');
+  } catch {
+    return null;
+  }
+}
+
+const addon = loadAddon();
+
+const SOURCE_ID = 'test-source';
+
+const FIXTURES: Record<string, string> = {
+  crlf: [
+    '#EXTM3U url-tvg="http://example.com/guide.xml"',
+    '#EXTINF:-1 tvg-id="cnn.us" tvg-logo="http://example.com/cnn.png" group-title="News",CNN HD',
+    'http://example.com/cnn',
+    '#EXTINF:-1 tvg-id="bbc.uk" group-title="News" tvg-chno="2",BBC One ',
+    'http://example.com/bbc',
+    '',
+  ].join('\r\n'),
+  'missing #EXTINF attributes': [
+    '#EXTM3U',
+    '#EXTINF:-1,No Attributes',
+    'http://example.com/bare',
+    '#EXTINF:0 tvg-id="" group-title="",Empty Values',
+    'https://example.com/empty',
+    '#EXTINF:-1 tvg-name="Name Only"',
+    'http://example.com/no-comma',
+    '#EXTINF:,',
+    'rtmp://example.com/nothing',
+    '#EXTINF:abc tvg-chno="",Bad Duration',
+    'http://example.com/bad-duration',
+    // The entry carries over directives and non-stream lines
+    '#EXTINF:-1,No URL follows',
+    '#EXTVLCOPT:http-user-agent=Test',
+    'udp://example.com/not-a-stream',
+    'http://example.com/after-directive',
+  ].join('\n'),
+  'quoted commas': [
+    '#EXTM3U x-tvg-url="http://example.com/a,b.xml"',
+    '#EXTINF:-1 tvg-name="News, Weather" group-title="News, Sports",Channel, One',
+    'http://example.com/one',
+    '#EXTINF:-1 tvg-id="two" group-title="A,B,C",Two',
+    'http://example.com/two',
+    // The last comma is inside the quotes: both parsers split there
+    '#EXTINF:-1 tvg-name="Trailing, comma"',
+    'http://example.com/three',
+  ].join('\n'),
+  bom: '\uFEFF' + [
+    '#EXTM3U url-tvg="http://example.com/bom.xml"',
+    '#EXTINF:-1 tvg-id="bébé" group-title="Français",Écran  ',
+    'http://example.com/bom',
+  ].join('\n'),
+  'empty file': '',
+};
+
+describe.skipIf(!addon)('native parseM3UFile', () => {
+  let dir: string;
+
+  beforeAll(() => {
+    dir = mkdtempSync(join(tmpdir(), 'sbtltv-m3u-'));
+  });
+
+  afterAll(() => {
+    rmSync(dir, { recursive: true, force: true });
+  });
+
+  it.each(Object.keys(FIXTURES))('matches parseM3U: %s', async (fixture) => {
+    const file = join(dir, `${fixture.replace(/\W+/g, '-')}.m3u`);
+    writeFileSync(file, FIXTURES[fixture]);
+
+    const native = parseM3UColumns(await addon!.parseM3UFile(file), SOURCE_ID);
+    const text = parseM3U(readFileSync(file, 'utf8'), SOURCE_ID);
+
+    expect(native).toEqual(text);
+  });
+
+  it('strips a BOM before the #EXTM3U header', async () => {
+    const file = join(dir, 'bom-check.m3u');
+    writeFileSync(file, FIXTURES.bom);
+
+    const result = parseM3UColumns(await addon!.parseM3UFile(file), SOURCE_ID);
+
+    expect(result.epgUrl).toBe('http://example.com/bom.xml');
+    expect(result.channels.map(c => c.name)).toEqual(['Écran']);
+    expect(result.channels[0].epg_channel_id).toBe('bébé');
+  });
+
+  it('returns no channels for an empty file', async () => {
+    const file = join(dir, 'empty-check.m3u');
+    writeFileSync(file, '');
+
+    const columns = await addon!.parseM3UFile(file);
+
+    expect(columns.count).toBe(0);
+    expect(columns.epgUrl).toBeNull();
+  });
+});
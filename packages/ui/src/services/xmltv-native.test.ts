@@ -0,0 +1,259 @@
+import { describe, it, expect, beforeAll, afterAll } from 'vitest';
+import { mkdtempSync, rmSync, writeFileSync } from 'node:fs';
+import { createRequire } from 'node:module';
+import { tmpdir } from 'node:os';
+import { join } from 'node:path';
+import { parseXmltvFull } from '@sbtltv/local-adapter';
+
+/** The result shapes of playlist_parser.node (see mpv-texture/src/playlist.ts) */
+interface EpgColumns {
+  count: number;
+  skipped: number;
+  strings: string[];
+  channels: string[];
+  offsets: Uint32Array;
+  title: Uint32Array;
+  description: Uint32Array;
+  start: Float64Array;
+  stop: Float64Array;
+}
+
+interface XmltvChannelInfo {
+  id: string;
+  displayNames: string[];
+}
+
+interface PlaylistAddon {
+  scanXmltvChannels(path: string, threads?: number): Promise<XmltvChannelInfo[]>;
+  parseXmltvProgrammes(path: string, channelIds: string[] | null, threads?: number): Promise<EpgColumns>;
+}
+
+/** playlist_parser.node from `pnpm --filter @sbtltv/mpv-texture build:native`, if built */
+function loadAddon(): PlaylistAddon | null {
+  try {
+    return createRequire(import.meta.url)('../../../mpv-texture/build/Release/playlist_parser.node');
+  } catch {
+    return null;
+  }
+}
+
+const addon = loadAddon();
+
+/** One range per thread; a small file is split only when the count is forced */
+const THREAD_COUNTS = [1, 4];
+
+interface Programme {
+  channel_id: string;
+  title: string;
+  description: string;
+  start: number;
+  stop: number;
+}
+
+/** "YYYYMMDDhhmmss +0000", `minutes` after 2025-01-01 00:00 UTC */
+function stamp(minutes: number): string {
+  const d = new Date(Date.UTC(2025, 0, 1) + minutes * 60_000);
+  const pad = (n: number) => String(n).padStart(2, '0');
+  return `${d.getUTCFullYear()}${pad(d.getUTCMonth() + 1)}${pad(d.getUTCDate())}` +
+    `${pad(d.getUTCHours())}${pad(d.getUTCMinutes())}00 +0000`;
+}
+
+/** Channel attributes of every <programme> written, for the filter's skip count */
+const programmeChannels: string[] = [];
+
+function programme(attrs: Record<string, string>, title: string, desc = '', quote = '"'): string {
+  if (attrs.channel !== undefined) programmeChannels.push(attrs.channel);
+  const tag = Object.entries(attrs).map(([k, v]) => `${k}=${quote}${v}${quote}`).join(' ');
+  return [
+    `  <programme ${tag}>`,
+    `    <title lang="en">${title}</title>`,
+    desc ? `    <desc lang="en">${desc}</desc>` : '',
+    '  </programme>',
+  ].filter(Boolean).join('\n');
+}
+
+const at = (channel: string, start: string, stop: string) => ({ start, stop, channel });
+
+/**
+ * A guide with enough programmes that forced ranges start in different
+ * places, interleaved channels (one listed in reverse time order), and the
+ * edge cases below
+ */
+function buildGuide(): string {
+  const parts = [
+    '<?xml version="1.0" encoding="UTF-8"?>',
+    '<tv generator-info-name="test">',
+    '  <channel id="news.uk"><display-name>BBC News</display-name><display-name>  News &amp; Weather </display-name></channel>',
+    '  <channel id="films.fr"><display-name>Cin&#233;ma</display-name><display-name></display-name></channel>',
+    '  <channel id="kids.us"><display-name>Kids &#55357;&#56842;</display-name></channel>',
+  ];
+
+  for (let i = 0; i < 60; i++) {
+    parts.push(programme(at('news.uk', stamp(i * 30), stamp(i * 30 + 30)), `News ${i}`, `Bulletin ${i % 7}`));
+    parts.push(programme(at('films.fr', stamp((59 - i) * 90), stamp((59 - i) * 90 + 90)), `Film ${59 - i}`));
+    parts.push(programme(at('kids.us', stamp(i * 15), stamp(i * 15 + 15)), `Cartoon ${i % 5}`, `Episode ${i}`));
+    if (i === 30) {
+      // A late channel element between programmes
+      parts.push('  <channel id="late.de"><display-name>Sp&#xE4;t</display-name></channel>');
+    }
+  }
+
+  parts.push(
+    // Same start: file order is kept
+    programme(at('late.de', stamp(60), stamp(120)), 'Tie first'),
+    programme(at('late.de', stamp(60), stamp(90)), 'Tie second'),
+    programme(at('late.de', stamp(0), stamp(60)), 'Earlier'),
+    // Fields out of range: an Invalid Date (NaN), kept and sorted last
+    programme(at('late.de', '20251301000000 +0000', stamp(30)), 'Bad month'),
+    programme(at('late.de', '20250101126000 +0000', '20250101240001 +0000'), 'Bad minute'),
+    programme(at('late.de', '20250101120000 +2400', stamp(30)), 'Bad offset'),
+    // Out of range for a Date string but still valid in V8
+    programme(at('late.de', '20250230000000 +0000', '20250101240000'), 'February 30'),
+    programme(at('late.de', stamp(30), '20250101120000 -0530'), 'Offset stop'),
+    // Not the expected format: dropped
+    programme(at('late.de', '2025010100000 +0000', stamp(30)), 'Short start'),
+    programme(at('late.de', stamp(0), '20250101000000 UTC'), 'Named zone'),
+    programme(at('late.de', stamp(0), '20250101000000 +000'), 'Short offset'),
+    programme({ start: stamp(0), channel: 'late.de' }, 'No stop'),
+    programme({ start: stamp(0), stop: stamp(30) }, 'No channel'),
+    programme(at('late.de', stamp(0), stamp(30)), ''),
+    // Entities, decoded in the JS order (so "&amp;lt;" decodes twice)
+    programme(at('ent.test', stamp(0), stamp(10)), 'Tom &amp; Jerry', '&lt;p&gt;&quot;Hi&quot; &apos;there&apos;&lt;/p&gt;'),
+    programme(at('ent.test', stamp(10), stamp(20)), '&amp;lt;b&amp;gt; twice'),
+    programme(at('ent.test', stamp(20), stamp(30)), 'Caf&#233; &#xE9;t&#xE9; &#8364;5'),
+    programme(at('ent.test', stamp(30), stamp(40)), 'Pair &#55357;&#56842; &#xD83D;&#xDE00;'),
+    programme(at('ent.test', stamp(40), stamp(50)), 'Lone &#55357; and &#56842; and &#xD83D;x'),
+    // Only the low 16 bits survive String.fromCharCode
+    programme(at('ent.test', stamp(50), stamp(60)), 'Wide &#x1F600; &#128512;'),
+    programme(at('ent.test', stamp(60), stamp(70)), 'Unterminated &#233 &amp'),
+    programme(at('ent.test', stamp(70), stamp(80)), 'Single quotes', '', "'"),
+  );
+
+  parts.push('</tv>', '');
+  return parts.join('\n');
+}
+
+/** As JS text reaches UTF-8 (storage, IPC): lone surrogates become U+FFFD */
+function wellFormed(text: string): string {
+  return new TextDecoder().decode(new TextEncoder().encode(text));
+}
+
+/** The native columns as programmes, in column order */
+function fromColumns(guide: EpgColumns): Programme[] {
+  const out: Programme[] = [];
+  guide.channels.forEach((channel, c) => {
+    for (let i = guide.offsets[c]; i < guide.offsets[c + 1]; i++) {
+      out.push({
+        channel_id: channel,
+        title: guide.strings[guide.title[i]],
+        description: guide.strings[guide.description[i]],
+        start: guide.start[i],
+        stop: guide.stop[i],
+      });
+    }
+  });
+  return out;
+}
+
+/**
+ * parseXmltvFull()'s programmes in the native order: grouped by channel in
+ * first-seen order, then by start time (Invalid Dates last, file order on ties)
+ */
+function fromJs(xml: string, channelIds: string[] | null = null): Programme[] {
+  const groups = new Map<string, Programme[]>();
+  for (const p of parseXmltvFull(xml).programs) {
+    if (channelIds && !channelIds.includes(p.channel_id)) continue;
+    let group = groups.get(p.channel_id);
+    if (!group) {
+      group = [];
+      groups.set(p.channel_id, group);
+    }
+    group.push({
+      channel_id: p.channel_id,
+      title: wellFormed(p.title),
+      description: wellFormed(p.description),
+      start: p.start.getTime(),
+      stop: p.stop.getTime(),
+    });
+  }
+  const key = (start: number) => (isNaN(start) ? Infinity : start);
+  return [...groups.values()].flatMap(group => group.sort((a, b) => key(a.start) - key(b.start)));
+}
+
+describe.skipIf(!addon)('native XMLTV parser', () => {
+  const xml = buildGuide();
+  let dir: string;
+  let file: string;
+
+  beforeAll(() => {
+    dir = mkdtempSync(join(tmpdir(), 'sbtltv-xmltv-'));
+    file = join(dir, 'guide.xml');
+    writeFileSync(file, xml);
+  });
+
+  afterAll(() => {
+    rmSync(dir, { recursive: true, force: true });
+  });
+
+  it.each(THREAD_COUNTS)('matches parseXmltvFull with %s thread(s)', async (threads) => {
+    const guide = await addon!.parseXmltvProgrammes(file, null, threads);
+
+    expect(fromColumns(guide)).toEqual(fromJs(xml));
+    expect(guide.count).toBe(guide.title.length);
+    expect(guide.skipped).toBe(0);
+  });
+
+  it('gives the same columns for every thread count', async () => {
+    const [single, ...split] = await Promise.all(
+      THREAD_COUNTS.map(threads => addon!.parseXmltvProgrammes(file, null, threads)),
+    );
+    for (const guide of split) {
+      expect(guide).toEqual(single);
+    }
+  });
+
+  it('keeps Invalid Dates as NaN, last in their channel, and drops unparseable times', async () => {
+    const programmes = fromColumns(await addon!.parseXmltvProgrammes(file, null, 1));
+    const late = programmes.filter(p => p.channel_id === 'late.de').map(p => p.title);
+
+    expect(late).toEqual([
+      'Earlier', 'Offset stop', 'Tie first', 'Tie second', 'February 30',
+      'Bad month', 'Bad minute', 'Bad offset',
+    ]);
+    const badMinute = programmes.find(p => p.title === 'Bad minute')!;
+    expect(badMinute.start).toBeNaN();
+    expect(badMinute.stop).toBeNaN();
+    expect(programmes.find(p => p.title === 'February 30')!.start).toBe(Date.UTC(2025, 2, 2));
+  });
+
+  it('decodes entities like the JS parser', async () => {
+    const titles = fromColumns(await addon!.parseXmltvProgrammes(file, ['ent.test'], 4)).map(p => p.title);
+
+    expect(titles).toEqual([
+      'Tom & Jerry',
+      '<b> twice',
+      'Café été €5',
+      'Pair 😊 😀',
+      'Lone \uFFFD and \uFFFD and \uFFFDx',
+      'Wide \uF600 \uF600',
+      'Unterminated &#233 &amp',
+      'Single quotes',
+    ]);
+  });
+
+  it.each(THREAD_COUNTS)('filters channels and counts the rest with %s thread(s)', async (threads) => {
+    const keep = ['ent.test', 'news.uk'];
+    const guide = await addon!.parseXmltvProgrammes(file, keep, threads);
+
+    expect(guide.channels).toEqual(['news.uk', 'ent.test']);
+    expect(fromColumns(guide)).toEqual(fromJs(xml, keep));
+    expect(guide.skipped).toBe(programmeChannels.filter(id => !keep.includes(id)).length);
+  });
+
+  it.each(THREAD_COUNTS)('scans channels like parseXmltvFull with %s thread(s)', async (threads) => {
+    const channels = await addon!.scanXmltvChannels(file, threads);
+
+    expect(channels).toEqual(parseXmltvFull(xml).channels);
+    expect(channels.map(c => c.id)).toEqual(['news.uk', 'films.fr', 'kids.us', 'late.de']);
+  });
+});
@@ -16,13 +16,21 @@ export interface MpvResult {
   error?: string;
 }
 
+export interface MpvThumbnailResult extends MpvResult {
+  width?: number;
+  height?: number;
+  /** RGBA8 pixels, top row first */
+  data?: Uint8Array;
+}
+
 export interface MpvModeInfo {
   mode: 'native' | 'external';
   sharedTextureAvailable: boolean;
 }
 
 export interface MpvApi {
-  load: (url: string, startPosition?: number) => Promise<MpvResult>;
+  // isLive picks the playback profile (native mode; live when omitted)
+  load: (url: string, startPosition?: number, isLive?: boolean) => Promise<MpvResult>;
   play: () => Promise<MpvResult>;
   pause: () => Promise<MpvResult>;
   togglePause: () => Promise<MpvResult>;
@@ -30,6 +38,10 @@ export interface MpvApi {
   setVolume: (volume: number) => Promise<MpvResult>;
   toggleMute: () => Promise<MpvResult>;
   seek: (seconds: number) => Promise<MpvResult>;
+  /** Pre-open likely next channels for instant zapping (native mode only) */
+  prepare: (urls: string[]) => Promise<MpvResult>;
+  /** Snapshot the playing picture, scaled to width x height (0 keeps aspect; native mode only) */
+  captureThumbnail: (width: number, height?: number) => Promise<MpvThumbnailResult>;
   getStatus: () => Promise<MpvStatus>;
   getMode: () => Promise<MpvModeInfo>;
   onReady: (callback: (ready: boolean) => void) => void;
@@ -107,12 +119,50 @@ export interface FetchProxyResponse {
   text: string;
 }
 
+// Columnar M3U parse result (shape must match M3UColumns in mpv-texture/src/playlist.ts)
+export interface M3UColumns {
+  count: number;
+  epgUrl: string | null;
+  strings: string[];
+  name: Uint32Array;
+  url: Uint32Array;
+  tvgId: Uint32Array;
+  tvgName: Uint32Array;
+  tvgLogo: Uint32Array;
+  group: Uint32Array;
+  channelNumber: Int32Array;
+  duration: Int32Array;
+}
+
+// Columnar XMLTV programmes (shape must match EpgColumns in mpv-texture/src/playlist.ts)
+export interface EpgColumns {
+  count: number;
+  skipped: number;
+  strings: string[];
+  channels: string[];
+  offsets: Uint32Array;
+  title: Uint32Array;
+  description: Uint32Array;
+  start: Float64Array;
+  stop: Float64Array;
+}
+
+// EPG parse result: `programs` from the worker thread (ISO date strings),
+// `guide` from the native parser
+export interface EpgParseData {
+  channels: { id: string; displayNames: string[] }[];
+  programs?: { channel_id: string; title: string; description: string; start: string; stop: string }[];
+  guide?: EpgColumns;
+}
+
 export interface FetchProxyApi {
   fetch: (url: string, options?: { method?: string; headers?: Record<string, string>; body?: string }) => Promise<StorageResult<FetchProxyResponse>>;
   fetchBinary: (url: string) => Promise<StorageResult<string>>; // Returns base64-encoded data
-  // Provider channel shape must match ProviderChannelInfo in main.ts and ProviderChannel in epg-parse-worker.ts
-  // Return shape must match EpgChannel/EpgProgram in epg-parse-worker.ts (dates are ISO strings over IPC)
-  fetchAndParseEpg: (url: string, providerChannels?: { epg_channel_id: string; name: string; stream_id: string }[]) => Promise<StorageResult<{ channels: { id: string; displayNames: string[] }[]; programs: { channel_id: string; title: string; description: string; start: string; stop: string }[] }>>;
+  // Provider channel shape must match ProviderChannelInfo in main.ts and ProviderChannel in @sbtltv/local-adapter
+  // Worker results must match EpgChannel (@sbtltv/local-adapter) / EpgProgram (epg-parse-worker.ts)
+  fetchAndParseEpg: (url: string, providerChannels?: { epg_channel_id: string; name: string; stream_id: string }[]) => Promise<StorageResult<EpgParseData>>;
+  // Native M3U parse in the main process (fails when the addon isn't available)
+  fetchAndParseM3U: (url: string) => Promise<StorageResult<M3UColumns> & { unavailable?: boolean }>;
 }
 
 export interface PlatformApi {
@@ -130,6 +180,14 @@ export interface DebugApi {
   getLogPath: () => Promise<StorageResult<string>>;
   logFromRenderer: (message: string) => Promise<StorageResult>;
   openLogFolder: () => Promise<StorageResult>;
+  /** Recent native mpv log messages as text (empty in external mode) */
+  getMpvLog: () => Promise<StorageResult<string>>;
+  /**
+   * Write the native frame latency trace (recorded while debug logging is
+   * on) next to the debug log as Chrome trace-event JSON; resolves to the
+   * file path, or null if nothing was recorded (external mode)
+   */
+  dumpMpvTrace: () => Promise<StorageResult<string | null>>;
 }
 
 export interface UpdateInfo {
@@ -164,6 +222,8 @@ export interface SharedTextureApi {
   onClear: (callback: () => void) => void;
   /** Remove the clear callback */
   removeClearListener: () => void;
+  /** Report when a drawn frame was presented (epoch ms), for display-synced pacing */
+  reportPresentation: (presentedAtMs: number) => void;
   /** Whether sharedTexture API is available (native mpv mode) */
   isAvailable: boolean;
 }